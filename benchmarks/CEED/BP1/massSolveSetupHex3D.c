@@ -300,6 +300,21 @@ solver_t *massSolveSetupHex3D(mesh_t *mesh, dfloat lambda, occa::kernelInfo &ker
 			                             "put",
 			                             kernelInfo);
 			                             
+			mesh->ogsExchangePackKernel =
+			  saferBuildKernelFromSource(mesh->device, DHOLMES "/okl/ogsExchange.okl",
+			                             "ogsExchangePack",
+			                             kernelInfo);
+			                             
+			mesh->ogsExchangeAddKernel =
+			  saferBuildKernelFromSource(mesh->device, DHOLMES "/okl/ogsExchange.okl",
+			                             "ogsExchangeAdd",
+			                             kernelInfo);
+			                             
+			mesh->ogsExchangeUnpackKernel =
+			  saferBuildKernelFromSource(mesh->device, DHOLMES "/okl/ogsExchange.okl",
+			                             "ogsExchangeUnpack",
+			                             kernelInfo);
+			                             
 			solver->partialAxKernel =
 			  saferBuildKernelFromSource(mesh->device, DHOLMES "/okl/massAxHex3D.okl",
 			                             "massPartialAxHex3D_v2",
@@ -383,6 +383,21 @@ solver_t *ellipticSolveSetupHex3D(mesh_t *mesh, dfloat lambda, occa::kernelInfo
 			                             "put",
 			                             kernelInfo);
 			                             
+			mesh->ogsExchangePackKernel =
+			  saferBuildKernelFromSource(mesh->device, DHOLMES "/okl/ogsExchange.okl",
+			                             "ogsExchangePack",
+			                             kernelInfo);
+			                             
+			mesh->ogsExchangeAddKernel =
+			  saferBuildKernelFromSource(mesh->device, DHOLMES "/okl/ogsExchange.okl",
+			                             "ogsExchangeAdd",
+			                             kernelInfo);
+			                             
+			mesh->ogsExchangeUnpackKernel =
+			  saferBuildKernelFromSource(mesh->device, DHOLMES "/okl/ogsExchange.okl",
+			                             "ogsExchangeUnpack",
+			                             kernelInfo);
+			                             
 #if 0
 			// WARNING
 			if(mesh->Nq<12) {
@@ -0,0 +1,103 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "mpi.h"
+
+#include "mesh.h"
+#include "mesh2D.h"
+#include "mesh3D.h"
+
+// how a kernel variant is called
+#define BENCHMARK_AX          0 // (E, ggeo, D, S, MM, lambda, q, Aq)
+#define BENCHMARK_PARTIAL_AX  1 // (E, elementList, ggeo, D, S, MM, lambda, q, Aq)
+#define BENCHMARK_GRADIENT    2 // (E, vgeo, D, q, gradq)
+#define BENCHMARK_PARTIAL_GRADIENT 3 // (E, offset, vgeo, D, q, gradq)
+#define BENCHMARK_VOLUME      4 // (E, vgeo, D, fieldOffset, U, NU)
+
+typedef struct{
+
+  const char *family;     // variants of a family compute the same result
+  const char *fileName;   // relative to DHOLMES, %s is the element suffix
+  const char *kernelName; // %s is the element suffix
+  const char *suffix;     // only for this element type ("" for all)
+  int launch;
+
+}kernelVariant_t;
+
+typedef struct{
+
+  int elementType;
+  int Nelements;
+  dfloat lambda;
+
+  mesh_t *mesh;           // reference element data (no connectivity)
+
+  occa::properties kernelInfo;
+
+  dfloat *ggeo, *vgeo, *Dmatrices, *Smatrices, *MM, *q;
+  dlong  *elementList;
+
+  // device copies
+  occa::memory o_ggeo, o_vgeo, o_Dmatrices, o_Smatrices, o_MM, o_q, o_Aq;
+  occa::memory o_elementList;
+
+}kernelBenchmark_t;
+
+kernelBenchmark_t *kernelBenchmarkSetup(occa::device &device, int elementType, int N, int Nelements);
+
+void kernelBenchmarkUpload(kernelBenchmark_t *bench, occa::device &device);
+
+void kernelBenchmarkFreeDevice(kernelBenchmark_t *bench);
+
+void kernelBenchmarkFree(kernelBenchmark_t *bench);
+
+// number of registered kernel variants and the table itself
+extern const int NkernelVariants;
+extern const kernelVariant_t kernelVariants[];
+
+// element suffix used in kernel and file names (Tri2D, Quad2D, Tet3D, Hex3D)
+const char *kernelBenchmarkSuffix(int elementType);
+
+// platform carries the device and communicator used by meshBuildKernel
+occa::kernel kernelBenchmarkBuild(mesh_t *platform, kernelBenchmark_t *bench, const kernelVariant_t *variant);
+
+void kernelBenchmarkLaunch(kernelBenchmark_t *bench, occa::kernel &kernel, const kernelVariant_t *variant);
+
+// number of dfloats a variant writes to o_Aq
+size_t kernelBenchmarkOutputSize(kernelBenchmark_t *bench, const kernelVariant_t *variant);
+
+// maximum error relative to the largest reference entry
+double kernelBenchmarkError(kernelBenchmark_t *bench, const kernelVariant_t *variant,
+                            const dfloat *ref, const dfloat *result);
+
+void kernelBenchmarkCost(kernelBenchmark_t *bench, const kernelVariant_t *variant,
+                         double *flopsPerElement, double *bytesPerElement);
+
+double kernelBenchmarkCopyBandwidth(occa::device &device, size_t Nbytes, int Niterations);
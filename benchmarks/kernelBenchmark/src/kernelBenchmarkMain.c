@@ -0,0 +1,233 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "kernelBenchmark.h"
+
+int main(int argc, char **argv){
+
+  // start up MPI
+  MPI_Init(&argc, &argv);
+
+  if(argc!=2){
+    printf("usage: ./kernelBenchmarkMain setupfile\n");
+    MPI_Finalize();
+    exit(-1);
+  }
+
+  // if argv > 2 then should load input data from argv
+  setupAide options(argv[1]);
+
+  // no mesh is read, the platform only carries the communicator and device
+  mesh_t *platform = (mesh_t*) calloc(1, sizeof(mesh_t));
+  platform->comm = MPI_COMM_WORLD;
+  MPI_Comm_rank(platform->comm, &(platform->rank));
+  MPI_Comm_size(platform->comm, &(platform->size));
+
+  occaDeviceConfig(platform, options);
+
+  // reference results always come from the Serial backend
+  mesh_t *refPlatform = (mesh_t*) calloc(1, sizeof(mesh_t));
+  refPlatform->comm = platform->comm;
+  refPlatform->rank = platform->rank;
+  refPlatform->size = platform->size;
+  refPlatform->hostComm = platform->hostComm;
+  refPlatform->hostRank = platform->hostRank;
+  refPlatform->device.setup("mode: 'Serial'");
+
+  const int rank = platform->rank;
+
+  // sweep parameters, comma separated lists
+  vector<string> elementTypes, degrees, counts, families;
+  options.getArgs("ELEMENT TYPES", elementTypes, ",");
+  options.getArgs("POLYNOMIAL DEGREES", degrees, ",");
+  options.getArgs("ELEMENT COUNTS", counts, ",");
+  options.getArgs("KERNELS", families, ",");
+
+  int Niterations = 10;
+  options.getArgs("NUMBER OF ITERATIONS", Niterations);
+
+  double peakGflops = 0; // optional compute ceiling of the roofline
+  options.getArgs("PEAK GFLOPS", peakGflops);
+
+  string outName;
+  options.getArgs("OUTPUT FILE NAME", outName);
+
+  string threadModel = options.getArgs("THREAD MODEL");
+
+  const double tol = (sizeof(dfloat)==8) ? 1.e-8 : 1.e-4;
+
+  // memory ceiling of the roofline, slowest rank
+  double copyGBs = kernelBenchmarkCopyBandwidth(platform->device, ((size_t)1)<<27, Niterations);
+  MPI_Allreduce(MPI_IN_PLACE, &copyGBs, 1, MPI_DOUBLE, MPI_MIN, platform->comm);
+
+  FILE *fp = NULL;
+  if(rank==0){
+    string fileName = outName + ".csv";
+    fp = fopen(fileName.c_str(), "w");
+    if(!fp){
+      printf("kernelBenchmark: could not open %s\n", fileName.c_str());
+      MPI_Abort(platform->comm, -1);
+    }
+    fprintf(fp, "family,variant,elementType,N,Np,Nelements,threadModel,time,gflops,gbs,flops,bytes,"
+            "intensity,copyGBs,rooflineGflops,rooflineFraction,maxError,status\n");
+
+    printf("Copy bandwidth: %g GB/s\n", copyGBs);
+  }
+
+  int Nfailed = 0;
+
+  for(size_t t=0;t<elementTypes.size();++t){
+    const int elementType = atoi(elementTypes[t].c_str());
+
+    for(size_t d=0;d<degrees.size();++d){
+      const int N = atoi(degrees[d].c_str());
+
+      for(size_t c=0;c<counts.size();++c){
+        const int Nelements = atoi(counts[c].c_str());
+
+        kernelBenchmark_t *bench = kernelBenchmarkSetup(platform->device, elementType, N, Nelements);
+
+        const char *suffix = kernelBenchmarkSuffix(elementType);
+        const int Np = bench->mesh->Np;
+
+        dfloat *zeros  = (dfloat*) calloc(4*Nelements*(size_t)Np, sizeof(dfloat));
+        dfloat *ref    = (dfloat*) calloc(4*Nelements*(size_t)Np, sizeof(dfloat));
+        dfloat *result = (dfloat*) calloc(4*Nelements*(size_t)Np, sizeof(dfloat));
+
+        for(size_t f=0;f<families.size();++f){
+
+          // variants of this family available for the element type
+          vector<int> ids;
+          for(int v=0;v<NkernelVariants;++v){
+            if(families[f].compare(kernelVariants[v].family)) continue;
+            if(strlen(kernelVariants[v].suffix) && strcmp(kernelVariants[v].suffix, suffix)) continue;
+            ids.push_back(v);
+          }
+
+          if(!ids.size()){
+            if(rank==0) printf("kernelBenchmark: no %s kernels for %s\n", families[f].c_str(), suffix);
+            continue;
+          }
+
+          const kernelVariant_t *refVariant = kernelVariants + ids[0];
+          const size_t Nout = kernelBenchmarkOutputSize(bench, refVariant);
+
+          // reference result
+          kernelBenchmarkUpload(bench, refPlatform->device);
+
+          occa::kernel refKernel;
+          for (int r=0;r<meshBuildKernelStages;r++){
+            if (r==meshBuildKernelStage(refPlatform))
+              refKernel = kernelBenchmarkBuild(refPlatform, bench, refVariant);
+            MPI_Barrier(platform->comm);
+          }
+
+          bench->o_Aq.copyFrom(zeros, Nout*sizeof(dfloat));
+          kernelBenchmarkLaunch(bench, refKernel, refVariant);
+          bench->o_Aq.copyTo(ref, Nout*sizeof(dfloat));
+
+          kernelBenchmarkUpload(bench, platform->device);
+
+          for(size_t i=0;i<ids.size();++i){
+            const kernelVariant_t *variant = kernelVariants + ids[i];
+
+            occa::kernel kernel;
+            for (int r=0;r<meshBuildKernelStages;r++){
+              if (r==meshBuildKernelStage(platform))
+                kernel = kernelBenchmarkBuild(platform, bench, variant);
+              MPI_Barrier(platform->comm);
+            }
+
+            // check (and warm up)
+            bench->o_Aq.copyFrom(zeros, Nout*sizeof(dfloat));
+            kernelBenchmarkLaunch(bench, kernel, variant);
+            bench->o_Aq.copyTo(result, Nout*sizeof(dfloat));
+
+            double maxError = kernelBenchmarkError(bench, variant, ref, result);
+
+            platform->device.finish();
+            occa::streamTag start = platform->device.tagStream();
+            for(int it=0;it<Niterations;++it)
+              kernelBenchmarkLaunch(bench, kernel, variant);
+            occa::streamTag end = platform->device.tagStream();
+            platform->device.finish();
+
+            double elapsed = platform->device.timeBetween(start, end)/Niterations;
+
+            MPI_Allreduce(MPI_IN_PLACE, &elapsed, 1, MPI_DOUBLE, MPI_MAX, platform->comm);
+            MPI_Allreduce(MPI_IN_PLACE, &maxError, 1, MPI_DOUBLE, MPI_MAX, platform->comm);
+
+            double flopsPerElement, bytesPerElement;
+            kernelBenchmarkCost(bench, variant, &flopsPerElement, &bytesPerElement);
+
+            const double flops = flopsPerElement*Nelements;
+            const double bytes = bytesPerElement*Nelements;
+            const double gflops = flops/(1.e9*elapsed);
+            const double gbs = bytes/(1.e9*elapsed);
+            const double intensity = flops/bytes;
+
+            double roofline = copyGBs*intensity;
+            if(peakGflops>0) roofline = mymin(roofline, peakGflops);
+
+            const int pass = (maxError<tol);
+            if(!pass) ++Nfailed;
+
+            if(rank==0){
+              char kernelName[BUFSIZ];
+              sprintf(kernelName, variant->kernelName, suffix);
+
+              fprintf(fp, "%s,%s,%s,%d,%d,%d,%s,%.6e,%.6e,%.6e,%.6e,%.6e,%.6e,%.6e,%.6e,%.6e,%.6e,%s\n",
+                      variant->family, kernelName, suffix, N, Np, Nelements, threadModel.c_str(),
+                      elapsed, gflops, gbs, flops, bytes, intensity, copyGBs, roofline, gflops/roofline,
+                      maxError, pass ? "PASS":"FAIL");
+              fflush(fp);
+
+              printf("%-32s N=%2d E=%8d: %8.3f GFLOPS/s %8.3f GB/s (%5.1f%% of roofline), err=%g %s\n",
+                     kernelName, N, Nelements, gflops, gbs, 100.*gflops/roofline, maxError,
+                     pass ? "":"FAILED");
+            }
+          }
+        }
+
+        free(zeros); free(ref); free(result);
+        kernelBenchmarkFree(bench);
+      }
+    }
+  }
+
+  int buildMismatch = meshBuildKernelReport(platform, options);
+
+  if(rank==0){
+    fclose(fp);
+    if(Nfailed) printf("kernelBenchmark: %d variants did not match their reference\n", Nfailed);
+    if(buildMismatch) printf("kernelBenchmark: ranks built different sets of kernels\n");
+  }
+
+  // close down MPI
+  MPI_Finalize();
+
+  return (Nfailed || buildMismatch) ? 1:0;
+}
@@ -0,0 +1,201 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "kernelBenchmark.h"
+
+// the first variant of a family valid for an element type is its reference
+const kernelVariant_t kernelVariants[] = {
+  {"Ax", "solvers/elliptic/okl/ellipticAx%s.okl", "ellipticAx%s",                "",       BENCHMARK_AX},
+  {"Ax", "solvers/elliptic/okl/ellipticAx%s.okl", "ellipticPartialAx%s",         "Tri2D",  BENCHMARK_PARTIAL_AX},
+  {"Ax", "solvers/elliptic/okl/ellipticAx%s.okl", "ellipticPartialAx%s",         "Quad2D", BENCHMARK_PARTIAL_AX},
+  {"Ax", "solvers/elliptic/okl/ellipticAx%s.okl", "ellipticPartialAx%s",         "Tet3D",  BENCHMARK_PARTIAL_AX},
+  {"Ax", "solvers/elliptic/okl/ellipticAx%s.okl", "ellipticPartialAx%s_v0",      "Tet3D",  BENCHMARK_PARTIAL_AX},
+  {"Ax", "solvers/elliptic/okl/ellipticAx%s.okl", "ellipticPartialAx%s",         "Hex3D",  BENCHMARK_PARTIAL_AX}, // _v0
+  {"Ax", "solvers/elliptic/okl/ellipticAx%s.okl", "ellipticPartialAx%s_v1",      "Hex3D",  BENCHMARK_PARTIAL_AX},
+
+  {"Gradient", "solvers/elliptic/okl/ellipticGradient%s.okl", "ellipticGradient%s",        "",      BENCHMARK_GRADIENT},
+  {"Gradient", "solvers/elliptic/okl/ellipticGradient%s.okl", "ellipticPartialGradient%s", "",      BENCHMARK_PARTIAL_GRADIENT},
+  {"Gradient", "solvers/elliptic/okl/ellipticGradient%s.okl", "ellipticGradient%s_v0",     "Tri2D", BENCHMARK_GRADIENT},
+
+  {"insGradient",  "solvers/ins/okl/insGradient%s.okl",  "insGradientVolume%s",  "", BENCHMARK_VOLUME},
+
+  {"insAdvection", "solvers/ins/okl/insAdvection%s.okl", "insAdvectionVolume%s", "", BENCHMARK_VOLUME}
+};
+
+const int NkernelVariants = sizeof(kernelVariants)/sizeof(kernelVariant_t);
+
+const char *kernelBenchmarkSuffix(int elementType){
+
+  if(elementType==TRIANGLES)      return "Tri2D";
+  if(elementType==QUADRILATERALS) return "Quad2D";
+  if(elementType==TETRAHEDRA)     return "Tet3D";
+  if(elementType==HEXAHEDRA)      return "Hex3D";
+
+  printf("kernelBenchmark: unknown element type %d\n", elementType);
+  MPI_Abort(MPI_COMM_WORLD, -1);
+  return NULL;
+}
+
+occa::kernel kernelBenchmarkBuild(mesh_t *platform, kernelBenchmark_t *bench, const kernelVariant_t *variant){
+
+  char fileName[BUFSIZ], relName[BUFSIZ], kernelName[BUFSIZ];
+
+  const char *suffix = kernelBenchmarkSuffix(bench->elementType);
+
+  sprintf(relName, variant->fileName, suffix);
+  sprintf(fileName, DHOLMES "/%s", relName);
+  sprintf(kernelName, variant->kernelName, suffix);
+
+  return meshBuildKernel(platform, fileName, kernelName, bench->kernelInfo);
+}
+
+void kernelBenchmarkLaunch(kernelBenchmark_t *bench, occa::kernel &kernel, const kernelVariant_t *variant){
+
+  const dlong Nelements = bench->Nelements;
+  const dlong offset = Nelements*bench->mesh->Np;
+
+  switch(variant->launch){
+  case BENCHMARK_AX:
+    kernel(Nelements, bench->o_ggeo, bench->o_Dmatrices, bench->o_Smatrices, bench->o_MM,
+           bench->lambda, bench->o_q, bench->o_Aq);
+    break;
+  case BENCHMARK_PARTIAL_AX:
+    kernel(Nelements, bench->o_elementList, bench->o_ggeo, bench->o_Dmatrices, bench->o_Smatrices, bench->o_MM,
+           bench->lambda, bench->o_q, bench->o_Aq);
+    break;
+  case BENCHMARK_GRADIENT:
+    kernel(Nelements, bench->o_vgeo, bench->o_Dmatrices, bench->o_q, bench->o_Aq);
+    break;
+  case BENCHMARK_PARTIAL_GRADIENT:
+    kernel(Nelements, (dlong) 0, bench->o_vgeo, bench->o_Dmatrices, bench->o_q, bench->o_Aq);
+    break;
+  case BENCHMARK_VOLUME:
+    kernel(Nelements, bench->o_vgeo, bench->o_Dmatrices, offset, bench->o_q, bench->o_Aq);
+    break;
+  }
+}
+
+size_t kernelBenchmarkOutputSize(kernelBenchmark_t *bench, const kernelVariant_t *variant){
+
+  const size_t Nnodes = bench->Nelements*(size_t)bench->mesh->Np;
+
+  switch(variant->launch){
+  case BENCHMARK_GRADIENT:
+  case BENCHMARK_PARTIAL_GRADIENT:
+    return 4*Nnodes; // dfloat4 per node
+  case BENCHMARK_VOLUME:
+    return bench->mesh->dim*Nnodes;
+  }
+  return Nnodes;
+}
+
+double kernelBenchmarkError(kernelBenchmark_t *bench, const kernelVariant_t *variant,
+                            const dfloat *ref, const dfloat *result){
+
+  const size_t Nentries = kernelBenchmarkOutputSize(bench, variant);
+  const int gradient = (variant->launch==BENCHMARK_GRADIENT || variant->launch==BENCHMARK_PARTIAL_GRADIENT);
+
+  double maxRef = 0, maxDiff = 0;
+  for(size_t n=0;n<Nentries;++n){
+    // 2D gradients leave the z component of the dfloat4 unset
+    if(gradient && bench->mesh->dim==2 && n%4==2) continue;
+
+    maxRef  = mymax(maxRef, fabs(ref[n]));
+    maxDiff = mymax(maxDiff, fabs(ref[n]-result[n]));
+  }
+
+  return (maxRef>0) ? maxDiff/maxRef : maxDiff;
+}
+
+// per-element flop and byte counts of the kernel families, derivative
+// and stiffness matrices are assumed to stay in cache
+void kernelBenchmarkCost(kernelBenchmark_t *bench, const kernelVariant_t *variant,
+                         double *flopsPerElement, double *bytesPerElement){
+
+  mesh_t *mesh = bench->mesh;
+
+  const int dim = mesh->dim;
+  const int tensor = (bench->elementType==QUADRILATERALS || bench->elementType==HEXAHEDRA);
+  const double Np = mesh->Np;
+
+  // same per-node derivative and geometric factor costs the solvers register
+  double Dflops, Vbytes;
+  meshKernelCostFactors(mesh, bench->elementType, &Dflops, &Vbytes);
+  const double Gbytes = Vbytes*mesh->Nggeo/mesh->Nvgeo;
+
+  double flops = 0, bytes = 0;
+
+  if(!strcmp(variant->family, "Ax")){
+    if(tensor){
+      // gradient, metric scaling, divergence and mass term at each node
+      flops = Np*(2*dim*Dflops + 2.*dim*dim + 2.);
+    }else{
+      // one pass per stiffness matrix plus the mass matrix
+      const int NS = (dim==2) ? 3:6;
+      flops = Np*(2.*Np*(NS+1) + 2.*NS + 2.);
+    }
+    bytes = 2*Np*sizeof(dfloat) + Gbytes;
+    if(variant->launch==BENCHMARK_PARTIAL_AX) bytes += sizeof(dlong);
+  }
+  else if(!strcmp(variant->family, "Gradient")){
+    flops = Np*(dim*Dflops + 2.*dim*dim);
+    bytes = Np*(1+4)*sizeof(dfloat) + Vbytes;
+  }
+  else if(!strcmp(variant->family, "insGradient")){
+    flops = Np*(dim*Dflops + 2.*dim*dim);
+    bytes = Np*(1+dim)*sizeof(dfloat) + Vbytes;
+  }
+  else if(!strcmp(variant->family, "insAdvection")){
+    flops = Np*dim*(dim*Dflops + 2.*dim*dim + 2.*dim);
+    bytes = Np*2*dim*sizeof(dfloat) + Vbytes;
+  }
+
+  *flopsPerElement = flops;
+  *bytesPerElement = bytes;
+}
+
+// sustained device to device copy bandwidth in GB/s (read plus write)
+double kernelBenchmarkCopyBandwidth(occa::device &device, size_t Nbytes, int Niterations){
+
+  occa::memory o_a = device.malloc(Nbytes);
+  occa::memory o_b = device.malloc(Nbytes);
+
+  // warm up
+  o_b.copyFrom(o_a);
+
+  occa::streamTag start = device.tagStream();
+  for(int it=0;it<Niterations;++it)
+    o_b.copyFrom(o_a);
+  occa::streamTag end = device.tagStream();
+
+  device.finish();
+  double elapsed = device.timeBetween(start, end);
+
+  o_a.free();
+  o_b.free();
+
+  return (elapsed>0) ? 2.*Nbytes*Niterations/(1.e9*elapsed) : 0;
+}
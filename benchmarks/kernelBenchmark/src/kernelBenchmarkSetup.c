@@ -0,0 +1,295 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "kernelBenchmark.h"
+
+// fill an array with reproducible values in [0,1)
+static dfloat *kernelBenchmarkRandom(size_t N){
+
+  dfloat *a = (dfloat*) calloc(N, sizeof(dfloat));
+  for(size_t n=0;n<N;++n)
+    a[n] = drand48();
+
+  return a;
+}
+
+kernelBenchmark_t *kernelBenchmarkSetup(occa::device &device, int elementType, int N, int Nelements){
+
+  kernelBenchmark_t *bench = new kernelBenchmark_t();
+
+  // reference element only, the benchmark needs no connectivity
+  mesh_t *mesh = (mesh_t*) calloc(1, sizeof(mesh_t));
+
+  bench->mesh = mesh;
+  bench->elementType = elementType;
+  bench->Nelements = Nelements;
+  bench->lambda = 1.0;
+
+  mesh->Nelements = Nelements;
+
+  switch(elementType){
+  case TRIANGLES:
+    mesh->dim = 2; mesh->Nverts = 3; mesh->Nfaces = 3;
+    mesh->Nvgeo = 5; mesh->Nggeo = 4; mesh->Nsgeo = 6;
+    meshLoadReferenceNodesTri2D(mesh, N);
+    break;
+  case QUADRILATERALS:
+    mesh->dim = 2; mesh->Nverts = 4; mesh->Nfaces = 4;
+    mesh->Nvgeo = 7; mesh->Nggeo = 4; mesh->Nsgeo = 7;
+    meshLoadReferenceNodesQuad2D(mesh, N);
+    break;
+  case TETRAHEDRA:
+    mesh->dim = 3; mesh->Nverts = 4; mesh->Nfaces = 4;
+    mesh->Nvgeo = 12; mesh->Nggeo = 7; mesh->Nsgeo = 14;
+    meshLoadReferenceNodesTet3D(mesh, N);
+    break;
+  case HEXAHEDRA:
+    mesh->dim = 3; mesh->Nverts = 8; mesh->Nfaces = 6;
+    mesh->Nvgeo = 12; mesh->Nggeo = 7; mesh->Nsgeo = 14;
+    meshLoadReferenceNodesHex3D(mesh, N);
+    break;
+  default:
+    printf("kernelBenchmark: unknown element type %d\n", elementType);
+    MPI_Abort(MPI_COMM_WORLD, -1);
+  }
+
+  mesh->Nq = N+1;
+
+  const int dim = mesh->dim;
+  const int Np = mesh->Np;
+  const int Nq = mesh->Nq;
+  const int tensor = (elementType==QUADRILATERALS || elementType==HEXAHEDRA);
+
+  // quad/hex factors are stored per node, tri/tet factors per element
+  const size_t NvgeoE = (tensor ? Np:1)*mesh->Nvgeo;
+  const size_t NggeoE = (tensor ? Np:1)*mesh->Nggeo;
+
+  // same seed on every run so the reference and the variants see the same data
+  srand48(12345);
+
+  bench->vgeo = kernelBenchmarkRandom(Nelements*NvgeoE);
+  bench->ggeo = kernelBenchmarkRandom(Nelements*NggeoE);
+  bench->MM   = kernelBenchmarkRandom(Np*Np);
+  bench->q    = kernelBenchmarkRandom(Nelements*(size_t)Np*3);
+
+  if(tensor){
+    bench->Dmatrices = (dfloat*) calloc(Nq*Nq, sizeof(dfloat));
+    bench->Smatrices = (dfloat*) calloc(Nq*Nq, sizeof(dfloat));
+    for(int n=0;n<Nq*Nq;++n){
+      bench->Dmatrices[n] = mesh->D[n];
+      bench->Smatrices[n] = mesh->D[n]; //dummy
+    }
+  }
+  else{
+    // transposed derivative matrices as in meshOccaSetup
+    dfloat *Drst[3] = {mesh->Dr, mesh->Ds, mesh->Dt};
+    bench->Dmatrices = (dfloat*) calloc(dim*Np*Np, sizeof(dfloat));
+    for(int d=0;d<dim;++d)
+      for(int n=0;n<Np;++n)
+        for(int m=0;m<Np;++m)
+          bench->Dmatrices[n+m*Np+d*Np*Np] = Drst[d][n*Np+m];
+
+    int NS = (dim==2) ? 3:6;
+    bench->Smatrices = kernelBenchmarkRandom(NS*Np*Np);
+  }
+
+  bench->elementList = (dlong*) calloc(Nelements, sizeof(dlong));
+  for(dlong e=0;e<Nelements;++e)
+    bench->elementList[e] = e;
+
+  // kernel defines, mirroring meshOccaSetup and the solver setups
+  occa::properties &kernelInfo = bench->kernelInfo;
+  if(sizeof(dfloat)==4){
+    kernelInfo["defines/" "dfloat"]="float";
+    kernelInfo["defines/" "dfloat2"]="float2";
+    kernelInfo["defines/" "dfloat4"]="float4";
+    kernelInfo["defines/" "dfloat8"]="float8";
+    kernelInfo["defines/" "pfloat"]="float";
+  }
+  if(sizeof(dfloat)==8){
+    kernelInfo["defines/" "dfloat"]="double";
+    kernelInfo["defines/" "dfloat2"]="double2";
+    kernelInfo["defines/" "dfloat4"]="double4";
+    kernelInfo["defines/" "dfloat8"]="double8";
+    kernelInfo["defines/" "pfloat"]="double";
+  }
+  if(sizeof(dlong)==4){
+    kernelInfo["defines/" "dlong"]="int";
+  }
+  if(sizeof(dlong)==8){
+    kernelInfo["defines/" "dlong"]="long long int";
+  }
+
+  if(device.mode()=="CUDA"){ // add backend compiler optimization for CUDA
+    kernelInfo["compiler_flags"] += "--ftz=true";
+    kernelInfo["compiler_flags"] += "--prec-div=false";
+    kernelInfo["compiler_flags"] += "--prec-sqrt=false";
+    kernelInfo["compiler_flags"] += "--use_fast_math";
+    kernelInfo["compiler_flags"] += "--fmad=true"; // compiler option for cuda
+  }
+
+  kernelInfo["defines/" "p_dim"]= dim;
+  kernelInfo["defines/" "p_N"]= mesh->N;
+  kernelInfo["defines/" "p_Nq"]= Nq;
+  kernelInfo["defines/" "p_Np"]= Np;
+  kernelInfo["defines/" "p_Nfp"]= mesh->Nfp;
+  kernelInfo["defines/" "p_Nfaces"]= mesh->Nfaces;
+  kernelInfo["defines/" "p_NfacesNfp"]= mesh->Nfp*mesh->Nfaces;
+  kernelInfo["defines/" "p_Nverts"]= mesh->Nverts;
+  kernelInfo["defines/" "p_Nvgeo"]= mesh->Nvgeo;
+  kernelInfo["defines/" "p_Nsgeo"]= mesh->Nsgeo;
+  kernelInfo["defines/" "p_Nggeo"]= mesh->Nggeo;
+  kernelInfo["defines/" "p_Nfields"]= 1;
+
+  kernelInfo["defines/" "p_RXID"]= RXID;
+  kernelInfo["defines/" "p_RYID"]= RYID;
+  kernelInfo["defines/" "p_SXID"]= SXID;
+  kernelInfo["defines/" "p_SYID"]= SYID;
+  kernelInfo["defines/" "p_JID"]= JID;
+  kernelInfo["defines/" "p_JWID"]= JWID;
+  kernelInfo["defines/" "p_IJWID"]= IJWID;
+
+  kernelInfo["defines/" "p_G00ID"]= G00ID;
+  kernelInfo["defines/" "p_G01ID"]= G01ID;
+  kernelInfo["defines/" "p_G11ID"]= G11ID;
+  kernelInfo["defines/" "p_GWJID"]= GWJID;
+
+  kernelInfo["defines/" "p_NXID"]= NXID;
+  kernelInfo["defines/" "p_NYID"]= NYID;
+  kernelInfo["defines/" "p_SJID"]= SJID;
+  kernelInfo["defines/" "p_IJID"]= IJID;
+  kernelInfo["defines/" "p_IHID"]= IHID;
+  kernelInfo["defines/" "p_WSJID"]= WSJID;
+  kernelInfo["defines/" "p_WIJID"]= WIJID;
+
+  if(dim==3){
+    kernelInfo["defines/" "p_RZID"]= RZID;
+    kernelInfo["defines/" "p_SZID"]= SZID;
+    kernelInfo["defines/" "p_TXID"]= TXID;
+    kernelInfo["defines/" "p_TYID"]= TYID;
+    kernelInfo["defines/" "p_TZID"]= TZID;
+
+    kernelInfo["defines/" "p_G02ID"]= G02ID;
+    kernelInfo["defines/" "p_G12ID"]= G12ID;
+    kernelInfo["defines/" "p_G22ID"]= G22ID;
+
+    kernelInfo["defines/" "p_NZID"]= NZID;
+  }
+
+  kernelInfo["defines/" "p_cubNq"]= mesh->cubNq;
+  kernelInfo["defines/" "p_cubNp"]= mesh->cubNp;
+  kernelInfo["defines/" "p_cubNfp"]= mesh->cubNfp;
+  kernelInfo["defines/" "p_intNfp"]= mesh->intNfp;
+  kernelInfo["defines/" "p_intNfpNfaces"]= mesh->intNfp*mesh->Nfaces;
+
+  int maxNthreads = 256;
+
+  int maxNodes = mymax(Np, (mesh->Nfp*mesh->Nfaces));
+  kernelInfo["defines/" "p_maxNodes"]= maxNodes;
+
+  int NblockV = mymax(1,maxNthreads/Np); // works for CUDA
+  int NnodesV = 1; //hard coded for now
+  kernelInfo["defines/" "p_NblockV"]= NblockV;
+  kernelInfo["defines/" "p_NnodesV"]= NnodesV;
+
+  int NblockS = mymax(1,maxNthreads/maxNodes); // works for CUDA
+  kernelInfo["defines/" "p_NblockS"]= NblockS;
+
+  int maxNodesVolumeCub = mymax(mesh->cubNp,Np);
+  kernelInfo["defines/" "p_maxNodesVolumeCub"]= maxNodesVolumeCub;
+  int cubNblockV = mymax(1,maxNthreads/maxNodesVolumeCub);
+
+  int maxNodesSurfaceCub = mymax(Np, mymax(mesh->Nfaces*mesh->Nfp, mesh->Nfaces*mesh->intNfp));
+  kernelInfo["defines/" "p_maxNodesSurfaceCub"]=maxNodesSurfaceCub;
+  int cubNblockS = mymax(maxNthreads/maxNodesSurfaceCub,1); // works for CUDA
+
+  kernelInfo["defines/" "p_cubNblockV"]=cubNblockV;
+  kernelInfo["defines/" "p_cubNblockS"]=cubNblockS;
+
+  kernelInfo["parser/" "automate-add-barriers"] =  "disabled";
+
+  return bench;
+}
+
+void kernelBenchmarkUpload(kernelBenchmark_t *bench, occa::device &device){
+
+  mesh_t *mesh = bench->mesh;
+
+  const dlong Nelements = bench->Nelements;
+  const int Np = mesh->Np;
+  const int Nq = mesh->Nq;
+  const int tensor = (bench->elementType==QUADRILATERALS || bench->elementType==HEXAHEDRA);
+
+  const size_t NvgeoE = (tensor ? Np:1)*mesh->Nvgeo;
+  const size_t NggeoE = (tensor ? Np:1)*mesh->Nggeo;
+  const size_t ND = tensor ? Nq*Nq : mesh->dim*Np*Np;
+  const size_t NS = tensor ? Nq*Nq : ((mesh->dim==2) ? 3:6)*Np*Np;
+
+  // release copies on a previously used device
+  kernelBenchmarkFreeDevice(bench);
+
+  bench->o_vgeo = device.malloc(Nelements*NvgeoE*sizeof(dfloat), bench->vgeo);
+  bench->o_ggeo = device.malloc(Nelements*NggeoE*sizeof(dfloat), bench->ggeo);
+  bench->o_Dmatrices = device.malloc(ND*sizeof(dfloat), bench->Dmatrices);
+  bench->o_Smatrices = device.malloc(NS*sizeof(dfloat), bench->Smatrices);
+  bench->o_MM = device.malloc(Np*Np*sizeof(dfloat), bench->MM);
+  bench->o_q  = device.malloc(Nelements*(size_t)Np*3*sizeof(dfloat), bench->q);
+
+  // large enough for a dfloat4 gradient
+  bench->o_Aq = device.malloc(Nelements*(size_t)Np*4*sizeof(dfloat));
+
+  bench->o_elementList = device.malloc(Nelements*sizeof(dlong), bench->elementList);
+}
+
+void kernelBenchmarkFreeDevice(kernelBenchmark_t *bench){
+
+  bench->o_vgeo.free();
+  bench->o_ggeo.free();
+  bench->o_Dmatrices.free();
+  bench->o_Smatrices.free();
+  bench->o_MM.free();
+  bench->o_q.free();
+  bench->o_Aq.free();
+  bench->o_elementList.free();
+}
+
+void kernelBenchmarkFree(kernelBenchmark_t *bench){
+
+  kernelBenchmarkFreeDevice(bench);
+
+  free(bench->vgeo);
+  free(bench->ggeo);
+  free(bench->Dmatrices);
+  free(bench->Smatrices);
+  free(bench->MM);
+  free(bench->q);
+  free(bench->elementList);
+
+  // arrays loaded with the reference nodes are left to the process
+  free(bench->mesh);
+
+  delete bench;
+}
@@ -31,6 +31,7 @@ SOFTWARE.
 
 #include "mpi.h"
 #include <math.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <occa.hpp>
 
@@ -50,6 +51,9 @@ typedef struct {
 
   MPI_Comm comm;
   int rank, size; // MPI rank and size (process count)
+
+  MPI_Comm hostComm; // ranks sharing this host
+  int hostRank;
   
   int dim;
   int Nverts, Nfaces, NfaceVertices;
@@ -77,10 +81,17 @@ typedef struct {
   dlong *haloElementList; // sorted list of elements to be sent in halo exchange
   int *NhaloPairs;      // number of elements worth of data to send/recv
   int  NhaloMessages;     // number of messages to send
+  int *haloNeighbors;     // ranks exchanged with (one per message, ascending)
+  dlong *haloNeighborOffsets; // element offset of each message in the halo buffers
 
   void *haloSendRequests;
   void *haloRecvRequests;
 
+  // persistent MPI requests for meshHaloExchangeStart/Finish, one per
+  // (message size, send buffer, recv buffer) combination seen so far.
+  // Shared with the multigrid level meshes built from this mesh
+  void *haloPlans;
+
   dlong NinternalElements; // number of elements that can update without halo exchange
   dlong NnotInternalElements; // number of elements that cannot update without halo exchange
 
@@ -291,6 +302,18 @@ typedef struct {
   dfloat *plotR, *plotS, *plotT; // coordinates of plot nodes in reference element
   dfloat *plotInterp;    // warp & blend to plot node interpolation matrix
 
+  // binary VTU output (see meshPlotVTUSetup)
+  int    plotNfields;    // number of plot field components staged on the device
+  float *plotPoints;     // plot node coordinates (3 per node)
+  float *plotq;          // host copy of the staged plot fields
+  occa::memory o_plotInterpT, o_plotq;
+  occa::kernel plotInterpKernel;
+  void  *plotWriter;     // background writer of the last frame
+
+  void  *checkpointWriter; // background writer of the last checkpoint (see meshCheckpointWrite)
+
+  void  *isoSurface;       // device isosurface extraction state and writer (see meshIsoSurfaceExtract)
+
   int *contourEToV;
   dfloat *contourVX, *contourVY, *contourVZ;
   dfloat *contourInterp, *contourInterp1, *contourFilter; 
@@ -550,6 +573,10 @@ typedef struct {
   occa::kernel getKernel;
   occa::kernel putKernel;
 
+  occa::kernel ogsExchangePackKernel;
+  occa::kernel ogsExchangeAddKernel;
+  occa::kernel ogsExchangeUnpackKernel;
+
   occa::kernel sumKernel;
   occa::kernel addScalarKernel;
 
@@ -621,18 +648,45 @@ void parallelSort(int size, int rank, MPI_Comm comm,
 		  void (*match)(void *, void *)
 		  );
 
+// exchange fixed size records between all ranks, returns the received records
+void *parallelExchange(MPI_Comm comm, size_t sz, void *v, int *Nsend, int *Nrecv);
+
 #define mymax(a,b) (((a)>(b))?(a):(b))
 #define mymin(a,b) (((a)<(b))?(a):(b))
 
+/* abort (instead of silently wrapping) if a count does not fit the configured index type */
+static inline void meshCheckIndexRange(MPI_Comm comm, long long int count, long long int maxCount, const char *label){
+  if(count<0 || count>maxCount){
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    printf("Rank %d: %s = %lld overflows the index type (max %lld), rebuild with HLONG64=1 and/or DLONG64=1\n",
+           rank, label, count, maxCount);
+    MPI_Abort(comm, 1);
+  }
+}
+
+/* native binary mesh format (see meshBinaryFormat.h) */
+int  meshBinaryFormat(char *fileName);
+void meshParallelReaderBinary(mesh_t *mesh, char *fileName);
+
 /* hash function */
 unsigned int hash(const unsigned int value) ;
 
 /* dimension independent mesh operations */
 void meshConnect(mesh_t *mesh);
 
+/* pair faces with equal sorted vertex tuples (match[n]=-1 if unmatched) */
+void meshMatchFaces(int NfaceVertices, dlong Nfaces, hlong *faceVerts, dlong *match);
+
 /* build parallel face connectivity */
 void meshParallelConnect(mesh_t *mesh);
 
+/* optional KL/FM-style boundary refinement of the element partition, set up
+   from the options with meshSetPartitionRefinement before meshSetup* (default: off).
+   Loads are balanced in elementWeight(elementInfo), NULL weights every element 1 */
+void meshSetPartitionRefinement(setupAide &options);
+void meshPartitionRefine(mesh_t *mesh, dfloat (*elementWeight)(int type));
+
 /* build global connectivity in parallel */
 void meshParallelConnectNodes(mesh_t *mesh);
 
@@ -655,6 +709,11 @@ void meshHaloExchangeStart(mesh_t *mesh,
 
 void meshHaloExchangeFinish(mesh_t *mesh);
 
+// create / release the persistent halo request list. Meshes that copy the halo
+// (multigrid levels) share the list, only the mesh that set it up frees it
+void meshHaloExchangeSetup(mesh_t *mesh);
+void meshHaloExchangeFree(mesh_t *mesh);
+
 // print out parallel partition i
 void meshPartitionStatistics(mesh_t *mesh);
 
@@ -677,6 +736,12 @@ ogs_t *meshParallelGatherScatterSetup(mesh_t *mesh,
                                       int verbose);
 
 void meshParallelGatherScatter(mesh_t *mesh, ogs_t *ogs, occa::memory &o_v);
+
+// split halo gather-scatter of Nentries fields (stride apart): Start gathers the
+// halo nodes of o_v and posts the messages, Finish completes them and scatters
+// the totals back, so non-halo work can run in between
+void meshParallelGatherScatterStart(mesh_t *mesh, ogs_t *ogs, occa::memory &o_v, int Nentries, dlong stride);
+void meshParallelGatherScatterFinish(mesh_t *mesh, ogs_t *ogs, occa::memory &o_v, int Nentries, dlong stride);
 void meshParallelGather(mesh_t *mesh, ogs_t *ogs, occa::memory &o_v, occa::memory &o_gv);
 void meshParallelScatter(mesh_t *mesh, ogs_t *ogs, occa::memory &o_v, occa::memory &o_sv);
 
@@ -741,5 +806,56 @@ void occaDeviceConfig(mesh_t *mesh, setupAide &newOptions);
 
 void *occaHostMallocPinned(occa::device &device, size_t size, void *source, occa::memory &mem);
 
+// kernels are built in meshBuildKernelStages stages (see meshBuildKernelStage)
+#define meshBuildKernelStages 3
+int meshBuildKernelStage(mesh_t *mesh);
+occa::kernel meshBuildKernel(mesh_t *mesh, const char *fileName, const char *kernelName,
+                             occa::properties &kernelInfo);
+// collective, returns 1 on every rank if the ranks registered different numbers of kernels
+int meshBuildKernelReport(mesh_t *mesh, setupAide &options);
+
+// profiler cost model: flops of one derivative of one field at a node and
+// geometric factor bytes per element (derivative matrices assumed cached)
+void meshKernelCostFactors(mesh_t *mesh, int elementType, double *Dflops, double *Gbytes);
+
+// per-kernel times and rates over all ranks to <OUTPUT FILE NAME>_profile.json/.csv
+void meshWriteProfile(mesh_t *mesh, setupAide &options);
+
+// binary appended-data VTU output: fields are interpolated to the plot nodes on the
+// device, copied back in one transfer and written by a background thread (rank 0
+// also writes the .pvtu). meshPlotVTUSetup is collective.
+void meshPlotVTUSetup(mesh_t *mesh, occa::properties &kernelInfo, int Nfields);
+void meshPlotVTUInterpolate(mesh_t *mesh, int field, int Nfields, dlong fieldOffset, occa::memory &o_q);
+void meshPlotVTUWrite(mesh_t *mesh, const char *fileBase, int frame,
+                      int Narrays, const char **arrayNames, const int *arrayComponents);
+void meshPlotVTUFinish(mesh_t *mesh);
+
+// checkpoint field: Nvalues dfloats per local element held in device array o_q from
+// offset (in dfloats). elementMap gives the record of each local element in o_q
+// (-1 if it has none), or is NULL when records are in element order.
+typedef struct {
+  occa::memory o_q;
+  dlong offset;
+  int   Nvalues;
+  dlong *elementMap;
+} meshCheckpointField_t;
+
+// single shared checkpoint file keyed by element vertex ids, so it can be read back
+// on any number of ranks. Writes are staged in alternating host buffers and drained
+// by a background thread; meshCheckpointFinish completes the last one. All collective.
+void meshCheckpointWrite(mesh_t *mesh, const char *fileName, int Nscalars, dfloat *scalars,
+                         int Nfields, meshCheckpointField_t *fields);
+int  meshCheckpointRead(mesh_t *mesh, const char *fileName, int Nscalars, dfloat *scalars,
+                        int Nfields, meshCheckpointField_t *fields);
+void meshCheckpointFinish(mesh_t *mesh);
+
+// device isosurfaces: marching tets on the plot sub-elements with count/scan/emit passes,
+// vertices welded by hashing on the device, written as binary .vtu pieces plus a .pvtu
+void meshIsoSurfaceSetup(mesh_t *mesh, occa::properties &kernelInfo, int isoNfields);
+dlong meshIsoSurfaceExtract(mesh_t *mesh, dlong Nelements, occa::memory *o_elementIds,
+                            int isoField, int isoNlevels, occa::memory &o_isoLevels, occa::memory &o_q);
+void meshIsoSurfaceWrite(mesh_t *mesh, const char *fileBase, int frame, const char **fieldNames);
+void meshIsoSurfaceFinish(mesh_t *mesh);
+
 #endif
 
@@ -50,6 +50,13 @@ void meshParallelConnect3D(mesh3D *mesh);
 // repartition elements in parallel
 void meshGeometricPartition3D(mesh3D *mesh);
 
+// switch meshGeometricPartition3D to Hilbert ordering split by cumulative weight
+// (call before meshSetup*3D); elements with elementInfo types[n] cost weights[n], others 1
+void meshGeometricPartitionCostModel3D(int Ntypes, int *types, dfloat *weights);
+
+// cost model weight of an element type (1 when no cost model is set)
+dfloat meshGeometricPartitionWeight3D(int type);
+
 // print out mesh 
 void meshPrint3D(mesh3D *mesh);
 
@@ -0,0 +1,58 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#ifndef MESH_BINARY_FORMAT_H
+#define MESH_BINARY_FORMAT_H 1
+
+/*
+  libParanumal native binary mesh format (.bmsh)
+
+  All integers are little-endian 64-bit, all coordinates are IEEE doubles.
+
+  [magic]         8 chars  "LPMESH01"
+  [header]        meshBinaryNheader int64:
+                     dim, Nverts, NfaceVertices, Nnodes, Nelements, NboundaryFaces, 0, 0
+  [elementInfo]   Nelements                         int64 (gmsh physical tag)
+  [EToV]          Nelements*Nverts                  int64 (zero based, orientation corrected)
+  [EX],[EY],[EZ]  dim blocks of Nelements*Nverts    double (element vertex coordinates)
+  [boundaryInfo]  NboundaryFaces*(NfaceVertices+1)  int64 (tag, zero based vertices)
+
+  Element data is stored element-contiguous so that each rank can read
+  its own slice of elements without touching the rest of the file.
+*/
+
+#define meshBinaryMagic "LPMESH01"
+#define meshBinaryMagicLength 8
+#define meshBinaryNheader 8
+
+#define meshBinaryDimId            0
+#define meshBinaryNvertsId         1
+#define meshBinaryNfaceVerticesId  2
+#define meshBinaryNnodesId         3
+#define meshBinaryNelementsId      4
+#define meshBinaryNboundaryFacesId 5
+
+#endif
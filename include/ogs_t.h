@@ -57,9 +57,36 @@ typedef struct {
   
   occa::memory o_ownedHaloGatherIds;
 
-  void         *haloGsh;       // gslib gather 
   dlong         Nhalo;            //  number of halo nodes
   dlong         NownedHalo;       //  number of owned halo nodes
+
+  // halo exchange: partial sums of each halo gather node are sent to its
+  // base rank, which adds them up and returns the totals
+  int           NsendRanks;       //  ranks that own halo nodes held here
+  int          *sendRanks;
+  dlong        *sendOffsets;      //  start of each rank's values in the send list
+  dlong         Nsend;
+  dlong        *sendIds;          //  halo gather node of each sent value
+
+  int           NrecvRanks;       //  ranks holding halo nodes owned here
+  int          *recvRanks;
+  dlong        *recvOffsets;      //  start of each rank's values in the recv list
+  dlong         Nrecv;
+  dlong        *recvIds;          //  halo gather node of each received value
+  dlong        *recvGatherStarts; //  received values of each halo gather node
+  dlong        *recvGatherIds;
+
+  occa::memory o_sendIds;
+  occa::memory o_recvIds;
+  occa::memory o_recvGatherStarts;
+  occa::memory o_recvGatherIds;
+
+  int           NentriesMax;      //  exchange buffers are sized for this many fields
+  dfloat       *exchangeSendBuffer;
+  dfloat       *exchangeRecvBuffer;
+  occa::memory o_exchangeSendBuffer;
+  occa::memory o_exchangeRecvBuffer;
+  void         *exchangeRequests;
   
   //degree vectors
   dfloat *invDegree, *gatherInvDegree;
@@ -275,6 +275,10 @@ typedef struct {
   bool nullSpace;
   dfloat nullSpacePenalty;
 
+  // key and lambda of this hierarchy in the eigenvalue cache
+  char eigenvalueCacheKey[BUFSIZ];
+  dfloat lambda;
+
   occa::device device;
   occa::stream defaultStream;
   occa::stream dataStream;  
@@ -322,6 +326,12 @@ void parAlmondAgmgSetup(parAlmond_t* parAlmond,
 
 void parAlmondPrecon(parAlmond_t* parAlmond, occa::memory o_x, occa::memory o_rhs);
 
+// on-disk cache of smoother spectral radius estimates ([EIGENVALUE CACHE] option)
+int  parAlmondEigenvalueCacheOn(setupAide &options);
+void parAlmondEigenvalueCacheMeshKey(mesh_t *mesh, setupAide &options, char *key);
+int  parAlmondEigenvalueCacheLookup(setupAide options, MPI_Comm comm, const char *key, dfloat lambda, dfloat *rho);
+void parAlmondEigenvalueCacheStore(setupAide options, MPI_Comm comm, const char *key, dfloat lambda, dfloat rho);
+
 int parAlmondFree(void* A);
 
 #endif
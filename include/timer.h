@@ -28,6 +28,7 @@ SOFTWARE.
 #define OCCA_TIMER_HEADER
 
 #include "occa.hpp"
+#include "mpi.h"
 
 #include <iostream>
 #include <fstream>
@@ -56,6 +57,21 @@ namespace occa {
     timerTraits();
   };
 
+  // device interval between two stream tags, resolved lazily
+  class timerEvent{
+  public:
+    std::stack<std::string> keys;
+    occa::streamTag startTag;
+    occa::streamTag endTag;
+  };
+
+  // registered cost of one element pass of a timed kernel
+  class timerCost{
+  public:
+    double flopsPerElement;
+    double bytesPerElement;
+  };
+
   class timer{
 
     bool profileKernels;
@@ -64,6 +80,14 @@ namespace occa {
 
     occa::device occaHandle;
 
+    // events are only resolved once this many are pending or at output
+    static const size_t maxPendingEvents = 4096;
+
+    std::stack<occa::streamTag> tagStack;
+    std::vector<timerEvent> pendingEvents;
+
+    std::map<std::string, timerCost> kernelCosts;
+
   public:
 
     timer();
@@ -74,6 +98,9 @@ namespace occa {
     inline void setKernelProfiling(bool b) { profileKernels = b; }
     inline void setApplicationProfiling(bool b) { profileApplication = b; }
 
+    // host timers only include device work after a sync unless kernels are timed with tags
+    inline bool hostTimed() const { return profileApplication && !profileKernels; }
+
     std::stack<std::string> keyStack;
     std::stack<double> timeStack;
 
@@ -93,6 +120,17 @@ namespace occa {
 
     double toc(std::string key, occa::kernel &kernel, double flops, double bw);
 
+    // stop a timer on a device stream tag instead of a device sync,
+    // the device time is resolved by flushEvents
+    double tocEvent(std::string key, double flops, double bw);
+
+    // same, charging Nelements passes of the cost registered for key
+    double tocEvent(std::string key, long long int Nelements);
+
+    void registerKernel(std::string key, double flopsPerElement, double bytesPerElement);
+
+    void flushEvents();
+
     double print_recursively(std::vector<std::string> &childs,
                              double parentTime,
                              double overallTime);
@@ -106,6 +144,10 @@ namespace occa {
 
 
     void printTimer();
+
+    // min/mean/max over the ranks of comm, written by rank 0 to
+    // fileBase.json and fileBase.csv
+    void writeTimer(MPI_Comm comm, std::string fileBase);
   };
 
 
@@ -130,10 +172,14 @@ namespace occa {
   double toc(std::string key, occa::kernel &kernel, double fp, double bw);
 
   void printTimer();
+
+  void writeTimer(MPI_Comm comm, std::string fileBase);
 }
 
 void occaTimerTic(occa::device device,std::string name);
 void occaTimerToc(occa::device device,std::string name);
+void occaTimerToc(occa::device device,std::string name, long long int Nelements);
+void occaTimerRegister(std::string name, double flopsPerElement, double bytesPerElement);
 
 
 #endif
@@ -38,28 +38,34 @@ SOFTWARE.
 #define dfloatString "double"
 #endif
 
-//host index data type
-#if 1
+#include <limits.h>
+
+//host index data type (build with HLONG64=1 for 64-bit global indices)
+#ifndef HLONG64
 #define hlong int
 #define MPI_HLONG MPI_INT
 #define hlongFormat "%d"
 #define hlongString "int"
+#define hlongMax INT_MAX
 #else
 #define hlong long long int
 #define MPI_HLONG MPI_LONG_LONG_INT
 #define hlongFormat "%lld"
 #define hlongString "long long int"
+#define hlongMax LLONG_MAX
 #endif
 
-//device index data type
-#if 1
+//device index data type (build with DLONG64=1 for 64-bit local indices)
+#ifndef DLONG64
 #define dlong int
 #define MPI_DLONG MPI_INT
 #define dlongFormat "%d"
 #define dlongString "int"
+#define dlongMax INT_MAX
 #else
 #define dlong long long int
 #define MPI_DLONG MPI_LONG_LONG_INT
 #define dlongFormat "%lld"
 #define dlongString "long long int"
+#define dlongMax LLONG_MAX
 #endif
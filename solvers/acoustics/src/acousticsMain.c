@@ -73,6 +73,9 @@ int main(int argc, char **argv){
   // run
   acousticsRun(acoustics, newOptions);
 
+  // release persistent halo requests
+  meshHaloExchangeFree(mesh);
+
   // close down MPI
   MPI_Finalize();
 
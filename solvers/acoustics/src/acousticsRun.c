@@ -35,6 +35,7 @@ void acousticsRun(acoustics_t *acoustics, setupAide &newOptions){
   occa::timer timer;
   
   timer.initTimer(mesh->device);
+  timer.setApplicationProfiling(true);
 
   timer.tic("Run");
   
@@ -159,5 +160,6 @@ void acousticsRun(acoustics_t *acoustics, setupAide &newOptions){
       }
     }
   }
-  
+
+  meshWriteProfile(mesh, newOptions);
 }
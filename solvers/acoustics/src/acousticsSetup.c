@@ -337,5 +337,17 @@ acoustics_t *acousticsSetup(mesh_t *mesh, setupAide &newOptions, char* boundaryH
 				       "meshHaloExtract3D",
 				       kernelInfo);
 
+  // per-element cost of the timed volume kernel for the profiler
+  {
+    const int dim = acoustics->dim;
+    const double Np = mesh->Np, Nfields = acoustics->Nfields;
+    double Dflops, Gbytes;
+    meshKernelCostFactors(mesh, acoustics->elementType, &Dflops, &Gbytes);
+
+    occaTimerRegister("Volume",
+                      Np*Nfields*(dim*Dflops + 2.*dim*dim),
+                      2.*Np*Nfields*sizeof(dfloat) + Gbytes);
+  }
+
   return acoustics;
 }
@@ -61,11 +61,13 @@ void acousticsDopriStep(acoustics_t *acoustics, setupAide &newOptions, const dfl
       meshHaloExchangeStart(mesh, mesh->Np*acoustics->Nfields*sizeof(dfloat), acoustics->sendBuffer, acoustics->recvBuffer);
     }
 
+    occaTimerTic(mesh->device, "Volume");
     acoustics->volumeKernel(mesh->Nelements, 
 		      mesh->o_vgeo, 
 		      mesh->o_Dmatrices,
 		      acoustics->o_rkq, 
 		      acoustics->o_rhsq);
+    occaTimerToc(mesh->device, "Volume", mesh->Nelements);
 
     // wait for q halo data to arrive
     if(mesh->totalHaloPairs>0){
@@ -130,11 +132,13 @@ void acousticsLserkStep(acoustics_t *acoustics, setupAide &newOptions, const dfl
       meshHaloExchangeStart(mesh, mesh->Np*acoustics->Nfields*sizeof(dfloat), acoustics->sendBuffer, acoustics->recvBuffer);
     }
 
+    occaTimerTic(mesh->device, "Volume");
     acoustics->volumeKernel(mesh->Nelements, 
 		      mesh->o_vgeo, 
 		      mesh->o_Dmatrices,
 		      acoustics->o_q, 
 		      acoustics->o_rhsq);
+    occaTimerToc(mesh->device, "Volume", mesh->Nelements);
     
     
     // wait for q halo data to arrive
@@ -108,12 +108,10 @@ typedef struct{
   dfloat *pmlresqx, *pmlresqy, *pmlresqz;
 
   // Some Iso-surfacing variables
-  int isoField, isoColorField, isoNfields, isoNlevels, isoMaxNtris, *isoNtris; 
-  dfloat isoMinVal, isoMaxVal, *isoLevels, *isoq; 
-  size_t isoMax; 
+  int isoField, isoColorField, isoNfields, isoNlevels; 
+  dfloat isoMinVal, isoMaxVal; 
 
-  occa::memory o_isoLevels, o_isoq, o_isoNtris; 
-  occa::memory o_plotInterp, o_plotEToV; 
+  occa::memory o_isoq; // fields of the non-pml elements staged for meshIsoSurfaceExtract
 
 
   // IMEX Coefficients
@@ -143,10 +141,6 @@ typedef struct{
 
 
 
-  // NBN: add storage for compacted isosurf data for gmsh write
-  std::vector<double> iso_nodes;
-  std::vector<int> iso_tris;
-
   int emethod; 
   int tstep, atstep, rtstep, tstepAccepted, rkp;
   dfloat ATOL, RTOL, time; 
@@ -209,7 +203,7 @@ typedef struct{
 
   occa::kernel vorticityKernel;
 
-  occa::kernel isoSurfaceKernel;
+  occa::kernel isoStageKernel;
 
   // Boltzmann Imex Kernels
   occa::kernel implicitUpdateKernel;
@@ -248,8 +242,6 @@ void bnsReport(bns_t *bns, dfloat time, setupAide &options);
 void bnsError(bns_t *bns, dfloat time, setupAide &options);
 void bnsForces(bns_t *bns, dfloat time, setupAide &options);
 void bnsPlotVTU(bns_t *bns, char * FileName);
-void bnsIsoPlotVTU(bns_t *bns, int isoNtris, dfloat *isoq, char *fileName);
-void bnsIsoWeldPlotVTU(bns_t *bns, char *fileName);
 
 //
 void bnsRestartWrite(bns_t *bns, setupAide &options, dfloat time); 
@@ -281,13 +273,6 @@ void bnsSARKStep(bns_t *bns, dfloat time, int haloBytes,
 void bnsRunEmbedded(bns_t *bns, int haloBytes, dfloat * sendBuffer,
 		    dfloat *recvBuffer, setupAide &options);
 
-// Welding Tris
-
-int bnsWeldTriVerts(bns_t *bns, int isoNtris, double *isoq);
-
-void bnsIsoPlotGmsh(bns_t *bns, int isoNtris, char *fname, int tstep, int N_offset,     
-  					int E_offset, int plotnum, double plottime,    bool bBinary, int procid);
-
 
 
 #define TRIANGLES 3
@@ -139,7 +139,7 @@ void bnsLSERKStep(bns_t *bns, int tstep, int haloBytes,
       mesh->o_Dmatrices,
       bns->o_q,
       bns->o_rhsq);
-      occaTimerToc(mesh->device,"NonPmlVolumeKernel");
+      occaTimerToc(mesh->device,"NonPmlVolumeKernel", mesh->nonPmlNelements);
     }
     occaTimerToc(mesh->device, "VolumeKernel");    
     
@@ -280,7 +280,7 @@ void bnsLSERKStep(bns_t *bns, int tstep, int haloBytes,
                         mesh->o_z,
                         bns->o_q,
                         bns->o_rhsq);
-      occaTimerToc(mesh->device,"NonPmlSurfaceKernel");
+      occaTimerToc(mesh->device,"NonPmlSurfaceKernel", mesh->nonPmlNelements);
     }
     occaTimerToc(mesh->device,"SurfaceKernel");
 
@@ -328,7 +328,7 @@ void bnsLSERKStep(bns_t *bns, int tstep, int haloBytes,
                         bns->o_rhsq,
                         bns->o_resq,
                         bns->o_q);
-      occaTimerToc(mesh->device,"NonPmlUpdateKernel");
+      occaTimerToc(mesh->device,"NonPmlUpdateKernel", mesh->nonPmlNelements);
     }
 
     occaTimerToc(mesh->device,"UpdateKernel");
@@ -48,7 +48,20 @@ int main(int argc, char **argv){
   options.getArgs("POLYNOMIAL DEGREE", N);
   options.getArgs("ELEMENT TYPE", elementType);
   options.getArgs("MESH DIMENSION", dim);
+
+  // optional boundary refinement of the geometric partition
+  meshSetPartitionRefinement(options);
   
+  // weighted Hilbert partition, PML elements (elementInfo 100-700) integrate the
+  // extra split fields and cost about twice an interior element
+  if(options.compareArgs("PARTITIONER", "WEIGHTED HILBERT")){
+    int pmlTypes[7] = {100, 200, 300, 400, 500, 600, 700};
+    dfloat pmlWeights[7];
+    for(int n=0;n<7;++n)
+      pmlWeights[n] = options.compareArgs("ABSORBING LAYER", "PML") ? 2.0 : 1.0;
+    meshGeometricPartitionCostModel3D(7, pmlTypes, pmlWeights);
+  }
+
   // set up mesh
    mesh_t *mesh;
    switch(elementType){
@@ -73,7 +86,16 @@ int main(int argc, char **argv){
 
 
    bnsRun(bns,options);
+
+   // wait for the last restart file to be written
+   if(bns->writeRestartFile) meshCheckpointFinish(mesh);
+
+   // and for the last isosurface
+   if(options.compareArgs("OUTPUT FILE FORMAT","ISO")) meshIsoSurfaceFinish(mesh);
    
+  // release persistent halo requests
+  meshHaloExchangeFree(mesh);
+
   // close down MPI
   MPI_Finalize();
   exit(0);
@@ -25,129 +25,66 @@ SOFTWARE.
 */
 
 #include "bns.h"
+
+// q and the pml variables of LSERK/SARK, pml records are mapped through pmlIds
+static int bnsRestartFields(bns_t *bns, setupAide &options, meshCheckpointField_t *fields){
+
+  mesh_t *mesh = bns->mesh;
+
+  int Nfields = 0;
+
+  if(options.compareArgs("TIME INTEGRATOR", "LSERK") || 
+     options.compareArgs("TIME INTEGRATOR", "SARK")){
+
+    fields[Nfields].o_q        = bns->o_q;
+    fields[Nfields].offset     = 0;
+    fields[Nfields].Nvalues    = bns->Nfields*mesh->Np;
+    fields[Nfields].elementMap = NULL;
+    Nfields++;
+
+    if(bns->pmlFlag){
+      dlong *pmlMap = (dlong*) calloc(mesh->Nelements+1, sizeof(dlong));
+      for(dlong e=0;e<mesh->Nelements;e++) pmlMap[e] = -1;
+      for(dlong es=0;es<mesh->pmlNelements;es++)
+        pmlMap[mesh->pmlElementIds[es]] = mesh->pmlIds[es];
+
+      for(int d=0;d<bns->dim;d++){
+        fields[Nfields].o_q        = (d==0) ? bns->o_pmlqx : (d==1) ? bns->o_pmlqy : bns->o_pmlqz;
+        fields[Nfields].offset     = 0;
+        fields[Nfields].Nvalues    = bns->Nfields*mesh->Np;
+        fields[Nfields].elementMap = pmlMap; // shared, freed with the first pml field
+        Nfields++;
+      }
+    }
+  }
+
+  return Nfields;
+}
+
+static void bnsRestartFree(int Nfields, meshCheckpointField_t *fields){
+  if(Nfields>1) free(fields[1].elementMap);
+}
+
 void bnsRestartWrite(bns_t *bns, setupAide &options, dfloat time){
 
   mesh_t *mesh = bns->mesh; 
-  // Copy Field To Host
-  bns->o_q.copyTo(bns->q);
 
   // Create Binary File Name
   char fname[BUFSIZ];
   string outName;
   options.getArgs("RESTART FILE NAME", outName);
-  sprintf(fname, "%s_%04d.dat",(char*)outName.c_str(), mesh->rank);
-  FILE *fp;
-  
-  // Overwrite  Binary File
-  fp = fopen(fname,"wb");
-
-  // Write q1....qN and all pml variables
-  dfloat *elmField  = (dfloat *) calloc(bns->Nfields, sizeof(dfloat)); 
-  dfloat *pmlField  = (dfloat *) calloc(bns->Nfields*bns->dim, sizeof(dfloat));
-
-  // First Write the Solution Time
-  fwrite(&time, sizeof(dfloat), 1, fp);
-  // Write output frame to prevent overwriting vtu files
-  fwrite(&bns->frame, sizeof(int), 1, fp);
-
-  // 
- if(options.compareArgs("TIME INTEGRATOR", "LSERK") || 
-    options.compareArgs("TIME INTEGRATOR", "SARK")){
-  // Write only q works check for MRAB, write history
-  for(dlong e = 0; e<mesh->Nelements; e++){
-    for(int n=0; n<mesh->Np; n++ ){
-      const dlong id = e*bns->Nfields*mesh->Np + n; 
-      for(int fld=0; fld<bns->Nfields; fld++){
-        elmField[fld] =  bns->q[id + fld*mesh->Np];
-      }
-      fwrite(elmField, sizeof(dfloat), bns->Nfields, fp);
-    }
-  }
+  sprintf(fname, "%s.dat",(char*)outName.c_str());
 
-  if(mesh->pmlNelements){
-    // Copy Field To Host
-    bns->o_pmlqx.copyTo(bns->pmlqx);
-    bns->o_pmlqy.copyTo(bns->pmlqy);
-    if(bns->dim==3)
-      bns->o_pmlqz.copyTo(bns->pmlqz);
-
-    // Write node data
-    for(dlong es = 0; es<mesh->pmlNelements; es++)
-    {
-      dlong e      = mesh->pmlElementIds[es]; 
-      dlong pmlId  = mesh->pmlIds[es]; 
-      for(int n=0; n<mesh->Np; n++ ){
-        const dlong id = pmlId*bns->Nfields*mesh->Np + n;
-        for(int fld=0; fld<bns->Nfields; fld++){
-          pmlField[fld + 0*bns->Nfields] =  bns->pmlqx[id + fld*mesh->Np];
-          pmlField[fld + 1*bns->Nfields] =  bns->pmlqy[id + fld*mesh->Np];
-          if(bns->dim==3)
-            pmlField[fld + 2*bns->Nfields] =  bns->pmlqz[id + fld*mesh->Np];
-        }
-      fwrite(pmlField, sizeof(dfloat), bns->Nfields*bns->dim, fp);
-      }
-    }
-  }
-}
+  // solution time and output frame (to prevent overwriting vtu files)
+  dfloat scalars[2] = {time, (dfloat) bns->frame};
 
-#if 0
-  // Assumes the same dt, there is no interpolation of history
-  // will be mofied later if the time step size changes 
-   if(options.compareArgs("TIME INTEGRATOR", "MRSAAB")){
-   // Keep the same index to prvent order loss at restart
-    for(int l = 0; l<mesh->MRABNlevels; l++)
-      fwrite(&mesh->MRABshiftIndex[l], sizeof(int),1, fp);
-
-      // Copy right hand side history
-      bns->o_rhsq.copyTo(bns->rhsq);
-
-      const dlong offset   = mesh->Nelements*mesh->Np*bns->Nfields; 
-
-      // Write all history, order is not important 
-      // as long as reading with the same order
-      for(int nrhs = 0; nrhs<bns->Nrhs; nrhs++){
-        for(dlong e = 0; e<mesh->Nelements; e++){
-          for(int n=0; n<mesh->Np; n++ ){
-            const dlong id = e*bns->Nfields*mesh->Np + n + nrhs*offset; 
-            for(int fld=0; fld<bns->Nfields; fld++){
-              elmField[fld] =  bns->q[id + fld*mesh->Np];
-            }
-          fwrite(elmField, sizeof(dfloat), bns->Nfields, fp);
-          }
-        }
-      }
+  meshCheckpointField_t fields[4];
+  int Nfields = bnsRestartFields(bns, options, fields);
 
-    if(bns->pmlFlag){
-      // Copy Field To Host
-      bns->o_pmlrhsqx.copyTo(bns->pmlrhsqx);
-      bns->o_pmlrhsqy.copyTo(bns->pmlrhsqy);
-      if(bns->dim==3)
-        bns->o_pmlrhsqz.copyTo(bns->pmlrhsqz);
-
-      const dlong pmloffset = mesh->pmlNelements*mesh->Np*bns->Nfields; 
-
-      // Write node data
-      for(int nrhs = 0; nrhs<bns->Nrhs; nrhs++){
-        for(dlong es = 0; es<mesh->pmlNelements; es++){
-          dlong e      = mesh->pmlElementIds[es]; 
-          dlong pmlId  = mesh->pmlIds[es]; 
-          for(int n=0; n<mesh->Np; n++ ){
-            const dlong id = pmlId*bns->Nfields*mesh->Np + n + nrhs*pmloffset;
-            for(int fld=0; fld<bns->Nfields; fld++){
-              pmlField[fld + 0*bns->Nfields] =  bns->pmlrhsqx[id + fld*mesh->Np];
-              pmlField[fld + 1*bns->Nfields] =  bns->pmlrhsqy[id + fld*mesh->Np];
-              if(bns->dim==3)
-                pmlField[fld + 2*bns->Nfields] =  bns->pmlrhsqz[id + fld*mesh->Np];
-              }
-            fwrite(pmlField, sizeof(dfloat), bns->Nfields*bns->dim, fp);
-          }
-        }
-      }
-    }
-   }
-#endif
+  // staged to host here, written to disk in the background
+  meshCheckpointWrite(mesh, fname, 2, scalars, Nfields, fields);
 
-  fclose(fp); 
+  bnsRestartFree(Nfields, fields);
 }
 
 
@@ -160,74 +97,27 @@ void bnsRestartRead(bns_t *bns, setupAide &options){
   char fname[BUFSIZ];
   string outName;
   options.getArgs("RESTART FILE NAME", outName);
-  sprintf(fname, "%s_%04d.dat",(char*)outName.c_str(), mesh->rank);
-  FILE *fp; 
-
-  // Overwrite  Binary File
-  fp = fopen(fname,"rb");
+  sprintf(fname, "%s.dat",(char*)outName.c_str());
 
-  if(fp != NULL){
-  
-    // Write q1....qN and all pml variables
-    dfloat *elmField  = (dfloat *) calloc(bns->Nfields, sizeof(dfloat)); 
-    dfloat *pmlField  = (dfloat *) calloc(bns->Nfields*bns->dim, sizeof(dfloat));
+  dfloat scalars[2] = {0.0, 0.0};
+  meshCheckpointField_t fields[4];
+  int Nfields = bnsRestartFields(bns, options, fields);
 
-    dfloat startTime = 0.0; 
-    // Update Start Time
-    fread(&startTime, sizeof(dfloat),1, fp);
-    // Update frame number to contioune outputs
-    fread(&bns->frame, sizeof(int), 1, fp);
+  // elements are matched by their vertices, so the rank count may differ from the writing run
+  int found = meshCheckpointRead(mesh, fname, 2, scalars, Nfields, fields);
 
+  bnsRestartFree(Nfields, fields);
 
-    if(mesh->rank==0) printf("Restart time: %.4e ...", startTime);
-
-    // Write only q works check for MRAB, write history
-    for(dlong e = 0; e<mesh->Nelements; e++){
-      for(int n=0; n<mesh->Np; n++ ){
-        
-        const dlong id = e*bns->Nfields*mesh->Np + n;
-        fread(elmField, sizeof(dfloat), bns->Nfields, fp);
-        
-        for(int fld=0; fld<bns->Nfields; fld++){
-          bns->q[id + fld*mesh->Np] = elmField[fld];
-        }
+  if(found){
 
-      }
-    }
-
-    if(bns->pmlFlag){
-      
-      // Write node data
-      for(dlong es = 0; es<mesh->pmlNelements; es++)
-      {
-        dlong e      = mesh->pmlElementIds[es]; 
-        dlong pmlId  = mesh->pmlIds[es]; 
-        for(int n=0; n<mesh->Np; n++ ){
-          const dlong id = pmlId*bns->Nfields*mesh->Np + n;
-
-          fread(pmlField, sizeof(dfloat), bns->Nfields*bns->dim, fp);
-          
-          for(int fld=0; fld<bns->Nfields; fld++){          
-            bns->pmlqx[id + fld*mesh->Np] = pmlField[fld + 0*bns->Nfields];
-            bns->pmlqy[id + fld*mesh->Np] = pmlField[fld + 1*bns->Nfields];
-            if(bns->dim==3)
-              bns->pmlqz[id + fld*mesh->Np] = pmlField[fld + 2*bns->Nfields];
-          }
-        }
-      } 
-    }
-
-  fclose(fp);
+    dfloat startTime = scalars[0]; 
+    // Update frame number to contioune outputs
+    bns->frame = (int) scalars[1];
 
-  // Update Fields
-    bns->o_q.copyFrom(bns->q);
+    if(mesh->rank==0) printf("Restart time: %.4e ...", startTime);
 
-    if(mesh->pmlNelements){
-      bns->o_pmlqx.copyFrom(bns->pmlqx);
-      bns->o_pmlqy.copyFrom(bns->pmlqy);
-      if(bns->dim==3)
-        bns->o_pmlqz.copyFrom(bns->pmlqz);    
-    }
+    // keep host copies in sync
+    bns->o_q.copyTo(bns->q);
 
   // Just Update Time Step Size
   bns->startTime = startTime; 
@@ -235,7 +125,7 @@ void bnsRestartRead(bns_t *bns, setupAide &options){
    bns->NtimeSteps = (bns->finalTime-bns->startTime)/bns->dt;
    bns->dt         = (bns->finalTime-bns->startTime)/bns->NtimeSteps; 
 }else{
-  printf("No restart file...");
+  if(mesh->rank==0) printf("No restart file...");
 
 }
 }
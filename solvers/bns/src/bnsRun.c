@@ -216,6 +216,8 @@ void bnsRun(bns_t *bns, setupAide &options){
   //bnsReport(bns, bns->NtimeSteps,options);
 
   occa::printTimer();
+
+  meshWriteProfile(mesh, options);
 }
 
 
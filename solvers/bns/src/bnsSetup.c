@@ -457,7 +457,6 @@ bns_t *bnsSetup(mesh_t *mesh, setupAide &options){
     
     // Only one field is exported for iso-surface to reduce the file size
     bns->isoNfields  = 1;   //1 + (bns->dim) + (1 + bns->dim) ; // p, u.v,w, vort_x, vort_y, vort_z, wort_mag 
-    bns->isoMaxNtris = 1.E7; 
 
     bns->procid = gethostid();
 
@@ -469,13 +468,8 @@ bns_t *bnsSetup(mesh_t *mesh, setupAide &options){
     options.getArgs("ISOSURFACE CONTOUR MIN", bns->isoMinVal);
 
 
-    bns->isoMax    = (bns->dim + bns->isoNfields)*3*bns->isoMaxNtris;
-    bns->isoNtris  = (int*) calloc(1, sizeof(int));
-    bns->isoq      = (dfloat*) calloc(bns->isoMax, sizeof(dfloat)); 
-
-  
-    bns->o_isoq      = mesh->device.malloc(bns->isoMax*sizeof(dfloat), bns->isoq);
-    bns->o_isoNtris  = mesh->device.malloc(1*sizeof(int), bns->isoNtris);
+    // isosurfaced fields staged per element, triangles are sized on the device
+    bns->o_isoq = mesh->device.malloc((mesh->Nelements*mesh->Np*bns->isoNfields+1)*sizeof(dfloat));
 
 
    
@@ -533,23 +527,6 @@ bns_t *bnsSetup(mesh_t *mesh, setupAide &options){
     
     }
 
-    // Interpolation operators form Np to PlotNp (equisapaced nodes of order >N generally)
-    dfloat *plotInterp = (dfloat*) calloc(mesh->plotNp*mesh->Np, sizeof(dfloat));
-    for(int n=0;n<mesh->plotNp;++n){
-      for(int m=0;m<mesh->Np;++m){
-        plotInterp[n+m*mesh->plotNp] = mesh->plotInterp[n*mesh->Np+m];
-      }
-    }
-    bns->o_plotInterp = mesh->device.malloc(mesh->plotNp*mesh->Np*sizeof(dfloat), plotInterp);
-
-    // EToV for local triangulation
-    int *plotEToV = (int*) calloc(mesh->plotNp*mesh->Np, sizeof(int));
-    for(int n=0;n<mesh->plotNelements;++n){
-      for(int m=0;m<mesh->plotNverts;++m){
-        plotEToV[n+m*mesh->plotNelements] = mesh->plotEToV[n*mesh->plotNverts+m];
-      }
-    }
-    bns->o_plotEToV = mesh->device.malloc(mesh->plotNp*mesh->Np*sizeof(int), plotEToV);
   }
 
 
@@ -708,17 +685,6 @@ if(options.compareArgs("TIME INTEGRATOR","SARK")){
 
   if(bns->dim==3){
     kernelInfo["defines/" "p_isoNfields"]= bns->isoNfields;
-    
-    // Define Isosurface Area Tolerance
-    kernelInfo["defines/" "p_triAreaTol"]= (dfloat) 1.0E-16;
-
-    kernelInfo["defines/" "p_dim"]= bns->dim;
-    kernelInfo["defines/" "p_plotNp"]= mesh->plotNp;
-    kernelInfo["defines/" "p_plotNelements"]= mesh->plotNelements;
-    
-    int plotNthreads = mymax(mesh->Np, mymax(mesh->plotNp, mesh->plotNelements));
-    kernelInfo["defines/" "p_plotNthreads"]= plotNthreads;
-    
  } 
 
   // set kernel name suffix
@@ -744,39 +710,39 @@ if(options.compareArgs("TIME INTEGRATOR","SARK")){
   kernelInfo["includes"] += (char*)boundaryHeaderFileName.c_str();
 
   char fileName[BUFSIZ], kernelName[BUFSIZ];
-  for (int r=0;r<mesh->size;r++){
+  for (int r=0;r<meshBuildKernelStages;r++){
 
-    if (r==mesh->rank) {
+    if (r==meshBuildKernelStage(mesh)) {
 
       // Volume kernels
       sprintf(fileName, DBNS "/okl/bnsVolume%s.okl", suffix);
 
       sprintf(kernelName, "bnsVolume%s", suffix);
-      bns->volumeKernel = mesh->device.buildKernel(fileName,kernelName,kernelInfo);
+      bns->volumeKernel = meshBuildKernel(mesh, fileName,kernelName,kernelInfo);
 
 
       // No that nonlinear terms are always integrated using cubature rules
       // this cubature shift is for sigma terms on pml formulation
       if(bns->pmlcubature){
         sprintf(kernelName, "bnsPmlVolumeCub%s", suffix);
-        bns->pmlVolumeKernel = mesh->device.buildKernel(fileName,kernelName,kernelInfo);
+        bns->pmlVolumeKernel = meshBuildKernel(mesh, fileName,kernelName,kernelInfo);
       }else{
         sprintf(kernelName, "bnsPmlVolume%s", suffix);
-        bns->pmlVolumeKernel = mesh->device.buildKernel(fileName,kernelName,kernelInfo);        
+        bns->pmlVolumeKernel = meshBuildKernel(mesh, fileName,kernelName,kernelInfo);        
       }
 
       // Relaxation kernels
       sprintf(fileName, DBNS "/okl/bnsRelaxation%s.okl", suffix);
 
       sprintf(kernelName, "bnsRelaxation%s", suffix);
-      bns->relaxationKernel = mesh->device.buildKernel(fileName,kernelName,kernelInfo);
+      bns->relaxationKernel = meshBuildKernel(mesh, fileName,kernelName,kernelInfo);
 
       if(bns->pmlcubature){
         sprintf(kernelName, "bnsPmlRelaxationCub%s", suffix);        
-        bns->pmlRelaxationKernel = mesh->device.buildKernel(fileName,kernelName,kernelInfo);        
+        bns->pmlRelaxationKernel = meshBuildKernel(mesh, fileName,kernelName,kernelInfo);        
       }else{
         sprintf(kernelName, "bnsPmlRelaxation%s", suffix);        
-        bns->pmlRelaxationKernel = mesh->device.buildKernel(fileName,kernelName,kernelInfo);        
+        bns->pmlRelaxationKernel = meshBuildKernel(mesh, fileName,kernelName,kernelInfo);        
       }
 
       
@@ -785,16 +751,16 @@ if(options.compareArgs("TIME INTEGRATOR","SARK")){
 
       if(options.compareArgs("TIME INTEGRATOR","MRSAAB")){
         sprintf(kernelName, "bnsMRSurface%s", suffix);
-        bns->surfaceKernel = mesh->device.buildKernel(fileName,kernelName, kernelInfo);
+        bns->surfaceKernel = meshBuildKernel(mesh, fileName,kernelName, kernelInfo);
 
         sprintf(kernelName, "bnsMRPmlSurface%s", suffix);
-        bns->pmlSurfaceKernel = mesh->device.buildKernel(fileName,kernelName, kernelInfo);
+        bns->pmlSurfaceKernel = meshBuildKernel(mesh, fileName,kernelName, kernelInfo);
       }else{
         sprintf(kernelName, "bnsSurface%s", suffix);
-        bns->surfaceKernel = mesh->device.buildKernel(fileName,kernelName, kernelInfo);
+        bns->surfaceKernel = meshBuildKernel(mesh, fileName,kernelName, kernelInfo);
 
         sprintf(kernelName, "bnsPmlSurface%s", suffix);
-        bns->pmlSurfaceKernel = mesh->device.buildKernel(fileName,kernelName, kernelInfo);
+        bns->pmlSurfaceKernel = meshBuildKernel(mesh, fileName,kernelName, kernelInfo);
       }
 
       
@@ -802,78 +768,109 @@ if(options.compareArgs("TIME INTEGRATOR","SARK")){
       // Update Kernels
       if(options.compareArgs("TIME INTEGRATOR","LSERK")){
         sprintf(kernelName, "bnsLSERKUpdate%s", suffixUpdate);
-        bns->updateKernel = mesh->device.buildKernel(fileName, kernelName,kernelInfo);
+        bns->updateKernel = meshBuildKernel(mesh, fileName, kernelName,kernelInfo);
 
         sprintf(kernelName, "bnsLSERKPmlUpdate%s", suffixUpdate);
-        bns->pmlUpdateKernel = mesh->device.buildKernel(fileName, kernelName,kernelInfo);
+        bns->pmlUpdateKernel = meshBuildKernel(mesh, fileName, kernelName,kernelInfo);
       } else if(options.compareArgs("TIME INTEGRATOR","SARK")){
         sprintf(kernelName, "bnsSARKUpdateStage%s", suffixUpdate);
-        bns->updateStageKernel = mesh->device.buildKernel(fileName,kernelName, kernelInfo);
+        bns->updateStageKernel = meshBuildKernel(mesh, fileName,kernelName, kernelInfo);
 
         sprintf(kernelName, "bnsSARKPmlUpdateStage%s", suffixUpdate);
-        bns->pmlUpdateStageKernel = mesh->device.buildKernel(fileName,kernelName, kernelInfo);
+        bns->pmlUpdateStageKernel = meshBuildKernel(mesh, fileName,kernelName, kernelInfo);
 
         sprintf(kernelName, "bnsSARKUpdate%s", suffixUpdate);
-        bns->updateKernel = mesh->device.buildKernel(fileName, kernelName,kernelInfo);
+        bns->updateKernel = meshBuildKernel(mesh, fileName, kernelName,kernelInfo);
 
         sprintf(kernelName, "bnsSARKPmlUpdate%s", suffixUpdate);
-        bns->pmlUpdateKernel = mesh->device.buildKernel(fileName, kernelName,kernelInfo);
+        bns->pmlUpdateKernel = meshBuildKernel(mesh, fileName, kernelName,kernelInfo);
 
           sprintf(fileName, DBNS "/okl/bnsErrorEstimate.okl");
           sprintf(kernelName, "bnsErrorEstimate");
-          bns->errorEstimateKernel = mesh->device.buildKernel(fileName,kernelName,kernelInfo);
+          bns->errorEstimateKernel = meshBuildKernel(mesh, fileName,kernelName,kernelInfo);
       } else if(options.compareArgs("TIME INTEGRATOR","MRSAAB")){
       
         sprintf(kernelName, "bnsMRSAABTraceUpdate%s", suffixUpdate);
-        bns->traceUpdateKernel = mesh->device.buildKernel(fileName,kernelName,kernelInfo);
+        bns->traceUpdateKernel = meshBuildKernel(mesh, fileName,kernelName,kernelInfo);
 
         sprintf(kernelName, "bnsMRSAABUpdate%s", suffixUpdate);
-        bns->updateKernel = mesh->device.buildKernel(fileName, kernelName,kernelInfo);
+        bns->updateKernel = meshBuildKernel(mesh, fileName, kernelName,kernelInfo);
 
         sprintf(kernelName, "bnsMRSAABPmlUpdate%s", suffixUpdate);
-        bns->pmlUpdateKernel = mesh->device.buildKernel(fileName, kernelName,kernelInfo);
+        bns->pmlUpdateKernel = meshBuildKernel(mesh, fileName, kernelName,kernelInfo);
       }
 
       sprintf(fileName, DBNS "/okl/bnsVorticity%s.okl",suffix);
       sprintf(kernelName, "bnsVorticity%s", suffix);
-      bns->vorticityKernel = mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+      bns->vorticityKernel = meshBuildKernel(mesh, fileName, kernelName, kernelInfo);
 
 
       // This needs to be unified
       mesh->haloExtractKernel =
-          mesh->device.buildKernel(DHOLMES "/okl/meshHaloExtract3D.okl","meshHaloExtract3D",kernelInfo);
+          meshBuildKernel(mesh, DHOLMES "/okl/meshHaloExtract3D.okl","meshHaloExtract3D",kernelInfo);
 
 
   if(bns->dim==3){
 
         mesh->gatherKernel = 
-          mesh->device.buildKernel(DHOLMES "/okl/gather.okl","gather", kernelInfo);
+          meshBuildKernel(mesh, DHOLMES "/okl/gather.okl","gather", kernelInfo);
 
         mesh->scatterKernel =
-          mesh->device.buildKernel(DHOLMES "/okl/scatter.okl","scatter",kernelInfo);
+          meshBuildKernel(mesh, DHOLMES "/okl/scatter.okl","scatter",kernelInfo);
 
         mesh->gatherScatterKernel =
-          mesh->device.buildKernel(DHOLMES "/okl/gatherScatter.okl", "gatherScatter", kernelInfo);
+          meshBuildKernel(mesh, DHOLMES "/okl/gatherScatter.okl", "gatherScatter", kernelInfo);
 
         mesh->getKernel = 
-          mesh->device.buildKernel(DHOLMES "/okl/get.okl", "get", kernelInfo);
+          meshBuildKernel(mesh, DHOLMES "/okl/get.okl", "get", kernelInfo);
 
         mesh->putKernel =
-          mesh->device.buildKernel(DHOLMES "/okl/put.okl", "put",kernelInfo);
+          meshBuildKernel(mesh, DHOLMES "/okl/put.okl", "put",kernelInfo);
+
+        mesh->ogsExchangePackKernel =
+          meshBuildKernel(mesh, DHOLMES "/okl/ogsExchange.okl", "ogsExchangePack", kernelInfo);
+
+        mesh->ogsExchangeAddKernel =
+          meshBuildKernel(mesh, DHOLMES "/okl/ogsExchange.okl", "ogsExchangeAdd", kernelInfo);
+
+        mesh->ogsExchangeUnpackKernel =
+          meshBuildKernel(mesh, DHOLMES "/okl/ogsExchange.okl", "ogsExchangeUnpack", kernelInfo);
 
-        bns->dotMultiplyKernel = mesh->device.buildKernel(DBNS "/okl/bnsDotMultiply.okl", "bnsDotMultiply", kernelInfo);
+        bns->dotMultiplyKernel = meshBuildKernel(mesh, DBNS "/okl/bnsDotMultiply.okl", "bnsDotMultiply", kernelInfo);
 
         // kernels from volume file
         sprintf(fileName, DBNS "/okl/bnsIsoSurface3D.okl");
-        sprintf(kernelName, "bnsIsoSurface3D");
+        sprintf(kernelName, "bnsIsoSurfaceStage3D");
 
-        bns->isoSurfaceKernel =
-          mesh->device.buildKernel(fileName, kernelName, kernelInfo);        
+        bns->isoStageKernel =
+          meshBuildKernel(mesh, fileName, kernelName, kernelInfo);        
       }
     }
     MPI_Barrier(mesh->comm);
   }
 
+  if(options.compareArgs("OUTPUT FILE FORMAT","ISO") && bns->dim==3)
+    meshIsoSurfaceSetup(mesh, kernelInfo, bns->isoNfields);
+
+  // per-element costs of the timed non-pml kernels for the profiler (lift matrices cached too)
+  {
+    const int dim = bns->dim;
+    const double Np = mesh->Np, NfpNfaces = mesh->Nfp*mesh->Nfaces, Nfields = bns->Nfields;
+    double Dflops, Gbytes;
+    meshKernelCostFactors(mesh, bns->elementType, &Dflops, &Gbytes);
+
+    occaTimerRegister("NonPmlVolumeKernel",
+                      Np*Nfields*(dim*Dflops + 2.*dim*dim),
+                      2.*Np*Nfields*sizeof(dfloat) + Gbytes + sizeof(dlong));
+    occaTimerRegister("NonPmlSurfaceKernel",
+                      Np*Nfields*2.*NfpNfaces,
+                      (NfpNfaces*(2.*Nfields + mesh->Nsgeo) + 2.*Np*Nfields)*sizeof(dfloat)
+                      + 2.*NfpNfaces*sizeof(dlong));
+    occaTimerRegister("NonPmlUpdateKernel",
+                      5.*Np*Nfields,
+                      5.*Np*Nfields*sizeof(dfloat) + sizeof(dlong));
+  }
+
 
 
   // Setup Gather Scales
@@ -888,6 +885,12 @@ if(options.compareArgs("TIME INTEGRATOR","SARK")){
                                                verbose);
   }
 
+  if(meshBuildKernelReport(mesh, options)){
+    if(mesh->rank==0) printf("ERROR: ranks built different sets of kernels\n");
+    MPI_Finalize();
+    exit(-1);
+  }
+
   return bns; 
 }
 
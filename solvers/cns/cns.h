@@ -65,6 +65,9 @@ typedef struct{
   dfloat wbar;
 
   int outputForceStep;
+
+  int readRestartFile, writeRestartFile;
+  dfloat startTime;
   
   
   mesh_t *mesh;
@@ -138,6 +141,10 @@ void cnsGaussianPulse(dfloat x, dfloat y, dfloat z, dfloat t,
 
 void cnsReport(cns_t *cns, dfloat time, setupAide &options);
 
+// Restarting from file
+void cnsRestartWrite(cns_t *cns, setupAide &options, dfloat time);
+void cnsRestartRead(cns_t *cns, setupAide &options);
+
 void cnsPlotVTU(cns_t *cns, char *fileName);
 
 void cnsDopriStep(cns_t *cns, setupAide &options, const dfloat time);
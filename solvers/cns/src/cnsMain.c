@@ -47,7 +47,14 @@ int main(int argc, char **argv){
   options.getArgs("POLYNOMIAL DEGREE", N);
   options.getArgs("ELEMENT TYPE", elementType);
   options.getArgs("MESH DIMENSION", dim);
+
+  // optional boundary refinement of the geometric partition
+  meshSetPartitionRefinement(options);
   
+  // weighted Hilbert partition, every element carries the same cubature cost
+  if(options.compareArgs("PARTITIONER", "WEIGHTED HILBERT"))
+    meshGeometricPartitionCostModel3D(0, NULL, NULL);
+
   // set up mesh
   mesh_t *mesh;
   switch(elementType){
@@ -64,9 +71,21 @@ int main(int argc, char **argv){
   // set up cns stuff
   cns_t *cns = cnsSetup(mesh, options);
 
+  if(cns->readRestartFile){
+    if(mesh->rank==0) printf("Reading restart file...");
+    cnsRestartRead(cns, options);
+    if(mesh->rank==0) printf("done\n");
+  }
+
   // run
   cnsRun(cns, options);
 
+  // wait for the last restart file to be written
+  if(cns->writeRestartFile) meshCheckpointFinish(mesh);
+
+  // release persistent halo requests
+  meshHaloExchangeFree(mesh);
+
   // close down MPI
   MPI_Finalize();
 
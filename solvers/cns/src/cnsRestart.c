@@ -0,0 +1,91 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "cns.h"
+
+void cnsRestartWrite(cns_t *cns, setupAide &options, dfloat time){
+
+  mesh_t *mesh = cns->mesh;
+
+  // Create Binary File Name
+  char fname[BUFSIZ];
+  string outName;
+  options.getArgs("RESTART FILE NAME", outName);
+  sprintf(fname, "%s.dat",(char*)outName.c_str());
+
+  // solution time, output frame and the adaptive step controller state
+  dfloat scalars[4] = {time, (dfloat) cns->frame, mesh->dt, cns->facold};
+
+  meshCheckpointField_t field;
+  field.o_q        = cns->o_q;
+  field.offset     = 0;
+  field.Nvalues    = mesh->Nfields*mesh->Np;
+  field.elementMap = NULL;
+
+  // staged to host here, written to disk in the background
+  meshCheckpointWrite(mesh, fname, 4, scalars, 1, &field);
+}
+
+void cnsRestartRead(cns_t *cns, setupAide &options){
+
+  mesh_t *mesh = cns->mesh;
+
+  // Create Binary File Name
+  char fname[BUFSIZ];
+  string outName;
+  options.getArgs("RESTART FILE NAME", outName);
+  sprintf(fname, "%s.dat",(char*)outName.c_str());
+
+  dfloat scalars[4] = {0.0, 0.0, 0.0, 0.0};
+
+  meshCheckpointField_t field;
+  field.o_q        = cns->o_q;
+  field.offset     = 0;
+  field.Nvalues    = mesh->Nfields*mesh->Np;
+  field.elementMap = NULL;
+
+  // elements are matched by their vertices, so the rank count may differ from the writing run
+  if(meshCheckpointRead(mesh, fname, 4, scalars, 1, &field)){
+
+    cns->startTime = scalars[0];
+    cns->frame     = (int) scalars[1];
+
+    if (options.compareArgs("TIME INTEGRATOR","DOPRI5")){
+      // continue with the step size and controller history of the writing run
+      mesh->dt    = scalars[2];
+      cns->facold = scalars[3];
+    } else {
+      // a restart at or near the final time still takes one (short) step
+      mesh->NtimeSteps = mymax(1, (int)((mesh->finalTime-cns->startTime)/mesh->dt));
+      mesh->dt         = (mesh->finalTime-cns->startTime)/mesh->NtimeSteps;
+    }
+
+    if(mesh->rank==0) printf("Restart time: %.4e ...", cns->startTime);
+
+  }else{
+    if(mesh->rank==0) printf("No restart file...");
+  }
+}
@@ -30,11 +30,12 @@ void cnsRun(cns_t *cns, setupAide &options){
 
   mesh_t *mesh = cns->mesh;
 
-  cnsReport(cns, 0, options);
+  cnsReport(cns, cns->startTime, options);
 
   occa::timer timer;
   
   timer.initTimer(mesh->device);
+  timer.setApplicationProfiling(true);
 
   timer.tic("Run");
   
@@ -46,20 +47,25 @@ void cnsRun(cns_t *cns, setupAide &options){
     options.getArgs("TIME OUTPUT INTERVAL", outputInterval);
     bool timeIntervalFlag = (outputInterval > 0.);
 
+    // first output time after the (restart) start time
     dfloat nextOutputTime = outputInterval;
+    if(timeIntervalFlag)
+      nextOutputTime = outputInterval*(floor(cns->startTime/outputInterval)+1);
     
     int outputTstepInterval;
     options.getArgs("TSTEP OUTPUT INTERVAL", outputTstepInterval);
     bool tstepIntervalFlag = (outputTstepInterval > 0);
 
     //initial time
-    dfloat time = 0.0;
+    dfloat time = cns->startTime;
     int tstep=0, allStep = 0;
 
     int done =0;
     while (!done) {
 
       cns->advSwitch = 1;
+
+      int outputFlag = 0;
       
       if (mesh->dt<cns->dtMIN){
         printf("ERROR: Time step became too small at time step=%d\n", tstep);
@@ -102,6 +108,7 @@ void cnsRun(cns_t *cns, setupAide &options){
 
           // increment next output time
           nextOutputTime += outputInterval;
+          outputFlag = 1;
         }
         
         // accept rkq
@@ -130,6 +137,7 @@ void cnsRun(cns_t *cns, setupAide &options){
 
           // increment next output time
           nextOutputTime += outputInterval;
+          outputFlag = 1;
         }
       } else {
         dtnew = mesh->dt/(mymax(cns->invfactor1,fac1/cns->safe));
@@ -141,7 +149,14 @@ void cnsRun(cns_t *cns, setupAide &options){
       mesh->dt = dtnew;
       allStep++;
 
-      printf("\rTime = %.4e (%d). Average Dt = %.4e, Rejection rate = %.2g   ", time, tstep, time/(dfloat)tstep, Nregect/(dfloat) tstep); fflush(stdout);
+      // checkpoint the accepted state along with the outputs
+      if(outputFlag && cns->writeRestartFile){
+        if(mesh->rank==0) printf("\nWriting Binary Restart File....");
+        cnsRestartWrite(cns, options, time);
+        if(mesh->rank==0) printf("done\n");
+      }
+
+      printf("\rTime = %.4e (%d). Average Dt = %.4e, Rejection rate = %.2g   ", time, tstep, (time-cns->startTime)/(dfloat)tstep, Nregect/(dfloat) tstep); fflush(stdout);
     }
     
     mesh->device.finish();
@@ -154,15 +169,23 @@ void cnsRun(cns_t *cns, setupAide &options){
 
     for(int tstep=0;tstep<mesh->NtimeSteps;++tstep){
 
-      dfloat time = tstep*mesh->dt;
+      dfloat time = cns->startTime + tstep*mesh->dt;
 
       cnsLserkStep(cns, options, time);
       
       if(((tstep+1)%mesh->errorStep)==0){
         time += mesh->dt;
         cnsReport(cns, time, options);
+
+        // Write a restart file
+        if(cns->writeRestartFile){
+          if(mesh->rank==0) printf("\nWriting Binary Restart File....");
+          cnsRestartWrite(cns, options, time);
+          if(mesh->rank==0) printf("done\n");
+        }
       }
     }
   }
-  
+
+  meshWriteProfile(mesh, options);
 }
@@ -82,6 +82,14 @@ cns_t *cnsSetup(mesh_t *mesh, setupAide &options){
   cns->outputForceStep = 0;
   
   options.getArgs("TSTEPS FOR FORCE OUTPUT",   cns->outputForceStep);
+
+  cns->readRestartFile = 0;
+  options.getArgs("RESTART FROM FILE", cns->readRestartFile);
+
+  cns->writeRestartFile = 0;
+  options.getArgs("WRITE RESTART FILE", cns->writeRestartFile);
+
+  cns->startTime = 0;
   
   // compute samples of q at interpolation nodes
   mesh->q    = (dfloat*) calloc((mesh->totalHaloPairs+mesh->Nelements)*mesh->Np*mesh->Nfields,
@@ -393,81 +401,103 @@ cns_t *cnsSetup(mesh_t *mesh, setupAide &options){
 
   char fileName[BUFSIZ], kernelName[BUFSIZ];
 
-  for (int r=0;r<mesh->size;r++) {
-    if (r==mesh->rank) {
+  for (int r=0;r<meshBuildKernelStages;r++) {
+    if (r==meshBuildKernelStage(mesh)) {
 
       // kernels from volume file
       sprintf(fileName, DCNS "/okl/cnsVolume%s.okl", suffix);
       sprintf(kernelName, "cnsVolume%s", suffix);
       
-      cns->volumeKernel =  mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+      cns->volumeKernel =  meshBuildKernel(mesh, fileName, kernelName, kernelInfo);
 
       sprintf(kernelName, "cnsStressesVolume%s", suffix);
-      cns->stressesVolumeKernel = mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+      cns->stressesVolumeKernel = meshBuildKernel(mesh, fileName, kernelName, kernelInfo);
 
       // kernels from surface file
       sprintf(fileName, DCNS "/okl/cnsSurface%s.okl", suffix);
       sprintf(kernelName, "cnsSurface%s", suffix);
       
-      cns->surfaceKernel = mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+      cns->surfaceKernel = meshBuildKernel(mesh, fileName, kernelName, kernelInfo);
 
       sprintf(kernelName, "cnsStressesSurface%s", suffix);
-      cns->stressesSurfaceKernel = mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+      cns->stressesSurfaceKernel = meshBuildKernel(mesh, fileName, kernelName, kernelInfo);
 
       if(cns->elementType != HEXAHEDRA){ //remove later
 	// kernels from cubature volume file
 	sprintf(fileName, DCNS "/okl/cnsCubatureVolume%s.okl", suffix);
 	sprintf(kernelName, "cnsCubatureVolume%s", suffix);
 	
-	cns->cubatureVolumeKernel = mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+	cns->cubatureVolumeKernel = meshBuildKernel(mesh, fileName, kernelName, kernelInfo);
 	
 	// kernels from cubature surface file
 	sprintf(fileName, DCNS "/okl/cnsCubatureSurface%s.okl", suffix);
 	sprintf(kernelName, "cnsCubatureSurface%s", suffix);
 	
-	cns->cubatureSurfaceKernel = mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+	cns->cubatureSurfaceKernel = meshBuildKernel(mesh, fileName, kernelName, kernelInfo);
       }
       
       // kernels from vorticity file
       sprintf(fileName, DCNS "/okl/cnsVorticity%s.okl", suffix);
       sprintf(kernelName, "cnsVorticity%s", suffix);
       
-      cns->vorticityKernel = mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+      cns->vorticityKernel = meshBuildKernel(mesh, fileName, kernelName, kernelInfo);
 
 
       // kernels from update file
       cns->updateKernel =
-        mesh->device.buildKernel(DCNS "/okl/cnsUpdate.okl",
+        meshBuildKernel(mesh, DCNS "/okl/cnsUpdate.okl",
                                            "cnsUpdate",
                                            kernelInfo);
 
       cns->rkUpdateKernel =
-        mesh->device.buildKernel(DCNS "/okl/cnsUpdate.okl",
+        meshBuildKernel(mesh, DCNS "/okl/cnsUpdate.okl",
                                            "cnsRkUpdate",
                                            kernelInfo);
       cns->rkStageKernel =
-        mesh->device.buildKernel(DCNS "/okl/cnsUpdate.okl",
+        meshBuildKernel(mesh, DCNS "/okl/cnsUpdate.okl",
                                            "cnsRkStage",
                                            kernelInfo);
 
       cns->rkOutputKernel =
-        mesh->device.buildKernel(DCNS "/okl/cnsUpdate.okl",
+        meshBuildKernel(mesh, DCNS "/okl/cnsUpdate.okl",
                                            "cnsRkOutput",
                                            kernelInfo);
 
       cns->rkErrorEstimateKernel =
-        mesh->device.buildKernel(DCNS "/okl/cnsUpdate.okl",
+        meshBuildKernel(mesh, DCNS "/okl/cnsUpdate.okl",
                                            "cnsErrorEstimate",
                                            kernelInfo);
 
       // fix this later
       mesh->haloExtractKernel =
-        mesh->device.buildKernel(DHOLMES "/okl/meshHaloExtract3D.okl",
+        meshBuildKernel(mesh, DHOLMES "/okl/meshHaloExtract3D.okl",
                                            "meshHaloExtract3D",
                                            kernelInfo);
     }
     MPI_Barrier(mesh->comm);
   }
 
+  // per-element costs of the timed collocation volume kernels for the profiler
+  {
+    const int dim = cns->dim;
+    const double Np = mesh->Np, Nfields = cns->Nfields, Nstresses = cns->Nstresses;
+    double Dflops, Gbytes;
+    meshKernelCostFactors(mesh, cns->elementType, &Dflops, &Gbytes);
+
+    occaTimerRegister("StressesVolume",
+                      Np*dim*(dim*Dflops + 2.*dim*dim),
+                      Np*(Nfields+Nstresses)*sizeof(dfloat) + Gbytes);
+    if(!options.compareArgs("ADVECTION TYPE", "CUBATURE"))
+      occaTimerRegister("Volume",
+                        Np*Nfields*(dim*Dflops + 2.*dim*dim),
+                        Np*(2.*Nfields+Nstresses)*sizeof(dfloat) + Gbytes);
+  }
+
+  if(meshBuildKernelReport(mesh, options)){
+    if(mesh->rank==0) printf("ERROR: ranks built different sets of kernels\n");
+    MPI_Finalize();
+    exit(-1);
+  }
+
   return cns;
 }
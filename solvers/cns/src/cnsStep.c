@@ -89,12 +89,14 @@ void cnsDopriStep(cns_t *cns, setupAide &newOptions, const dfloat time){
     }
 
     // now compute viscous stresses
+    occaTimerTic(mesh->device, "StressesVolume");
     cns->stressesVolumeKernel(mesh->Nelements, 
                               mesh->o_vgeo, 
                               mesh->o_Dmatrices,
                               cns->mu,
                               cns->o_rkq, 
                               cns->o_viscousStresses);
+    occaTimerToc(mesh->device, "StressesVolume", mesh->Nelements);
 
     // wait for q halo data to arrive
     if(mesh->totalHaloPairs>0){
@@ -179,6 +181,7 @@ void cnsDopriStep(cns_t *cns, setupAide &newOptions, const dfloat time){
                                 cns->o_rkq, 
                                 cns->o_rhsq);
     } else {
+      occaTimerTic(mesh->device, "Volume");
       cns->volumeKernel(mesh->Nelements, 
                         cns->advSwitch,
 			fx, fy, fz,
@@ -187,6 +190,7 @@ void cnsDopriStep(cns_t *cns, setupAide &newOptions, const dfloat time){
                         cns->o_viscousStresses, 
                         cns->o_rkq, 
                         cns->o_rhsq);
+      occaTimerToc(mesh->device, "Volume", mesh->Nelements);
     }
 
     // wait for halo stresses data to arrive
@@ -327,12 +331,14 @@ void cnsLserkStep(cns_t *cns, setupAide &newOptions, const dfloat time){
     }
       
     // now compute viscous stresses
+    occaTimerTic(mesh->device, "StressesVolume");
     cns->stressesVolumeKernel(mesh->Nelements, 
                               mesh->o_vgeo, 
                               mesh->o_Dmatrices, 
                               cns->mu,			      
                               cns->o_q, 
                               cns->o_viscousStresses);
+    occaTimerToc(mesh->device, "StressesVolume", mesh->Nelements);
       
     // wait for q halo data to arrive
     if(mesh->totalHaloPairs>0){
@@ -386,6 +392,7 @@ void cnsLserkStep(cns_t *cns, setupAide &newOptions, const dfloat time){
                                 cns->o_q, 
                                 cns->o_rhsq);
     } else {
+      occaTimerTic(mesh->device, "Volume");
       cns->volumeKernel(mesh->Nelements, 
                         advSwitch,
 			fx, fy, fz,
@@ -394,6 +401,7 @@ void cnsLserkStep(cns_t *cns, setupAide &newOptions, const dfloat time){
                         cns->o_viscousStresses, 
                         cns->o_q, 
                         cns->o_rhsq);
+      occaTimerToc(mesh->device, "Volume", mesh->Nelements);
     }
 
     // wait for halo stresses data to arrive
@@ -56,7 +56,6 @@ typedef struct {
   char *type;
 
   dlong Nblock;
-  dlong Nblock2; // second reduction
 
   dfloat tau;
 
@@ -99,8 +98,16 @@ typedef struct {
   occa::memory o_Sres;
   occa::memory o_Ax; // A*initial guess
   occa::memory o_Ap; // A*search direction
-  occa::memory o_tmp; // temporary
-  occa::memory o_tmp2; // temporary (second reduction)
+  occa::memory o_Az; // A*z (pipelined PCG)
+  occa::memory o_MAz; // Precon^{-1} A*z (pipelined PCG)
+  occa::memory o_AMAz; // A*Precon^{-1} A*z (pipelined PCG)
+  occa::memory o_q; // Precon^{-1} A*p (pipelined PCG)
+  occa::memory o_Aq; // A*q (pipelined PCG)
+  occa::memory o_tmp; // temporary (block partial sums, pinned)
+  int atomicReduction; // PCG dot products accumulated on the device with atomicAdd
+  occa::memory o_dots; // device accumulators of the atomic PCG dot products
+  occa::memory o_pipelinedDots; // block partial sums of pipelined PCG inner products
+  dfloat *pipelinedDots;
   occa::memory o_grad; // temporary gradient storage (part of A*)
   occa::memory o_rtmp;
   occa::memory o_invDegree;
@@ -108,6 +115,27 @@ typedef struct {
   occa::memory o_R;
   occa::memory o_Ry;
 
+  // block PCG workspace (Nfields vectors, blockFieldOffset entries apart)
+  int NblockFields;
+  dlong blockFieldOffset;
+  dfloat *blockTmp; // per field block partial sums (pinned)
+  double *blockDots; // local and global sums (up to 2 per field, 4*Nfields)
+  occa::memory o_blockTmp;
+  occa::memory o_blockP, o_blockZ, o_blockAp;
+  occa::memory o_blockAlpha, o_blockBeta;
+
+  // successive right hand side projection of the initial guess (INITIAL GUESS=PROJECTION)
+  int Nprojection, maxProjection; // vectors in use and capacity
+  dfloat projectionLambda; // lambda the basis is A-orthonormal for
+  dfloat *projectionAlpha;
+  dfloat *projectionCoeffs; // host projection coefficients (maxProjection)
+  dfloat *projectionDots; // per vector block partial sums (pinned)
+  occa::memory o_projectionDots;
+  occa::memory o_projectionX, o_projectionB; // basis and A*basis, maxProjection vectors of Ntotal
+  occa::memory o_projectionXbar, o_projectionXnew, o_projectionAx;
+  occa::memory o_projectionAlpha;
+  occa::memory o_projectionWeight; // inner product weights matching the Krylov solver
+
   occa::memory o_EXYZ; // element vertices for reconstructing geofacs (trilinear hexes only)
   occa::memory o_gllzw; // GLL nodes and weights
   
@@ -128,9 +156,21 @@ typedef struct {
   occa::kernel weightedInnerProduct1Kernel;
   occa::kernel weightedInnerProduct2Kernel;
   occa::kernel scaledAddKernel;
+  occa::kernel multiWeightedInnerProductKernel;
+  occa::kernel multiScaledAddKernel;
+  occa::kernel updatePCGKernel;
+  occa::kernel flexibleInnerProductsPCGKernel;
   occa::kernel dotMultiplyKernel;
   occa::kernel dotDivideKernel;
 
+  occa::kernel pipelinedInnerProductsKernel;
+  occa::kernel pipelinedUpdateKernel;
+
+  occa::kernel blockWeightedInnerProductKernel;
+  occa::kernel blockUpdatePCGKernel;
+  occa::kernel blockFlexibleInnerProductsKernel;
+  occa::kernel blockScaledAddKernel;
+
   occa::kernel weightedNorm2Kernel;
   occa::kernel norm2Kernel;
 
@@ -142,6 +182,20 @@ typedef struct {
 
 }elliptic_t;
 
+// N-independent data shared by the coarse p-multigrid levels: connectivity, halo plans,
+// EToV, vertex coordinates, gather element lists, BCs, streams and vector kernels.
+// (Simplex geometric factors are per element and shared as well.)
+typedef struct {
+
+  elliptic_t *fine;          // fine level, source of the dummy buffers
+
+  mesh_t mesh;               // N-independent mesh fields only
+  elliptic_t elliptic;       // N-independent elliptic fields only
+
+  long long int sharedBytes; // device bytes held once for all levels
+
+}ellipticLevelShared_t;
+
 elliptic_t *ellipticSetup(mesh2D *mesh, dfloat lambda, occa::properties &kernelInfo, setupAide options);
 
 void ellipticParallelGatherScatter(mesh2D *mesh, ogs_t *ogs, occa::memory &o_v, const char *type, const char *op);
@@ -153,6 +207,15 @@ void ellipticPreconditionerSetup(elliptic_t *elliptic, ogs_t *ogs, dfloat lambda
 int  ellipticSolve(elliptic_t *elliptic, dfloat lambda, dfloat tol, occa::memory &o_r, occa::memory &o_x);
 void ellipticSolveSetup(elliptic_t *elliptic, dfloat lambda, occa::properties &kernelInfo);
 
+// solve Nfields systems that share one operator in a single block PCG loop
+int  ellipticBlockSolve(elliptic_t **solvers, int Nfields, dfloat lambda, dfloat tol,
+                        occa::memory &o_r, occa::memory &o_x, int *Niter);
+void ellipticBlockSolveSetup(elliptic_t **solvers, int Nfields, dlong offset, occa::properties &kernelInfo);
+
+// initial guess from the span of previous solutions and the update of that span
+void ellipticProjectInitialGuess(elliptic_t *elliptic, dfloat lambda, occa::memory &o_r, occa::memory &o_x);
+void ellipticUpdateProjectionSpace(elliptic_t *elliptic, dfloat lambda, occa::memory &o_x);
+
 
 void ellipticStartHaloExchange(elliptic_t *elliptic, occa::memory &o_q, int Nentries, dfloat *sendBuffer, dfloat *recvBuffer);
 void ellipticInterimHaloExchange(elliptic_t *elliptic, occa::memory &o_q, int Nentries, dfloat *sendBuffer, dfloat *recvBuffer);
@@ -160,13 +223,38 @@ void ellipticEndHaloExchange(elliptic_t *elliptic, occa::memory &o_q, int Nentri
 
 //Linear solvers
 int pcg      (elliptic_t* elliptic, dfloat lambda, occa::memory &o_r, occa::memory &o_x, const dfloat tol, const int MAXIT);
+int ppcg     (elliptic_t* elliptic, dfloat lambda, occa::memory &o_r, occa::memory &o_x, const dfloat tol, const int MAXIT);
+int bpcg     (elliptic_t** solvers, int Nfields, dfloat lambda, occa::memory &o_r, occa::memory &o_x,
+              const dfloat tol, const int MAXIT, int *Niter);
 
 void ellipticScaledAdd(elliptic_t *elliptic, dfloat alpha, occa::memory &o_a, dfloat beta, occa::memory &o_b);
 dfloat ellipticWeightedInnerProduct(elliptic_t *elliptic, occa::memory &o_w, occa::memory &o_a, occa::memory &o_b);
 
 dfloat ellipticCascadingWeightedInnerProduct(elliptic_t *elliptic, occa::memory &o_w, occa::memory &o_a, occa::memory &o_b);
 
+dfloat ellipticUpdatePCG(elliptic_t *elliptic, occa::memory &o_w, occa::memory &o_p, occa::memory &o_Ap,
+                         dfloat alpha, occa::memory &o_x, occa::memory &o_r);
+void ellipticFlexibleInnerProductsPCG(elliptic_t *elliptic, occa::memory &o_w, occa::memory &o_z,
+                                      occa::memory &o_r, occa::memory &o_Ap, dfloat *zdotr, dfloat *zdotAp);
+
 void ellipticOperator(elliptic_t *elliptic, dfloat lambda, occa::memory &o_q, occa::memory &o_Aq, const char *precision);
+void ellipticBlockOperator(elliptic_t **solvers, int Nfields, dfloat lambda, occa::memory &o_q, occa::memory &o_Aq);
+
+// element map of the continuous partial Ax kernels ([ELEMENT MAP] option). Only
+// these kernels change: vgeo, sgeo and cubvgeo stay on the DEVICE, and solvers
+// with their own ggeo kernels (INS diffusion and boundary right hand sides) keep ggeo
+#define ELEMENT_MAP_STORED    0 // stored ggeo (ISOPARAMETRIC)
+#define ELEMENT_MAP_TRILINEAR 1 // hexes, factors from the element vertices
+#define ELEMENT_MAP_RECOMPUTE 2 // quads/hexes, factors from the node coordinates
+
+// element map dispatch shared by the continuous operators
+int  ellipticElementMapType(elliptic_t *elliptic);
+
+// per-element cost of the timed Ax for the profiler
+void ellipticAxCostRegister(elliptic_t *elliptic);
+void ellipticPartialAxKernelName(elliptic_t *elliptic, const char *suffix, char *kernelName);
+void ellipticPartialAx(elliptic_t *elliptic, occa::kernel &partialAxKernel, dfloat lambda,
+                       dlong Nelements, occa::memory &o_elementList, occa::memory &o_q, occa::memory &o_Aq);
 
 dfloat ellipticWeightedNorm2(elliptic_t *elliptic, occa::memory &o_w, occa::memory &o_a);
 void ellipticBuildIpdg(elliptic_t* elliptic, int basisNp, dfloat *basis, dfloat lambda, 
@@ -176,6 +264,7 @@ void ellipticBuildContinuous(elliptic_t* elliptic, dfloat lambda, nonZero_t **A,
                                   dlong *nnz, ogs_t **ogs, hlong *globalStarts);
 
 void ellipticBuildJacobi(elliptic_t *elliptic, dfloat lambda, dfloat **invDiagA);
+void ellipticUpdateJacobi(elliptic_t *elliptic, dfloat lambda);
 
 void ellipticBuildLocalPatches(elliptic_t *elliptic, dfloat lambda, dfloat rateTolerance,
                                dlong *Npataches, dlong **patchesIndex, dfloat **patchesInvA);
@@ -184,13 +273,17 @@ void ellipticBuildLocalPatches(elliptic_t *elliptic, dfloat lambda, dfloat rateT
 void ellipticSetupSmoother(elliptic_t *elliptic, precon_t *precon, dfloat lambda);
 void ellipticSetupSmootherDampedJacobi    (elliptic_t *elliptic, precon_t *precon, agmgLevel *level, dfloat lambda);
 void ellipticSetupSmootherLocalPatch(elliptic_t *elliptic, precon_t *precon, agmgLevel *level, dfloat lambda, dfloat rateTolerance);
+void ellipticSetupSmootherSchwarz(elliptic_t *elliptic, precon_t *precon, agmgLevel *level, dfloat lambda);
+void ellipticBuildSmootherKernels(elliptic_t *elliptic, occa::properties &kernelInfo, const char *suffix);
+void ellipticEigenvalueCacheKey(elliptic_t *elliptic, char *key);
 
 void ellipticMultiGridSetup(elliptic_t *elliptic, precon_t* precon, dfloat lambda);
-elliptic_t *ellipticBuildMultigridLevel(elliptic_t *baseElliptic, int Nc, int Nf);
+ellipticLevelShared_t *ellipticLevelSharedSetup(elliptic_t *fine);
+elliptic_t *ellipticBuildMultigridLevel(ellipticLevelShared_t *shared, int Nc, int Nf);
 
 void ellipticSEMFEMSetup(elliptic_t *elliptic, precon_t* precon, dfloat lambda);
 
-dfloat maxEigSmoothAx(elliptic_t* elliptic, agmgLevel *level);
+dfloat maxEigSmoothAx(elliptic_t* elliptic, agmgLevel *level, int k);
 
 #define maxNthreads 256
 
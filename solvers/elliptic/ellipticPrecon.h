@@ -35,7 +35,8 @@ typedef struct{
 
 typedef struct {
 
-  long long int preconBytes;
+  long long int preconBytes; // device bytes of the preconditioner set up for this solver (whole hierarchy)
+  long long int levelBytes;  // device bytes of this multigrid level alone (operator and smoother data)
 
   ogs_t *ogs;
   ogs_t *FEMogs;
@@ -62,6 +63,20 @@ typedef struct {
   occa::memory o_oasForwardDgT;
   occa::memory o_oasBackDgT;
 
+  // fast diagonalization Schwarz smoother (quads and hexes)
+  occa::memory o_oasDiagOp;
+  occa::memory o_oasScales;
+  occa::memory o_oasMapP;
+  occa::memory o_oasPatchIds;
+  occa::memory o_oasTargetIds;
+  occa::memory o_oasSourceIds;
+  occa::memory o_oasR;
+  occa::memory o_oasOverlap;
+  occa::memory o_oasHaloBuffer;
+
+  dfloat *oasSendBuffer, *oasRecvBuffer;
+  occa::memory o_oasSendBuffer, o_oasRecvBuffer;
+
   occa::kernel restrictKernel;
 
   occa::kernel coarsenKernel;
@@ -74,6 +89,9 @@ typedef struct {
   occa::kernel approxFacePatchSolverKernel;
   occa::kernel exactBlockJacobiSolverKernel;
   occa::kernel approxBlockJacobiSolverKernel;
+  occa::kernel dampedJacobiKernel;
+  occa::kernel oasFastDiagKernel;
+  occa::kernel oasOverlapAddKernel;
   occa::kernel patchGatherKernel;
   occa::kernel facePatchGatherKernel;
   occa::kernel CGLocalPatchKernel;
@@ -137,4 +155,5 @@ void ellipticMultigridSmoothChebyshev(void **args, occa::memory &o_r, occa::memo
 
 //smoother ops
 void LocalPatch  (void **args, occa::memory &o_r, occa::memory &o_Sr);
-void dampedJacobi(void **args, occa::memory &o_r, occa::memory &o_Sr);
\ No newline at end of file
+void dampedJacobi(void **args, occa::memory &o_r, occa::memory &o_Sr);
+void overlappingSchwarz(void **args, occa::memory &o_r, occa::memory &o_Sr);
\ No newline at end of file
@@ -0,0 +1,255 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "elliptic.h"
+
+// sum the block partial sums of Ndots dot products and reduce them in one message
+static void ellipticBlockReduce(elliptic_t *elliptic, int Ndots, dfloat *dots){
+
+  mesh_t *mesh = elliptic->mesh;
+  dfloat *tmp = elliptic->blockTmp;
+  dlong Ntotal = mesh->Nelements*mesh->Np;
+  dlong Nblock = (Ntotal+blockSize-1)/blockSize;
+
+  // partial sums land in pinned host memory
+  mesh->device.finish();
+
+  double *localDots  = elliptic->blockDots;
+  double *globalDots = elliptic->blockDots + Ndots;
+
+  for(int d=0;d<Ndots;++d)
+    localDots[d] = 0.;
+
+  for(int d=0;d<Ndots;++d)
+    for(dlong n=0;n<Nblock;++n)
+      localDots[d] += tmp[n+d*Nblock];
+
+  MPI_Allreduce(localDots, globalDots, Ndots, MPI_DOUBLE, MPI_SUM, mesh->comm);
+
+  for(int d=0;d<Ndots;++d)
+    dots[d] = globalDots[d];
+}
+
+static void ellipticBlockWeightedInnerProduct(elliptic_t *elliptic, int Nfields, occa::memory &o_a, occa::memory &o_b, dfloat *ab){
+
+  mesh_t *mesh = elliptic->mesh;
+  dlong Ntotal = mesh->Nelements*mesh->Np;
+
+  elliptic->blockWeightedInnerProductKernel(Ntotal, Nfields, elliptic->blockFieldOffset, elliptic->o_invDegree,
+                                            o_a, o_b, elliptic->o_blockTmp);
+
+  ellipticBlockReduce(elliptic, Nfields, ab);
+}
+
+// w.z.r and w.z.Ap of every field from one sweep and one reduction (flexible PCG)
+static void ellipticBlockFlexibleInnerProducts(elliptic_t *elliptic, int Nfields, occa::memory &o_z,
+                                               occa::memory &o_r, occa::memory &o_Ap, dfloat *zdots){
+
+  mesh_t *mesh = elliptic->mesh;
+  dlong Ntotal = mesh->Nelements*mesh->Np;
+
+  elliptic->blockFlexibleInnerProductsKernel(Ntotal, Nfields, elliptic->blockFieldOffset, elliptic->o_invDegree,
+                                             o_z, o_r, o_Ap, elliptic->o_blockTmp);
+
+  ellipticBlockReduce(elliptic, 2*Nfields, zdots);
+}
+
+static void ellipticBlockUpdatePCG(elliptic_t *elliptic, int Nfields, dfloat *alpha, occa::memory &o_p, occa::memory &o_Ap,
+                                   occa::memory &o_x, occa::memory &o_r, dfloat *rdotr){
+
+  mesh_t *mesh = elliptic->mesh;
+  dlong Ntotal = mesh->Nelements*mesh->Np;
+
+  elliptic->o_blockAlpha.copyFrom(alpha, Nfields*sizeof(dfloat));
+
+  elliptic->blockUpdatePCGKernel(Ntotal, Nfields, elliptic->blockFieldOffset, elliptic->o_invDegree,
+                                 elliptic->o_blockAlpha, o_p, o_Ap, o_x, o_r, elliptic->o_blockTmp);
+
+  ellipticBlockReduce(elliptic, Nfields, rdotr);
+}
+
+static void ellipticBlockScaledAdd(elliptic_t *elliptic, int Nfields, dfloat *alpha, occa::memory &o_a,
+                                   dfloat *beta, occa::memory &o_b){
+
+  mesh_t *mesh = elliptic->mesh;
+  dlong Ntotal = mesh->Nelements*mesh->Np;
+
+  elliptic->o_blockAlpha.copyFrom(alpha, Nfields*sizeof(dfloat));
+  elliptic->o_blockBeta.copyFrom(beta, Nfields*sizeof(dfloat));
+
+  elliptic->blockScaledAddKernel(Ntotal, Nfields, elliptic->blockFieldOffset,
+                                 elliptic->o_blockAlpha, o_a, elliptic->o_blockBeta, o_b);
+}
+
+// Nfields independent PCG recurrences advanced in lock step: one operator
+// application (one gather-scatter exchange) and one Nfields-wide reduction per
+// sweep. Each field stops updating once it converges, Niter[fld] records when.
+int bpcg(elliptic_t** solvers, int Nfields, dfloat lambda, occa::memory &o_r, occa::memory &o_x,
+         const dfloat tol, const int MAXIT, int *Niter){
+
+  elliptic_t *elliptic = solvers[0];
+  mesh_t *mesh = elliptic->mesh;
+  setupAide options = elliptic->options;
+
+  size_t fieldBytes = elliptic->blockFieldOffset*sizeof(dfloat);
+
+  /*aux variables */
+  occa::memory &o_p  = elliptic->o_blockP;
+  occa::memory &o_z  = elliptic->o_blockZ;
+  occa::memory &o_Ap = elliptic->o_blockAp;
+
+  dfloat *normB  = (dfloat*) calloc(Nfields, sizeof(dfloat));
+  dfloat *TOL    = (dfloat*) calloc(Nfields, sizeof(dfloat));
+  dfloat *rdotr  = (dfloat*) calloc(Nfields, sizeof(dfloat));
+  dfloat *rdotz0 = (dfloat*) calloc(Nfields, sizeof(dfloat));
+  dfloat *rdotz1 = (dfloat*) calloc(Nfields, sizeof(dfloat));
+  dfloat *pAp    = (dfloat*) calloc(Nfields, sizeof(dfloat));
+  dfloat *alpha  = (dfloat*) calloc(Nfields, sizeof(dfloat));
+  dfloat *beta   = (dfloat*) calloc(Nfields, sizeof(dfloat));
+  dfloat *zdots  = (dfloat*) calloc(2*Nfields, sizeof(dfloat)); // z.r then z.Ap (flexible)
+  int *active    = (int*) calloc(Nfields, sizeof(int));
+
+  int flexible = options.compareArgs("KRYLOV SOLVER", "FLEXIBLE");
+
+  /*compute norm b, set the tolerance */
+  ellipticBlockWeightedInnerProduct(elliptic, Nfields, o_r, o_r, normB);
+
+  for(int fld=0;fld<Nfields;++fld)
+    TOL[fld] = mymax(tol*tol*normB[fld],tol*tol);
+
+  // r = b - A*x
+  ellipticBlockOperator(solvers, Nfields, lambda, o_x, o_Ap);
+
+  for(int fld=0;fld<Nfields;++fld){
+    alpha[fld] = -1.f;
+    beta[fld]  =  1.f;
+  }
+  ellipticBlockScaledAdd(elliptic, Nfields, alpha, o_Ap, beta, o_r);
+
+  ellipticBlockWeightedInnerProduct(elliptic, Nfields, o_r, o_r, rdotr);
+
+  int Nactive = 0;
+  for(int fld=0;fld<Nfields;++fld){
+    Niter[fld] = 0;
+    active[fld] = (rdotr[fld]<1E-20) ? 0:1; //sanity check
+    Nactive += active[fld];
+
+    if (options.compareArgs("VERBOSE", "TRUE")&&(mesh->rank==0))
+      printf("BCG: field %d initial res norm %12.12f WE NEED TO GET TO %12.12f \n", fld, sqrt(rdotr[fld]), sqrt(TOL[fld]));
+  }
+
+  // Precon^{-1} (b-A*x), each field uses its own preconditioner
+  for(int fld=0;fld<Nfields;++fld){
+    if(!active[fld]) continue;
+    occa::memory o_rf = o_r + fld*fieldBytes;
+    occa::memory o_zf = o_z + fld*fieldBytes;
+    ellipticPreconditioner(solvers[fld], lambda, o_rf, o_zf);
+  }
+
+  // p = z (converged fields get p = 0 so they stop moving)
+  for(int fld=0;fld<Nfields;++fld){
+    alpha[fld] = active[fld] ? 1.f : 0.f;
+    beta[fld]  = 0.f;
+  }
+  ellipticBlockScaledAdd(elliptic, Nfields, alpha, o_z, beta, o_p);
+
+  // dot(r,z)
+  ellipticBlockWeightedInnerProduct(elliptic, Nfields, o_r, o_z, rdotz0);
+
+  int it = 0;
+  while(Nactive && (it<MAXIT)) {
+
+    // A*p
+    ellipticBlockOperator(solvers, Nfields, lambda, o_p, o_Ap);
+
+    // dot(p,A*p)
+    ellipticBlockWeightedInnerProduct(elliptic, Nfields, o_p, o_Ap, pAp);
+
+    // alpha = dot(r,z)/dot(p,A*p)
+    for(int fld=0;fld<Nfields;++fld)
+      alpha[fld] = active[fld] ? rdotz0[fld]/pAp[fld] : 0.f;
+
+    // x <= x + alpha*p, r <= r - alpha*A*p, dot(r,r)
+    ellipticBlockUpdatePCG(elliptic, Nfields, alpha, o_p, o_Ap, o_x, o_r, rdotr);
+
+    for(int fld=0;fld<Nfields;++fld){
+      if(!active[fld]) continue;
+
+      if (options.compareArgs("VERBOSE", "TRUE")&&(mesh->rank==0))
+        printf("BCG: it %d field %d r norm %12.12f alpha = %f \n", it, fld, sqrt(rdotr[fld]), alpha[fld]);
+
+      if(rdotr[fld] < TOL[fld]) {
+        active[fld] = 0;
+        Niter[fld] = it;
+        --Nactive;
+      }
+    }
+
+    if(!Nactive) break;
+
+    // z = Precon^{-1} r
+    for(int fld=0;fld<Nfields;++fld){
+      if(!active[fld]) continue;
+      occa::memory o_rf = o_r + fld*fieldBytes;
+      occa::memory o_zf = o_z + fld*fieldBytes;
+      ellipticPreconditioner(solvers[fld], lambda, o_rf, o_zf);
+    }
+
+    // dot(r,z), flexible PCG also needs dot(z,A*p) for
+    // beta = z.(r-r_old)/rdotz0 = -alpha*z.Ap/rdotz0
+    if(flexible){
+      ellipticBlockFlexibleInnerProducts(elliptic, Nfields, o_z, o_r, o_Ap, zdots);
+      for(int fld=0;fld<Nfields;++fld)
+        rdotz1[fld] = zdots[fld];
+    } else {
+      ellipticBlockWeightedInnerProduct(elliptic, Nfields, o_r, o_z, rdotz1);
+    }
+
+    // p = z + beta*p
+    for(int fld=0;fld<Nfields;++fld){
+      if(!active[fld])
+        beta[fld] = 0.f;
+      else if(flexible)
+        beta[fld] = -alpha[fld]*zdots[Nfields+fld]/rdotz0[fld];
+      else
+        beta[fld] = rdotz1[fld]/rdotz0[fld];
+      alpha[fld] = active[fld] ? 1.f : 0.f;
+      rdotz0[fld] = rdotz1[fld];
+    }
+    ellipticBlockScaledAdd(elliptic, Nfields, alpha, o_z, beta, o_p);
+
+    ++it;
+  }
+
+  for(int fld=0;fld<Nfields;++fld)
+    if(active[fld]) Niter[fld] = it;
+
+  free(normB); free(TOL); free(rdotr);
+  free(rdotz0); free(rdotz1); free(pAp);
+  free(alpha); free(beta); free(zdots); free(active);
+
+  return it;
+}
@@ -98,20 +98,12 @@ int pcg(elliptic_t* elliptic, dfloat lambda,
     // alpha = dot(r,z)/dot(p,A*p)
     alpha = rdotz0/pAp;
 
-    // x <= x + alpha*p
-    ellipticScaledAdd(elliptic,  alpha, o_p,  1.f, o_x);
-
     occaTimerTic(mesh->device,"Residual update");
     // [
+    // x <= x + alpha*p
     // r <= r - alpha*A*p
-    ellipticScaledAdd(elliptic, -alpha, o_Ap, 1.f, o_r);
-
     // dot(r,r)
-#if 1
-    rdotr1 = ellipticCascadingWeightedInnerProduct(elliptic, elliptic->o_invDegree, o_r, o_r);
-#else
-    rdotr1 = ellipticWeightedNorm2(elliptic, elliptic->o_invDegree, o_r);
-#endif
+    rdotr1 = ellipticUpdatePCG(elliptic, elliptic->o_invDegree, o_p, o_Ap, alpha, o_x, o_r);
     // ]
     occaTimerToc(mesh->device,"Residual update");
     
@@ -129,18 +121,19 @@ int pcg(elliptic_t* elliptic, dfloat lambda,
     // z = Precon^{-1} r
     ellipticPreconditioner(elliptic, lambda, o_r, o_z);
 
-    // dot(r,z)
-    rdotz1 = ellipticCascadingWeightedInnerProduct(elliptic, elliptic->o_invDegree, o_r, o_z);
-    // ]
-    
     // flexible pcg beta = (z.(-alpha*Ap))/zdotz0
     if(options.compareArgs("KRYLOV SOLVER", "PCG+FLEXIBLE") ||
        options.compareArgs("KRYLOV SOLVER", "PCG,FLEXIBLE")) {
-      dfloat zdotAp = ellipticCascadingWeightedInnerProduct(elliptic, elliptic->o_invDegree, o_z, o_Ap);
+      // dot(r,z) and dot(z,A*p) in one sweep
+      dfloat zdotAp;
+      ellipticFlexibleInnerProductsPCG(elliptic, elliptic->o_invDegree, o_z, o_r, o_Ap, &rdotz1, &zdotAp);
       beta = -alpha*zdotAp/rdotz0;
     } else {
+      // dot(r,z)
+      rdotz1 = ellipticCascadingWeightedInnerProduct(elliptic, elliptic->o_invDegree, o_r, o_z);
       beta = rdotz1/rdotz0;
     }
+    // ]
 
     // p = z + beta*p
     ellipticScaledAdd(elliptic, 1.f, o_z, beta, o_p);
@@ -0,0 +1,161 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+
+#include "elliptic.h"
+
+// sum the block partial inner products and start their global reduction
+static void ellipticPipelinedReduceStart(elliptic_t *elliptic, dfloat *localDots, dfloat *globalDots, MPI_Request *request){
+
+  mesh_t *mesh = elliptic->mesh;
+  dlong Nblock = elliptic->Nblock;
+
+  // partial sums land in mapped host memory
+  mesh->device.finish();
+
+  localDots[0] = 0; localDots[1] = 0; localDots[2] = 0;
+  for(dlong n=0;n<Nblock;++n){
+    localDots[0] += elliptic->pipelinedDots[3*n+0];
+    localDots[1] += elliptic->pipelinedDots[3*n+1];
+    localDots[2] += elliptic->pipelinedDots[3*n+2];
+  }
+
+  MPI_Iallreduce(localDots, globalDots, 3, MPI_DFLOAT, MPI_SUM, mesh->comm, request);
+}
+
+/* pipelined PCG (Ghysels & Vanroose): one non-blocking reduction per
+   iteration, hidden behind the preconditioner and operator applications */
+int ppcg(elliptic_t* elliptic, dfloat lambda, 
+         occa::memory &o_r, occa::memory &o_x, 
+         const dfloat tol, const int MAXIT) {
+
+  mesh_t *mesh = elliptic->mesh;
+  setupAide options = elliptic->options;
+
+  dlong Ntotal = mesh->Np*mesh->Nelements;
+  int weighted = options.compareArgs("DISCRETIZATION", "CONTINUOUS") ? 1:0;
+
+  /*aux variables */
+  occa::memory &o_p    = elliptic->o_p;
+  occa::memory &o_z    = elliptic->o_z;
+  occa::memory &o_Ap   = elliptic->o_Ap;
+  occa::memory &o_Ax   = elliptic->o_Ax;
+  occa::memory &o_Az   = elliptic->o_Az;
+  occa::memory &o_MAz  = elliptic->o_MAz;
+  occa::memory &o_AMAz = elliptic->o_AMAz;
+  occa::memory &o_q    = elliptic->o_q;
+  occa::memory &o_Aq   = elliptic->o_Aq;
+
+  /*compute norm b, set the tolerance */
+  dfloat normB = ellipticCascadingWeightedInnerProduct(elliptic, elliptic->o_invDegree, o_r, o_r);
+
+  dfloat TOL =  mymax(tol*tol*normB,tol*tol);
+
+  // compute A*x
+  ellipticOperator(elliptic, lambda, o_x, elliptic->o_Ax, dfloatString);
+
+  // subtract r = b - A*x
+  ellipticScaledAdd(elliptic, -1.f, o_Ax, 1.f, o_r);
+
+  dfloat rdotr0 = ellipticCascadingWeightedInnerProduct(elliptic, elliptic->o_invDegree, o_r, o_r);
+
+  int Niter = 0;
+
+  //sanity check
+  if (rdotr0<1E-20) {
+    if (options.compareArgs("VERBOSE", "TRUE")&&(mesh->rank==0)){
+      printf("converged in ZERO iterations. Stopping.\n");}
+    return 0;
+  } 
+
+  if (options.compareArgs("VERBOSE", "TRUE")&&(mesh->rank==0)) 
+    printf("CG: initial res norm %12.12f WE NEED TO GET TO %12.12f \n", sqrt(rdotr0), sqrt(TOL));
+
+  // z = Precon^{-1} r, Az = A*z
+  ellipticPreconditioner(elliptic, lambda, o_r, o_z);
+  ellipticOperator(elliptic, lambda, o_z, o_Az, dfloatString);
+
+  dfloat localDots[3], globalDots[3];
+  MPI_Request request;
+
+  // [ dot(r,z), dot(Az,z), dot(r,r) ]
+  elliptic->pipelinedInnerProductsKernel(Ntotal, weighted, elliptic->o_invDegree,
+                                         o_r, o_z, o_Az, elliptic->o_pipelinedDots);
+  ellipticPipelinedReduceStart(elliptic, localDots, globalDots, &request);
+
+  dfloat alpha = 0, beta = 0;
+  dfloat rdotz0 = 0, rdotz1 = 0, Azdotz1 = 0, rdotr1 = 0;
+
+  while((Niter <MAXIT)) {
+
+    occaTimerTic(mesh->device,"Preconditioner");
+    // MAz = Precon^{-1} Az (overlaps the reduction)
+    ellipticPreconditioner(elliptic, lambda, o_Az, o_MAz);
+    occaTimerToc(mesh->device,"Preconditioner");
+
+    // AMAz = A*MAz (overlaps the reduction)
+    ellipticOperator(elliptic, lambda, o_MAz, o_AMAz, dfloatString);
+
+    MPI_Wait(&request, MPI_STATUS_IGNORE);
+
+    rdotz1  = globalDots[0];
+    Azdotz1 = globalDots[1];
+    rdotr1  = globalDots[2];
+
+    if(Niter>0){
+      if (options.compareArgs("VERBOSE", "TRUE")&&(mesh->rank==0)) 
+        printf("CG: it %d r norm %12.12f alpha = %f \n",Niter, sqrt(rdotr1), alpha);
+
+      if(rdotr1 < TOL) break;
+    }
+
+    if(Niter>0){
+      beta  = rdotz1/rdotz0;
+      alpha = rdotz1/(Azdotz1 - beta*rdotz1/alpha);
+    } else {
+      beta  = 0;
+      alpha = rdotz1/Azdotz1;
+    }
+
+    occaTimerTic(mesh->device,"Residual update");
+    // p, Ap, q, Aq, x, r, z, Az updates fused with the next inner products
+    elliptic->pipelinedUpdateKernel(Ntotal, weighted, elliptic->o_invDegree, alpha, beta,
+                                    o_AMAz, o_MAz, o_Aq, o_q, o_Ap, o_p, o_x, o_r, o_z, o_Az,
+                                    elliptic->o_pipelinedDots);
+    ellipticPipelinedReduceStart(elliptic, localDots, globalDots, &request);
+    occaTimerToc(mesh->device,"Residual update");
+
+    rdotz0 = rdotz1;
+
+    ++Niter;
+  }
+
+  // complete any reduction left in flight at MAXIT
+  if(Niter==MAXIT)
+    MPI_Wait(&request, MPI_STATUS_IGNORE);
+
+  return Niter;
+}
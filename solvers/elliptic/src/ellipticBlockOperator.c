@@ -0,0 +1,77 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "elliptic.h"
+
+// Aq = A*q for Nfields continuous systems sharing a mesh and operator, only the masks differ.
+// The C0 halo gather-scatter carries all fields in a single exchange.
+void ellipticBlockOperator(elliptic_t **solvers, int Nfields, dfloat lambda, occa::memory &o_q, occa::memory &o_Aq){
+
+  elliptic_t *elliptic = solvers[0];
+  mesh_t *mesh = elliptic->mesh;
+  ogs_t *ogs = mesh->ogs;
+
+  dlong offset = elliptic->blockFieldOffset;
+  size_t fieldBytes = offset*sizeof(dfloat);
+
+  occaTimerTic(mesh->device,"blockAxKernel");
+
+  if(elliptic->NglobalGatherElements) {
+    for(int fld=0;fld<Nfields;++fld){
+      occa::memory o_qf  = o_q  + fld*fieldBytes;
+      occa::memory o_Aqf = o_Aq + fld*fieldBytes;
+      ellipticPartialAx(elliptic, elliptic->partialAxKernel, lambda, elliptic->NglobalGatherElements, elliptic->o_globalGatherElementList, o_qf, o_Aqf);
+    }
+  }
+
+  // start C0 halo gather-scatter of all fields (messages overlap the local elements)
+  meshParallelGatherScatterStart(mesh, ogs, o_Aq, Nfields, offset);
+
+  if(elliptic->NlocalGatherElements) {
+    for(int fld=0;fld<Nfields;++fld){
+      occa::memory o_qf  = o_q  + fld*fieldBytes;
+      occa::memory o_Aqf = o_Aq + fld*fieldBytes;
+      ellipticPartialAx(elliptic, elliptic->partialAxKernel, lambda, elliptic->NlocalGatherElements, elliptic->o_localGatherElementList, o_qf, o_Aqf);
+    }
+  }
+
+  // finalize gather using local and global contributions
+  if(ogs->NnonHaloGather)
+    mesh->gatherScatterKernel(ogs->NnonHaloGather, ogs->o_nonHaloGatherOffsets, ogs->o_nonHaloGatherLocalIds, Nfields, offset, o_Aq);
+
+  // finish C0 halo gather-scatter
+  meshParallelGatherScatterFinish(mesh, ogs, o_Aq, Nfields, offset);
+
+  //post-mask, each field has its own boundary conditions
+  for(int fld=0;fld<Nfields;++fld){
+    if (solvers[fld]->Nmasked) {
+      occa::memory o_Aqf = o_Aq + fld*fieldBytes;
+      mesh->maskKernel(solvers[fld]->Nmasked, solvers[fld]->o_maskIds, o_Aqf);
+    }
+  }
+
+  occaTimerToc(mesh->device,"blockAxKernel");
+}
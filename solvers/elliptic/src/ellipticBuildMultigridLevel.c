@@ -26,131 +26,174 @@ SOFTWARE.
 
 #include "elliptic.h"
 
-// create elliptic and mesh structs for multigrid levels
-elliptic_t *ellipticBuildMultigridLevel(elliptic_t *baseElliptic, int Nc, int Nf){
+// device bytes of a buffer held by the shared level data
+static long long int ellipticLevelSharedBytes(occa::memory &o_a){
+  return o_a.isInitialized() ? (long long int) o_a.size() : 0;
+}
 
-  elliptic_t *elliptic = (elliptic_t*) calloc(1, sizeof(elliptic_t));
+// N-independent data of the coarse p-multigrid levels, taken from the fine level once
+ellipticLevelShared_t *ellipticLevelSharedSetup(elliptic_t *fine){
+
+  ellipticLevelShared_t *shared = (ellipticLevelShared_t*) calloc(1, sizeof(ellipticLevelShared_t));
+  mesh_t *fineMesh = fine->mesh;
+
+  shared->fine = fine;
 
 #ifndef OCCA_VERSION_1_0
-  memcpy(elliptic,baseElliptic,sizeof(elliptic_t));
+  memcpy(&(shared->elliptic),fine,sizeof(elliptic_t));
 #else
 
-  elliptic->dim = baseElliptic->dim;
-  elliptic->elementType = baseElliptic->elementType;
-  elliptic->options = baseElliptic->options;
-  elliptic->tau = baseElliptic->tau;
-  elliptic->BCType = baseElliptic->BCType;
-  elliptic->allNeumann = baseElliptic->allNeumann;
-  elliptic->allNeumannPenalty = baseElliptic->allNeumannPenalty;
+  shared->elliptic.dim = fine->dim;
+  shared->elliptic.elementType = fine->elementType;
+  shared->elliptic.options = fine->options;
+  shared->elliptic.tau = fine->tau;
+  shared->elliptic.BCType = fine->BCType;
+  shared->elliptic.allNeumann = fine->allNeumann;
+  shared->elliptic.allNeumannPenalty = fine->allNeumannPenalty;
     
-  elliptic->sendBuffer = baseElliptic->sendBuffer;
-  elliptic->recvBuffer = baseElliptic->recvBuffer;
-  elliptic->gradSendBuffer = baseElliptic->gradSendBuffer;
-  elliptic->gradRecvBuffer = baseElliptic->gradRecvBuffer;
-
-  elliptic->defaultStream = baseElliptic->defaultStream;
-  elliptic->dataStream = baseElliptic->dataStream;
-
-  elliptic->o_EToB = baseElliptic->o_EToB;    
-  elliptic->o_globalGatherElementList = baseElliptic->o_globalGatherElementList;    
-  elliptic->o_localGatherElementList = baseElliptic->o_localGatherElementList;    
-
-  elliptic->o_grad = baseElliptic->o_grad;
-
-  elliptic->o_EXYZ = baseElliptic->o_EXYZ;    
-
-  elliptic->weightedInnerProduct1Kernel = baseElliptic->weightedInnerProduct1Kernel;
-  elliptic->weightedInnerProduct2Kernel = baseElliptic->weightedInnerProduct2Kernel;
-  elliptic->innerProductKernel = baseElliptic->innerProductKernel;
-  elliptic->weightedNorm2Kernel = baseElliptic->weightedNorm2Kernel;
-  elliptic->norm2Kernel = baseElliptic->norm2Kernel;
-  elliptic->scaledAddKernel = baseElliptic->scaledAddKernel;
-  elliptic->dotMultiplyKernel = baseElliptic->dotMultiplyKernel;
-  elliptic->dotDivideKernel = baseElliptic->dotDivideKernel;
+  shared->elliptic.sendBuffer = fine->sendBuffer;
+  shared->elliptic.recvBuffer = fine->recvBuffer;
+  shared->elliptic.gradSendBuffer = fine->gradSendBuffer;
+  shared->elliptic.gradRecvBuffer = fine->gradRecvBuffer;
+
+  shared->elliptic.defaultStream = fine->defaultStream;
+  shared->elliptic.dataStream = fine->dataStream;
+
+  shared->elliptic.o_EToB = fine->o_EToB;    
+  shared->elliptic.o_globalGatherElementList = fine->o_globalGatherElementList;    
+  shared->elliptic.o_localGatherElementList = fine->o_localGatherElementList;    
+
+  // workspace sized for the fine degree
+  shared->elliptic.o_grad = fine->o_grad;
+
+  shared->elliptic.o_EXYZ = fine->o_EXYZ;    
+
+  shared->elliptic.weightedInnerProduct1Kernel = fine->weightedInnerProduct1Kernel;
+  shared->elliptic.weightedInnerProduct2Kernel = fine->weightedInnerProduct2Kernel;
+  shared->elliptic.innerProductKernel = fine->innerProductKernel;
+  shared->elliptic.weightedNorm2Kernel = fine->weightedNorm2Kernel;
+  shared->elliptic.norm2Kernel = fine->norm2Kernel;
+  shared->elliptic.scaledAddKernel = fine->scaledAddKernel;
+  shared->elliptic.dotMultiplyKernel = fine->dotMultiplyKernel;
+  shared->elliptic.dotDivideKernel = fine->dotDivideKernel;
 #endif
-    
-  //populate the mini-mesh using the mesh struct
-  mesh_t *mesh = (mesh_t*) calloc(1,sizeof(mesh_t));
 
 #ifndef OCCA_VERSION_1_0
-  memcpy(mesh,baseElliptic->mesh,sizeof(mesh_t));
+  memcpy(&(shared->mesh),fine->mesh,sizeof(mesh_t));
 #else
-  mesh->rank = baseElliptic->mesh->rank;
-  mesh->size = baseElliptic->mesh->size;
+  shared->mesh.rank = fineMesh->rank;
+  shared->mesh.size = fineMesh->size;
 
-  MPI_Comm_dup(baseElliptic->mesh->comm, &(mesh->comm));
+  // levels are only ever used one at a time so they share the communicator
+  shared->mesh.comm = fineMesh->comm;
     
-  mesh->dim = baseElliptic->mesh->dim;
-  mesh->Nverts        = baseElliptic->mesh->Nverts;
-  mesh->Nfaces        = baseElliptic->mesh->Nfaces;
-  mesh->NfaceVertices = baseElliptic->mesh->NfaceVertices;
+  shared->mesh.dim = fineMesh->dim;
+  shared->mesh.Nverts        = fineMesh->Nverts;
+  shared->mesh.Nfaces        = fineMesh->Nfaces;
+  shared->mesh.NfaceVertices = fineMesh->NfaceVertices;
 
-  mesh->Nnodes = baseElliptic->mesh->Nnodes;
-  mesh->EX = baseElliptic->mesh->EX; // coordinates of vertices for each element
-  mesh->EY = baseElliptic->mesh->EY;
-  mesh->EZ = baseElliptic->mesh->EZ;
+  shared->mesh.Nnodes = fineMesh->Nnodes;
+  shared->mesh.EX = fineMesh->EX; // coordinates of vertices for each element
+  shared->mesh.EY = fineMesh->EY;
+  shared->mesh.EZ = fineMesh->EZ;
 
-  mesh->Nelements = baseElliptic->mesh->Nelements;
-  mesh->EToV = baseElliptic->mesh->EToV; // element-to-vertex connectivity
-  mesh->EToE = baseElliptic->mesh->EToE; // element-to-element connectivity
-  mesh->EToF = baseElliptic->mesh->EToF; // element-to-(local)face connectivity
-  mesh->EToP = baseElliptic->mesh->EToP; // element-to-partition/process connectivity
-  mesh->EToB = baseElliptic->mesh->EToB; // element-to-boundary condition type
+  shared->mesh.Nelements = fineMesh->Nelements;
+  shared->mesh.EToV = fineMesh->EToV; // element-to-vertex connectivity
+  shared->mesh.EToE = fineMesh->EToE; // element-to-element connectivity
+  shared->mesh.EToF = fineMesh->EToF; // element-to-(local)face connectivity
+  shared->mesh.EToP = fineMesh->EToP; // element-to-partition/process connectivity
+  shared->mesh.EToB = fineMesh->EToB; // element-to-boundary condition type
 
-  mesh->elementInfo = baseElliptic->mesh->elementInfo;
+  shared->mesh.elementInfo = fineMesh->elementInfo;
 
   // boundary faces
-  mesh->NboundaryFaces = baseElliptic->mesh->NboundaryFaces;
-  mesh->boundaryInfo = baseElliptic->mesh->boundaryInfo;
+  shared->mesh.NboundaryFaces = fineMesh->NboundaryFaces;
+  shared->mesh.boundaryInfo = fineMesh->boundaryInfo;
 
   // MPI halo exchange info
-  mesh->totalHaloPairs = baseElliptic->mesh->totalHaloPairs;
-  mesh->haloElementList = baseElliptic->mesh->haloElementList;
-  mesh->NhaloPairs = baseElliptic->mesh->NhaloPairs;
-  mesh->NhaloMessages = baseElliptic->mesh->NhaloMessages;
-
-  mesh->haloSendRequests = baseElliptic->mesh->haloSendRequests;
-  mesh->haloRecvRequests = baseElliptic->mesh->haloRecvRequests;
+  shared->mesh.totalHaloPairs = fineMesh->totalHaloPairs;
+  shared->mesh.haloElementList = fineMesh->haloElementList;
+  shared->mesh.NhaloPairs = fineMesh->NhaloPairs;
+  shared->mesh.NhaloMessages = fineMesh->NhaloMessages;
+  shared->mesh.haloNeighbors = fineMesh->haloNeighbors;
+  shared->mesh.haloNeighborOffsets = fineMesh->haloNeighborOffsets;
+
+  shared->mesh.haloSendRequests = fineMesh->haloSendRequests;
+  shared->mesh.haloRecvRequests = fineMesh->haloRecvRequests;
+  shared->mesh.haloPlans = fineMesh->haloPlans; // freed with the base mesh
+
+  shared->mesh.NinternalElements = fineMesh->NinternalElements;
+  shared->mesh.NnotInternalElements = fineMesh->NnotInternalElements;
+
+  shared->mesh.o_haloElementList = fineMesh->o_haloElementList;
+  shared->mesh.o_haloBuffer      = fineMesh->o_haloBuffer;
+  shared->mesh.o_internalElementIds    = fineMesh->o_internalElementIds;
+  shared->mesh.o_notInternalElementIds = fineMesh->o_notInternalElementIds;
+
+  // triangles and tets have one set of geometric factors per element, quad and hex
+  // factors are per node and are built by each level
+  if(fine->elementType==TRIANGLES || fine->elementType==TETRAHEDRA){
+    shared->mesh.Nvgeo = fineMesh->Nvgeo;
+    shared->mesh.vgeo = fineMesh->vgeo;
+    shared->mesh.o_vgeo = fineMesh->o_vgeo;
+
+    shared->mesh.Nggeo = fineMesh->Nggeo;
+    shared->mesh.ggeo = fineMesh->ggeo;
+    shared->mesh.o_ggeo = fineMesh->o_ggeo;
+
+    shared->mesh.Nsgeo = fineMesh->Nsgeo;
+    shared->mesh.sgeo = fineMesh->sgeo;
+    shared->mesh.o_sgeo = fineMesh->o_sgeo;
+  }
 
-  mesh->NinternalElements = baseElliptic->mesh->NinternalElements;
-  mesh->NnotInternalElements = baseElliptic->mesh->NnotInternalElements;
+  // occa stuff
+  shared->mesh.device = fineMesh->device;
+
+  shared->mesh.defaultStream = fineMesh->defaultStream;
+  shared->mesh.dataStream = fineMesh->dataStream;
+
+  shared->mesh.haloExtractKernel = fineMesh->haloExtractKernel;
+  shared->mesh.gatherKernel = fineMesh->gatherKernel;
+  shared->mesh.scatterKernel = fineMesh->scatterKernel;
+  shared->mesh.gatherScatterKernel = fineMesh->gatherScatterKernel;
+  shared->mesh.getKernel = fineMesh->getKernel;
+  shared->mesh.putKernel = fineMesh->putKernel;
+  shared->mesh.ogsExchangePackKernel = fineMesh->ogsExchangePackKernel;
+  shared->mesh.ogsExchangeAddKernel = fineMesh->ogsExchangeAddKernel;
+  shared->mesh.ogsExchangeUnpackKernel = fineMesh->ogsExchangeUnpackKernel;
+  shared->mesh.addScalarKernel = fineMesh->addScalarKernel;
+  shared->mesh.maskKernel = fineMesh->maskKernel;
+  shared->mesh.sumKernel = fineMesh->sumKernel;
+#endif
 
-  mesh->o_haloElementList = baseElliptic->mesh->o_haloElementList;
-  mesh->o_haloBuffer      = baseElliptic->mesh->o_haloBuffer;
-  mesh->o_internalElementIds    = baseElliptic->mesh->o_internalElementIds;
-  mesh->o_notInternalElementIds = baseElliptic->mesh->o_notInternalElementIds;
+  shared->sharedBytes =
+      ellipticLevelSharedBytes(shared->mesh.o_haloElementList)
+    + ellipticLevelSharedBytes(shared->mesh.o_haloBuffer)
+    + ellipticLevelSharedBytes(shared->mesh.o_internalElementIds)
+    + ellipticLevelSharedBytes(shared->mesh.o_notInternalElementIds)
+    + ellipticLevelSharedBytes(shared->mesh.o_vgeo)
+    + ellipticLevelSharedBytes(shared->mesh.o_ggeo)
+    + ellipticLevelSharedBytes(shared->mesh.o_sgeo)
+    + ellipticLevelSharedBytes(shared->elliptic.o_EToB)
+    + ellipticLevelSharedBytes(shared->elliptic.o_globalGatherElementList)
+    + ellipticLevelSharedBytes(shared->elliptic.o_localGatherElementList)
+    + ellipticLevelSharedBytes(shared->elliptic.o_grad)
+    + ellipticLevelSharedBytes(shared->elliptic.o_EXYZ);
+
+  return shared;
+}
 
-  // volumeGeometricFactors;
-  mesh->Nvgeo = baseElliptic->mesh->Nvgeo;
-  mesh->vgeo = baseElliptic->mesh->vgeo;
-  mesh->o_vgeo = baseElliptic->mesh->o_vgeo;
+// create elliptic and mesh structs for a multigrid level of degree Nc. The level starts
+// as a copy of the shared N-independent data and only its degree dependent data is built
+elliptic_t *ellipticBuildMultigridLevel(ellipticLevelShared_t *shared, int Nc, int Nf){
 
-  // second order volume geometric factors
-  mesh->Nggeo = baseElliptic->mesh->Nggeo;
-  mesh->ggeo = baseElliptic->mesh->ggeo;
-  mesh->o_ggeo = baseElliptic->mesh->o_ggeo;
+  elliptic_t *elliptic = (elliptic_t*) calloc(1, sizeof(elliptic_t));
+  *elliptic = shared->elliptic;
 
-  mesh->Nsgeo = baseElliptic->mesh->Nsgeo;
-  mesh->sgeo = baseElliptic->mesh->sgeo;
-  mesh->o_sgeo = baseElliptic->mesh->o_sgeo;
+  //populate the mini-mesh using the shared mesh data
+  mesh_t *mesh = (mesh_t*) calloc(1,sizeof(mesh_t));
+  *mesh = shared->mesh;
 
-  // occa stuff
-  mesh->device = baseElliptic->mesh->device;
-
-  mesh->defaultStream = baseElliptic->mesh->defaultStream;
-  mesh->dataStream = baseElliptic->mesh->dataStream;
-
-  mesh->haloExtractKernel = baseElliptic->mesh->haloExtractKernel;
-  mesh->gatherKernel = baseElliptic->mesh->gatherKernel;
-  mesh->scatterKernel = baseElliptic->mesh->scatterKernel;
-  mesh->gatherScatterKernel = baseElliptic->mesh->gatherScatterKernel;
-  mesh->getKernel = baseElliptic->mesh->getKernel;
-  mesh->putKernel = baseElliptic->mesh->putKernel;
-  mesh->addScalarKernel = baseElliptic->mesh->addScalarKernel;
-  mesh->maskKernel = baseElliptic->mesh->maskKernel;
-  mesh->sumKernel = baseElliptic->mesh->sumKernel;
-#endif
-    
   elliptic->mesh = mesh;
 
   setupAide options = elliptic->options;
@@ -214,6 +257,16 @@ elliptic_t *ellipticBuildMultigridLevel(elliptic_t *baseElliptic, int Nc, int Nf
   // global nodes
   meshParallelConnectNodes(mesh);
 
+  // recomputed geometric factors are built from the node coordinates on the DEVICE
+  if(ellipticElementMapType(elliptic)==ELEMENT_MAP_RECOMPUTE){
+    mesh->o_x = mesh->device.malloc(localNodes*sizeof(dfloat), mesh->x);
+    mesh->o_y = mesh->device.malloc(localNodes*sizeof(dfloat), mesh->y);
+    if (elliptic->dim==3)
+      mesh->o_z = mesh->device.malloc(localNodes*sizeof(dfloat), mesh->z);
+    else
+      mesh->o_z = mesh->o_y; // dummy z variables (not used)
+  }
+
   //dont need these once vmap is made
   free(mesh->x);
   free(mesh->y);
@@ -224,10 +277,8 @@ elliptic_t *ellipticBuildMultigridLevel(elliptic_t *baseElliptic, int Nc, int Nf
 
   dlong Ntotal = mesh->Np*mesh->Nelements;
   dlong Nblock = mymax(1,(Ntotal+blockSize-1)/blockSize);
-  dlong Nblock2 = mymax(1,(Nblock+blockSize-1)/blockSize);
 
   elliptic->Nblock = Nblock;
-  elliptic->Nblock2 = Nblock2;
 
   if (elliptic->elementType==TRIANGLES) {
 
@@ -419,20 +470,24 @@ elliptic_t *ellipticBuildMultigridLevel(elliptic_t *baseElliptic, int Nc, int Nf
     }
 
     mesh->o_D = mesh->device.malloc(mesh->Nq*mesh->Nq*sizeof(dfloat), mesh->D);
-    mesh->o_Dmatrices = mesh->device.malloc(mesh->Nq*mesh->Nq*sizeof(dfloat), mesh->D);
-    mesh->o_Smatrices = mesh->device.malloc(mesh->Nq*mesh->Nq*sizeof(dfloat), mesh->D); //dummy
+    mesh->o_Dmatrices = mesh->o_D;
+    mesh->o_Smatrices = mesh->o_D; //dummy
+
+    // the continuous Ax only reads ggeo, the volume and surface factors are IPDG only
+    if(options.compareArgs("DISCRETIZATION","IPDG")){
+      mesh->o_vgeo =
+        mesh->device.malloc(mesh->Nelements*mesh->Nvgeo*mesh->Np*sizeof(dfloat),
+                            mesh->vgeo);
+      mesh->o_sgeo =
+        mesh->device.malloc(mesh->Nelements*mesh->Nfaces*mesh->Nfp*mesh->Nsgeo*sizeof(dfloat),
+                            mesh->sgeo);
+    }
+    if(ellipticElementMapType(elliptic)!=ELEMENT_MAP_RECOMPUTE)
+      mesh->o_ggeo =
+        mesh->device.malloc(mesh->Nelements*mesh->Np*mesh->Nggeo*sizeof(dfloat),
+                            mesh->ggeo);
 
-    mesh->o_vgeo =
-      mesh->device.malloc(mesh->Nelements*mesh->Nvgeo*mesh->Np*sizeof(dfloat),
-			  mesh->vgeo);
-    mesh->o_sgeo =
-      mesh->device.malloc(mesh->Nelements*mesh->Nfaces*mesh->Nfp*mesh->Nsgeo*sizeof(dfloat),
-			  mesh->sgeo);
-    mesh->o_ggeo =
-      mesh->device.malloc(mesh->Nelements*mesh->Np*mesh->Nggeo*sizeof(dfloat),
-			  mesh->ggeo);
-
-    mesh->o_LIFTT = baseElliptic->mesh->o_LIFTT; //dummy buffer
+    mesh->o_LIFTT = shared->fine->mesh->o_LIFTT; //dummy buffer
     
   } else if (elliptic->elementType==TETRAHEDRA) {
 
@@ -582,34 +637,31 @@ elliptic_t *ellipticBuildMultigridLevel(elliptic_t *baseElliptic, int Nc, int Nf
     }
 
     mesh->o_D = mesh->device.malloc(mesh->Nq*mesh->Nq*sizeof(dfloat), mesh->D);
-    mesh->o_Dmatrices = mesh->device.malloc(mesh->Nq*mesh->Nq*sizeof(dfloat), mesh->D);
-    mesh->o_Smatrices = mesh->device.malloc(mesh->Nq*mesh->Nq*sizeof(dfloat), mesh->D); //dummy
-
-    mesh->o_vgeo =
-      mesh->device.malloc(mesh->Nelements*mesh->Nvgeo*mesh->Np*sizeof(dfloat),
-			  mesh->vgeo);
-    mesh->o_sgeo =
-      mesh->device.malloc(mesh->Nelements*mesh->Nfaces*mesh->Nfp*mesh->Nsgeo*sizeof(dfloat),
-			  mesh->sgeo);
-    mesh->o_ggeo =
-      mesh->device.malloc(mesh->Nelements*mesh->Np*mesh->Nggeo*sizeof(dfloat),
-			  mesh->ggeo);
-
-    mesh->o_vmapM =
-      mesh->device.malloc(mesh->Nelements*mesh->Nfp*mesh->Nfaces*sizeof(dlong),
-			  mesh->vmapM);
-
-    mesh->o_vmapP =
-      mesh->device.malloc(mesh->Nelements*mesh->Nfp*mesh->Nfaces*sizeof(dlong),
-			  mesh->vmapP);
+    mesh->o_Dmatrices = mesh->o_D;
+    mesh->o_Smatrices = mesh->o_D; //dummy
+
+    // the continuous Ax only reads ggeo, the volume and surface factors are IPDG only
+    if(options.compareArgs("DISCRETIZATION","IPDG")){
+      mesh->o_vgeo =
+        mesh->device.malloc(mesh->Nelements*mesh->Nvgeo*mesh->Np*sizeof(dfloat),
+                            mesh->vgeo);
+      mesh->o_sgeo =
+        mesh->device.malloc(mesh->Nelements*mesh->Nfaces*mesh->Nfp*mesh->Nsgeo*sizeof(dfloat),
+                            mesh->sgeo);
+    }
+    if(ellipticElementMapType(elliptic)!=ELEMENT_MAP_RECOMPUTE)
+      mesh->o_ggeo =
+        mesh->device.malloc(mesh->Nelements*mesh->Np*mesh->Nggeo*sizeof(dfloat),
+                            mesh->ggeo);
 
-    mesh->LIFT = baseElliptic->mesh->LIFT; //dummy buffer
-    mesh->o_LIFTT = baseElliptic->mesh->o_LIFTT; //dummy buffer
+    mesh->LIFT = shared->fine->mesh->LIFT; //dummy buffer
+    mesh->o_LIFTT = shared->fine->mesh->o_LIFTT; //dummy buffer
   }
 
 
   //fill geometric factors in halo
-  if(mesh->totalHaloPairs && (elliptic->elementType==QUADRILATERALS || elliptic->elementType==HEXAHEDRA)){
+  if(mesh->totalHaloPairs && options.compareArgs("DISCRETIZATION","IPDG") &&
+     (elliptic->elementType==QUADRILATERALS || elliptic->elementType==HEXAHEDRA)){
     dlong Nlocal = mesh->Np*mesh->Nelements;
     dlong Nhalo = mesh->totalHaloPairs*mesh->Np;
     dfloat *vgeoSendBuffer = (dfloat*) calloc(Nhalo*mesh->Nvgeo, sizeof(dfloat));
@@ -632,13 +684,19 @@ elliptic_t *ellipticBuildMultigridLevel(elliptic_t *baseElliptic, int Nc, int Nf
     mesh->device.malloc(mesh->Np*mesh->Np*sizeof(dfloat),
 			mesh->MM);
 
-  mesh->o_vmapM =
-    mesh->device.malloc(mesh->Nelements*mesh->Nfp*mesh->Nfaces*sizeof(int),
-			mesh->vmapM);
+  // face node maps are only read by the IPDG kernels
+  if(options.compareArgs("DISCRETIZATION","IPDG")){
+    mesh->o_vmapM =
+      mesh->device.malloc(mesh->Nelements*mesh->Nfp*mesh->Nfaces*sizeof(dlong),
+                          mesh->vmapM);
 
-  mesh->o_vmapP =
-    mesh->device.malloc(mesh->Nelements*mesh->Nfp*mesh->Nfaces*sizeof(int),
-			mesh->vmapP);
+    mesh->o_vmapP =
+      mesh->device.malloc(mesh->Nelements*mesh->Nfp*mesh->Nfaces*sizeof(dlong),
+                          mesh->vmapP);
+  } else {
+    mesh->o_vmapM = occa::memory();
+    mesh->o_vmapP = occa::memory();
+  }
 
   
   //set the normalization constant for the allNeumann Poisson problem on this coarse mesh
@@ -647,9 +705,8 @@ elliptic_t *ellipticBuildMultigridLevel(elliptic_t *baseElliptic, int Nc, int Nf
   MPI_Allreduce(&localElements, &totalElements, 1, MPI_HLONG, MPI_SUM, mesh->comm);
   elliptic->allNeumannScale = 1.0/sqrt(mesh->Np*totalElements);
 
-  elliptic->tmp = (dfloat*) calloc(Nblock, sizeof(dfloat));
-  elliptic->o_tmp = mesh->device.malloc(Nblock*sizeof(dfloat), elliptic->tmp);
-  elliptic->o_tmp2 = mesh->device.malloc(Nblock2*sizeof(dfloat), elliptic->tmp);
+  // room for two partial sums per block, as in ellipticSolveSetup
+  elliptic->tmp = (dfloat*) occaHostMallocPinned(mesh->device, 2*Nblock*sizeof(dfloat), NULL, elliptic->o_tmp);
 
   // info for kernel construction
   occa::properties kernelInfo;
@@ -756,8 +813,8 @@ elliptic_t *ellipticBuildMultigridLevel(elliptic_t *baseElliptic, int Nc, int Nf
 
   char fileName[BUFSIZ], kernelName[BUFSIZ];
 
-  for (int r=0;r<mesh->size;r++) {
-    if (r==mesh->rank) {
+  for (int r=0;r<meshBuildKernelStages;r++) {
+    if (r==meshBuildKernelStage(mesh)) {
       kernelInfo["defines/" "p_blockSize"]= blockSize;
 
       // add custom defines
@@ -802,59 +859,51 @@ elliptic_t *ellipticBuildMultigridLevel(elliptic_t *baseElliptic, int Nc, int Nf
       
       sprintf(fileName, DELLIPTIC "/okl/ellipticAx%s.okl", suffix);
       sprintf(kernelName, "ellipticAx%s", suffix);
-      elliptic->AxKernel = mesh->device.buildKernel(fileName,kernelName,dfloatKernelInfo);
+      elliptic->AxKernel = meshBuildKernel(mesh, fileName,kernelName,dfloatKernelInfo);
 
-      // check for trilinear
-      if(elliptic->elementType!=HEXAHEDRA){
-	sprintf(kernelName, "ellipticPartialAx%s", suffix);
-      }
-      else{
-	if(elliptic->options.compareArgs("ELEMENT MAP", "TRILINEAR")){
-	  sprintf(kernelName, "ellipticPartialAxTrilinear%s", suffix);
-	}else{
-	  sprintf(kernelName, "ellipticPartialAx%s", suffix);
-	}
-      }
+      // check for trilinear or recomputed geometric factors
+      ellipticPartialAxKernelName(elliptic, suffix, kernelName);
 
-      //sprintf(kernelName, "ellipticPartialAx%s", suffix);
-      
-      elliptic->partialAxKernel = mesh->device.buildKernel(fileName,kernelName,dfloatKernelInfo);
+      elliptic->partialAxKernel = meshBuildKernel(mesh, fileName,kernelName,dfloatKernelInfo);
 
-      elliptic->partialFloatAxKernel = mesh->device.buildKernel(fileName,kernelName,floatKernelInfo);
+      // level operators only run in single precision with MULTIGRID PRECISION=FLOAT
+      if (options.compareArgs("MULTIGRID PRECISION","FLOAT"))
+        elliptic->partialFloatAxKernel = meshBuildKernel(mesh, fileName,kernelName,floatKernelInfo);
       
-      if (options.compareArgs("BASIS", "BERN")) {
+      // the gradient and IPDG kernels are not needed by the continuous levels
+      if (options.compareArgs("DISCRETIZATION", "IPDG") && options.compareArgs("BASIS", "BERN")) {
 
         sprintf(fileName, DELLIPTIC "/okl/ellipticGradientBB%s.okl", suffix);
         sprintf(kernelName, "ellipticGradientBB%s", suffix);
 
-        elliptic->gradientKernel = mesh->device.buildKernel(fileName,kernelName,kernelInfo);
+        elliptic->gradientKernel = meshBuildKernel(mesh, fileName,kernelName,kernelInfo);
 
         sprintf(kernelName, "ellipticPartialGradientBB%s", suffix);
-        elliptic->partialGradientKernel = mesh->device.buildKernel(fileName,kernelName,kernelInfo);
+        elliptic->partialGradientKernel = meshBuildKernel(mesh, fileName,kernelName,kernelInfo);
       
         sprintf(fileName, DELLIPTIC "/okl/ellipticAxIpdgBB%s.okl", suffix);
         sprintf(kernelName, "ellipticAxIpdgBB%s", suffix);
-        elliptic->ipdgKernel = mesh->device.buildKernel(fileName,kernelName,kernelInfo);
+        elliptic->ipdgKernel = meshBuildKernel(mesh, fileName,kernelName,kernelInfo);
 
         sprintf(kernelName, "ellipticPartialAxIpdgBB%s", suffix);
-        elliptic->partialIpdgKernel = mesh->device.buildKernel(fileName,kernelName,kernelInfo);
+        elliptic->partialIpdgKernel = meshBuildKernel(mesh, fileName,kernelName,kernelInfo);
           
-      } else if (options.compareArgs("BASIS", "NODAL")) {
+      } else if (options.compareArgs("DISCRETIZATION", "IPDG") && options.compareArgs("BASIS", "NODAL")) {
 
         sprintf(fileName, DELLIPTIC "/okl/ellipticGradient%s.okl", suffix);
         sprintf(kernelName, "ellipticGradient%s", suffix);
 
-        elliptic->gradientKernel = mesh->device.buildKernel(fileName,kernelName,kernelInfo);
+        elliptic->gradientKernel = meshBuildKernel(mesh, fileName,kernelName,kernelInfo);
 
         sprintf(kernelName, "ellipticPartialGradient%s", suffix);
-        elliptic->partialGradientKernel = mesh->device.buildKernel(fileName,kernelName,kernelInfo);
+        elliptic->partialGradientKernel = meshBuildKernel(mesh, fileName,kernelName,kernelInfo);
 
         sprintf(fileName, DELLIPTIC "/okl/ellipticAxIpdg%s.okl", suffix);
         sprintf(kernelName, "ellipticAxIpdg%s", suffix);
-        elliptic->ipdgKernel = mesh->device.buildKernel(fileName,kernelName,kernelInfo);
+        elliptic->ipdgKernel = meshBuildKernel(mesh, fileName,kernelName,kernelInfo);
 
         sprintf(kernelName, "ellipticPartialAxIpdg%s", suffix);
-        elliptic->partialIpdgKernel = mesh->device.buildKernel(fileName,kernelName,kernelInfo);
+        elliptic->partialIpdgKernel = meshBuildKernel(mesh, fileName,kernelName,kernelInfo);
       }
     }
     MPI_Barrier(mesh->comm);
@@ -863,18 +912,16 @@ elliptic_t *ellipticBuildMultigridLevel(elliptic_t *baseElliptic, int Nc, int Nf
   //new precon struct
   elliptic->precon = (precon_t *) calloc(1,sizeof(precon_t));
 
-  for (int r=0;r<mesh->size;r++) {
-    if (r==mesh->rank) {
+  for (int r=0;r<meshBuildKernelStages;r++) {
+    if (r==meshBuildKernelStage(mesh)) {
       sprintf(fileName, DELLIPTIC "/okl/ellipticBlockJacobiPrecon.okl");
       sprintf(kernelName, "ellipticBlockJacobiPrecon");
-      elliptic->precon->blockJacobiKernel = mesh->device.buildKernel(fileName,kernelName,kernelInfo);
+      elliptic->precon->blockJacobiKernel = meshBuildKernel(mesh, fileName,kernelName,kernelInfo);
 
       sprintf(kernelName, "ellipticPartialBlockJacobiPrecon");
-      elliptic->precon->partialblockJacobiKernel = mesh->device.buildKernel(fileName,kernelName,kernelInfo);
+      elliptic->precon->partialblockJacobiKernel = meshBuildKernel(mesh, fileName,kernelName,kernelInfo);
 
-      sprintf(fileName, DELLIPTIC "/okl/ellipticPatchSolver.okl");
-      sprintf(kernelName, "ellipticApproxBlockJacobiSolver");
-      elliptic->precon->approxBlockJacobiSolverKernel = mesh->device.buildKernel(fileName,kernelName,kernelInfo);
+      ellipticBuildSmootherKernels(elliptic, kernelInfo, suffix);
 
       //sizes for the coarsen and prolongation kernels. degree NFine to degree N
       int NqFine   = (Nf+1);
@@ -911,11 +958,11 @@ elliptic_t *ellipticBuildMultigridLevel(elliptic_t *baseElliptic, int Nc, int Nf
 
       sprintf(fileName, DELLIPTIC "/okl/ellipticPreconCoarsen%s.okl", suffix);
       sprintf(kernelName, "ellipticPreconCoarsen%s", suffix);
-      elliptic->precon->coarsenKernel = mesh->device.buildKernel(fileName,kernelName,kernelInfo);
+      elliptic->precon->coarsenKernel = meshBuildKernel(mesh, fileName,kernelName,kernelInfo);
 
       sprintf(fileName, DELLIPTIC "/okl/ellipticPreconProlongate%s.okl", suffix);
       sprintf(kernelName, "ellipticPreconProlongate%s", suffix);
-      elliptic->precon->prolongateKernel = mesh->device.buildKernel(fileName,kernelName,kernelInfo);
+      elliptic->precon->prolongateKernel = meshBuildKernel(mesh, fileName,kernelName,kernelInfo);
     }
     MPI_Barrier(mesh->comm);
   }
@@ -963,9 +1010,9 @@ elliptic_t *ellipticBuildMultigridLevel(elliptic_t *baseElliptic, int Nc, int Nf
   if (elliptic->Nmasked) elliptic->o_maskIds = mesh->device.malloc(elliptic->Nmasked*sizeof(dlong), elliptic->maskIds);
 
 
-  if(elliptic->elementType==HEXAHEDRA){
+  if(elliptic->elementType==HEXAHEDRA || elliptic->elementType==QUADRILATERALS){
     if(options.compareArgs("DISCRETIZATION","CONTINUOUS")){
-      if(options.compareArgs("ELEMENT MAP", "TRILINEAR")){
+      if(ellipticElementMapType(elliptic)!=ELEMENT_MAP_STORED){
 	
 	// pack gllz, gllw, and elementwise EXYZ
 	dfloat *gllzw = (dfloat*) calloc(2*mesh->Nq, sizeof(dfloat));
@@ -982,6 +1029,7 @@ elliptic_t *ellipticBuildMultigridLevel(elliptic_t *baseElliptic, int Nc, int Nf
     }
   }
 
+  ellipticAxCostRegister(elliptic);
   
   return elliptic;
 }
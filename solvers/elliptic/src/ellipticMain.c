@@ -50,6 +50,9 @@ int main(int argc, char **argv){
   options.getArgs("ELEMENT TYPE", elementType);
   options.getArgs("MESH DIMENSION", dim);
 
+  // optional boundary refinement of the geometric partition
+  meshSetPartitionRefinement(options);
+
   // set up mesh
   mesh_t *mesh;
   switch(elementType){
@@ -93,18 +96,8 @@ int main(int argc, char **argv){
 	ellipticOperator(elliptic, lambda, elliptic->o_x, elliptic->o_Ax, dfloatString); // standard precision
 
       if(options.compareArgs("BENCHMARK", "BK5")){
-	if(!options.compareArgs("ELEMENT MAP", "TRILINEAR")){
-	  elliptic->partialAxKernel(elliptic->NlocalGatherElements,			      
-				    elliptic->o_localGatherElementList,
-				    mesh->o_ggeo, mesh->o_Dmatrices, mesh->o_Smatrices, mesh->o_MM,
-				    lambda, elliptic->o_x, elliptic->o_Ax);
-	}
-	else{
-	  elliptic->partialAxKernel(elliptic->NlocalGatherElements,			      
-				    elliptic->o_localGatherElementList,
-				    elliptic->o_EXYZ, elliptic->o_gllzw, mesh->o_Dmatrices, mesh->o_Smatrices, mesh->o_MM,
-				    lambda, elliptic->o_x, elliptic->o_Ax);
-	}
+	ellipticPartialAx(elliptic, elliptic->partialAxKernel, lambda, elliptic->NlocalGatherElements,
+			  elliptic->o_localGatherElementList, elliptic->o_x, elliptic->o_Ax);
       }
     }
       
@@ -217,7 +210,12 @@ int main(int argc, char **argv){
     ellipticPlotVTUHex3D(mesh, "bah", 0);
   }
 #endif
+
+  meshWriteProfile(mesh, options);
   
+  // release persistent halo requests
+  meshHaloExchangeFree(mesh);
+
   // close down MPI
   MPI_Finalize();
   
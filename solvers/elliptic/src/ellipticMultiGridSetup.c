@@ -31,7 +31,12 @@ void ellipticMultigridAx(void **args, occa::memory &o_x, occa::memory &o_Ax) {
   elliptic_t *elliptic = (elliptic_t *) args[0];
   dfloat *lambda = (dfloat *) args[1];
 
-  ellipticOperator(elliptic,*lambda,o_x,o_Ax, dfloatString); // "float" ); // hard coded for testing (should make an option)
+  // level operators can run in single precision arithmetic (pfloat partial Ax kernels),
+  // level vectors, coarsen/prolongate and the parALMOND coarse solve stay dfloat
+  if (elliptic->options.compareArgs("MULTIGRID PRECISION","FLOAT"))
+    ellipticOperator(elliptic,*lambda,o_x,o_Ax, "float");
+  else
+    ellipticOperator(elliptic,*lambda,o_x,o_Ax, dfloatString);
 }
 
 void ellipticMultigridCoarsen(void **args, occa::memory &o_x, occa::memory &o_Rx) {
@@ -166,16 +171,27 @@ void ellipticMultiGridSetup(elliptic_t *elliptic, precon_t* precon, dfloat lambd
 
   //initialize parAlmond
   precon->parAlmond = parAlmondInit(mesh, elliptic->options);
+  precon->parAlmond->lambda = lambda; // eigenvalue cache key
+  ellipticEigenvalueCacheKey(elliptic, precon->parAlmond->eigenvalueCacheKey);
   agmgLevel **levels = precon->parAlmond->levels;
 
+  // device bytes of each level (degree dependent mesh data, operators and smoother)
+  long long int *levelBytes = (long long int *) calloc(numLevels, sizeof(long long int));
+
   //build a elliptic struct for every degree
   elliptic_t **ellipticsN = (elliptic_t**) calloc(mesh->N+1,sizeof(elliptic_t*));
   ellipticsN[mesh->N] = elliptic; //top level
+
+  // coarse levels share the N-independent data of the fine level
+  ellipticLevelShared_t *shared = ellipticLevelSharedSetup(elliptic);
+
   for (int n=1;n<numLevels;n++) {  //build elliptic for this degree
     int Nf = levelDegree[n-1];
     int Nc = levelDegree[n];
     printf("=============BUILDING MULTIGRID LEVEL OF DEGREE %d==================\n", Nc);
-    ellipticsN[Nc] = ellipticBuildMultigridLevel(elliptic,Nc,Nf);
+    long long int pre = mesh->device.memoryAllocated();
+    ellipticsN[Nc] = ellipticBuildMultigridLevel(shared,Nc,Nf);
+    levelBytes[n] = mesh->device.memoryAllocated()-pre;
   }
 
   // set multigrid operators for fine levels
@@ -183,6 +199,8 @@ void ellipticMultiGridSetup(elliptic_t *elliptic, precon_t* precon, dfloat lambd
     int N = levelDegree[n];
     elliptic_t *ellipticL = ellipticsN[N];
 
+    long long int pre = mesh->device.memoryAllocated();
+
     //add the level manually
     precon->parAlmond->numLevels++;
     levels[n] = (agmgLevel *) calloc(1,sizeof(agmgLevel));
@@ -239,19 +257,26 @@ void ellipticMultiGridSetup(elliptic_t *elliptic, precon_t* precon, dfloat lambd
     //set up the fine problem smoothing
     if(options.compareArgs("MULTIGRID SMOOTHER","LOCALPATCH")){
       ellipticSetupSmootherLocalPatch(ellipticL, ellipticL->precon, levels[n], lambda, rateTolerance);
+    } else if(options.compareArgs("MULTIGRID SMOOTHER","SCHWARZ")){
+      ellipticSetupSmootherSchwarz(ellipticL, ellipticL->precon, levels[n], lambda);
     } else { //default to damped jacobi
       ellipticSetupSmootherDampedJacobi(ellipticL, ellipticL->precon, levels[n], lambda);
     }
+
+    levelBytes[n] += mesh->device.memoryAllocated()-pre;
   }
 
+  for (int n=0;n<numLevels;n++)
+    ellipticsN[levelDegree[n]]->precon->levelBytes = levelBytes[n];
+
   //report top levels
   if (options.compareArgs("VERBOSE","TRUE")) {
     if((mesh->rank==0)&&(numLevels>0)) { //report the upper multigrid levels
-      printf("------------------Multigrid Report---------------------\n");
-      printf("-------------------------------------------------------\n");
-      printf("level|  Degree  |    dimension   |      Smoother       \n");
-      printf("     |  Degree  |  (min,max,avg) |      Smoother       \n");
-      printf("-------------------------------------------------------\n");
+      printf("--------------------------Multigrid Report-----------------------------\n");
+      printf("-----------------------------------------------------------------------\n");
+      printf("level|  Degree  |    dimension   |  memory (MB)  |      Smoother       \n");
+      printf("     |  Degree  |  (min,max,avg) |     (max)     |      Smoother       \n");
+      printf("-----------------------------------------------------------------------\n");
     }
 
     for(int lev=0; lev<numLevels; lev++){
@@ -270,19 +295,29 @@ void ellipticMultiGridSetup(elliptic_t *elliptic, precon_t* precon, dfloat lambd
       if (Nrows==0) Nrows=maxNrows; //set this so it's ignored for the global min
       MPI_Allreduce(&Nrows, &minNrows, 1, MPI_DLONG, MPI_MIN, mesh->comm);
 
+      long long int maxBytes = 0;
+      MPI_Allreduce(levelBytes+lev, &maxBytes, 1, MPI_LONG_LONG_INT, MPI_MAX, mesh->comm);
+
       char smootherString[BUFSIZ];
       strcpy(smootherString, (char*) (options.getArgs("MULTIGRID SMOOTHER")).c_str());
 
       if (mesh->rank==0){
-        printf(" %3d |   %3d    |    %10.2f  |   %s  \n",
-          lev, levelDegree[lev], (dfloat)minNrows, smootherString);
-        printf("     |          |    %10.2f  |   \n", (dfloat)maxNrows);
-        printf("     |          |    %10.2f  |   \n", avgNrows);
+        printf(" %3d |   %3d    |    %10.2f  |   %9.2f   |   %s  \n",
+          lev, levelDegree[lev], (dfloat)minNrows, maxBytes/1.E6, smootherString);
+        printf("     |          |    %10.2f  |               |   \n", (dfloat)maxNrows);
+        printf("     |          |    %10.2f  |               |   \n", avgNrows);
       }
     }
-    if((mesh->rank==0)&&(numLevels>0)) 
-      printf("-------------------------------------------------------\n");
+    long long int maxSharedBytes = 0;
+    MPI_Allreduce(&(shared->sharedBytes), &maxSharedBytes, 1, MPI_LONG_LONG_INT, MPI_MAX, mesh->comm);
+
+    if((mesh->rank==0)&&(numLevels>0)) {
+      printf("-----------------------------------------------------------------------\n");
+      printf(" %-32s|   %9.2f   |\n", "shared level data", maxSharedBytes/1.E6);
+      printf("-----------------------------------------------------------------------\n");
+    }
   }
+  free(levelBytes);
 
   /* build degree 1 problem and pass to AMG */
   nonZero_t *coarseA;
@@ -26,12 +26,92 @@ SOFTWARE.
 
 #include "elliptic.h"
 
+// ELEMENT_MAP_* used by the continuous partial Ax kernels
+int ellipticElementMapType(elliptic_t *elliptic){
+
+  if((elliptic->elementType==HEXAHEDRA || elliptic->elementType==QUADRILATERALS) &&
+     elliptic->options.compareArgs("ELEMENT MAP", "RECOMPUTE")) return ELEMENT_MAP_RECOMPUTE;
+
+  if(elliptic->elementType==HEXAHEDRA &&
+     elliptic->options.compareArgs("ELEMENT MAP", "TRILINEAR")) return ELEMENT_MAP_TRILINEAR;
+
+  return ELEMENT_MAP_STORED;
+}
+
+// multigrid levels of lower degree run this operator too, so the Ax timer is keyed by degree
+static void ellipticAxTimerName(mesh_t *mesh, char *name){
+  sprintf(name, "AxKernel N=%d", mesh->N);
+}
+
+void ellipticAxCostRegister(elliptic_t *elliptic){
+
+  mesh_t *mesh = elliptic->mesh;
+  const int dim = elliptic->dim;
+  const double Np = mesh->Np;
+  double Dflops, Gbytes;
+  meshKernelCostFactors(mesh, elliptic->elementType, &Dflops, &Gbytes);
+
+  // geometric factors read by the partial Ax for the element map in use
+  double geoBytes = Gbytes*mesh->Nggeo/mesh->Nvgeo;
+  if(ellipticElementMapType(elliptic)==ELEMENT_MAP_TRILINEAR) geoBytes = mesh->Nverts*dim*sizeof(dfloat);
+  if(ellipticElementMapType(elliptic)==ELEMENT_MAP_RECOMPUTE) geoBytes = Np*dim*sizeof(dfloat);
+
+  double flops;
+  if(elliptic->elementType==QUADRILATERALS || elliptic->elementType==HEXAHEDRA){
+    // gradient, geometric factor contraction, weak divergence and mass term
+    flops = Np*(2.*dim*Dflops + 2.*dim*dim + 2.);
+  }else{
+    // one pass per stiffness matrix plus the mass matrix
+    const int NS = (dim==2) ? 3:6;
+    flops = Np*(2.*Np*(NS+1) + 2.*NS + 2.);
+  }
+
+  char name[BUFSIZ];
+  ellipticAxTimerName(mesh, name);
+  occaTimerRegister(name, flops, 2.*Np*sizeof(dfloat) + geoBytes);
+}
+
+// partial Ax kernel matching the element map
+void ellipticPartialAxKernelName(elliptic_t *elliptic, const char *suffix, char *kernelName){
+
+  switch(ellipticElementMapType(elliptic)){
+  case ELEMENT_MAP_TRILINEAR: sprintf(kernelName, "ellipticPartialAxTrilinear%s", suffix); break;
+  case ELEMENT_MAP_RECOMPUTE: sprintf(kernelName, "ellipticPartialAxRecompute%s", suffix); break;
+  default: sprintf(kernelName, "ellipticPartialAx%s", suffix);
+  }
+}
+
+// continuous Ax on a list of elements, the argument list depends on the element map
+void ellipticPartialAx(elliptic_t *elliptic, occa::kernel &partialAxKernel, dfloat lambda,
+                       dlong Nelements, occa::memory &o_elementList, occa::memory &o_q, occa::memory &o_Aq){
+
+  mesh_t *mesh = elliptic->mesh;
+
+  switch(ellipticElementMapType(elliptic)){
+  case ELEMENT_MAP_STORED:
+    partialAxKernel(Nelements, o_elementList,
+                    mesh->o_ggeo, mesh->o_Dmatrices, mesh->o_Smatrices, mesh->o_MM, lambda, o_q, o_Aq);
+    break;
+  case ELEMENT_MAP_TRILINEAR:
+    partialAxKernel(Nelements, o_elementList,
+                    elliptic->o_EXYZ, elliptic->o_gllzw, mesh->o_Dmatrices, mesh->o_Smatrices, mesh->o_MM, lambda, o_q, o_Aq);
+    break;
+  case ELEMENT_MAP_RECOMPUTE:
+    partialAxKernel(Nelements, o_elementList,
+                    mesh->o_x, mesh->o_y, mesh->o_z, elliptic->o_gllzw,
+                    mesh->o_Dmatrices, mesh->o_Smatrices, mesh->o_MM, lambda, o_q, o_Aq);
+    break;
+  }
+}
+
 void ellipticOperator(elliptic_t *elliptic, dfloat lambda, occa::memory &o_q, occa::memory &o_Aq, const char *precision){
 
   mesh_t *mesh = elliptic->mesh;
   setupAide options = elliptic->options;
 
-  occaTimerTic(mesh->device,"AxKernel");
+  char AxTimer[BUFSIZ];
+  ellipticAxTimerName(mesh, AxTimer);
+  occaTimerTic(mesh->device,AxTimer);
 
   dfloat *sendBuffer = elliptic->sendBuffer;
   dfloat *recvBuffer = elliptic->recvBuffer;
@@ -49,67 +129,30 @@ void ellipticOperator(elliptic_t *elliptic, dfloat lambda, occa::memory &o_q, oc
   if(options.compareArgs("DISCRETIZATION", "CONTINUOUS")){
     ogs_t *ogs = elliptic->mesh->ogs;
 
-    int mapType = (elliptic->elementType==HEXAHEDRA &&
-		   options.compareArgs("ELEMENT MAP", "TRILINEAR")) ? 1:0;
-
     occa::kernel &partialAxKernel = (strstr(precision, "float")) ? elliptic->partialFloatAxKernel : elliptic->partialAxKernel;
     
-    if(elliptic->NglobalGatherElements) {
-      if(mapType==0)
-	partialAxKernel(elliptic->NglobalGatherElements, elliptic->o_globalGatherElementList,
-			mesh->o_ggeo, mesh->o_Dmatrices, mesh->o_Smatrices, mesh->o_MM, lambda, o_q, o_Aq);
-      else
-	partialAxKernel(elliptic->NglobalGatherElements, elliptic->o_globalGatherElementList,
-			elliptic->o_EXYZ, elliptic->o_gllzw, mesh->o_Dmatrices, mesh->o_Smatrices, mesh->o_MM, lambda, o_q, o_Aq);
-    }
-    if(ogs->NhaloGather) {
-      mesh->gatherKernel(ogs->NhaloGather, ogs->o_haloGatherOffsets, ogs->o_haloGatherLocalIds, one, dOne, o_Aq, ogs->o_haloGatherTmp);
+    if(elliptic->NglobalGatherElements)
+      ellipticPartialAx(elliptic, partialAxKernel, lambda, elliptic->NglobalGatherElements,
+                        elliptic->o_globalGatherElementList, o_q, o_Aq);
 
-      mesh->device.finish();
-      mesh->device.setStream(elliptic->dataStream);
-      
-      ogs->o_haloGatherTmp.copyTo(ogs->haloGatherTmp,"async: true");
+    // start C0 halo gather-scatter (messages overlap the local elements)
+    meshParallelGatherScatterStart(mesh, ogs, o_Aq, one, dOne);
 
-      mesh->device.setStream(elliptic->defaultStream);
-    }
-
-    if(elliptic->NlocalGatherElements){
-      if(mapType==0)
-	partialAxKernel(elliptic->NlocalGatherElements, elliptic->o_localGatherElementList,
-				  mesh->o_ggeo, mesh->o_Dmatrices, mesh->o_Smatrices, mesh->o_MM, lambda, o_q, o_Aq);
-      else
-	partialAxKernel(elliptic->NlocalGatherElements, elliptic->o_localGatherElementList,
-			elliptic->o_EXYZ, elliptic->o_gllzw, mesh->o_Dmatrices, mesh->o_Smatrices, mesh->o_MM, lambda, o_q, o_Aq);
-    }
+    if(elliptic->NlocalGatherElements)
+      ellipticPartialAx(elliptic, partialAxKernel, lambda, elliptic->NlocalGatherElements,
+                        elliptic->o_localGatherElementList, o_q, o_Aq);
     
     // finalize gather using local and global contributions
     if(ogs->NnonHaloGather) 
       mesh->gatherScatterKernel(ogs->NnonHaloGather, ogs->o_nonHaloGatherOffsets, ogs->o_nonHaloGatherLocalIds, one, dOne, o_Aq);
 
-    // C0 halo gather-scatter (on data stream)
-    if(ogs->NhaloGather) {
-      mesh->device.setStream(elliptic->dataStream);
-      mesh->device.finish();
-
-      // MPI based gather scatter using libgs
-      gsParallelGatherScatter(ogs->haloGsh, ogs->haloGatherTmp, dfloatString, "add");
-
-      // copy totally gather halo data back from HOST to DEVICE
-      ogs->o_haloGatherTmp.copyFrom(ogs->haloGatherTmp,"async: true");
-
-      mesh->device.finish(); 
-
-      mesh->device.setStream(elliptic->defaultStream);
-      
-      // do scatter back to local nodes
-      mesh->scatterKernel(ogs->NhaloGather, ogs->o_haloGatherOffsets, ogs->o_haloGatherLocalIds, one, dOne, ogs->o_haloGatherTmp, o_Aq);
-    
-    }
+    // finish C0 halo gather-scatter
+    meshParallelGatherScatterFinish(mesh, ogs, o_Aq, one, dOne);
 
     if(elliptic->allNeumann) {
       // mesh->sumKernel(mesh->Nelements*mesh->Np, o_q, o_tmp);
       elliptic->innerProductKernel(mesh->Nelements*mesh->Np, elliptic->o_invDegree, o_q, o_tmp);
-      o_tmp.copyTo(tmp);
+      mesh->device.finish();
 
       for(dlong n=0;n<Nblock;++n)
         alpha += tmp[n];
@@ -199,7 +242,7 @@ void ellipticOperator(elliptic_t *elliptic, dfloat lambda, occa::memory &o_q, oc
     }
 
     if(elliptic->allNeumann) {
-      o_tmp.copyTo(tmp);
+      mesh->device.finish();
 
       for(dlong n=0;n<Nblock;++n)
         alpha += tmp[n];
@@ -275,5 +318,5 @@ void ellipticOperator(elliptic_t *elliptic, dfloat lambda, occa::memory &o_q, oc
       mesh->addScalarKernel(mesh->Nelements*mesh->Np, alphaG, o_Aq);
   } 
 
-  occaTimerToc(mesh->device,"AxKernel");
+  occaTimerToc(mesh->device,AxTimer,mesh->Nelements);
 }
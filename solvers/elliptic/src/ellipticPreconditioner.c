@@ -62,12 +62,11 @@ void ellipticPreconditioner(elliptic_t *elliptic, dfloat lambda,
         precon->partialblockJacobiKernel(elliptic->NglobalGatherElements, 
                                 elliptic->o_globalGatherElementList,
                                 invLambda, mesh->o_vgeo, precon->o_invMM, elliptic->o_rtmp, o_z);
-        mesh->device.finish();
-        mesh->device.setStream(elliptic->dataStream);
-        mesh->gatherKernel(ogs->NhaloGather, ogs->o_haloGatherOffsets, ogs->o_haloGatherLocalIds, one, dOne, o_z, ogs->o_haloGatherTmp);
-        ogs->o_haloGatherTmp.copyTo(ogs->haloGatherTmp,"async: true");
-        mesh->device.setStream(elliptic->defaultStream);
       }
+
+      // start C0 halo gather-scatter (messages overlap the local elements)
+      meshParallelGatherScatterStart(mesh, ogs, o_z, one, dOne);
+
       if(elliptic->NlocalGatherElements){
         precon->partialblockJacobiKernel(elliptic->NlocalGatherElements, 
                                 elliptic->o_localGatherElementList,
@@ -77,26 +76,8 @@ void ellipticPreconditioner(elliptic_t *elliptic, dfloat lambda,
       // finalize gather using local and global contributions
       if(ogs->NnonHaloGather) mesh->gatherScatterKernel(ogs->NnonHaloGather, ogs->o_nonHaloGatherOffsets, ogs->o_nonHaloGatherLocalIds, one, dOne, o_z);
 
-      // C0 halo gather-scatter (on data stream)
-      if(ogs->NhaloGather) {
-        mesh->device.setStream(elliptic->dataStream);
-        mesh->device.finish();
-
-        // MPI based gather scatter using libgs
-        gsParallelGatherScatter(ogs->haloGsh, ogs->haloGatherTmp, dfloatString, "add");
-
-        // copy totally gather halo data back from HOST to DEVICE
-        ogs->o_haloGatherTmp.copyFrom(ogs->haloGatherTmp,"async: true");
-
-        // do scatter back to local nodes
-        mesh->scatterKernel(ogs->NhaloGather, ogs->o_haloGatherOffsets, ogs->o_haloGatherLocalIds, one, dOne, ogs->o_haloGatherTmp, o_z);
-        mesh->device.setStream(elliptic->defaultStream);
-      }
-
-      mesh->device.finish();    
-      mesh->device.setStream(elliptic->dataStream);
-      mesh->device.finish();    
-      mesh->device.setStream(elliptic->defaultStream);
+      // finish C0 halo gather-scatter
+      meshParallelGatherScatterFinish(mesh, ogs, o_z, one, dOne);
 
       elliptic->dotMultiplyKernel(mesh->Nelements*mesh->Np, ogs->o_invDegree, o_z, o_z);
 
@@ -60,6 +60,8 @@ void ellipticPreconditionerSetup(elliptic_t *elliptic, ogs_t *ogs, dfloat lambda
     }
 
     precon->parAlmond = parAlmondInit(mesh, options);
+    precon->parAlmond->lambda = lambda; // eigenvalue cache key
+    ellipticEigenvalueCacheKey(elliptic, precon->parAlmond->eigenvalueCacheKey);
     parAlmondAgmgSetup(precon->parAlmond,
                        globalStarts,
                        nnz,
@@ -152,3 +154,16 @@ void ellipticPreconditionerSetup(elliptic_t *elliptic, ogs_t *ogs, dfloat lambda
     free(invDiagA);
   }
 }
+
+// rebuild the Jacobi diagonal for a new lambda, the other preconditioners are fixed at setup
+void ellipticUpdateJacobi(elliptic_t *elliptic, dfloat lambda){
+
+  mesh_t *mesh = elliptic->mesh;
+
+  if(!elliptic->options.compareArgs("PRECONDITIONER", "JACOBI")) return;
+
+  dfloat *invDiagA;
+  ellipticBuildJacobi(elliptic,lambda,&invDiagA);
+  elliptic->precon->o_invDiagA.copyFrom(invDiagA, mesh->Np*mesh->Nelements*sizeof(dfloat));
+  free(invDiagA);
+}
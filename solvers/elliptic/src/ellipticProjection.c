@@ -0,0 +1,169 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "elliptic.h"
+
+// dots[l] = x_l . W . y for the first L vectors of o_X, one global reduction
+static void ellipticProjectionInnerProducts(elliptic_t *elliptic, int L, occa::memory &o_X,
+                                            occa::memory &o_y, dfloat *dots){
+
+  mesh_t *mesh = elliptic->mesh;
+  dlong Nblock = elliptic->Nblock;
+  dlong Ntotal = mesh->Nelements*mesh->Np;
+
+  dfloat *localDots = elliptic->projectionAlpha;
+
+  elliptic->multiWeightedInnerProductKernel(L, Nblock, Ntotal, elliptic->o_projectionWeight, o_X, o_y,
+                                            elliptic->o_projectionDots);
+
+  // block partial sums land in pinned host memory
+  mesh->device.finish();
+
+  for(int l=0;l<L;++l){
+    localDots[l] = 0;
+    for(dlong n=0;n<Nblock;++n)
+      localDots[l] += elliptic->projectionDots[n+l*Nblock];
+  }
+
+  MPI_Allreduce(localDots, dots, L, MPI_DFLOAT, MPI_SUM, mesh->comm);
+}
+
+// o_y += sum_l alpha[l] x_l over the first L vectors of o_X
+static void ellipticProjectionCombine(elliptic_t *elliptic, int L, dfloat *alpha,
+                                      occa::memory &o_X, occa::memory &o_y){
+
+  mesh_t *mesh = elliptic->mesh;
+  dlong Ntotal = mesh->Nelements*mesh->Np;
+
+  dfloat one = 1.;
+
+  elliptic->o_projectionAlpha.copyFrom(alpha, L*sizeof(dfloat));
+  elliptic->multiScaledAddKernel(L, Ntotal, elliptic->o_projectionAlpha, o_X, one, o_y);
+}
+
+// append o_projectionXnew (with A*Xnew in o_projectionAx) to the basis after
+// A-orthogonalising it against the stored vectors
+static void ellipticProjectionAppend(elliptic_t *elliptic){
+
+  mesh_t *mesh = elliptic->mesh;
+  dlong Ntotal = mesh->Nelements*mesh->Np;
+  int L = elliptic->Nprojection;
+
+  occa::memory &o_xnew = elliptic->o_projectionXnew;
+  occa::memory &o_Axnew = elliptic->o_projectionAx;
+
+  dfloat norm0;
+  ellipticProjectionInnerProducts(elliptic, 1, o_xnew, o_Axnew, &norm0);
+
+  if(L>0){
+    dfloat *beta = elliptic->projectionCoeffs;
+
+    // beta_l = x_l . A xnew, then remove those components from xnew and A xnew
+    ellipticProjectionInnerProducts(elliptic, L, elliptic->o_projectionX, o_Axnew, beta);
+    for(int l=0;l<L;++l) beta[l] = -beta[l];
+
+    ellipticProjectionCombine(elliptic, L, beta, elliptic->o_projectionX, o_xnew);
+    ellipticProjectionCombine(elliptic, L, beta, elliptic->o_projectionB, o_Axnew);
+  }
+
+  dfloat norm;
+  ellipticProjectionInnerProducts(elliptic, 1, o_xnew, o_Axnew, &norm);
+
+  // nothing new in this solution (or it was lost to cancellation)
+  if(!(norm>1e-12*norm0)) return;
+
+  dfloat zero = 0., scale = 1./sqrt(norm);
+  elliptic->scaledAddKernel(Ntotal, zero, o_xnew,  scale, o_xnew);
+  elliptic->scaledAddKernel(Ntotal, zero, o_Axnew, scale, o_Axnew);
+
+  elliptic->o_projectionX.copyFrom(o_xnew,  Ntotal*sizeof(dfloat), L*Ntotal*sizeof(dfloat), 0);
+  elliptic->o_projectionB.copyFrom(o_Axnew, Ntotal*sizeof(dfloat), L*Ntotal*sizeof(dfloat), 0);
+
+  elliptic->Nprojection = L+1;
+}
+
+// x = sum_l (x_l . r) x_l is the A-norm best approximation to A^{-1} r in the
+// span of the stored solutions; the Krylov solver then only sees the remainder
+void ellipticProjectInitialGuess(elliptic_t *elliptic, dfloat lambda, occa::memory &o_r, occa::memory &o_x){
+
+  mesh_t *mesh = elliptic->mesh;
+  dlong Ntotal = mesh->Nelements*mesh->Np;
+  int L = elliptic->Nprojection;
+
+  occa::memory &o_xbar = elliptic->o_projectionXbar;
+
+  // the basis is only A-orthonormal for the operator it was built with
+  if(lambda!=elliptic->projectionLambda){
+    elliptic->Nprojection = 0;
+    elliptic->projectionLambda = lambda;
+    L = 0;
+  }
+
+  if(L==0){
+    // keep the caller's initial guess
+    o_xbar.copyFrom(o_x, Ntotal*sizeof(dfloat));
+    return;
+  }
+
+  dfloat *alpha = elliptic->projectionCoeffs;
+  ellipticProjectionInnerProducts(elliptic, L, elliptic->o_projectionX, o_r, alpha);
+
+  dfloat zero = 0.;
+  elliptic->scaledAddKernel(Ntotal, zero, o_xbar, zero, o_xbar);
+  ellipticProjectionCombine(elliptic, L, alpha, elliptic->o_projectionX, o_xbar);
+
+  o_x.copyFrom(o_xbar, Ntotal*sizeof(dfloat));
+}
+
+// add the correction the Krylov solver made to the projected guess to the
+// basis, when the basis is full it is reset according to PROJECTION RESET
+void ellipticUpdateProjectionSpace(elliptic_t *elliptic, dfloat lambda, occa::memory &o_x){
+
+  mesh_t *mesh = elliptic->mesh;
+  setupAide &options = elliptic->options;
+  dlong Ntotal = mesh->Nelements*mesh->Np;
+
+  occa::memory &o_xnew = elliptic->o_projectionXnew;
+
+  if(elliptic->Nprojection==elliptic->maxProjection){
+    elliptic->Nprojection = 0;
+
+    // CLEAR drops the basis, otherwise restart it from the latest solution
+    if(!options.compareArgs("PROJECTION RESET","CLEAR")){
+      o_xnew.copyFrom(o_x, Ntotal*sizeof(dfloat));
+      ellipticOperator(elliptic, lambda, o_xnew, elliptic->o_projectionAx, dfloatString);
+      ellipticProjectionAppend(elliptic);
+      return;
+    }
+  }
+
+  // dx = x - xbar
+  o_xnew.copyFrom(o_x, Ntotal*sizeof(dfloat));
+  ellipticScaledAdd(elliptic, -1.f, elliptic->o_projectionXbar, 1.f, o_xnew);
+
+  ellipticOperator(elliptic, lambda, o_xnew, elliptic->o_projectionAx, dfloatString);
+  ellipticProjectionAppend(elliptic);
+}
@@ -587,6 +587,8 @@ void ellipticSEMFEMSetup(elliptic_t *elliptic, precon_t* precon, dfloat lambda)
   }
 
   precon->parAlmond = parAlmondInit(mesh, options);
+  precon->parAlmond->lambda = lambda; // eigenvalue cache key
+  ellipticEigenvalueCacheKey(elliptic, precon->parAlmond->eigenvalueCacheKey);
   parAlmondAgmgSetup(precon->parAlmond,
                      globalStarts,
                      nnz,
@@ -60,7 +60,7 @@ elliptic_t *ellipticSetup(mesh_t *mesh, dfloat lambda, occa::properties &kernelI
   // build trilinear geometric factors for hexes (do before solve setup)
   if(elliptic->elementType==HEXAHEDRA){
     if(options.compareArgs("DISCRETIZATION","CONTINUOUS")){
-      if(options.compareArgs("ELEMENT MAP", "TRILINEAR")){
+      if(ellipticElementMapType(elliptic)==ELEMENT_MAP_TRILINEAR){
 	printf("mesh->dim = %d, mesh->Nverts = %d\n", mesh->dim, mesh->Nverts);
 	
 	// pack gllz, gllw, and elementwise EXYZ
@@ -155,12 +155,12 @@ elliptic_t *ellipticSetup(mesh_t *mesh, dfloat lambda, occa::properties &kernelI
 
   //add boundary condition contribution to rhs
   if (options.compareArgs("DISCRETIZATION","IPDG")) {
-    for(int r=0;r<mesh->size;++r){
-      if(r==mesh->rank){
+    for(int r=0;r<meshBuildKernelStages;++r){
+      if(r==meshBuildKernelStage(mesh)){
 	sprintf(fileName, DELLIPTIC "/okl/ellipticRhsBCIpdg%s.okl", suffix);
 	sprintf(kernelName, "ellipticRhsBCIpdg%s", suffix);
 	
-	elliptic->rhsBCIpdgKernel = mesh->device.buildKernel(fileName,kernelName, kernelInfo);
+	elliptic->rhsBCIpdgKernel = meshBuildKernel(mesh, fileName,kernelName, kernelInfo);
       }
       MPI_Barrier(mesh->comm);
     }
@@ -182,17 +182,17 @@ elliptic_t *ellipticSetup(mesh_t *mesh, dfloat lambda, occa::properties &kernelI
   }
 
   if (options.compareArgs("DISCRETIZATION","CONTINUOUS")) {
-    for(int r=0;r<mesh->size;++r){
-      if(r==mesh->rank){
+    for(int r=0;r<meshBuildKernelStages;++r){
+      if(r==meshBuildKernelStage(mesh)){
 	sprintf(fileName, DELLIPTIC "/okl/ellipticRhsBC%s.okl", suffix);
 	sprintf(kernelName, "ellipticRhsBC%s", suffix);
 	
-	elliptic->rhsBCKernel = mesh->device.buildKernel(fileName,kernelName, kernelInfo);
+	elliptic->rhsBCKernel = meshBuildKernel(mesh, fileName,kernelName, kernelInfo);
 	
 	sprintf(fileName, DELLIPTIC "/okl/ellipticAddBC%s.okl", suffix);
 	sprintf(kernelName, "ellipticAddBC%s", suffix);
 	
-	elliptic->addBCKernel = mesh->device.buildKernel(fileName,kernelName, kernelInfo);
+	elliptic->addBCKernel = meshBuildKernel(mesh, fileName,kernelName, kernelInfo);
       }
       MPI_Barrier(mesh->comm);
     }
@@ -215,11 +215,26 @@ elliptic_t *ellipticSetup(mesh_t *mesh, dfloat lambda, occa::properties &kernelI
                         elliptic->o_r);
   }
 
+  // Ax recomputes the second order geometric factors, so release them on the DEVICE
+  if(options.compareArgs("DISCRETIZATION","CONTINUOUS") &&
+     ellipticElementMapType(elliptic)==ELEMENT_MAP_RECOMPUTE){
+    mesh->o_ggeo.free();
+    reportMemoryUsage(mesh->device, "after releasing ggeo");
+  }
+
   // gather-scatter
   if(options.compareArgs("DISCRETIZATION","CONTINUOUS")){
     ellipticParallelGatherScatter(mesh, mesh->ogs, elliptic->o_r, dfloatString, "add");  
     if (elliptic->Nmasked) mesh->maskKernel(elliptic->Nmasked, elliptic->o_maskIds, elliptic->o_r);
   }
 
+  ellipticAxCostRegister(elliptic);
+
+  if(meshBuildKernelReport(mesh, options)){
+    if(mesh->rank==0) printf("ERROR: ranks built different sets of kernels\n");
+    MPI_Finalize();
+    exit(-1);
+  }
+
   return elliptic;
 }
@@ -134,5 +134,127 @@ void dampedJacobi(void **args, occa::memory &o_r, occa::memory &o_Sr) {
 
   occa::memory o_invDiagA = elliptic->precon->o_invDiagA;
 
-  elliptic->dotMultiplyKernel(mesh->Np*mesh->Nelements,o_invDiagA,o_r,o_Sr);
-}
\ No newline at end of file
+  elliptic->precon->dampedJacobiKernel(mesh->Np*mesh->Nelements,o_invDiagA,o_r,o_Sr);
+}
+
+// halo exchange of Nentries per element into the halo zone of o_q, split like
+// ellipticStart/Interim/EndHaloExchange so the interior patches run in between.
+// The overlap buffer can be larger than Np so the Schwarz smoother keeps its own buffers
+static void ellipticOasHaloExchangeStart(elliptic_t *elliptic, occa::memory &o_q, int Nentries){
+
+  mesh_t *mesh = elliptic->mesh;
+  precon_t *precon = elliptic->precon;
+
+  dlong haloBytes = mesh->totalHaloPairs*Nentries*sizeof(dfloat);
+
+  if(haloBytes){
+    // make sure o_q is ready, then extract and copy to HOST on the data stream
+    mesh->device.finish();
+    mesh->device.setStream(elliptic->dataStream);
+
+    mesh->haloExtractKernel(mesh->totalHaloPairs, Nentries, mesh->o_haloElementList,
+                            o_q, precon->o_oasHaloBuffer);
+    precon->o_oasHaloBuffer.copyTo(precon->oasSendBuffer, haloBytes, 0, "async: true");
+
+    mesh->device.setStream(elliptic->defaultStream);
+  }
+}
+
+static void ellipticOasHaloExchangeInterim(elliptic_t *elliptic, int Nentries){
+
+  mesh_t *mesh = elliptic->mesh;
+  precon_t *precon = elliptic->precon;
+
+  if(mesh->totalHaloPairs){
+    // wait for the send buffer, the interior patches keep the default stream busy
+    mesh->device.setStream(elliptic->dataStream);
+    mesh->device.finish();
+
+    meshHaloExchangeStart(mesh, Nentries*sizeof(dfloat), precon->oasSendBuffer, precon->oasRecvBuffer);
+
+    mesh->device.setStream(elliptic->defaultStream);
+  }
+}
+
+static void ellipticOasHaloExchangeEnd(elliptic_t *elliptic, occa::memory &o_q, int Nentries){
+
+  mesh_t *mesh = elliptic->mesh;
+  precon_t *precon = elliptic->precon;
+
+  dlong haloBytes = mesh->totalHaloPairs*Nentries*sizeof(dfloat);
+  dlong haloOffset = mesh->Nelements*Nentries*sizeof(dfloat);
+
+  if(haloBytes){
+    meshHaloExchangeFinish(mesh);
+
+    // queued behind the interior patches on the default stream
+    o_q.copyFrom(precon->oasRecvBuffer, haloBytes, haloOffset);
+  }
+}
+
+static void ellipticOasFastDiag(elliptic_t *elliptic, dfloat lambda, dlong Nelements,
+                                occa::memory &o_elementList, occa::memory &o_Sr){
+
+  mesh_t *mesh = elliptic->mesh;
+  precon_t *precon = elliptic->precon;
+
+  if(!Nelements) return;
+
+  occaTimerTic(mesh->device,"oasFastDiagKernel");
+  precon->oasFastDiagKernel(Nelements,
+                            o_elementList,
+                            lambda,
+                            precon->o_oasMapP,
+                            precon->o_oasPatchIds,
+                            precon->o_oasTargetIds,
+                            precon->o_oasScales,
+                            precon->o_oasForward,
+                            precon->o_oasBack,
+                            precon->o_oasDiagOp,
+                            precon->o_oasR,
+                            o_Sr,
+                            precon->o_oasOverlap);
+  occaTimerToc(mesh->device,"oasFastDiagKernel");
+}
+
+static void ellipticOasOverlapAdd(elliptic_t *elliptic, dlong Nelements,
+                                  occa::memory &o_elementList, occa::memory &o_Sr){
+
+  precon_t *precon = elliptic->precon;
+
+  if(!Nelements) return;
+
+  precon->oasOverlapAddKernel(Nelements, o_elementList, precon->o_oasMapP, precon->o_oasSourceIds,
+                              precon->o_oasOverlap, o_Sr);
+}
+
+void overlappingSchwarz(void **args, occa::memory &o_r, occa::memory &o_Sr) {
+
+  elliptic_t *elliptic = (elliptic_t *) args[0];
+  dfloat *lambda = (dfloat *) args[1];
+  mesh_t *mesh = elliptic->mesh;
+
+  // work on a copy of r, the smoother is also applied in place
+  elliptic->precon->o_oasR.copyFrom(o_r, mesh->Nelements*mesh->Np*sizeof(dfloat));
+
+  // patches of interior elements only read local residuals
+  ellipticOasHaloExchangeStart(elliptic, elliptic->precon->o_oasR, mesh->Np);
+  ellipticOasFastDiag(elliptic, *lambda, mesh->NinternalElements, mesh->o_internalElementIds, o_Sr);
+  ellipticOasHaloExchangeInterim(elliptic, mesh->Np);
+  ellipticOasHaloExchangeEnd(elliptic, elliptic->precon->o_oasR, mesh->Np);
+  ellipticOasFastDiag(elliptic, *lambda, mesh->NnotInternalElements, mesh->o_notInternalElementIds, o_Sr);
+
+  // return the overlap of each patch to the neighbors it covers, interior
+  // elements only take overlap from local patches
+  ellipticOasHaloExchangeStart(elliptic, elliptic->precon->o_oasOverlap, mesh->Nfaces*mesh->Nfp);
+  ellipticOasOverlapAdd(elliptic, mesh->NinternalElements, mesh->o_internalElementIds, o_Sr);
+  ellipticOasHaloExchangeInterim(elliptic, mesh->Nfaces*mesh->Nfp);
+  ellipticOasHaloExchangeEnd(elliptic, elliptic->precon->o_oasOverlap, mesh->Nfaces*mesh->Nfp);
+  ellipticOasOverlapAdd(elliptic, mesh->NnotInternalElements, mesh->o_notInternalElementIds, o_Sr);
+
+  // sum the patch contributions to shared nodes
+  if (elliptic->options.compareArgs("DISCRETIZATION","CONTINUOUS")) {
+    ellipticParallelGatherScatter(mesh, mesh->ogs, o_Sr, dfloatString, "add");
+    if (elliptic->Nmasked) mesh->maskKernel(elliptic->Nmasked, elliptic->o_maskIds, o_Sr);
+  }
+}
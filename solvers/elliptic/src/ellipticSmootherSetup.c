@@ -45,6 +45,134 @@ int parallelCompareBaseId(const void *a, const void *b){
   return 0;
 }
 
+// smoother operators are stored in pfloat: float when "MULTIGRID PRECISION" is FLOAT,
+// which halves the footprint and bandwidth of the patch inverses, diagonals and the
+// Schwarz transforms. The vectors they act on stay dfloat
+static size_t ellipticSmootherBytes(elliptic_t *elliptic, dlong N){
+
+  if (elliptic->options.compareArgs("MULTIGRID PRECISION","FLOAT"))
+    return N*sizeof(float);
+  else
+    return N*sizeof(dfloat);
+}
+
+// smoother kernels read their operators as pfloat, see ellipticSmootherBytes
+void ellipticBuildSmootherKernels(elliptic_t *elliptic, occa::properties &kernelInfo, const char *suffix){
+
+  mesh_t *mesh = elliptic->mesh;
+  setupAide options = elliptic->options;
+
+  char fileName[BUFSIZ], kernelName[BUFSIZ];
+
+  occa::properties smootherKernelInfo = kernelInfo;
+  if (options.compareArgs("MULTIGRID PRECISION","FLOAT"))
+    smootherKernelInfo["defines/" "pfloat"]= "float";
+  else
+    smootherKernelInfo["defines/" "pfloat"]= dfloatString;
+
+  sprintf(fileName, DELLIPTIC "/okl/ellipticPatchSolver.okl");
+  sprintf(kernelName, "ellipticApproxBlockJacobiSolver");
+  elliptic->precon->approxBlockJacobiSolverKernel = meshBuildKernel(mesh, fileName,kernelName,smootherKernelInfo);
+
+  sprintf(fileName, DELLIPTIC "/okl/ellipticDampedJacobi.okl");
+  sprintf(kernelName, "ellipticDampedJacobi");
+  elliptic->precon->dampedJacobiKernel = meshBuildKernel(mesh, fileName,kernelName,smootherKernelInfo);
+
+  if (options.compareArgs("MULTIGRID SMOOTHER","SCHWARZ")) {
+    // fast diagonalization works on the (Nq+2)^dim overlapping patch
+    occa::properties schwarzKernelInfo = smootherKernelInfo;
+    schwarzKernelInfo["defines/" "p_NqP"]= mesh->NpP;
+
+    sprintf(fileName, DELLIPTIC "/okl/ellipticOasFastDiag%s.okl", suffix);
+    sprintf(kernelName, "ellipticOasFastDiag%s", suffix);
+    elliptic->precon->oasFastDiagKernel = meshBuildKernel(mesh, fileName,kernelName,schwarzKernelInfo);
+
+    sprintf(fileName, DELLIPTIC "/okl/ellipticOasOverlapAdd.okl");
+    sprintf(kernelName, "ellipticOasOverlapAdd");
+    elliptic->precon->oasOverlapAddKernel = meshBuildKernel(mesh, fileName,kernelName,schwarzKernelInfo);
+  }
+}
+
+static void ellipticSmootherCopyFrom(elliptic_t *elliptic, occa::memory &o_v, dlong N, dfloat *v){
+
+  if (elliptic->options.compareArgs("MULTIGRID PRECISION","FLOAT")) {
+    float *fv = (float*) calloc(N, sizeof(float));
+    for (dlong n=0;n<N;n++) fv[n] = (float) v[n];
+    o_v.copyFrom(fv, N*sizeof(float));
+    free(fv);
+  } else {
+    o_v.copyFrom(v, N*sizeof(dfloat));
+  }
+}
+
+// collective when the cache is on: eigenvalue cache key of this problem, the mesh
+// key plus a signature of the boundary conditions (mask) and the smoother options.
+// Empty, without communication, when the cache is off.
+void ellipticEigenvalueCacheKey(elliptic_t *elliptic, char *key){
+
+  mesh_t *mesh = elliptic->mesh;
+  setupAide options = elliptic->options;
+
+  key[0] = '\0';
+  if(!parAlmondEigenvalueCacheOn(options)) return;
+
+  char meshKey[BUFSIZ];
+  parAlmondEigenvalueCacheMeshKey(mesh, options, meshKey);
+
+  hlong localSig[3] = {(hlong) elliptic->Nmasked, 0, 0};
+  hlong sig[3];
+  for(dlong e=0;e<mesh->Nelements;++e){
+    for(int n=0;n<mesh->Np;++n){
+      hlong bc = (hlong) elliptic->mapB[n+e*mesh->Np];
+      localSig[1] += bc;
+      localSig[2] += bc*(n+1);
+    }
+  }
+  MPI_Allreduce(localSig, sig, 3, MPI_HLONG, MPI_SUM, mesh->comm);
+
+  string mgSmoother = "NONE", amgSmoother = "NONE";
+  options.getArgs("MULTIGRID SMOOTHER", mgSmoother);
+  options.getArgs("PARALMOND SMOOTHER", amgSmoother);
+
+  sprintf(key, "%s_BC" hlongFormat "_" hlongFormat "_" hlongFormat "_%s_%s_%s",
+          meshKey, sig[0], sig[1], sig[2], mgSmoother.c_str(), amgSmoother.c_str(),
+          options.compareArgs("MULTIGRID PRECISION","FLOAT") ? "FLOAT" : "DOUBLE");
+
+  // the cache file is whitespace separated
+  for(char *c=key;*c;++c)
+    if(isspace(*c)) *c = '-';
+}
+
+// spectral radius of S*A for this level, reusing the "EIGENVALUE CACHE" entry
+// when the same problem and smoother has been seen before at (nearly) this lambda
+static dfloat ellipticSmootherSpectralRadius(elliptic_t *elliptic, agmgLevel *level,
+                                             dfloat lambda, const char *smootherName){
+
+  mesh_t *mesh = elliptic->mesh;
+  setupAide options = elliptic->options;
+
+  char problemKey[BUFSIZ], key[BUFSIZ];
+  ellipticEigenvalueCacheKey(elliptic, problemKey);
+  sprintf(key, "%s_MG_%s_NS%d", problemKey, smootherName, elliptic->allNeumann);
+
+  dfloat cachedRho = 0;
+  int hit = parAlmondEigenvalueCacheLookup(options, mesh->comm, key, lambda, &cachedRho);
+
+  dfloat rho;
+  if (hit==2) {
+    rho = cachedRho;
+  } else if (hit==1) { // nearby lambda, cheap refresh
+    rho = mymax(cachedRho, maxEigSmoothAx(elliptic, level, 3));
+  } else {
+    rho = maxEigSmoothAx(elliptic, level, 10);
+  }
+
+  if (hit!=2)
+    parAlmondEigenvalueCacheStore(options, mesh->comm, key, lambda, rho);
+
+  return rho;
+}
+
 void ellipticSetupSmootherLocalPatch(elliptic_t *elliptic, precon_t *precon, 
                                       agmgLevel *level, dfloat lambda, 
                                       dfloat rateTolerance) {
@@ -61,7 +189,8 @@ void ellipticSetupSmootherLocalPatch(elliptic_t *elliptic, precon_t *precon,
   //initialize the full inverse operators on each 4 element patch
   ellipticBuildLocalPatches(elliptic, lambda, rateTolerance, &Npatches, &patchesIndex, &invAP);
 
-  precon->o_invAP = mesh->device.malloc(Npatches*NpP*NpP*sizeof(dfloat),invAP);
+  precon->o_invAP = mesh->device.malloc(ellipticSmootherBytes(elliptic, Npatches*NpP*NpP));
+  ellipticSmootherCopyFrom(elliptic, precon->o_invAP, Npatches*NpP*NpP, invAP);
   precon->o_patchesIndex = mesh->device.malloc(mesh->Nelements*sizeof(dlong), patchesIndex);
 
   dfloat *invDegree = (dfloat*) calloc(mesh->Nelements,sizeof(dfloat));
@@ -73,7 +202,7 @@ void ellipticSetupSmootherLocalPatch(elliptic_t *elliptic, precon_t *precon,
   level->device_smoother = LocalPatch;
 
   //estimate the max eigenvalue of S*A
-  dfloat rho = maxEigSmoothAx(elliptic, level);
+  dfloat rho = ellipticSmootherSpectralRadius(elliptic, level, lambda, "LOCALPATCH");
 
   if (options.compareArgs("MULTIGRID SMOOTHER","CHEBYSHEV")) {
 
@@ -105,12 +234,13 @@ void ellipticSetupSmootherDampedJacobi(elliptic_t *elliptic, precon_t *precon,
 
   ellipticBuildJacobi(elliptic,lambda, &invDiagA);
 
-  precon->o_invDiagA = mesh->device.malloc(mesh->Np*mesh->Nelements*sizeof(dfloat), invDiagA);
-    
+  precon->o_invDiagA = mesh->device.malloc(ellipticSmootherBytes(elliptic, mesh->Np*mesh->Nelements));
+  ellipticSmootherCopyFrom(elliptic, precon->o_invDiagA, mesh->Np*mesh->Nelements, invDiagA);
+
   level->device_smoother = dampedJacobi;
 
   //estimate the max eigenvalue of S*A
-  dfloat rho = maxEigSmoothAx(elliptic, level);
+  dfloat rho = ellipticSmootherSpectralRadius(elliptic, level, lambda, "DAMPEDJACOBI");
 
   if (options.compareArgs("MULTIGRID SMOOTHER","CHEBYSHEV")) {
 
@@ -128,12 +258,198 @@ void ellipticSetupSmootherDampedJacobi(elliptic_t *elliptic, precon_t *precon,
       invDiagA[n] *= weight;
 
     //update diagonal with weight
-    precon->o_invDiagA.copyFrom(invDiagA);
+    ellipticSmootherCopyFrom(elliptic, precon->o_invDiagA, mesh->Np*mesh->Nelements, invDiagA);
   }
 
   free(invDiagA);
 }
 
+// length of the element edge between vertices a and b
+static dfloat ellipticVertexDistance(mesh_t *mesh, dlong e, int a, int b){
+
+  dlong id = e*mesh->Nverts;
+  dfloat dx = mesh->EX[id+b]-mesh->EX[id+a];
+  dfloat dy = mesh->EY[id+b]-mesh->EY[id+a];
+  dfloat dz = (mesh->dim==3) ? mesh->EZ[id+b]-mesh->EZ[id+a] : 0.;
+
+  return sqrt(dx*dx+dy*dy+dz*dz);
+}
+
+void ellipticSetupSmootherSchwarz(elliptic_t *elliptic, precon_t *precon,
+                                  agmgLevel *level, dfloat lambda) {
+
+  mesh_t *mesh = elliptic->mesh;
+  setupAide options = elliptic->options;
+
+  int continuous = options.compareArgs("DISCRETIZATION","CONTINUOUS");
+
+  // the C0 patch operator is singular for N=1 (see writeNodeDataHex3D.m)
+  if (continuous && mesh->N==1) {
+    ellipticSetupSmootherDampedJacobi(elliptic, precon, level, lambda);
+    return;
+  }
+
+  int dim = mesh->dim;
+  int Nq = mesh->N+1;
+  int NqP = mesh->NpP; // 1D patch width, Nq+2
+  int NpP = (dim==3) ? NqP*NqP*NqP : NqP*NqP;
+  int NfacesNfp = mesh->Nfaces*mesh->Nfp;
+
+  // reference patch layout: element nodes sit in the middle of the patch, each face node
+  // has one overlap node outside it. C0 patches overlap the neighbor's first interior
+  // layer, IPDG patches take the neighbor's copy of the face node
+  int *patchIds  = (int*) calloc(NpP, sizeof(int));
+  int *targetIds = (int*) calloc(NfacesNfp, sizeof(int));
+  int *sourceIds = (int*) calloc(mesh->Np*mesh->Nfaces, sizeof(int));
+
+  for (int n=0;n<NpP;n++) patchIds[n] = -1;
+  for (int n=0;n<mesh->Np*mesh->Nfaces;n++) sourceIds[n] = -1;
+
+  int strides[3] = {1, NqP, NqP*NqP};
+
+  for (int n=0;n<mesh->Np;n++) {
+    int ijk[3] = {n%Nq, (n/Nq)%Nq, n/(Nq*Nq)};
+    int id = 0;
+    for (int d=0;d<dim;d++) id += (ijk[d]+1)*strides[d];
+    patchIds[id] = n;
+  }
+
+  for (int f=0;f<mesh->Nfaces;f++) {
+    // outward direction of this face
+    int dir = 0, sgn = 0;
+    for (int d=0;d<dim;d++) {
+      int lo = 1, hi = 1;
+      for (int n=0;n<mesh->Nfp;n++) {
+        int m = mesh->faceNodes[f*mesh->Nfp+n];
+        int ijk[3] = {m%Nq, (m/Nq)%Nq, m/(Nq*Nq)};
+        if (ijk[d]!=0)    lo = 0;
+        if (ijk[d]!=Nq-1) hi = 0;
+      }
+      if (lo) { dir = d; sgn = -1; }
+      if (hi) { dir = d; sgn = +1; }
+    }
+
+    for (int n=0;n<mesh->Nfp;n++) {
+      int m = mesh->faceNodes[f*mesh->Nfp+n];
+      int ijk[3] = {m%Nq, (m/Nq)%Nq, m/(Nq*Nq)};
+
+      int id = 0;
+      for (int d=0;d<dim;d++) id += (ijk[d]+1)*strides[d];
+      patchIds[id + sgn*strides[dir]] = mesh->Np + f*mesh->Nfp + n;
+
+      // node covered by the neighbor's overlap across this face node
+      if (continuous) ijk[dir] -= sgn;
+      int target = ijk[0] + ijk[1]*Nq + ijk[2]*Nq*Nq;
+      targetIds[f*mesh->Nfp+n] = target;
+
+      for (int s=0;s<mesh->Nfaces;s++) {
+        if (sourceIds[target*mesh->Nfaces+s]==-1) {
+          sourceIds[target*mesh->Nfaces+s] = f*mesh->Nfp + n;
+          break;
+        }
+      }
+    }
+  }
+
+  // face node connectivity, -1 marks a domain boundary (no overlap)
+  dlong *oasMapP = (dlong*) calloc(mesh->Nelements*NfacesNfp, sizeof(dlong));
+  for (dlong e=0;e<mesh->Nelements;e++) {
+    for (int f=0;f<mesh->Nfaces;f++) {
+      int bc = (mesh->EToE[e*mesh->Nfaces+f]<0) || (mesh->EToF[e*mesh->Nfaces+f]<0);
+      for (int n=0;n<mesh->Nfp;n++) {
+        dlong id = e*NfacesNfp + f*mesh->Nfp + n;
+        oasMapP[id] = bc ? -1 : mesh->mapP[id];
+      }
+    }
+  }
+
+  // per element Jacobian and inverse squared lengths, the patch is treated as a
+  // scaled box so the 1D eigen-decompositions can be shared by all elements
+  dfloat *scales = (dfloat*) calloc(mesh->Nelements*(dim+1), sizeof(dfloat));
+  for (dlong e=0;e<mesh->Nelements;e++) {
+    dfloat h[3];
+    if (dim==3) {
+      h[0] = 0.25*(ellipticVertexDistance(mesh,e,0,1) + ellipticVertexDistance(mesh,e,3,2)
+                  +ellipticVertexDistance(mesh,e,4,5) + ellipticVertexDistance(mesh,e,7,6));
+      h[1] = 0.25*(ellipticVertexDistance(mesh,e,0,3) + ellipticVertexDistance(mesh,e,1,2)
+                  +ellipticVertexDistance(mesh,e,4,7) + ellipticVertexDistance(mesh,e,5,6));
+      h[2] = 0.25*(ellipticVertexDistance(mesh,e,0,4) + ellipticVertexDistance(mesh,e,1,5)
+                  +ellipticVertexDistance(mesh,e,2,6) + ellipticVertexDistance(mesh,e,3,7));
+    } else {
+      h[0] = 0.5*(ellipticVertexDistance(mesh,e,0,1) + ellipticVertexDistance(mesh,e,3,2));
+      h[1] = 0.5*(ellipticVertexDistance(mesh,e,0,3) + ellipticVertexDistance(mesh,e,1,2));
+    }
+
+    dfloat J = 1.;
+    for (int d=0;d<dim;d++) {
+      J *= 0.5*h[d];
+      scales[e*(dim+1)+1+d] = 4./(h[d]*h[d]);
+    }
+    scales[e*(dim+1)] = J;
+  }
+
+  // the 1D eigen-decomposition and the element scales are smoother operators (pfloat)
+  precon->o_oasForward = mesh->device.malloc(ellipticSmootherBytes(elliptic, NqP*NqP));
+  precon->o_oasBack    = mesh->device.malloc(ellipticSmootherBytes(elliptic, NqP*NqP));
+  precon->o_oasDiagOp  = mesh->device.malloc(ellipticSmootherBytes(elliptic, NqP));
+  if (continuous) {
+    ellipticSmootherCopyFrom(elliptic, precon->o_oasForward, NqP*NqP, mesh->oasForward);
+    ellipticSmootherCopyFrom(elliptic, precon->o_oasBack,    NqP*NqP, mesh->oasBack);
+    ellipticSmootherCopyFrom(elliptic, precon->o_oasDiagOp,  NqP,     mesh->oasDiagOp);
+  } else {
+    ellipticSmootherCopyFrom(elliptic, precon->o_oasForward, NqP*NqP, mesh->oasForwardDg);
+    ellipticSmootherCopyFrom(elliptic, precon->o_oasBack,    NqP*NqP, mesh->oasBackDg);
+    ellipticSmootherCopyFrom(elliptic, precon->o_oasDiagOp,  NqP,     mesh->oasDiagOpDg);
+  }
+
+  precon->o_oasPatchIds  = mesh->device.malloc(NpP*sizeof(int), patchIds);
+  precon->o_oasTargetIds = mesh->device.malloc(NfacesNfp*sizeof(int), targetIds);
+  precon->o_oasSourceIds = mesh->device.malloc(mesh->Np*mesh->Nfaces*sizeof(int), sourceIds);
+  precon->o_oasMapP      = mesh->device.malloc(mesh->Nelements*NfacesNfp*sizeof(dlong), oasMapP);
+  precon->o_oasScales    = mesh->device.malloc(ellipticSmootherBytes(elliptic, mesh->Nelements*(dim+1)));
+  ellipticSmootherCopyFrom(elliptic, precon->o_oasScales, mesh->Nelements*(dim+1), scales);
+
+  dlong Ntotal = mesh->Nelements+mesh->totalHaloPairs;
+  precon->o_oasR       = mesh->device.malloc(Ntotal*mesh->Np*sizeof(dfloat));
+  precon->o_oasOverlap = mesh->device.malloc(Ntotal*NfacesNfp*sizeof(dfloat));
+
+  if (mesh->totalHaloPairs) {
+    dlong Nbytes = mesh->totalHaloPairs*mymax(mesh->Np, NfacesNfp)*sizeof(dfloat);
+    precon->o_oasHaloBuffer = mesh->device.malloc(Nbytes);
+    precon->oasSendBuffer = (dfloat*) occaHostMallocPinned(mesh->device, Nbytes, NULL, precon->o_oasSendBuffer);
+    precon->oasRecvBuffer = (dfloat*) occaHostMallocPinned(mesh->device, Nbytes, NULL, precon->o_oasRecvBuffer);
+  }
+
+  level->device_smoother = overlappingSchwarz;
+
+  //estimate the max eigenvalue of S*A
+  dfloat rho = ellipticSmootherSpectralRadius(elliptic, level, lambda, "SCHWARZ");
+
+  if (options.compareArgs("MULTIGRID SMOOTHER","CHEBYSHEV")) {
+
+    level->smoother_params = (dfloat *) calloc(2,sizeof(dfloat));
+
+    level->smoother_params[0] = rho;
+    level->smoother_params[1] = rho/10.;
+
+  } else {
+
+    //set the stabilty weight (jacobi-type interation), folded into the element Jacobians
+    dfloat weight = (4./3.)/rho;
+
+    for (dlong e=0;e<mesh->Nelements;e++)
+      scales[e*(dim+1)] /= weight;
+
+    ellipticSmootherCopyFrom(elliptic, precon->o_oasScales, mesh->Nelements*(dim+1), scales);
+  }
+
+  free(patchIds);
+  free(targetIds);
+  free(sourceIds);
+  free(oasMapP);
+  free(scales);
+}
+
 static void eig(const int Nrows, double *A, double *WR, double *WI){
 
   int NB  = 256;
@@ -160,7 +476,7 @@ static void eig(const int Nrows, double *A, double *WR, double *WI){
   delete [] WORK;
 }
 
-dfloat maxEigSmoothAx(elliptic_t* elliptic, agmgLevel *level){
+dfloat maxEigSmoothAx(elliptic_t* elliptic, agmgLevel *level, int k){
 
   mesh_t *mesh = elliptic->mesh;
   setupAide options = elliptic->options;
@@ -168,8 +484,6 @@ dfloat maxEigSmoothAx(elliptic_t* elliptic, agmgLevel *level){
   const dlong N = level->Nrows;
   const dlong M = level->Ncols;
 
-  int k = 10;
-
   hlong Nlocal = (hlong) level->Nrows;
   hlong Ntotal = 0;
   MPI_Allreduce(&Nlocal, &Ntotal, 1, MPI_HLONG, MPI_SUM, mesh->comm);
@@ -42,10 +42,26 @@ int ellipticSolve(elliptic_t *elliptic, dfloat lambda, dfloat tol,
     start = MPI_Wtime(); 
   }
 
+  // start from the best approximation in the span of previous solutions
+  if(options.compareArgs("INITIAL GUESS","PROJECTION")){
+    occaTimerTic(mesh->device,"Projection");
+    ellipticProjectInitialGuess(elliptic, lambda, o_r, o_x);
+    occaTimerToc(mesh->device,"Projection");
+  }
+
   occaTimerTic(mesh->device,"Linear Solve");
-  Niter = pcg (elliptic, lambda, o_r, o_x, tol, maxIter);
+  if(options.compareArgs("KRYLOV SOLVER", "PIPELINED PCG"))
+    Niter = ppcg(elliptic, lambda, o_r, o_x, tol, maxIter);
+  else
+    Niter = pcg (elliptic, lambda, o_r, o_x, tol, maxIter);
   occaTimerToc(mesh->device,"Linear Solve");
 
+  if(options.compareArgs("INITIAL GUESS","PROJECTION")){
+    occaTimerTic(mesh->device,"Projection");
+    ellipticUpdateProjectionSpace(elliptic, lambda, o_x);
+    occaTimerToc(mesh->device,"Projection");
+  }
+
   if(options.compareArgs("VERBOSE","TRUE")){
     mesh->device.finish();
     end = MPI_Wtime();
@@ -75,3 +91,40 @@ int ellipticSolve(elliptic_t *elliptic, dfloat lambda, dfloat tol,
   return Niter;
 
 }
+
+int ellipticBlockSolve(elliptic_t **solvers, int Nfields, dfloat lambda, dfloat tol,
+                       occa::memory &o_r, occa::memory &o_x, int *Niter){
+
+  elliptic_t *elliptic = solvers[0];
+  mesh_t *mesh = elliptic->mesh;
+  setupAide options = elliptic->options;
+
+  int maxIter = 5000;
+
+  double start = 0.0, end =0.0;
+
+  if(options.compareArgs("VERBOSE","TRUE")){
+    mesh->device.finish();
+    start = MPI_Wtime();
+  }
+
+  occaTimerTic(mesh->device,"Block Linear Solve");
+  int NiterMax = bpcg(solvers, Nfields, lambda, o_r, o_x, tol, maxIter, Niter);
+  occaTimerToc(mesh->device,"Block Linear Solve");
+
+  if(options.compareArgs("VERBOSE","TRUE")){
+    mesh->device.finish();
+    end = MPI_Wtime();
+    double localElapsed = end-start;
+    double globalElapsed;
+
+    MPI_Reduce(&localElapsed, &globalElapsed, 1, MPI_DOUBLE, MPI_MAX, 0, mesh->comm );
+
+    if(mesh->rank==0){
+      printf("Block solver converged in %d iters [", NiterMax);
+      for(int fld=0;fld<Nfields;++fld) printf(" %d", Niter[fld]);
+      printf(" ] %17.15lg \n", globalElapsed);
+    }
+  }
+  return NiterMax;
+}
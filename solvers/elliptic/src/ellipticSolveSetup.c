@@ -50,12 +50,24 @@ void ellipticSolveSetup(elliptic_t *elliptic, dfloat lambda, occa::properties &k
     exit(-1);
   }
 
+  if (options.compareArgs("ELEMENT MAP","RECOMPUTE") && elliptic->elementType!=QUADRILATERALS
+                                                     && elliptic->elementType!=HEXAHEDRA) {
+    printf("ERROR: RECOMPUTE element map is only available for quadrilateral and hexahedral elements\n");
+    MPI_Finalize();
+    exit(-1);
+  }
+
+  if (options.compareArgs("MULTIGRID SMOOTHER","SCHWARZ") && elliptic->elementType!=QUADRILATERALS
+                                                          && elliptic->elementType!=HEXAHEDRA) {
+    printf("ERROR: SCHWARZ multigrid smoother is only available for quadrilateral and hexahedral elements\n");
+    MPI_Finalize();
+    exit(-1);
+  }
+
   dlong Ntotal = mesh->Np*mesh->Nelements;
   dlong Nblock = mymax(1,(Ntotal+blockSize-1)/blockSize);
   dlong Nhalo = mesh->Np*mesh->totalHaloPairs;
   dlong Nall   = Ntotal + Nhalo;
-
-  dlong Nblock2 = mymax(1,(Nblock+blockSize-1)/blockSize);
   
   //tau
   if (elliptic->elementType==TRIANGLES || elliptic->elementType==QUADRILATERALS)
@@ -67,7 +79,6 @@ void ellipticSolveSetup(elliptic_t *elliptic, dfloat lambda, occa::properties &k
   elliptic->z   = (dfloat*) calloc(Nall,   sizeof(dfloat));
   elliptic->Ax  = (dfloat*) calloc(Nall,   sizeof(dfloat));
   elliptic->Ap  = (dfloat*) calloc(Nall,   sizeof(dfloat));
-  elliptic->tmp = (dfloat*) calloc(Nblock, sizeof(dfloat));
 
   elliptic->grad = (dfloat*) calloc(Nall*4, sizeof(dfloat));
 
@@ -76,14 +87,77 @@ void ellipticSolveSetup(elliptic_t *elliptic, dfloat lambda, occa::properties &k
   elliptic->o_z   = mesh->device.malloc(Nall*sizeof(dfloat), elliptic->z);
 
   elliptic->o_res = mesh->device.malloc(Nall*sizeof(dfloat), elliptic->z);
+
+  // the Ax kernels recompute the geometric factors from the node coordinates
+  // and only need the GLL weights (the trilinear map is set up in ellipticSetup)
+  if (options.compareArgs("DISCRETIZATION","CONTINUOUS") &&
+      ellipticElementMapType(elliptic)==ELEMENT_MAP_RECOMPUTE) {
+    dfloat *gllzw = (dfloat*) calloc(2*mesh->Nq, sizeof(dfloat));
+
+    int sk = 0;
+    for(int n=0;n<mesh->Nq;++n)
+      gllzw[sk++] = mesh->gllz[n];
+    for(int n=0;n<mesh->Nq;++n)
+      gllzw[sk++] = mesh->gllw[n];
+
+    elliptic->o_gllzw = mesh->device.malloc(2*mesh->Nq*sizeof(dfloat), gllzw);
+    free(gllzw);
+  }
   elliptic->o_Sres = mesh->device.malloc(Nall*sizeof(dfloat), elliptic->z);
   elliptic->o_Ax  = mesh->device.malloc(Nall*sizeof(dfloat), elliptic->p);
   elliptic->o_Ap  = mesh->device.malloc(Nall*sizeof(dfloat), elliptic->Ap);
-  elliptic->o_tmp = mesh->device.malloc(Nblock*sizeof(dfloat), elliptic->tmp);
-  elliptic->o_tmp2 = mesh->device.malloc(Nblock2*sizeof(dfloat), elliptic->tmp);
+
+  // block partial sums are read back through pinned host memory (room for two per block)
+  elliptic->tmp = (dfloat*) occaHostMallocPinned(mesh->device, 2*Nblock*sizeof(dfloat), NULL, elliptic->o_tmp);
+
+  // GPU modes finish the PCG dot products on the device with atomicAdd
+  elliptic->atomicReduction = (mesh->device.mode()=="CUDA" || mesh->device.mode()=="HIP") ? 1:0;
+  elliptic->o_dots = mesh->device.malloc(2*sizeof(dfloat));
 
   elliptic->o_grad  = mesh->device.malloc(Nall*4*sizeof(dfloat), elliptic->grad);
 
+  if(options.compareArgs("KRYLOV SOLVER", "PIPELINED PCG")){
+    elliptic->o_Az   = mesh->device.malloc(Nall*sizeof(dfloat), elliptic->z);
+    elliptic->o_MAz  = mesh->device.malloc(Nall*sizeof(dfloat), elliptic->z);
+    elliptic->o_AMAz = mesh->device.malloc(Nall*sizeof(dfloat), elliptic->z);
+    elliptic->o_q    = mesh->device.malloc(Nall*sizeof(dfloat), elliptic->z);
+    elliptic->o_Aq   = mesh->device.malloc(Nall*sizeof(dfloat), elliptic->z);
+
+    // three partial sums per block, read back through pinned host memory
+    elliptic->pipelinedDots = (dfloat*) occaHostMallocPinned(mesh->device, 3*Nblock*sizeof(dfloat), NULL, elliptic->o_pipelinedDots);
+  }
+
+  // successive right hand side projection keeps the last maxProjection solutions,
+  // A-orthonormalised, together with their images under A
+  elliptic->Nprojection = 0;
+  elliptic->maxProjection = 0;
+  if(options.compareArgs("INITIAL GUESS","PROJECTION")){
+    elliptic->maxProjection = 8;
+    options.getArgs("PROJECTION VECTORS", elliptic->maxProjection);
+
+    if(elliptic->maxProjection<1 || elliptic->maxProjection>16){
+      printf("ERROR: PROJECTION VECTORS must be between 1 and 16\n");
+      MPI_Finalize();
+      exit(-1);
+    }
+
+    elliptic->projectionLambda = lambda;
+
+    elliptic->o_projectionX    = mesh->device.malloc(elliptic->maxProjection*Ntotal*sizeof(dfloat));
+    elliptic->o_projectionB    = mesh->device.malloc(elliptic->maxProjection*Ntotal*sizeof(dfloat));
+    elliptic->o_projectionXbar = mesh->device.malloc(Nall*sizeof(dfloat), elliptic->z);
+    elliptic->o_projectionXnew = mesh->device.malloc(Nall*sizeof(dfloat), elliptic->z);
+    elliptic->o_projectionAx   = mesh->device.malloc(Nall*sizeof(dfloat), elliptic->z);
+
+    elliptic->projectionAlpha   = (dfloat*) calloc(elliptic->maxProjection, sizeof(dfloat));
+    elliptic->projectionCoeffs  = (dfloat*) calloc(elliptic->maxProjection, sizeof(dfloat));
+    elliptic->o_projectionAlpha = mesh->device.malloc(elliptic->maxProjection*sizeof(dfloat), elliptic->projectionAlpha);
+
+    // partial sums of all basis inner products, read back through pinned host memory
+    elliptic->projectionDots = (dfloat*) occaHostMallocPinned(mesh->device, elliptic->maxProjection*Nblock*sizeof(dfloat),
+                                                              NULL, elliptic->o_projectionDots);
+  }
+
   //setup async halo stream
   elliptic->defaultStream = mesh->defaultStream;
   elliptic->dataStream = mesh->dataStream;
@@ -119,7 +193,6 @@ void ellipticSolveSetup(elliptic_t *elliptic, dfloat lambda, occa::properties &k
   elliptic->type = strdup(dfloatString);
 
   elliptic->Nblock = Nblock;
-  elliptic->Nblock2 = Nblock2;
 
   //fill geometric factors in halo
   if(mesh->totalHaloPairs){
@@ -234,48 +307,63 @@ void ellipticSolveSetup(elliptic_t *elliptic, dfloat lambda, occa::properties &k
   char fileName[BUFSIZ], kernelName[BUFSIZ];
 
 
-  for (int r=0;r<mesh->size;r++) {
-    if (r==mesh->rank) {
+  for (int r=0;r<meshBuildKernelStages;r++) {
+    if (r==meshBuildKernelStage(mesh)) {
 
       //mesh kernels 
       mesh->haloExtractKernel =
-        mesh->device.buildKernel(DHOLMES "/okl/meshHaloExtract2D.okl",
+        meshBuildKernel(mesh, DHOLMES "/okl/meshHaloExtract2D.okl",
     				       "meshHaloExtract2D",
     				       kernelInfo);
 
       mesh->gatherKernel =
-        mesh->device.buildKernel(DHOLMES "/okl/gather.okl",
+        meshBuildKernel(mesh, DHOLMES "/okl/gather.okl",
     				       "gather",
     				       kernelInfo);
 
       mesh->scatterKernel =
-        mesh->device.buildKernel(DHOLMES "/okl/scatter.okl",
+        meshBuildKernel(mesh, DHOLMES "/okl/scatter.okl",
     				       "scatter",
     				       kernelInfo);
 
       mesh->gatherScatterKernel =
-        mesh->device.buildKernel(DHOLMES "/okl/gatherScatter.okl",
+        meshBuildKernel(mesh, DHOLMES "/okl/gatherScatter.okl",
                    "gatherScatter",
                    kernelInfo);
 
       mesh->getKernel =
-        mesh->device.buildKernel(DHOLMES "/okl/get.okl",
+        meshBuildKernel(mesh, DHOLMES "/okl/get.okl",
     				       "get",
     				       kernelInfo);
 
       mesh->putKernel =
-        mesh->device.buildKernel(DHOLMES "/okl/put.okl",
+        meshBuildKernel(mesh, DHOLMES "/okl/put.okl",
     				       "put",
     				       kernelInfo);
 
+      mesh->ogsExchangePackKernel =
+        meshBuildKernel(mesh, DHOLMES "/okl/ogsExchange.okl",
+                   "ogsExchangePack",
+                   kernelInfo);
+
+      mesh->ogsExchangeAddKernel =
+        meshBuildKernel(mesh, DHOLMES "/okl/ogsExchange.okl",
+                   "ogsExchangeAdd",
+                   kernelInfo);
+
+      mesh->ogsExchangeUnpackKernel =
+        meshBuildKernel(mesh, DHOLMES "/okl/ogsExchange.okl",
+                   "ogsExchangeUnpack",
+                   kernelInfo);
+
 
       mesh->addScalarKernel =
-        mesh->device.buildKernel(DHOLMES "/okl/addScalar.okl",
+        meshBuildKernel(mesh, DHOLMES "/okl/addScalar.okl",
                    "addScalar",
                    kernelInfo);
 
       mesh->maskKernel =
-        mesh->device.buildKernel(DHOLMES "/okl/mask.okl",
+        meshBuildKernel(mesh, DHOLMES "/okl/mask.okl",
                    "mask",
                    kernelInfo);
 
@@ -284,50 +372,90 @@ void ellipticSolveSetup(elliptic_t *elliptic, dfloat lambda, occa::properties &k
       
 
       mesh->sumKernel =
-        mesh->device.buildKernel(DHOLMES "/okl/sum.okl",
+        meshBuildKernel(mesh, DHOLMES "/okl/sum.okl",
                    "sum",
                    kernelInfo);
 
       elliptic->weightedInnerProduct1Kernel =
-        mesh->device.buildKernel(DHOLMES "/okl/weightedInnerProduct1.okl",
+        meshBuildKernel(mesh, DHOLMES "/okl/weightedInnerProduct1.okl",
     				       "weightedInnerProduct1",
     				       kernelInfo);
 
       elliptic->weightedInnerProduct2Kernel =
-        mesh->device.buildKernel(DHOLMES "/okl/weightedInnerProduct2.okl",
+        meshBuildKernel(mesh, DHOLMES "/okl/weightedInnerProduct2.okl",
     				       "weightedInnerProduct2",
     				       kernelInfo);
 
       elliptic->innerProductKernel =
-        mesh->device.buildKernel(DHOLMES "/okl/innerProduct.okl",
+        meshBuildKernel(mesh, DHOLMES "/okl/innerProduct.okl",
     				       "innerProduct",
     				       kernelInfo);
 
       elliptic->weightedNorm2Kernel =
-        mesh->device.buildKernel(DHOLMES "/okl/weightedNorm2.okl",
+        meshBuildKernel(mesh, DHOLMES "/okl/weightedNorm2.okl",
 					   "weightedNorm2",
 					   kernelInfo);
 
       elliptic->norm2Kernel =
-        mesh->device.buildKernel(DHOLMES "/okl/norm2.okl",
+        meshBuildKernel(mesh, DHOLMES "/okl/norm2.okl",
 					   "norm2",
 					   kernelInfo);
       
       
       elliptic->scaledAddKernel =
-          mesh->device.buildKernel(DHOLMES "/okl/scaledAdd.okl",
+          meshBuildKernel(mesh, DHOLMES "/okl/scaledAdd.okl",
     					 "scaledAdd",
     					 kernelInfo);
 
+      if(options.compareArgs("INITIAL GUESS","PROJECTION")){
+        occa::properties projectionKernelInfo = kernelInfo;
+        projectionKernelInfo["defines/" "p_maxMultiVectors"]= elliptic->maxProjection;
+
+        elliptic->multiWeightedInnerProductKernel =
+          meshBuildKernel(mesh, DHOLMES "/okl/multiWeightedInnerProduct.okl",
+                          "multiWeightedInnerProduct",
+                          projectionKernelInfo);
+
+        elliptic->multiScaledAddKernel =
+          meshBuildKernel(mesh, DHOLMES "/okl/multiScaledAdd.okl",
+                          "multiScaledAdd",
+                          projectionKernelInfo);
+      }
+
       elliptic->dotMultiplyKernel =
-          mesh->device.buildKernel(DHOLMES "/okl/dotMultiply.okl",
+          meshBuildKernel(mesh, DHOLMES "/okl/dotMultiply.okl",
     					 "dotMultiply",
     					 kernelInfo);
 
       elliptic->dotDivideKernel =
-          mesh->device.buildKernel(DHOLMES "/okl/dotDivide.okl",
+          meshBuildKernel(mesh, DHOLMES "/okl/dotDivide.okl",
     					 "dotDivide",
     					 kernelInfo);
+
+      occa::properties updatePCGInfo = kernelInfo;
+      updatePCGInfo["defines/" "p_atomicReduction"] = elliptic->atomicReduction;
+
+      elliptic->updatePCGKernel =
+          meshBuildKernel(mesh, DELLIPTIC "/okl/ellipticUpdatePCG.okl",
+    					 "ellipticUpdatePCG",
+    					 updatePCGInfo);
+
+      elliptic->flexibleInnerProductsPCGKernel =
+          meshBuildKernel(mesh, DELLIPTIC "/okl/ellipticUpdatePCG.okl",
+    					 "ellipticFlexibleInnerProductsPCG",
+    					 updatePCGInfo);
+
+      if(options.compareArgs("KRYLOV SOLVER", "PIPELINED PCG")){
+        elliptic->pipelinedInnerProductsKernel =
+          meshBuildKernel(mesh, DELLIPTIC "/okl/ellipticPipelinedPCG.okl",
+                     "ellipticPipelinedInnerProducts",
+                     kernelInfo);
+
+        elliptic->pipelinedUpdateKernel =
+          meshBuildKernel(mesh, DELLIPTIC "/okl/ellipticPipelinedPCG.okl",
+                     "ellipticPipelinedUpdate",
+                     kernelInfo);
+      }
       
       // add custom defines
       kernelInfo["defines/" "p_NpP"]= (mesh->Np+mesh->Nfp*mesh->Nfaces);
@@ -385,56 +513,47 @@ void ellipticSolveSetup(elliptic_t *elliptic, dfloat lambda, occa::properties &k
       floatKernelInfo["defines/" "pfloat"]= "float";
       dfloatKernelInfo["defines/" "pfloat"]= dfloatString;
 
-      elliptic->AxKernel = mesh->device.buildKernel(fileName,kernelName,dfloatKernelInfo);
+      elliptic->AxKernel = meshBuildKernel(mesh, fileName,kernelName,dfloatKernelInfo);
       
-      if(elliptic->elementType!=HEXAHEDRA){
-	sprintf(kernelName, "ellipticPartialAx%s", suffix);
-      }
-      else{
-	if(elliptic->options.compareArgs("ELEMENT MAP", "TRILINEAR")){
-	  sprintf(kernelName, "ellipticPartialAxTrilinear%s", suffix);
-	}else{
-	  sprintf(kernelName, "ellipticPartialAx%s", suffix);
-	}
-      }
+      ellipticPartialAxKernelName(elliptic, suffix, kernelName);
 
-      elliptic->partialAxKernel = mesh->device.buildKernel(fileName,kernelName,dfloatKernelInfo);
+      elliptic->partialAxKernel = meshBuildKernel(mesh, fileName,kernelName,dfloatKernelInfo);
 
-      elliptic->partialFloatAxKernel = mesh->device.buildKernel(fileName,kernelName,floatKernelInfo);
+      elliptic->partialFloatAxKernel = meshBuildKernel(mesh, fileName,kernelName,floatKernelInfo);
       
       if (options.compareArgs("BASIS","BERN")) {
 
         sprintf(fileName, DELLIPTIC "/okl/ellipticGradientBB%s.okl", suffix);
         sprintf(kernelName, "ellipticGradientBB%s", suffix);
 
-        elliptic->gradientKernel = mesh->device.buildKernel(fileName,kernelName,kernelInfo);
+        elliptic->gradientKernel = meshBuildKernel(mesh, fileName,kernelName,kernelInfo);
 
         sprintf(kernelName, "ellipticPartialGradientBB%s", suffix);
-        elliptic->partialGradientKernel = mesh->device.buildKernel(fileName,kernelName,kernelInfo);
+        elliptic->partialGradientKernel = meshBuildKernel(mesh, fileName,kernelName,kernelInfo);
       
         sprintf(fileName, DELLIPTIC "/okl/ellipticAxIpdgBB%s.okl", suffix);
         sprintf(kernelName, "ellipticAxIpdgBB%s", suffix);
-        elliptic->ipdgKernel = mesh->device.buildKernel(fileName,kernelName,kernelInfo);
+        elliptic->ipdgKernel = meshBuildKernel(mesh, fileName,kernelName,kernelInfo);
 
         sprintf(kernelName, "ellipticPartialAxIpdgBB%s", suffix);
-        elliptic->partialIpdgKernel = mesh->device.buildKernel(fileName,kernelName,kernelInfo);
+        elliptic->partialIpdgKernel = meshBuildKernel(mesh, fileName,kernelName,kernelInfo);
           
       } else if (options.compareArgs("BASIS","NODAL")) {
 
         sprintf(fileName, DELLIPTIC "/okl/ellipticGradient%s.okl", suffix);
         sprintf(kernelName, "ellipticGradient%s", suffix);
 
-        elliptic->gradientKernel = mesh->device.buildKernel(fileName,kernelName,kernelInfo);
+        elliptic->gradientKernel = meshBuildKernel(mesh, fileName,kernelName,kernelInfo);
 
         sprintf(kernelName, "ellipticPartialGradient%s", suffix);
-        elliptic->partialGradientKernel = mesh->device.buildKernel(fileName,kernelName,kernelInfo);
+        elliptic->partialGradientKernel = meshBuildKernel(mesh, fileName,kernelName,kernelInfo);
 
         sprintf(fileName, DELLIPTIC "/okl/ellipticAxIpdg%s.okl", suffix);
         sprintf(kernelName, "ellipticAxIpdg%s", suffix);
-        elliptic->ipdgKernel = mesh->device.buildKernel(fileName,kernelName,kernelInfo);
+        elliptic->ipdgKernel = meshBuildKernel(mesh, fileName,kernelName,kernelInfo);
 
         sprintf(kernelName, "ellipticPartialAxIpdg%s", suffix);
-        elliptic->partialIpdgKernel = mesh->device.buildKernel(fileName,kernelName,kernelInfo);
+        elliptic->partialIpdgKernel = meshBuildKernel(mesh, fileName,kernelName,kernelInfo);
       }
     }
   MPI_Barrier(mesh->comm);
@@ -447,6 +566,18 @@ void ellipticSolveSetup(elliptic_t *elliptic, dfloat lambda, occa::properties &k
   // set up separate gather scatter infrastructure for halo and non halo nodes
   ellipticParallelGatherScatterSetup(elliptic);
 
+  // the continuous inner products weight shared nodes by their inverse degree
+  if(options.compareArgs("INITIAL GUESS","PROJECTION")){
+    if(options.compareArgs("DISCRETIZATION","CONTINUOUS")){
+      elliptic->o_projectionWeight = elliptic->o_invDegree;
+    } else {
+      dfloat *ones = (dfloat*) calloc(Ntotal, sizeof(dfloat));
+      for(dlong n=0;n<Ntotal;++n) ones[n] = 1.;
+      elliptic->o_projectionWeight = mesh->device.malloc(Ntotal*sizeof(dfloat), ones);
+      free(ones);
+    }
+  }
+
   //make a node-wise bc flag using the gsop (prioritize Dirichlet boundaries over Neumann)
   elliptic->mapB = (int *) calloc(mesh->Nelements*mesh->Np,sizeof(int));
   for (dlong e=0;e<mesh->Nelements;e++) {
@@ -487,37 +618,35 @@ void ellipticSolveSetup(elliptic_t *elliptic, dfloat lambda, occa::properties &k
   elliptic->precon = (precon_t*) calloc(1, sizeof(precon_t));
 
 
-  for (int r=0;r<mesh->size;r++) {
-    if (r==mesh->rank) {
+  for (int r=0;r<meshBuildKernelStages;r++) {
+    if (r==meshBuildKernelStage(mesh)) {
 
       sprintf(fileName, DELLIPTIC "/okl/ellipticPreconCoarsen%s.okl", suffix);
       sprintf(kernelName, "ellipticPreconCoarsen%s", suffix);
-      elliptic->precon->coarsenKernel = mesh->device.buildKernel(fileName,kernelName,kernelInfo);
+      elliptic->precon->coarsenKernel = meshBuildKernel(mesh, fileName,kernelName,kernelInfo);
 
       sprintf(fileName, DELLIPTIC "/okl/ellipticPreconProlongate%s.okl", suffix);
       sprintf(kernelName, "ellipticPreconProlongate%s", suffix);
-      elliptic->precon->prolongateKernel = mesh->device.buildKernel(fileName,kernelName,kernelInfo);
+      elliptic->precon->prolongateKernel = meshBuildKernel(mesh, fileName,kernelName,kernelInfo);
 
       sprintf(fileName, DELLIPTIC "/okl/ellipticBlockJacobiPrecon.okl");
       sprintf(kernelName, "ellipticBlockJacobiPrecon");
-      elliptic->precon->blockJacobiKernel = mesh->device.buildKernel(fileName,kernelName,kernelInfo);
+      elliptic->precon->blockJacobiKernel = meshBuildKernel(mesh, fileName,kernelName,kernelInfo);
 
       sprintf(kernelName, "ellipticPartialBlockJacobiPrecon");
-      elliptic->precon->partialblockJacobiKernel = mesh->device.buildKernel(fileName,kernelName,kernelInfo);
+      elliptic->precon->partialblockJacobiKernel = meshBuildKernel(mesh, fileName,kernelName,kernelInfo);
 
-      sprintf(fileName, DELLIPTIC "/okl/ellipticPatchSolver.okl");
-      sprintf(kernelName, "ellipticApproxBlockJacobiSolver");
-      elliptic->precon->approxBlockJacobiSolverKernel = mesh->device.buildKernel(fileName,kernelName,kernelInfo);
+      ellipticBuildSmootherKernels(elliptic, kernelInfo, suffix);
 
       if (   elliptic->elementType == TRIANGLES 
           || elliptic->elementType == TETRAHEDRA) {
         elliptic->precon->SEMFEMInterpKernel =
-          mesh->device.buildKernel(DELLIPTIC "/okl/ellipticSEMFEMInterp.okl",
+          meshBuildKernel(mesh, DELLIPTIC "/okl/ellipticSEMFEMInterp.okl",
                      "ellipticSEMFEMInterp",
                      kernelInfo);
 
         elliptic->precon->SEMFEMAnterpKernel =
-          mesh->device.buildKernel(DELLIPTIC "/okl/ellipticSEMFEMAnterp.okl",
+          meshBuildKernel(mesh, DELLIPTIC "/okl/ellipticSEMFEMAnterp.okl",
                      "ellipticSEMFEMAnterp",
                      kernelInfo);
       }
@@ -535,3 +664,71 @@ void ellipticSolveSetup(elliptic_t *elliptic, dfloat lambda, occa::properties &k
 
   elliptic->precon->preconBytes = usedBytes;
 }
+
+// workspace and kernels for solving Nfields systems with ellipticBlockSolve.
+// The fields are stored offset entries apart and the workspace lives on solvers[0].
+void ellipticBlockSolveSetup(elliptic_t **solvers, int Nfields, dlong offset, occa::properties &kernelInfo){
+
+  elliptic_t *elliptic = solvers[0];
+  mesh_t *mesh = elliptic->mesh;
+
+  //sanity checking
+  for(int fld=0;fld<Nfields;++fld){
+    if (!solvers[fld]->options.compareArgs("DISCRETIZATION","CONTINUOUS")) {
+      printf("ERROR: block solves are only available for the CONTINUOUS discretization\n");
+      MPI_Finalize();
+      exit(-1);
+    }
+    if (solvers[fld]->allNeumann) {
+      printf("ERROR: block solves are unavailable for all Neumann boundary conditions\n");
+      MPI_Finalize();
+      exit(-1);
+    }
+  }
+
+  elliptic->NblockFields = Nfields;
+  elliptic->blockFieldOffset = offset;
+
+  dlong Ntotal = mesh->Nelements*mesh->Np;
+  dlong Nblock = mymax(1,(Ntotal+blockSize-1)/blockSize);
+
+  dfloat *zeros = (dfloat*) calloc(Nfields*offset, sizeof(dfloat));
+  elliptic->o_blockP  = mesh->device.malloc(Nfields*offset*sizeof(dfloat), zeros);
+  elliptic->o_blockZ  = mesh->device.malloc(Nfields*offset*sizeof(dfloat), zeros);
+  elliptic->o_blockAp = mesh->device.malloc(Nfields*offset*sizeof(dfloat), zeros);
+  free(zeros);
+
+  elliptic->o_blockAlpha = mesh->device.malloc(Nfields*sizeof(dfloat));
+  elliptic->o_blockBeta  = mesh->device.malloc(Nfields*sizeof(dfloat));
+
+  // room for two dot products per field (flexible PCG)
+  elliptic->blockTmp = (dfloat*) occaHostMallocPinned(mesh->device, 2*Nfields*Nblock*sizeof(dfloat), NULL, elliptic->o_blockTmp);
+  elliptic->blockDots = (double*) calloc(4*Nfields, sizeof(double));
+
+  kernelInfo["defines/" "p_blockSize"]= blockSize;
+
+  for (int r=0;r<meshBuildKernelStages;r++) {
+    if (r==meshBuildKernelStage(mesh)) {
+      elliptic->blockWeightedInnerProductKernel =
+        meshBuildKernel(mesh, DELLIPTIC "/okl/ellipticBlockPCG.okl",
+                   "ellipticBlockWeightedInnerProduct",
+                   kernelInfo);
+
+      elliptic->blockUpdatePCGKernel =
+        meshBuildKernel(mesh, DELLIPTIC "/okl/ellipticBlockPCG.okl",
+                   "ellipticBlockUpdatePCG",
+                   kernelInfo);
+
+      elliptic->blockFlexibleInnerProductsKernel =
+        meshBuildKernel(mesh, DELLIPTIC "/okl/ellipticBlockPCG.okl",
+                   "ellipticBlockFlexibleInnerProducts",
+                   kernelInfo);
+
+      elliptic->blockScaledAddKernel =
+        meshBuildKernel(mesh, DELLIPTIC "/okl/ellipticBlockPCG.okl",
+                   "ellipticBlockScaledAdd",
+                   kernelInfo);
+    }
+    MPI_Barrier(mesh->comm);
+  }
+}
@@ -43,11 +43,9 @@ dfloat ellipticWeightedInnerProduct(elliptic_t *elliptic, occa::memory &o_w, occ
   mesh_t *mesh = elliptic->mesh;
   dfloat *tmp = elliptic->tmp;
   dlong Nblock = elliptic->Nblock;
-  dlong Nblock2 = elliptic->Nblock2;
   dlong Ntotal = mesh->Nelements*mesh->Np;
 
   occa::memory &o_tmp = elliptic->o_tmp;
-  occa::memory &o_tmp2 = elliptic->o_tmp2;
 
   occaTimerTic(mesh->device,"weighted inner product2");
   if(elliptic->options.compareArgs("DISCRETIZATION","CONTINUOUS"))
@@ -57,27 +55,11 @@ dfloat ellipticWeightedInnerProduct(elliptic_t *elliptic, occa::memory &o_w, occ
 
   occaTimerToc(mesh->device,"weighted inner product2");
 
-  /* add a second sweep if Nblock>Ncutoff */
-  dlong Ncutoff = 10;
-  dlong Nfinal;
-  if(Nblock>Ncutoff){
-
-    mesh->sumKernel(Nblock, o_tmp, o_tmp2);
-
-    o_tmp2.copyTo(tmp);
-
-    Nfinal = Nblock2;
-	
-  }
-  else{
-    o_tmp.copyTo(tmp);
-    
-    Nfinal = Nblock;
-
-  }    
+  // block partial sums land in pinned host memory
+  mesh->device.finish();
 
   dfloat wab = 0;
-  for(dlong n=0;n<Nfinal;++n){
+  for(dlong n=0;n<Nblock;++n){
     wab += tmp[n];
   }
 
@@ -119,7 +101,7 @@ dfloat ellipticCascadingWeightedInnerProduct(elliptic_t *elliptic, occa::memory
   
   occaTimerToc(mesh->device,"weighted inner product2");
   
-  o_tmp.copyTo(tmp);
+  mesh->device.finish();
   
   for(int n=0;n<Nblock;++n){
     const dfloat ftmpn = tmp[n];
@@ -151,11 +133,9 @@ dfloat ellipticWeightedNorm2(elliptic_t *elliptic, occa::memory &o_w, occa::memo
   mesh_t *mesh = elliptic->mesh;
   dfloat *tmp = elliptic->tmp;
   dlong Nblock = elliptic->Nblock;
-  dlong Nblock2 = elliptic->Nblock2;
   dlong Ntotal = mesh->Nelements*mesh->Np;
 
   occa::memory &o_tmp = elliptic->o_tmp;
-  occa::memory &o_tmp2 = elliptic->o_tmp2;
 
   occaTimerTic(mesh->device,"weighted inner product2");
   if(elliptic->options.compareArgs("DISCRETIZATION","CONTINUOUS"))
@@ -165,27 +145,11 @@ dfloat ellipticWeightedNorm2(elliptic_t *elliptic, occa::memory &o_w, occa::memo
 
   occaTimerToc(mesh->device,"weighted norm2");
 
-  /* add a second sweep if Nblock>Ncutoff */
-  dlong Ncutoff = 10;
-  dlong Nfinal;
-  if(Nblock>Ncutoff){
-    
-    mesh->sumKernel(Nblock, o_tmp, o_tmp2);
-    
-    o_tmp2.copyTo(tmp);
-    
-    Nfinal = Nblock2;
-	
-  }
-  else{
-    o_tmp.copyTo(tmp);
-    
-    Nfinal = Nblock;
-
-  }    
+  // block partial sums land in pinned host memory
+  mesh->device.finish();
 
   dfloat wab = 0;
-  for(dlong n=0;n<Nfinal;++n){
+  for(dlong n=0;n<Nblock;++n){
     wab += tmp[n];
   }
 
@@ -209,7 +173,7 @@ dfloat ellipticInnerProduct(elliptic_t *elliptic, occa::memory &o_a, occa::memor
   elliptic->innerProductKernel(Ntotal, o_a, o_b, o_tmp);
   occaTimerToc(mesh->device,"inner product");
 
-  o_tmp.copyTo(tmp);
+  mesh->device.finish();
 
   dfloat ab = 0;
   for(dlong n=0;n<Nblock;++n){
@@ -221,3 +185,88 @@ dfloat ellipticInnerProduct(elliptic_t *elliptic, occa::memory &o_a, occa::memor
 
   return globalab;
 }
+
+// x <= x + alpha*p, r <= r - alpha*Ap, returns dot(r,r) in a single sweep
+dfloat ellipticUpdatePCG(elliptic_t *elliptic, occa::memory &o_w, occa::memory &o_p, occa::memory &o_Ap,
+                         dfloat alpha, occa::memory &o_x, occa::memory &o_r){
+
+  mesh_t *mesh = elliptic->mesh;
+  dfloat *tmp = elliptic->tmp;
+  dlong Nblock = elliptic->Nblock;
+  dlong Ntotal = mesh->Nelements*mesh->Np;
+
+  int weighted = elliptic->options.compareArgs("DISCRETIZATION","CONTINUOUS") ? 1:0;
+
+  double rdotr = 0;
+
+  if(elliptic->atomicReduction){
+    // single pass: the kernel adds every block sum into o_dots
+    const dfloat zero = 0;
+    elliptic->o_dots.copyFrom(&zero, sizeof(dfloat));
+
+    occaTimerTic(mesh->device,"updatePCGKernel");
+    elliptic->updatePCGKernel(Ntotal, weighted, o_w, alpha, o_p, o_Ap, o_x, o_r, elliptic->o_dots);
+    occaTimerToc(mesh->device,"updatePCGKernel");
+
+    elliptic->o_dots.copyTo(tmp, sizeof(dfloat));
+    rdotr = tmp[0];
+  } else {
+    occaTimerTic(mesh->device,"updatePCGKernel");
+    elliptic->updatePCGKernel(Ntotal, weighted, o_w, alpha, o_p, o_Ap, o_x, o_r, elliptic->o_tmp);
+    occaTimerToc(mesh->device,"updatePCGKernel");
+
+    mesh->device.finish();
+
+    for(dlong n=0;n<Nblock;++n){
+      rdotr += tmp[n];
+    }
+  }
+
+  double globalrdotr = 0;
+  MPI_Allreduce(&rdotr, &globalrdotr, 1, MPI_DOUBLE, MPI_SUM, mesh->comm);
+
+  return globalrdotr;
+}
+
+// dot(z,r) and dot(z,Ap) in a single sweep and a single reduction
+void ellipticFlexibleInnerProductsPCG(elliptic_t *elliptic, occa::memory &o_w, occa::memory &o_z,
+                                      occa::memory &o_r, occa::memory &o_Ap, dfloat *zdotr, dfloat *zdotAp){
+
+  mesh_t *mesh = elliptic->mesh;
+  dfloat *tmp = elliptic->tmp;
+  dlong Nblock = elliptic->Nblock;
+  dlong Ntotal = mesh->Nelements*mesh->Np;
+
+  int weighted = elliptic->options.compareArgs("DISCRETIZATION","CONTINUOUS") ? 1:0;
+
+  double zdots[2] = {0,0}, globalzdots[2] = {0,0};
+
+  if(elliptic->atomicReduction){
+    const dfloat zeros[2] = {0,0};
+    elliptic->o_dots.copyFrom(zeros, 2*sizeof(dfloat));
+
+    occaTimerTic(mesh->device,"flexibleInnerProductsPCGKernel");
+    elliptic->flexibleInnerProductsPCGKernel(Ntotal, weighted, o_w, o_z, o_r, o_Ap, elliptic->o_dots);
+    occaTimerToc(mesh->device,"flexibleInnerProductsPCGKernel");
+
+    elliptic->o_dots.copyTo(tmp, 2*sizeof(dfloat));
+    zdots[0] = tmp[0];
+    zdots[1] = tmp[1];
+  } else {
+    occaTimerTic(mesh->device,"flexibleInnerProductsPCGKernel");
+    elliptic->flexibleInnerProductsPCGKernel(Ntotal, weighted, o_w, o_z, o_r, o_Ap, elliptic->o_tmp);
+    occaTimerToc(mesh->device,"flexibleInnerProductsPCGKernel");
+
+    mesh->device.finish();
+
+    for(dlong n=0;n<Nblock;++n){
+      zdots[0] += tmp[2*n+0];
+      zdots[1] += tmp[2*n+1];
+    }
+  }
+
+  MPI_Allreduce(zdots, globalzdots, 2, MPI_DOUBLE, MPI_SUM, mesh->comm);
+
+  *zdotr  = globalzdots[0];
+  *zdotAp = globalzdots[1];
+}
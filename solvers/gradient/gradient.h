@@ -49,21 +49,14 @@ typedef struct{
 
   dfloat *q, *gradientq;
 
-  dfloat *plotInterp;
-  int *plotEToV;
-  
   int frame;
 
   mesh_t *mesh;
 
   occa::kernel gradientKernel;
-  occa::kernel isoSurfaceKernel;
   occa::memory o_q;
   occa::memory o_gradientq;
 
-  occa::memory o_plotEToV;
-  occa::memory o_plotInterp;
-  
   //halo data
   dlong haloBytes;
   dfloat *sendBuffer;
@@ -85,5 +78,3 @@ void gradientError(mesh_t *mesh, dfloat time);
 
 void gradientReport(gradient_t *gradient, dfloat time, setupAide &options);
 
-void gradientPlotVTU(gradient_t *gradient, int isoNtris, dfloat *isoq, char *fileName);
-
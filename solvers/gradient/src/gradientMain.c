@@ -106,6 +106,10 @@ int main(int argc, char **argv){
   if(mesh->dim==3)
    gradientReport(gradient, 0.0,  options);
 
+  // wait for the isosurface to be written
+  if(mesh->dim==3)
+    meshIsoSurfaceFinish(mesh);
+
   // close down MPI
   MPI_Finalize();
 
@@ -30,15 +30,10 @@ void gradientReport(gradient_t *gradient, dfloat time, setupAide &options){
 
   mesh3D *mesh = gradient->mesh;
 
-  int isoField = 3;
+  int isoField = 0; // q field to isosurface
   int isoNlevels = 4;
-  int isoMaxNtris = 1E8;
   
   dfloat *isoLevels = (dfloat*) calloc(isoNlevels, sizeof(dfloat));
-  int *isoNtris = (int*) calloc(1, sizeof(int));
-
-  size_t isoMax = (mesh->dim + gradient->Nfields)*3*isoMaxNtris;
-  dfloat *isoq = (dfloat*) calloc(isoMax, sizeof(dfloat));
 
   dfloat isoMinVal = -.8;
   dfloat isoMaxVal = .8;
@@ -47,59 +42,22 @@ void gradientReport(gradient_t *gradient, dfloat time, setupAide &options){
     isoLevels[l] = isoMinVal + (isoMaxVal-isoMinVal)*l/(dfloat)(isoNlevels-1);
 
   occa::memory o_isoLevels = mesh->device.malloc(isoNlevels*sizeof(dfloat), isoLevels);
-  occa::memory o_isoq      = mesh->device.malloc(isoMax*sizeof(dfloat), isoq);
-
-  // note that this should be zero before calling isoSurface kernel
-  occa::memory o_isoNtris  = mesh->device.malloc(1*sizeof(int), isoNtris);
-    
-						 
-  gradient->isoSurfaceKernel(mesh->Nelements,    // number of elements
-			     isoField,     // which field to use for isosurfacing
-			     isoNlevels,   // number of isosurface levels
-			     o_isoLevels,  // array of isosurface levels
-			     isoMaxNtris,  // maximum number of generated triangles
-			     mesh->o_x,
-			     mesh->o_y,
-			     mesh->o_z,
-			     gradient->o_q,
-			     gradient->o_plotInterp,
-			     gradient->o_plotEToV,
-			     o_isoNtris,  // output: number of generated triangles
-			     o_isoq       // output: (p_dim+p_Nfields)*3*isoNtris[0] values (x,y,z,q0,q1..)
-			     );
-  
 
-  // find number of generated triangles
-  o_isoNtris.copyTo(isoNtris);
-  isoNtris[0] = mymin(isoNtris[0], isoMaxNtris);
+  // triangles are counted, placed and welded on the device
+  dlong Ntris = meshIsoSurfaceExtract(mesh, mesh->Nelements, NULL, isoField,
+                                      isoNlevels, o_isoLevels, gradient->o_q);
   
-  printf("generated %d triangles\n", isoNtris[0]);
-  
-  //
-  int offset = 0;
-  o_isoq.copyTo(isoq, isoNtris[0]*(mesh->dim+gradient->Nfields)*3*sizeof(dfloat), offset);
-
-#if 0
-  for(int n=0;n<isoNtris[0];++n){
-    for(int v=0;v<3;++v){
-      printf("[%d,%d]: [", n, v);
-      for(int fld=0;fld<(mesh->dim+gradient->Nfields);++fld){
-	int id = (n*3+v)*(mesh->dim+gradient->Nfields) + fld;
-	printf(" %f", isoq[id]);
-      }
-      printf("]\n");
-    }
-  }
-#endif			  
+  printf("generated %d triangles\n", (int) Ntris);
   
-#if 1
   // output field files
   char fname[BUFSIZ];
   string outName;
   options.getArgs("OUTPUT FILE NAME", outName);
-  sprintf(fname, "%s_%04d_%04d.vtu",(char*)outName.c_str(), mesh->rank, gradient->frame++);
+  sprintf(fname, "%s",(char*)outName.c_str());
 
-  gradientPlotVTU(gradient, isoNtris[0], isoq, fname);
-#endif
+  const char *isoNames[1] = {"q"};
+  meshIsoSurfaceWrite(mesh, fname, gradient->frame++, isoNames);
 
+  o_isoLevels.free();
+  free(isoLevels);
 }
@@ -78,23 +78,6 @@ gradient_t *gradientSetup(mesh_t *mesh, setupAide &options){
   gradient->o_gradientq =
     mesh->device.malloc(mesh->Np*(mesh->totalHaloPairs+mesh->Nelements)*mesh->dim*sizeof(dfloat));
 
-  dfloat *plotInterp = (dfloat*) calloc(mesh->plotNp*mesh->Np, sizeof(dfloat));
-  for(int n=0;n<mesh->plotNp;++n){
-    for(int m=0;m<mesh->Np;++m){
-      plotInterp[n+m*mesh->plotNp] = mesh->plotInterp[n*mesh->Np+m];
-    }
-  }
-  gradient->o_plotInterp = mesh->device.malloc(mesh->plotNp*mesh->Np*sizeof(dfloat), plotInterp);
-
-  int *plotEToV = (int*) calloc(mesh->plotNp*mesh->Np, sizeof(int));
-  for(int n=0;n<mesh->plotNelements;++n){
-    for(int m=0;m<mesh->plotNverts;++m){
-      plotEToV[n+m*mesh->plotNelements] = mesh->plotEToV[n*mesh->plotNverts+m];
-    }
-  }
-  gradient->o_plotEToV = mesh->device.malloc(mesh->plotNp*mesh->Np*sizeof(int), plotEToV);
-  
-  
   if(mesh->totalHaloPairs>0){
     // temporary DEVICE buffer for halo (maximum size Nfields*Np for dfloat)
     mesh->o_haloBuffer =
@@ -124,11 +107,6 @@ gradient_t *gradientSetup(mesh_t *mesh, setupAide &options){
   
   kernelInfo["defines/" "p_Nfields"]= mesh->Nfields;
   kernelInfo["defines/" "p_dim"]= mesh->dim;
-  kernelInfo["defines/" "p_plotNp"]= mesh->plotNp;
-  kernelInfo["defines/" "p_plotNelements"]= mesh->plotNelements;
-
-  int plotNthreads = mymax(mesh->Np, mymax(mesh->plotNp, mesh->plotNelements));
-  kernelInfo["defines/" "p_plotNthreads"]= plotNthreads;
   
   const dfloat p_one = 1.0, p_two = 2.0, p_half = 1./2., p_third = 1./3., p_zero = 0;
 
@@ -177,15 +155,6 @@ gradient_t *gradientSetup(mesh_t *mesh, setupAide &options){
     MPI_Barrier(mesh->comm);
     if (r==mesh->rank) {
 
-      // kernels from volume file
-      if(mesh->dim==3){
-	sprintf(fileName, DHOLMES "/okl/meshIsoSurface3D.okl");
-	sprintf(kernelName, "meshIsoSurface3D");
-	
-	gradient->isoSurfaceKernel =
-	  mesh->device.buildKernel(fileName, kernelName, kernelInfo);
-      }
-      
       // kernels from volume file
       sprintf(fileName, DGRADIENT "/okl/gradientVolume%s.okl",
 	      suffix);
@@ -206,5 +175,9 @@ gradient_t *gradientSetup(mesh_t *mesh, setupAide &options){
     }
   }
 
+  // isosurfaces of q are extracted on the device
+  if(mesh->dim==3)
+    meshIsoSurfaceSetup(mesh, kernelInfo, gradient->Nfields);
+
   return gradient;
 }
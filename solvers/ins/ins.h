@@ -71,11 +71,24 @@ typedef struct {
   int   outputForceStep; 
   int   dtAdaptStep; 
 
+  // per-element length scale and block minima for the device dt reduction
+  dfloat *hmin, *dtBlock;
+  occa::memory o_hmin, o_dtBlock;
+
+  // Lagrange weights resampling the history after a dt change
+  dfloat *interpC;
+  occa::memory o_interpC;
+
+  // lambda the velocity preconditioners were last built with
+  dfloat vPreconLambda;
+
 
   int ARKswitch;
   
   int NiterU, NiterV, NiterW, NiterP;
 
+  int vBlockSolve; // solve all velocity components in one block PCG loop
+
 
   //solver tolerances
   dfloat presTOL, velTOL;
@@ -114,13 +127,11 @@ typedef struct {
   dfloat *vRecvBuffer;
   dfloat *pSendBuffer;
   dfloat *pRecvBuffer;
-  dfloat * velocityHaloGatherTmp;
 
   occa::memory o_vSendBuffer;
   occa::memory o_vRecvBuffer;
   occa::memory o_pSendBuffer;
   occa::memory o_pRecvBuffer;
-  occa::memory o_gatherTmpPinned;
 
 
   int Nsubsteps;  
@@ -131,15 +142,11 @@ typedef struct {
   occa::memory o_cU, o_cUd;
 
   // Some Iso-surfacing variables
-  int isoField, isoColorField, isoNfields, isoNlevels, isoMaxNtris, *isoNtris; 
-  dfloat isoMinVal, isoMaxVal, *isoLevels, *isoq; 
-  size_t isoMax; 
+  int isoField, isoColorField, isoNfields, isoNlevels; 
+  dfloat isoMinVal, isoMaxVal; 
   
   int *isoGNlevels, isoGNgroups;
   dfloat **isoGLvalues;
-  // NBN: add storage for compacted isosurf data for gmsh write
-  std::vector<dfloat> iso_nodes;
-  std::vector<int> iso_tris;
 
 
   int readRestartFile,writeRestartFile, restartedFromFile;
@@ -147,8 +154,7 @@ typedef struct {
 
 
   occa::memory *o_isoGLvalues; 
-  occa::memory o_isoLevels, o_isoq, o_isoNtris; 
-  occa::memory o_plotInterp, o_plotEToV; 
+  occa::memory o_isoq; // fields staged for meshIsoSurfaceExtract
 
 
 
@@ -159,6 +165,9 @@ typedef struct {
   occa::kernel subCycleRKUpdateKernel;
   occa::kernel subCycleExtKernel;
 
+  occa::kernel computeDtKernel;
+  occa::kernel interpolateHistoryKernel;
+
 
   occa::memory o_U, o_P;
   occa::memory o_rhsU, o_rhsV, o_rhsW, o_rhsP; 
@@ -167,13 +176,13 @@ typedef struct {
   occa::memory o_GU;
 
   occa::memory o_UH, o_VH, o_WH;
+  occa::memory o_blockRhsU, o_blockUH; // all velocity components, fieldOffset apart
   occa::memory o_rkU, o_rkP, o_PI;
   occa::memory o_rkNU, o_rkLU, o_rkGP;
 
   occa::memory o_Vort, o_Div;
 
   occa::memory o_vHaloBuffer, o_pHaloBuffer; 
-  occa::memory o_velocityHaloGatherTmp;
 
   //ARK data
   occa::memory o_rkC;
@@ -222,7 +231,7 @@ typedef struct {
   occa::kernel velocityUpdateKernel;  
   
   occa::kernel vorticityKernel;
-  occa::kernel isoSurfaceKernel;
+  occa::kernel isoStageKernel;
 
 
 }ins_t;
@@ -237,6 +246,8 @@ void insReport(ins_t *ins, dfloat time,  int tstep);
 void insError(ins_t *ins, dfloat time);
 void insForces(ins_t *ins, dfloat time);
 void insComputeDt(ins_t *ins, dfloat time); 
+void insInterpolateHistory(ins_t *ins, dfloat time, dfloat dtOld, dfloat dtNew);
+void insUpdateVelocityPreconditioner(ins_t *ins);
 
 void insAdvection(ins_t *ins, dfloat time, occa::memory o_U, occa::memory o_NU);
 void insDiffusion(ins_t *ins, dfloat time, occa::memory o_U, occa::memory o_LU);
@@ -252,10 +263,6 @@ void insPressureRhs  (ins_t *ins, dfloat time, int stage);
 void insPressureSolve(ins_t *ins, dfloat time, int stage);
 void insPressureUpdate(ins_t *ins, dfloat time, int stage, occa::memory o_rkP);
 
-// Welding  to Tris, needs to be moved seperate library
-int insWeldTriVerts(ins_t *ins, int isoNtris, dfloat *isoq);
-void insIsoPlotVTU(ins_t *ins, char *fileName);
-
 // Restarting from file
 void insRestartWrite(ins_t *ins, setupAide &options, dfloat time); 
 void insRestartRead(ins_t *ins, setupAide &options); 
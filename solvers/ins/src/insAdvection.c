@@ -71,7 +71,7 @@ void insAdvection(ins_t *ins, dfloat time, occa::memory o_U, occa::memory o_NU){
                                o_U,
                                o_NU);
   }
-  occaTimerToc(mesh->device,"AdvectionVolume");
+  occaTimerToc(mesh->device,"AdvectionVolume", mesh->Nelements);
 
   // COMPLETE HALO EXCHANGE
   if(mesh->totalHaloPairs>0){
@@ -55,19 +55,11 @@ void insDiffusion(ins_t *ins, dfloat time, occa::memory o_U, occa::memory o_LU){
                            ins->fieldOffset,
                            o_U, 
                            o_LU);
-
-      mesh->device.finish();
-      mesh->device.setStream(uSolver->dataStream);
-      mesh->gatherKernel(ogs->NhaloGather, 
-                         ogs->o_haloGatherOffsets, 
-                         ogs->o_haloGatherLocalIds, 
-                         o_LU, 
-                         ins->NVfields,
-                         ins->fieldOffset,
-                         ins->o_velocityHaloGatherTmp);
-      ins->o_velocityHaloGatherTmp.copyTo(ins->velocityHaloGatherTmp,"async: true");
-      mesh->device.setStream(uSolver->defaultStream);
     }
+
+    // start C0 halo gather-scatter of all velocity components in one message
+    meshParallelGatherScatterStart(mesh, ogs, o_LU, ins->NVfields, ins->fieldOffset);
+
     if(uSolver->NlocalGatherElements){
         ins->diffusionKernel(uSolver->NlocalGatherElements, 
                              uSolver->o_localGatherElementList,
@@ -98,32 +90,8 @@ void insDiffusion(ins_t *ins, dfloat time, occa::memory o_U, occa::memory o_LU){
                                 ins->fieldOffset, 
                                 o_LU);
 
-    // C0 halo gather-scatter (on data stream)
-    if(ogs->NhaloGather) {
-      mesh->device.setStream(uSolver->dataStream);
-      mesh->device.finish();
-
-      // MPI based gather scatter using libgs
-      gsVecParallelGatherScatter(ogs->haloGsh, ins->velocityHaloGatherTmp, ins->NVfields, dfloatString, "add");
-
-      // copy totally gather halo data back from HOST to DEVICE
-      ins->o_velocityHaloGatherTmp.copyFrom(ins->velocityHaloGatherTmp,"async: true");
-    
-      // do scatter back to local nodes
-      mesh->scatterKernel(ogs->NhaloGather, 
-                          ogs->o_haloGatherOffsets, 
-                          ogs->o_haloGatherLocalIds, 
-                          ins->NVfields,
-                          ins->fieldOffset,
-                          ins->o_velocityHaloGatherTmp, 
-                          o_LU);
-      mesh->device.setStream(uSolver->defaultStream);
-    }
-
-    mesh->device.finish();    
-    mesh->device.setStream(uSolver->dataStream);
-    mesh->device.finish();    
-    mesh->device.setStream(uSolver->defaultStream);
+    // finish C0 halo gather-scatter
+    meshParallelGatherScatterFinish(mesh, ogs, o_LU, ins->NVfields, ins->fieldOffset);
 
   } else if(options.compareArgs("DISCRETIZATION", "IPDG")) {
     dlong offset = 0;
@@ -59,7 +59,7 @@ void insDivergence(ins_t *ins, dfloat time, occa::memory o_U, occa::memory o_DU)
                              ins->fieldOffset,
                              o_U,
                              o_DU);
-  occaTimerToc(mesh->device,"DivergenceVolume");
+  occaTimerToc(mesh->device,"DivergenceVolume", mesh->Nelements);
 
   //if (ins->vOptions.compareArgs("DISCRETIZATION","IPDG")) {
     if(mesh->totalHaloPairs>0){
@@ -58,7 +58,7 @@ void insGradient(ins_t *ins, dfloat time, occa::memory o_P, occa::memory o_GP){
                             ins->fieldOffset,
                             o_P,
                             o_GP);
-  occaTimerToc(mesh->device,"GradientVolume");
+  occaTimerToc(mesh->device,"GradientVolume", mesh->Nelements);
 
   // COMPLETE HALO EXCHANGE
   if (ins->pOptions.compareArgs("DISCRETIZATION","IPDG")) {
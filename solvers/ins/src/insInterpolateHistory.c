@@ -0,0 +1,82 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "ins.h"
+
+// Resample the EXTBDF history from the old step size to the new one, level s
+// is moved from time-s*dtOld to time-s*dtNew by Lagrange interpolation through
+// all Nstages levels so the fixed step coefficients stay valid after a dt change
+void insInterpolateHistory(ins_t *ins, dfloat time, dfloat dtOld, dfloat dtNew){
+
+  const int Nstages = ins->Nstages;
+  if(Nstages<2) return;
+
+  for(int k=0;k<Nstages;++k){
+    const dfloat tk = -k*dtNew;
+    for(int s=0;s<Nstages;++s){
+      dfloat c = 1.0;
+      for(int m=0;m<Nstages;++m){
+        if(m==s) continue;
+        c *= (tk + m*dtOld)/((m-s)*dtOld);
+      }
+      ins->interpC[k*Nstages+s] = c;
+    }
+  }
+  ins->o_interpC.copyFrom(ins->interpC);
+
+  const dlong NV = ins->NVfields*ins->Ntotal;
+
+  ins->interpolateHistoryKernel(NV, NV, ins->o_interpC, ins->o_U);
+  ins->interpolateHistoryKernel(ins->Ntotal, ins->Ntotal, ins->o_interpC, ins->o_P);
+
+  // level 0 of the explicit terms is only filled during the step, evaluate it
+  // here so the interpolation sees the full history
+  insGradient(ins, time, ins->o_P, ins->o_GP);
+  ins->interpolateHistoryKernel(NV, NV, ins->o_interpC, ins->o_GP);
+
+  // subcycling rebuilds the advection from the velocity history
+  if(!ins->Nsubsteps){
+    insAdvection(ins, time, ins->o_U, ins->o_NU);
+    ins->interpolateHistoryKernel(NV, NV, ins->o_interpC, ins->o_NU);
+  }
+}
+
+// relative change of lambda that triggers a rebuild of the velocity preconditioners
+#define vPreconLambdaTolerance 0.05
+
+// refresh the velocity preconditioners after a dt change moved lambda
+void insUpdateVelocityPreconditioner(ins_t *ins){
+
+  const dfloat change = fabs(ins->lambda-ins->vPreconLambda)/ins->vPreconLambda;
+  if(change<=vPreconLambdaTolerance) return;
+
+  ellipticUpdateJacobi(ins->uSolver, ins->lambda);
+  ellipticUpdateJacobi(ins->vSolver, ins->lambda);
+  if(ins->dim==3)
+    ellipticUpdateJacobi(ins->wSolver, ins->lambda);
+
+  ins->vPreconLambda = ins->lambda;
+}
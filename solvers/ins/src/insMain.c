@@ -48,6 +48,9 @@ int main(int argc, char **argv){
   options.getArgs("POLYNOMIAL DEGREE", N);
   options.getArgs("ELEMENT TYPE", elementType);
   options.getArgs("MESH DIMENSION", dim);
+
+  // optional boundary refinement of the geometric partition
+  meshSetPartitionRefinement(options);
   
   // set up mesh
   mesh_t *mesh;
@@ -75,6 +78,14 @@ int main(int argc, char **argv){
   if (ins->options.compareArgs("TIME INTEGRATOR", "ARK"))  insRunARK(ins);
   if (ins->options.compareArgs("TIME INTEGRATOR", "EXTBDF"))  insRunEXTBDF(ins);
 
+  // wait for any output still being written
+  if (ins->options.compareArgs("OUTPUT FORMAT", "BINARY")) meshPlotVTUFinish(mesh);
+  if (ins->writeRestartFile) meshCheckpointFinish(mesh);
+  if (ins->options.compareArgs("OUTPUT TYPE", "ISO")) meshIsoSurfaceFinish(mesh);
+
+  // release persistent halo requests
+  meshHaloExchangeFree(mesh);
+
   // close down MPI
   MPI_Finalize();
 
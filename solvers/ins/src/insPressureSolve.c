@@ -76,7 +76,7 @@ void insPressureSolve(ins_t *ins, dfloat time, int stage){
     occaTimerToc(mesh->device,"PoissonRhsIpdg");
   }
 
-  //keep current PI as the initial guess?
+  // current PI is the initial guess unless PRESSURE INITIAL GUESS is PROJECTION
 
   // gather-scatter
   if(ins->pOptions.compareArgs("DISCRETIZATION","CONTINUOUS")){
@@ -74,56 +74,42 @@ void insReport(ins_t *ins, dfloat time, int tstep){
     char fname[BUFSIZ];
     string outName;
     ins->options.getArgs("OUTPUT FILE NAME", outName);
-    sprintf(fname, "%s_%04d_%04d.vtu",(char*)outName.c_str(), mesh->rank, ins->frame++);
-
-    insPlotVTU(ins, fname);
+    if(ins->options.compareArgs("OUTPUT FORMAT","BINARY")){
+      // interpolate on the device, file is written in the background
+      int NvortFields = (ins->dim==3) ? 3:1;
+      meshPlotVTUInterpolate(mesh, 0, 1, 0, ins->o_P);
+      meshPlotVTUInterpolate(mesh, 1, 1, 0, ins->o_Div);
+      meshPlotVTUInterpolate(mesh, 2, NvortFields, ins->fieldOffset, ins->o_Vort);
+      meshPlotVTUInterpolate(mesh, 2+NvortFields, ins->dim, ins->fieldOffset, ins->o_U);
+
+      const char *names[4] = {"Pressure", "Divergence", "Vorticity", "Velocity"};
+      int components[4] = {1, 1, NvortFields, ins->dim};
+      meshPlotVTUWrite(mesh, (char*)outName.c_str(), ins->frame++, 4, names, components);
+    } else {
+      sprintf(fname, "%s_%04d_%04d.vtu",(char*)outName.c_str(), mesh->rank, ins->frame++);
+      insPlotVTU(ins, fname);
+    }
   }
 
   if(ins->options.compareArgs("OUTPUT TYPE","ISO") && (ins->dim==3)){ 
 
+     ins->isoStageKernel(mesh->Nelements, ins->fieldOffset, ins->o_U, ins->o_isoq);
+
+     const char *isoNames[1] = {"Velocity Magnitude"};
+
      for (int gr=0; gr<ins->isoGNgroups; gr++){
 
-        ins->isoNtris[0] = 0; 
-        ins->o_isoNtris.copyFrom(ins->isoNtris);
-
-        ins->isoSurfaceKernel(mesh->Nelements,
-                              ins->fieldOffset,    
-                              ins->isoField,               
-                              ins->isoColorField,          
-                              ins->isoGNlevels[gr],        
-                              ins->o_isoGLvalues[gr],      
-                              ins->isoMaxNtris,            
-                              mesh->o_x,
-                              mesh->o_y,
-                              mesh->o_z,
-                              ins->o_P, 
-                              ins->o_U,
-                              ins->o_Vort,
-                              ins->o_plotInterp,
-                              ins->o_plotEToV,
-                              ins->o_isoNtris,             // output: number of generated triangles
-                              ins->o_isoq);                // output: (p_dim+p_Nfields)*3*isoNtris[0] values (x,y,z,q0,q1..)
-                  
-
-        // find number of generated triangles
-        ins->o_isoNtris.copyTo(ins->isoNtris);
-        ins->isoNtris[0] = mymin(ins->isoNtris[0], ins->isoMaxNtris);
-        // 
-        printf("Rank:%2d Group:%2d Triangles:%8d\n", mesh->rank, gr, ins->isoNtris[0]);
-        //
-        int offset = 0;
-        ins->o_isoq.copyTo(ins->isoq, ins->isoNtris[0]*(mesh->dim+ins->isoNfields)*3*sizeof(dfloat), offset);
-
-        int Ntris1 = ins->isoNtris[0];
-        int Ntris2 = insWeldTriVerts(ins, Ntris1, ins->isoq);
-
-        printf("Welding triangles:%8d to:%8d\n", Ntris1, Ntris2);
+        // counted, placed and welded on the device, written in the background
+        dlong Ntris = meshIsoSurfaceExtract(mesh, mesh->Nelements, NULL, 0,
+                                            ins->isoGNlevels[gr], ins->o_isoGLvalues[gr], ins->o_isoq);
+
+        printf("Rank:%2d Group:%2d Triangles:%8d\n", mesh->rank, gr, (int) Ntris);
 
         char fname[BUFSIZ];
         string outName;
         ins->options.getArgs("OUTPUT FILE NAME", outName);
-        sprintf(fname, "%s_%d_%d_ %04d_%04d.vtu",(char*)outName.c_str(), ins->isoField, gr, mesh->rank, ins->frame++);
-        insIsoPlotVTU(ins,  fname);
+        sprintf(fname, "%s_%d_%d",(char*)outName.c_str(), ins->isoField, gr);
+        meshIsoSurfaceWrite(mesh, fname, ins->frame++, isoNames);
       }
   }
 
@@ -25,78 +25,52 @@ SOFTWARE.
 */
 
 #include "ins.h"
+static void insRestartField(meshCheckpointField_t *field, occa::memory &o_q, dlong offset, int Nvalues){
+  field->o_q        = o_q;
+  field->offset     = offset;
+  field->Nvalues    = Nvalues;
+  field->elementMap = NULL;
+}
+
+// EXTBDF history: U, P, NU and GP of every stage, one checkpoint field per component
+static int insRestartFields(ins_t *ins, setupAide &options, meshCheckpointField_t *fields){
+
+  mesh_t *mesh = ins->mesh;
+
+  if(!options.compareArgs("TIME INTEGRATOR", "EXTBDF")) return 0;
+
+  int Nfields = 0;
+  for(int s=0;s<ins->Nstages;s++){
+    for(int vf=0;vf<ins->NVfields;vf++){
+      const dlong offset = (s*ins->NVfields + vf)*ins->fieldOffset;
+      insRestartField(fields+Nfields++, ins->o_U,  offset, mesh->Np);
+      insRestartField(fields+Nfields++, ins->o_NU, offset, mesh->Np);
+      insRestartField(fields+Nfields++, ins->o_GP, offset, mesh->Np);
+    }
+    insRestartField(fields+Nfields++, ins->o_P, s*ins->fieldOffset, mesh->Np);
+  }
+
+  return Nfields;
+}
+
 void insRestartWrite(ins_t *ins, setupAide &options, dfloat t){
 
   mesh_t *mesh = ins->mesh; 
 
-  // Copy Field To Host
-  // copy data back to host
-  ins->o_U.copyTo(ins->U);
-  ins->o_P.copyTo(ins->P);
-  
-  // History of nonlinear terms !!!!
-  ins->o_NU.copyTo(ins->NU);
-  // History of Pressure !!!!!
-  ins->o_GP.copyTo(ins->GP);
-
   // Create Binary File Name
   char fname[BUFSIZ];
   string outName;
   options.getArgs("RESTART FILE NAME", outName);
-  sprintf(fname, "%s_%04d.dat",(char*)outName.c_str(), mesh->rank);
-  FILE *fp;
-  
-  // Overwrite  Binary File
-  fp = fopen(fname,"wb");
-  
-  // Write q1....qN and all pml variables
-  dfloat *elmField  = (dfloat *) calloc((ins->NVfields+1), sizeof(dfloat)); 
-  dfloat *elmField2 = (dfloat *) calloc(2*ins->NVfields, sizeof(dfloat)); 
-
-  // First Write the Solution Time
-  fwrite(&t, sizeof(dfloat), 1, fp);
-  //Write dt
-  fwrite(&ins->dt, sizeof(dfloat), 1, fp);
-  // Write output frame to prevent overwriting vtu files
-  fwrite(&ins->frame, sizeof(int), 1, fp);
-
-  // 
- if(options.compareArgs("TIME INTEGRATOR", "EXTBDF") ){
-
-  // Write U and P 
-  for(int s =0; s<ins->Nstages; s++){
-    for(dlong e = 0;e<mesh->Nelements; e++){
-      for(int n=0; n<mesh->Np; n++ ){
-        const dlong idv = e*mesh->Np + n + s*ins->fieldOffset*ins->NVfields; 
-        const dlong idp = e*mesh->Np + n + s*ins->fieldOffset; 
-          for(int vf = 0; vf<ins->NVfields; vf++){
-            elmField[vf]   =  ins->U[idv + vf*ins->fieldOffset];
-          }
-          elmField[ins->NVfields] = ins->P[idp]; 
-        fwrite(elmField, sizeof(dfloat), (ins->NVfields+1), fp);
-      }
-    } 
-  }
-  // Write nonlinear History 
-  for(int s =0; s<ins->Nstages; s++){
-    for(dlong e = 0;e<mesh->Nelements; e++){
-      for(int n=0; n<mesh->Np; n++ ){
-        const dlong idv = e*mesh->Np + n + s*ins->fieldOffset*ins->NVfields; 
-          
-          for(int vf = 0; vf<ins->NVfields; vf++)
-            elmField2[vf]   =  ins->NU[idv + vf*ins->fieldOffset];
-          
-          for(int vf = 0; vf<ins->NVfields; vf++)
-            elmField2[ins->NVfields+ vf]   =  ins->GP[idv + vf*ins->fieldOffset];
-
-        fwrite(elmField2, sizeof(dfloat), 2*ins->NVfields, fp);
-      }
-    } 
-  }
-}
+  sprintf(fname, "%s.dat",(char*)outName.c_str());
+
+  // solution time, dt and output frame (to prevent overwriting vtu files)
+  dfloat scalars[3] = {t, ins->dt, (dfloat) ins->frame};
 
-fclose(fp); 
+  meshCheckpointField_t fields[4*3*3];
+  int Nfields = insRestartFields(ins, options, fields);
 
+  // staged to host here, written to disk in the background
+  meshCheckpointWrite(mesh, fname, 3, scalars, Nfields, fields);
 }
 
 
@@ -110,67 +84,25 @@ void insRestartRead(ins_t *ins, setupAide &options){
   char fname[BUFSIZ];
   string outName;
   options.getArgs("RESTART FILE NAME", outName);
-  sprintf(fname, "%s_%04d.dat",(char*)outName.c_str(), mesh->rank);
-  FILE *fp; 
-
+  sprintf(fname, "%s.dat",(char*)outName.c_str());
 
   ins->restartedFromFile = 0; 
-  // Overwrite  Binary File
-  fp = fopen(fname,"rb");
-
-  if(fp != NULL){
-  
-      // Write q1....qN and all pml variables
-    dfloat *elmField  = (dfloat *) calloc((ins->NVfields+1), sizeof(dfloat)); 
-    dfloat *elmField2 = (dfloat *) calloc(2*ins->NVfields, sizeof(dfloat)); 
-
-    // First Write the Solution Time
-    dfloat startTime = 0.0, dtold = 0.0;  
-    fread(&startTime, sizeof(dfloat), 1, fp); 
-    //Write dt
-    fread(&dtold, sizeof(dfloat), 1, fp);
-    // Write output frame to prevent overwriting vtu files
-    fread(&ins->frame, sizeof(int), 1, fp);
-
-    // 
-    if(options.compareArgs("TIME INTEGRATOR", "EXTBDF") ){
 
-      // Write U and P
-      for(int s =0; s<ins->Nstages; s++){
-        for(dlong e = 0;e<mesh->Nelements; e++){
-          for(int n=0; n<mesh->Np; n++ ){
+  dfloat scalars[3] = {0.0, 0.0, 0.0};
+  meshCheckpointField_t fields[4*3*3];
+  int Nfields = insRestartFields(ins, options, fields);
 
-            fread(elmField, sizeof(dfloat), (ins->NVfields+1), fp);
+  // elements are matched by their vertices, so the rank count may differ from the writing run
+  if(meshCheckpointRead(mesh, fname, 3, scalars, Nfields, fields)){
 
-            const dlong idv = e*mesh->Np + n + s*ins->fieldOffset*ins->NVfields; 
-            const dlong idp = e*mesh->Np + n + s*ins->fieldOffset;
-
-              for(int vf = 0; vf<ins->NVfields; vf++)
-                ins->U[idv + vf*ins->fieldOffset] = elmField[vf];
-
-              ins->P[idp] = elmField[ins->NVfields]; 
-          }
-        } 
-      }
-      // Write nonlinear History 
-      for(int s =0; s<ins->Nstages; s++){
-        for(dlong e = 0;e<mesh->Nelements; e++){
-          for(int n=0; n<mesh->Np; n++ ){
-            const dlong idv = e*mesh->Np + n + s*ins->fieldOffset*ins->NVfields;       
-            fread(elmField2, sizeof(dfloat), 2*ins->NVfields, fp);       
-              for(int vf = 0; vf<ins->NVfields; vf++)
-                ins->NU[idv + vf*ins->fieldOffset] = elmField2[vf];    
-              for(int vf = 0; vf<ins->NVfields; vf++)
-                ins->GP[idv + vf*ins->fieldOffset] = elmField2[ins->NVfields+vf];
-          }
-        } 
-      }
-    }else{
-
-      if(mesh->rank==0) printf("restart for ARK has not tested yet\n");
-    }
+    dfloat startTime = scalars[0], dtold = scalars[1];
+    ins->frame = (int) scalars[2];
 
-  fclose(fp);
+    // history is interpolated on the host below
+    ins->o_U.copyTo(ins->U);
+    ins->o_P.copyTo(ins->P);
+    ins->o_NU.copyTo(ins->NU);
+    ins->o_GP.copyTo(ins->GP);
 
   ins->restartedFromFile = 1;  
   // Just Update start time
@@ -297,7 +229,7 @@ void insRestartRead(ins_t *ins, setupAide &options){
 
 
 }else{
-  printf("No restart file...");
+  if(mesh->rank==0) printf("No restart file...");
 }
 
 }
@@ -265,4 +265,6 @@ void insRunARK(ins_t *ins){
   insReport(ins, finalTime, ins->NtimeSteps);
   
   if(mesh->rank==0) occa::printTimer();
+
+  meshWriteProfile(mesh, ins->options);
 }
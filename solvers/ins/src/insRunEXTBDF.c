@@ -28,6 +28,9 @@ SOFTWARE.
 
 void extbdfCoefficents(ins_t *ins, int order);
 
+// largest step size growth per adapt, bounds how far the history resampling extrapolates
+#define insDtMaxGrowth 1.2
+
 void insRunEXTBDF(ins_t *ins){
 
   mesh_t *mesh = ins->mesh;
@@ -94,6 +97,8 @@ void insRunEXTBDF(ins_t *ins){
   // Write Initial Data
   if(ins->outputStep) insReport(ins, ins->startTime, 0);
 
+  dfloat time = ins->startTime;
+
   for(int tstep=0;tstep<ins->NtimeSteps;++tstep){
 
     // if(ins->restartedFromFile){
@@ -110,7 +115,35 @@ void insRunEXTBDF(ins_t *ins){
         extbdfCoefficents(ins,tstep+1);
     // }
 
-    dfloat time = ins->startTime + tstep*ins->dt;
+    // Update Time-Step Size once the history is complete
+    if(ins->dtAdaptStep && tstep>=ins->Nstages){
+      if((tstep%(ins->dtAdaptStep))==0){
+        const dfloat dtOld = ins->dt;
+        insComputeDt(ins, time);
+        ins->dt = mymin(ins->dt, insDtMaxGrowth*dtOld);
+
+        // land on the final time with a whole number of steps
+        const int NremainingSteps = mymax(1, (int) ceil((ins->finalTime-time)/ins->dt));
+        ins->dt = (ins->finalTime-time)/NremainingSteps;
+        ins->NtimeSteps = tstep + NremainingSteps;
+        if(ins->Nsubsteps) ins->sdt = ins->dt/ins->Nsubsteps;
+        ins->idt    = 1.0/ins->dt;
+        ins->lambda = ins->g0 / (ins->dt * ins->nu);
+
+        if (ins->dt<ins->dtMIN){
+          printf("ERROR: Time step became too small at time step=%d\n", tstep);
+          exit (-1);
+        }
+        if (isnan(ins->dt)) {
+          printf("ERROR: Solution became unstable at time step=%d\n", tstep);
+          exit (-1);
+        }
+
+        // Interpolate history for the new time step size
+        insInterpolateHistory(ins, time, dtOld, ins->dt);
+        insUpdateVelocityPreconditioner(ins);
+      }
+    }
 
     if(ins->Nsubsteps) {
       insSubCycle(ins, time, ins->Nstages, ins->o_U, ins->o_NU);
@@ -171,18 +204,6 @@ void insRunEXTBDF(ins_t *ins){
             insRestartWrite(ins, ins->options, time+ins->dt);
           if(mesh->rank==0) printf("done\n");
         }
-
-        // // Update Time-Step Size
-        // if(ins->dtAdaptStep){
-        //   if(((ins->tstep)%(ins->dtAdaptStep))==0){
-        //     if(rank==0) printf("\n Adapting time Step Size to ");
-        //       insComputeDt(ins, ins->time);
-        //     if(rank==0) printf("%.4e\n", ins->dt);
-        //      // Interpolate history for the new time step size
-        //       insInterpolateHistory(ins, ins->dtold, ins->dt);
-
-        //   }
-        // } 
       }
     }
 
@@ -190,16 +211,19 @@ void insRunEXTBDF(ins_t *ins){
     if (ins->dim==3 && mesh->rank==0) printf("\rtstep = %d, solver iterations: U - %3d, V - %3d, W - %3d, P - %3d", tstep+1, ins->NiterU, ins->NiterV, ins->NiterW, ins->NiterP); fflush(stdout);
     
     occaTimerToc(mesh->device,"Report");
+
+    time += ins->dt;
   }
   occaTimerToc(mesh->device,"INS");
 
 
-  dfloat finalTime = ins->NtimeSteps*ins->dt;
   printf("\n");
 
-  if(ins->outputStep) insReport(ins, finalTime,ins->NtimeSteps);
+  if(ins->outputStep) insReport(ins, time, ins->NtimeSteps);
   
   if(mesh->rank==0) occa::printTimer();
+
+  meshWriteProfile(mesh, ins->options);
 }
 
 
@@ -332,12 +332,12 @@ ins_t *insSetup(mesh_t *mesh, setupAide options){
     occa::setVerboseCompilation(false);
 #endif
   
-  for (int r=0;r<mesh->size;r++) {
-    if (r==mesh->rank) {
+  for (int r=0;r<meshBuildKernelStages;r++) {
+    if (r==meshBuildKernelStage(mesh)) {
       if (ins->dim==2) 
-        ins->setFlowFieldKernel =  mesh->device.buildKernel(DINS "/okl/insSetFlowField2D.okl", "insSetFlowField2D", kernelInfo);  
+        ins->setFlowFieldKernel =  meshBuildKernel(mesh, DINS "/okl/insSetFlowField2D.okl", "insSetFlowField2D", kernelInfo);  
       else
-        ins->setFlowFieldKernel =  mesh->device.buildKernel(DINS "/okl/insSetFlowField3D.okl", "insSetFlowField3D", kernelInfo);  
+        ins->setFlowFieldKernel =  meshBuildKernel(mesh, DINS "/okl/insSetFlowField3D.okl", "insSetFlowField3D", kernelInfo);  
     }
     MPI_Barrier(mesh->comm);
   }
@@ -357,7 +357,9 @@ ins_t *insSetup(mesh_t *mesh, setupAide options){
   // set time step
   dfloat hmin = 1e9, hmax = 0;
   dfloat umax = 0;
+  ins->hmin = (dfloat*) calloc(mesh->Nelements, sizeof(dfloat));
   for(dlong e=0;e<mesh->Nelements;++e){
+    ins->hmin[e] = 1e9;
     for(int f=0;f<mesh->Nfaces;++f){
       dlong sid = mesh->Nsgeo*(mesh->Nfaces*e + f);
       dfloat sJ   = mesh->sgeo[sid + SJID];
@@ -365,6 +367,7 @@ ins_t *insSetup(mesh_t *mesh, setupAide options){
 
       dfloat hest = 2./(sJ*invJ);
 
+      ins->hmin[e] = mymin(ins->hmin[e], hest);
       hmin = mymin(hmin, hest);
       hmax = mymax(hmax, hest);
     }
@@ -401,6 +404,40 @@ ins_t *insSetup(mesh_t *mesh, setupAide options){
   ins->dtAdaptStep = 0; 
   options.getArgs("TSTEPS FOR TIME STEP ADAPT", ins->dtAdaptStep);
 
+  // only the Jacobi diagonal is rebuilt when an adapted dt changes lambda
+  if(ins->dtAdaptStep &&
+     (options.compareArgs("VELOCITY PRECONDITIONER", "MULTIGRID") ||
+      options.compareArgs("VELOCITY PRECONDITIONER", "FULLALMOND") ||
+      options.compareArgs("VELOCITY PRECONDITIONER", "SEMFEM"))){
+    if(mesh->rank==0)
+      printf("ERROR: TSTEPS FOR TIME STEP ADAPT needs a JACOBI, MASSMATRIX or NONE VELOCITY PRECONDITIONER\n");
+    MPI_Finalize();
+    exit(-1);
+  }
+
+  // RECOMPUTE only reaches the elliptic Ax kernels, the INS kernels keep reading ggeo
+  if(options.compareArgs("ELEMENT MAP", "RECOMPUTE") && mesh->rank==0)
+    printf("NOTE: ELEMENT MAP RECOMPUTE applies to the pressure and velocity Ax kernels only, ggeo stays on the device\n");
+
+  // the block velocity solve starts from the previous solution and has no projection space
+  if(options.compareArgs("VELOCITY BLOCK SOLVER", "TRUE") &&
+     options.compareArgs("VELOCITY INITIAL GUESS", "PROJECTION")){
+    if(mesh->rank==0)
+      printf("ERROR: VELOCITY INITIAL GUESS PROJECTION is not supported with VELOCITY BLOCK SOLVER TRUE\n");
+    MPI_Finalize();
+    exit(-1);
+  }
+
+  // element length scales stay fixed, insComputeDt only reads the velocity on the device
+  dlong NdtBlock = mymax(1, (mesh->Nelements+blockSize-1)/blockSize);
+  ins->dtBlock = (dfloat*) calloc(NdtBlock, sizeof(dfloat));
+  ins->o_hmin    = mesh->device.malloc(mymax(1,mesh->Nelements)*sizeof(dfloat));
+  ins->o_dtBlock = mesh->device.malloc(NdtBlock*sizeof(dfloat), ins->dtBlock);
+  if(mesh->Nelements) ins->o_hmin.copyFrom(ins->hmin);
+
+  ins->interpC   = (dfloat*) calloc(ins->Nstages*ins->Nstages, sizeof(dfloat));
+  ins->o_interpC = mesh->device.malloc(ins->Nstages*ins->Nstages*sizeof(dfloat), ins->interpC);
+
   // MPI_Allreduce to get global minimum dt
   MPI_Allreduce(&dt, &(ins->dti), 1, MPI_DFLOAT, MPI_MIN, mesh->comm);
 
@@ -454,7 +491,6 @@ ins_t *insSetup(mesh_t *mesh, setupAide options){
     
     // Only one field is exported for iso-surface to reduce the file size
     ins->isoNfields  = 1;   //1 + (ins->dim) + (1 + ins->dim) ; // p, u.v,w, vort_x, vort_y, vort_z, wort_mag 
-    ins->isoMaxNtris = 1.E7; 
     //
     options.getArgs("ISOSURFACE FIELD ID", ins->isoField); 
     options.getArgs("ISOSURFACE COLOR ID", ins->isoColorField); 
@@ -462,12 +498,8 @@ ins_t *insSetup(mesh_t *mesh, setupAide options){
     options.getArgs("ISOSURFACE CONTOUR MAX", ins->isoMaxVal); 
     options.getArgs("ISOSURFACE CONTOUR MIN", ins->isoMinVal);
 
-    ins->isoMax    = (ins->dim + ins->isoNfields)*3*ins->isoMaxNtris;
-    ins->isoNtris  = (int*) calloc(1, sizeof(int));
-    ins->isoq      = (dfloat*) calloc(ins->isoMax, sizeof(dfloat)); 
-
-    ins->o_isoq      = mesh->device.malloc(ins->isoMax*sizeof(dfloat), ins->isoq);
-    ins->o_isoNtris  = mesh->device.malloc(1*sizeof(int), ins->isoNtris);
+    // isosurfaced fields staged per element, triangles are sized on the device
+    ins->o_isoq = mesh->device.malloc((mesh->Nelements*mesh->Np*ins->isoNfields+1)*sizeof(dfloat));
 
     // Create all contour levels
     dfloat *isoLevels = (dfloat*) calloc(ins->isoNlevels, sizeof(dfloat));
@@ -521,23 +553,6 @@ ins_t *insSetup(mesh_t *mesh, setupAide options){
     
     }
 
-    // Interpolation operators form Np to PlotNp (equisapaced nodes of order >N generally)
-    dfloat *plotInterp = (dfloat*) calloc(mesh->plotNp*mesh->Np, sizeof(dfloat));
-    for(int n=0;n<mesh->plotNp;++n){
-      for(int m=0;m<mesh->Np;++m){
-        plotInterp[n+m*mesh->plotNp] = mesh->plotInterp[n*mesh->Np+m];
-      }
-    }
-    ins->o_plotInterp = mesh->device.malloc(mesh->plotNp*mesh->Np*sizeof(dfloat), plotInterp);
-
-    // EToV for local triangulation
-    int *plotEToV = (int*) calloc(mesh->plotNp*mesh->Np, sizeof(int));
-    for(int n=0;n<mesh->plotNelements;++n){
-      for(int m=0;m<mesh->plotNverts;++m){
-        plotEToV[n+m*mesh->plotNelements] = mesh->plotEToV[n*mesh->plotNverts+m];
-      }
-    }
-    ins->o_plotEToV = mesh->device.malloc(mesh->plotNp*mesh->Np*sizeof(int), plotEToV);
 
 
   }
@@ -553,9 +568,11 @@ ins_t *insSetup(mesh_t *mesh, setupAide options){
   ins->vOptions.setArgs("PRECONDITIONER",       options.getArgs("VELOCITY PRECONDITIONER"));
   ins->vOptions.setArgs("MULTIGRID COARSENING", options.getArgs("VELOCITY MULTIGRID COARSENING"));
   ins->vOptions.setArgs("MULTIGRID SMOOTHER",   options.getArgs("VELOCITY MULTIGRID SMOOTHER"));
+  ins->vOptions.setArgs("MULTIGRID PRECISION",  options.getArgs("VELOCITY MULTIGRID PRECISION"));
   ins->vOptions.setArgs("PARALMOND CYCLE",      options.getArgs("VELOCITY PARALMOND CYCLE"));
   ins->vOptions.setArgs("PARALMOND SMOOTHER",   options.getArgs("VELOCITY PARALMOND SMOOTHER"));
   ins->vOptions.setArgs("PARALMOND PARTITION",  options.getArgs("VELOCITY PARALMOND PARTITION"));
+  ins->vOptions.setArgs("INITIAL GUESS",        options.getArgs("VELOCITY INITIAL GUESS"));
 
   ins->pOptions = options;
   ins->pOptions.setArgs("KRYLOV SOLVER",        options.getArgs("PRESSURE KRYLOV SOLVER"));
@@ -564,9 +581,11 @@ ins_t *insSetup(mesh_t *mesh, setupAide options){
   ins->pOptions.setArgs("PRECONDITIONER",       options.getArgs("PRESSURE PRECONDITIONER"));
   ins->pOptions.setArgs("MULTIGRID COARSENING", options.getArgs("PRESSURE MULTIGRID COARSENING"));
   ins->pOptions.setArgs("MULTIGRID SMOOTHER",   options.getArgs("PRESSURE MULTIGRID SMOOTHER"));
+  ins->pOptions.setArgs("MULTIGRID PRECISION",  options.getArgs("PRESSURE MULTIGRID PRECISION"));
   ins->pOptions.setArgs("PARALMOND CYCLE",      options.getArgs("PRESSURE PARALMOND CYCLE"));
   ins->pOptions.setArgs("PARALMOND SMOOTHER",   options.getArgs("PRESSURE PARALMOND SMOOTHER"));
   ins->pOptions.setArgs("PARALMOND PARTITION",  options.getArgs("PRESSURE PARALMOND PARTITION"));
+  ins->pOptions.setArgs("INITIAL GUESS",        options.getArgs("PRESSURE INITIAL GUESS"));
 
   if (mesh->rank==0) printf("==================ELLIPTIC SOLVE SETUP=========================\n");
 
@@ -617,6 +636,23 @@ ins_t *insSetup(mesh_t *mesh, setupAide options){
     memcpy(ins->wSolver->BCType,wBCType,7*sizeof(int));
     ellipticSolveSetup(ins->wSolver, ins->lambda, kernelInfoV);  
   }
+  ins->vPreconLambda = ins->lambda;
+
+  // one block PCG loop for all velocity components (shared operator, one exchange per sweep)
+  ins->vBlockSolve = 0;
+  if (options.compareArgs("VELOCITY BLOCK SOLVER", "TRUE")) {
+    elliptic_t *vSolvers[3] = {ins->uSolver, ins->vSolver, ins->wSolver};
+
+    int allNeumann = 0;
+    for (int fld=0;fld<ins->NVfields;fld++) allNeumann += vSolvers[fld]->allNeumann;
+
+    if (ins->vOptions.compareArgs("DISCRETIZATION","CONTINUOUS") && !allNeumann) {
+      ins->vBlockSolve = 1;
+      ellipticBlockSolveSetup(vSolvers, ins->NVfields, ins->fieldOffset, kernelInfoV);
+    } else if (mesh->rank==0) {
+      printf("VELOCITY BLOCK SOLVER needs a CONTINUOUS discretization without all Neumann boundaries, using separate solves\n");
+    }
+  }
   
   if (mesh->rank==0) printf("==================PRESSURE SOLVE SETUP=========================\n");
   ins->pSolver = (elliptic_t*) calloc(1, sizeof(elliptic_t));
@@ -690,15 +726,6 @@ ins_t *insSetup(mesh_t *mesh, setupAide options){
   // IsoSurface related
   if(ins->dim==3){
     kernelInfo["defines/" "p_isoNfields"]= ins->isoNfields;
-    // Define Isosurface Area Tolerance
-    kernelInfo["defines/" "p_triAreaTol"]= (dfloat) 1.0E-16;
-
-    kernelInfo["defines/" "p_dim"]= ins->dim;
-    kernelInfo["defines/" "p_plotNp"]= mesh->plotNp;
-    kernelInfo["defines/" "p_plotNelements"]= mesh->plotNelements;
-    
-    int plotNthreads = mymax(mesh->Np, mymax(mesh->plotNp, mesh->plotNelements));
-    kernelInfo["defines/" "p_plotNthreads"]= plotNthreads;
  } 
 
 
@@ -759,6 +786,11 @@ ins_t *insSetup(mesh_t *mesh, setupAide options){
   ins->o_VH = mesh->device.malloc(Ntotal*sizeof(dfloat));
   ins->o_WH = mesh->device.malloc(Ntotal*sizeof(dfloat));
 
+  if (ins->vBlockSolve) {
+    ins->o_blockRhsU = mesh->device.malloc(ins->NVfields*Ntotal*sizeof(dfloat));
+    ins->o_blockUH   = mesh->device.malloc(ins->NVfields*Ntotal*sizeof(dfloat));
+  }
+
   //plotting fields
   ins->o_Vort = mesh->device.malloc(ins->NVfields*Ntotal*sizeof(dfloat), ins->Vort);
   ins->o_Div  = mesh->device.malloc(              Nlocal*sizeof(dfloat), ins->Div);
@@ -771,7 +803,6 @@ ins_t *insSetup(mesh_t *mesh, setupAide options){
   if(mesh->totalHaloPairs){//halo setup
     dlong vHaloBytes = mesh->totalHaloPairs*mesh->Np*(ins->NVfields)*sizeof(dfloat);
     dlong pHaloBytes = mesh->totalHaloPairs*mesh->Np*sizeof(dfloat);
-    dlong vGatherBytes = ins->NVfields*mesh->ogs->NhaloGather*sizeof(dfloat);
     ins->o_vHaloBuffer = mesh->device.malloc(vHaloBytes);
     ins->o_pHaloBuffer = mesh->device.malloc(pHaloBytes);
 
@@ -780,25 +811,19 @@ ins_t *insSetup(mesh_t *mesh, setupAide options){
     occa::memory o_vrecvBuffer = mesh->device.mappedAlloc(vHaloBytes, NULL);
     occa::memory o_psendBuffer = mesh->device.mappedAlloc(pHaloBytes, NULL);
     occa::memory o_precvBuffer = mesh->device.mappedAlloc(pHaloBytes, NULL);
-    occa::memory o_gatherTmpPinned = mesh->device.mappedAlloc(vGatherBytes, NULL);
     
     ins->vSendBuffer = (dfloat*) o_vsendBuffer.getMappedPointer();
     ins->vRecvBuffer = (dfloat*) o_vrecvBuffer.getMappedPointer();
     ins->pSendBuffer = (dfloat*) o_psendBuffer.getMappedPointer();
     ins->pRecvBuffer = (dfloat*) o_precvBuffer.getMappedPointer();
-    ins->velocityHaloGatherTmp = (dfloat*) o_gatherTmpPinned.getMappedPointer();
 #endif
-    occa::memory o_vSendBuffer, o_vRecvBuffer, o_pSendBuffer, o_pRecvBuffer, o_gatherTmpPinned;
+    occa::memory o_vSendBuffer, o_vRecvBuffer, o_pSendBuffer, o_pRecvBuffer;
 
     ins->vSendBuffer = (dfloat*) occaHostMallocPinned(mesh->device, vHaloBytes, NULL, ins->o_vSendBuffer);
     ins->vRecvBuffer = (dfloat*) occaHostMallocPinned(mesh->device, vHaloBytes, NULL, ins->o_vRecvBuffer);
 
     ins->pSendBuffer = (dfloat*) occaHostMallocPinned(mesh->device, pHaloBytes, NULL, ins->o_pSendBuffer);
     ins->pRecvBuffer = (dfloat*) occaHostMallocPinned(mesh->device, pHaloBytes, NULL, ins->o_pRecvBuffer);
-
-    ins->velocityHaloGatherTmp = (dfloat*) occaHostMallocPinned(mesh->device, vGatherBytes, NULL, ins->o_gatherTmpPinned);
-    
-    ins->o_velocityHaloGatherTmp = mesh->device.malloc(vGatherBytes,  ins->velocityHaloGatherTmp);
   }
 
   // set kernel name suffix
@@ -815,67 +840,67 @@ ins_t *insSetup(mesh_t *mesh, setupAide options){
 
   char fileName[BUFSIZ], kernelName[BUFSIZ];
 
-  for (int r=0;r<mesh->size;r++) {
-    if (r==mesh->rank) {
+  for (int r=0;r<meshBuildKernelStages;r++) {
+    if (r==meshBuildKernelStage(mesh)) {
       sprintf(fileName, DINS "/okl/insHaloExchange.okl");
       sprintf(kernelName, "insVelocityHaloExtract");
-      ins->velocityHaloExtractKernel =  mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+      ins->velocityHaloExtractKernel =  meshBuildKernel(mesh, fileName, kernelName, kernelInfo);
 
       sprintf(kernelName, "insVelocityHaloScatter");
-      ins->velocityHaloScatterKernel =  mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+      ins->velocityHaloScatterKernel =  meshBuildKernel(mesh, fileName, kernelName, kernelInfo);
 
       sprintf(kernelName, "insPressureHaloExtract");
-      ins->pressureHaloExtractKernel =  mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+      ins->pressureHaloExtractKernel =  meshBuildKernel(mesh, fileName, kernelName, kernelInfo);
 
       sprintf(kernelName, "insPressureHaloScatter");
-      ins->pressureHaloScatterKernel =  mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+      ins->pressureHaloScatterKernel =  meshBuildKernel(mesh, fileName, kernelName, kernelInfo);
 
       // ===========================================================================
 
       sprintf(fileName, DINS "/okl/insAdvection%s.okl", suffix);
       sprintf(kernelName, "insAdvectionCubatureVolume%s", suffix);
-      ins->advectionCubatureVolumeKernel =  mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+      ins->advectionCubatureVolumeKernel =  meshBuildKernel(mesh, fileName, kernelName, kernelInfo);
 
       sprintf(kernelName, "insAdvectionCubatureSurface%s", suffix);
-      ins->advectionCubatureSurfaceKernel =  mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+      ins->advectionCubatureSurfaceKernel =  meshBuildKernel(mesh, fileName, kernelName, kernelInfo);
 
       sprintf(kernelName, "insAdvectionVolume%s", suffix);
-      ins->advectionVolumeKernel =  mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+      ins->advectionVolumeKernel =  meshBuildKernel(mesh, fileName, kernelName, kernelInfo);
 
       sprintf(kernelName, "insAdvectionSurface%s", suffix);
-      ins->advectionSurfaceKernel =  mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+      ins->advectionSurfaceKernel =  meshBuildKernel(mesh, fileName, kernelName, kernelInfo);
 
       // ===========================================================================
       
       sprintf(fileName, DINS "/okl/insDiffusion%s.okl", suffix);
       sprintf(kernelName, "insDiffusion%s", suffix);
-      ins->diffusionKernel =  mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+      ins->diffusionKernel =  meshBuildKernel(mesh, fileName, kernelName, kernelInfo);
 
       sprintf(fileName, DINS "/okl/insDiffusionIpdg%s.okl", suffix);
       sprintf(kernelName, "insDiffusionIpdg%s", suffix);
-      ins->diffusionIpdgKernel =  mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+      ins->diffusionIpdgKernel =  meshBuildKernel(mesh, fileName, kernelName, kernelInfo);
 
       sprintf(fileName, DINS "/okl/insVelocityGradient%s.okl", suffix);
       sprintf(kernelName, "insVelocityGradient%s", suffix);
-      ins->velocityGradientKernel =  mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+      ins->velocityGradientKernel =  meshBuildKernel(mesh, fileName, kernelName, kernelInfo);
 
       // ===========================================================================
 
       sprintf(fileName, DINS "/okl/insGradient%s.okl", suffix);
       sprintf(kernelName, "insGradientVolume%s", suffix);
-      ins->gradientVolumeKernel =  mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+      ins->gradientVolumeKernel =  meshBuildKernel(mesh, fileName, kernelName, kernelInfo);
 
       sprintf(kernelName, "insGradientSurface%s", suffix);
-      ins->gradientSurfaceKernel =  mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+      ins->gradientSurfaceKernel =  meshBuildKernel(mesh, fileName, kernelName, kernelInfo);
 
       // ===========================================================================
       
       sprintf(fileName, DINS "/okl/insDivergence%s.okl", suffix);
       sprintf(kernelName, "insDivergenceVolume%s", suffix);
-      ins->divergenceVolumeKernel =  mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+      ins->divergenceVolumeKernel =  meshBuildKernel(mesh, fileName, kernelName, kernelInfo);
 
       sprintf(kernelName, "insDivergenceSurface%s", suffix);
-      ins->divergenceSurfaceKernel =  mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+      ins->divergenceSurfaceKernel =  meshBuildKernel(mesh, fileName, kernelName, kernelInfo);
 
       // ===========================================================================
       
@@ -884,56 +909,66 @@ ins_t *insSetup(mesh_t *mesh, setupAide options){
         sprintf(kernelName, "insVelocityRhsARK%s", suffix);
       else if (options.compareArgs("TIME INTEGRATOR", "EXTBDF")) 
         sprintf(kernelName, "insVelocityRhsEXTBDF%s", suffix);
-      ins->velocityRhsKernel =  mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+      ins->velocityRhsKernel =  meshBuildKernel(mesh, fileName, kernelName, kernelInfo);
 
       sprintf(fileName, DINS "/okl/insVelocityBC%s.okl", suffix);
       sprintf(kernelName, "insVelocityIpdgBC%s", suffix);
-      ins->velocityRhsIpdgBCKernel =  mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+      ins->velocityRhsIpdgBCKernel =  meshBuildKernel(mesh, fileName, kernelName, kernelInfo);
 
       sprintf(kernelName, "insVelocityBC%s", suffix);
-      ins->velocityRhsBCKernel =  mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+      ins->velocityRhsBCKernel =  meshBuildKernel(mesh, fileName, kernelName, kernelInfo);
 
       sprintf(kernelName, "insVelocityAddBC%s", suffix);
-      ins->velocityAddBCKernel =  mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+      ins->velocityAddBCKernel =  meshBuildKernel(mesh, fileName, kernelName, kernelInfo);
 
       // ===========================================================================
       
       sprintf(fileName, DINS "/okl/insPressureRhs%s.okl", suffix);
       sprintf(kernelName, "insPressureRhs%s", suffix);
-      ins->pressureRhsKernel =  mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+      ins->pressureRhsKernel =  meshBuildKernel(mesh, fileName, kernelName, kernelInfo);
 
       sprintf(fileName, DINS "/okl/insPressureBC%s.okl", suffix);
       sprintf(kernelName, "insPressureIpdgBC%s", suffix);
-      ins->pressureRhsIpdgBCKernel =  mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+      ins->pressureRhsIpdgBCKernel =  meshBuildKernel(mesh, fileName, kernelName, kernelInfo);
 
       sprintf(kernelName, "insPressureBC%s", suffix);
-      ins->pressureRhsBCKernel =  mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+      ins->pressureRhsBCKernel =  meshBuildKernel(mesh, fileName, kernelName, kernelInfo);
 
       sprintf(kernelName, "insPressureAddBC%s", suffix);
-      ins->pressureAddBCKernel =  mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+      ins->pressureAddBCKernel =  meshBuildKernel(mesh, fileName, kernelName, kernelInfo);
 
       // ===========================================================================
 
       sprintf(fileName, DINS "/okl/insPressureUpdate.okl");
       sprintf(kernelName, "insPressureUpdate");
-      ins->pressureUpdateKernel =  mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+      ins->pressureUpdateKernel =  meshBuildKernel(mesh, fileName, kernelName, kernelInfo);
 
       sprintf(fileName, DINS "/okl/insVelocityUpdate.okl");
       sprintf(kernelName, "insVelocityUpdate");
-      ins->velocityUpdateKernel =  mesh->device.buildKernel(fileName, kernelName, kernelInfo);      
+      ins->velocityUpdateKernel =  meshBuildKernel(mesh, fileName, kernelName, kernelInfo);      
+
+      // ===========================================================================
+
+      sprintf(fileName, DINS "/okl/insComputeDt.okl");
+      sprintf(kernelName, "insComputeDt");
+      ins->computeDtKernel =  meshBuildKernel(mesh, fileName, kernelName, kernelInfo);
+
+      sprintf(fileName, DINS "/okl/insInterpolateHistory.okl");
+      sprintf(kernelName, "insInterpolateHistory");
+      ins->interpolateHistoryKernel =  meshBuildKernel(mesh, fileName, kernelName, kernelInfo);
 
       // ===========================================================================
 
       sprintf(fileName, DINS "/okl/insVorticity%s.okl", suffix);
       sprintf(kernelName, "insVorticity%s", suffix);
-      ins->vorticityKernel =  mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+      ins->vorticityKernel =  meshBuildKernel(mesh, fileName, kernelName, kernelInfo);
     
       // ===========================================================================
       if(ins->dim==3 && ins->options.compareArgs("OUTPUT TYPE","ISO")){
         sprintf(fileName, DINS "/okl/insIsoSurface3D.okl");
-        sprintf(kernelName, "insIsoSurface3D");
+        sprintf(kernelName, "insIsoSurfaceStage3D");
 
-        ins->isoSurfaceKernel = mesh->device.buildKernel(fileName, kernelName, kernelInfo);  
+        ins->isoStageKernel = meshBuildKernel(mesh, fileName, kernelName, kernelInfo);  
       }
       
       if(ins->Nsubsteps){
@@ -950,32 +985,66 @@ ins_t *insSetup(mesh_t *mesh, setupAide options){
 
         sprintf(fileName, DHOLMES "/okl/scaledAdd.okl");
         sprintf(kernelName, "scaledAddwOffset");
-        ins->scaledAddKernel =  mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+        ins->scaledAddKernel =  meshBuildKernel(mesh, fileName, kernelName, kernelInfo);
 
         sprintf(fileName, DINS "/okl/insSubCycle%s.okl", suffix);
         sprintf(kernelName, "insSubCycleVolume%s", suffix);
-        ins->subCycleVolumeKernel =  mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+        ins->subCycleVolumeKernel =  meshBuildKernel(mesh, fileName, kernelName, kernelInfo);
 
         sprintf(kernelName, "insSubCycleSurface%s", suffix);
-        ins->subCycleSurfaceKernel =  mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+        ins->subCycleSurfaceKernel =  meshBuildKernel(mesh, fileName, kernelName, kernelInfo);
 
         sprintf(kernelName, "insSubCycleCubatureVolume%s", suffix);
-        ins->subCycleCubatureVolumeKernel =  mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+        ins->subCycleCubatureVolumeKernel =  meshBuildKernel(mesh, fileName, kernelName, kernelInfo);
 
         sprintf(kernelName, "insSubCycleCubatureSurface%s", suffix);
-        ins->subCycleCubatureSurfaceKernel =  mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+        ins->subCycleCubatureSurfaceKernel =  meshBuildKernel(mesh, fileName, kernelName, kernelInfo);
 
         sprintf(fileName, DINS "/okl/insSubCycle.okl");
         sprintf(kernelName, "insSubCycleRKUpdate");
-        ins->subCycleRKUpdateKernel =  mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+        ins->subCycleRKUpdateKernel =  meshBuildKernel(mesh, fileName, kernelName, kernelInfo);
 
         sprintf(kernelName, "insSubCycleExt");
-        ins->subCycleExtKernel =  mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+        ins->subCycleExtKernel =  meshBuildKernel(mesh, fileName, kernelName, kernelInfo);
       }
     }
     MPI_Barrier(mesh->comm);
   }
 
+  if(ins->dim==3 && options.compareArgs("OUTPUT TYPE","ISO"))
+    meshIsoSurfaceSetup(mesh, kernelInfo, ins->isoNfields);
+
+  if(options.compareArgs("OUTPUT TYPE","VTU") && options.compareArgs("OUTPUT FORMAT","BINARY")){
+    // pressure, divergence, vorticity and velocity components
+    int NvortFields = (ins->dim==3) ? 3:1;
+    meshPlotVTUSetup(mesh, kernelInfo, 2+NvortFields+ins->dim);
+  }
+
+  // per-element costs of the timed volume kernels for the profiler
+  {
+    const int dim = ins->dim;
+    const double Np = mesh->Np;
+    double Dflops, Gbytes;
+    meshKernelCostFactors(mesh, ins->elementType, &Dflops, &Gbytes);
+
+    occaTimerRegister("GradientVolume",
+                      Np*(dim*Dflops + 2.*dim*dim),
+                      Np*(1+dim)*sizeof(dfloat) + Gbytes);
+    occaTimerRegister("DivergenceVolume",
+                      Np*dim*(dim*Dflops + 2.*dim),
+                      Np*(dim+1)*sizeof(dfloat) + Gbytes);
+    if(!options.compareArgs("ADVECTION TYPE", "CUBATURE"))
+      occaTimerRegister("AdvectionVolume",
+                        Np*dim*(dim*Dflops + 2.*dim*dim + 2.*dim),
+                        Np*2*dim*sizeof(dfloat) + Gbytes);
+  }
+
+  if(meshBuildKernelReport(mesh, options)){
+    if(mesh->rank==0) printf("ERROR: ranks built different sets of kernels\n");
+    MPI_Finalize();
+    exit(-1);
+  }
+
   return ins;
 }
 
@@ -26,6 +26,63 @@ SOFTWARE.
 
 #include "ins.h"
 
+// all velocity components in one block PCG loop: one gather-scatter exchange
+// carrying every component and one reduction per sweep
+static void insVelocityBlockSolve(ins_t *ins, dfloat time, occa::memory &o_rhsU,
+                                                           occa::memory &o_rhsV,
+                                                           occa::memory &o_rhsW,
+                                                           occa::memory &o_Uhat){
+
+  mesh_t *mesh = ins->mesh;
+  elliptic_t *vSolvers[3] = {ins->uSolver, ins->vSolver, ins->wSolver};
+  int Niter[3] = {0, 0, 0};
+
+  dlong Ntotal = (mesh->Nelements+mesh->totalHaloPairs)*mesh->Np;
+  size_t fieldBytes = ins->fieldOffset*sizeof(dfloat);
+
+  ins->o_blockRhsU.copyFrom(o_rhsU,Ntotal*sizeof(dfloat),0*fieldBytes,0);
+  ins->o_blockRhsU.copyFrom(o_rhsV,Ntotal*sizeof(dfloat),1*fieldBytes,0);
+  if (ins->dim==3)
+    ins->o_blockRhsU.copyFrom(o_rhsW,Ntotal*sizeof(dfloat),2*fieldBytes,0);
+
+  // current velocity fields as initial guess
+  ins->o_blockUH.copyFrom(ins->o_U,ins->NVfields*fieldBytes,0,0);
+
+  for (int fld=0;fld<ins->NVfields;fld++) {
+    if (vSolvers[fld]->Nmasked) {
+      occa::memory o_UHf = ins->o_blockUH + fld*fieldBytes;
+      mesh->maskKernel(vSolvers[fld]->Nmasked, vSolvers[fld]->o_maskIds, o_UHf);
+    }
+  }
+
+  occaTimerTic(mesh->device,"U-BlockSolve");
+  ellipticBlockSolve(vSolvers, ins->NVfields, ins->lambda, ins->velTOL, ins->o_blockRhsU, ins->o_blockUH, Niter);
+  occaTimerToc(mesh->device,"U-BlockSolve");
+
+  ins->NiterU = Niter[0];
+  ins->NiterV = Niter[1];
+  ins->NiterW = Niter[2];
+
+  occa::memory o_UHf = ins->o_blockUH + 0*fieldBytes;
+  occa::memory o_VHf = ins->o_blockUH + 1*fieldBytes;
+  occa::memory o_WHf = (ins->dim==3) ? ins->o_blockUH + 2*fieldBytes : ins->o_WH;
+
+  ins->velocityAddBCKernel(mesh->Nelements,
+                          time,
+                          mesh->o_sgeo,
+                          mesh->o_x,
+                          mesh->o_y,
+                          mesh->o_z,
+                          mesh->o_vmapM,
+                          ins->o_VmapB,
+                          o_UHf,
+                          o_VHf,
+                          o_WHf);
+
+  //copy into intermediate stage storage
+  ins->o_blockUH.copyTo(o_Uhat,ins->NVfields*fieldBytes,0,0);
+}
+
 // solve lambda*U + A*U = rhsU
 void insVelocitySolve(ins_t *ins, dfloat time, int stage,  occa::memory o_rhsU, 
                                                            occa::memory o_rhsV, 
@@ -91,6 +148,12 @@ void insVelocitySolve(ins_t *ins, dfloat time, int stage,  occa::memory o_rhsU,
 
   //copy current velocity fields as initial guess? (could use Uhat or beter guess)
   dlong Ntotal = (mesh->Nelements+mesh->totalHaloPairs)*mesh->Np;
+
+  if (ins->vBlockSolve) {
+    insVelocityBlockSolve(ins, time, o_rhsU, o_rhsV, o_rhsW, o_Uhat);
+    return;
+  }
+
   ins->o_UH.copyFrom(ins->o_U,Ntotal*sizeof(dfloat),0,0*ins->fieldOffset*sizeof(dfloat));
   ins->o_VH.copyFrom(ins->o_U,Ntotal*sizeof(dfloat),0,1*ins->fieldOffset*sizeof(dfloat));
   if (ins->dim==3)
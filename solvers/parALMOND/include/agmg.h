@@ -51,7 +51,7 @@ SOFTWARE.
 
 void agmgSetup(parAlmond_t *parAlmond, csr *A, dfloat *nullA, hlong *globalRowStarts, setupAide options);
 void parAlmondReport(parAlmond_t *parAlmond);
-void buildAlmondKernels(parAlmond_t *parAlmond);
+void buildAlmondKernels(parAlmond_t *parAlmond, mesh_t *mesh);
 
 void kcycle(parAlmond_t *parAlmond, int k);
 void device_kcycle(parAlmond_t *parAlmond, int k);
@@ -95,7 +95,7 @@ void device_agmgSmooth(void **args, occa::memory &o_rhs, occa::memory &o_x, bool
   }
 }
 
-dfloat rhoDinvA(parAlmond_t *parAlmond, csr *A, dfloat *invD);
+dfloat rhoDinvA(parAlmond_t *parAlmond, csr *A, dfloat *invD, int k);
 
 void setupSmoother(parAlmond_t *parAlmond, agmgLevel *level, SmoothType s){
 
@@ -116,7 +116,32 @@ void setupSmoother(parAlmond_t *parAlmond, agmgLevel *level, SmoothType s){
       level->A->diagInv[i] = 1.0/diag;
     }
 
-    rho = rhoDinvA(parAlmond, level->A, level->A->diagInv);
+    // reuse the estimate from the eigenvalue cache when possible
+    int lev = 0;
+    while((lev<MAX_LEVELS)&&(parAlmond->levels[lev]!=level)) lev++;
+
+    // global row count is only part of the key, skip the reduction without a cache
+    hlong localRows = (hlong) level->A->Nrows;
+    hlong globalRows = 0;
+    if(parAlmondEigenvalueCacheOn(parAlmond->options))
+      MPI_Allreduce(&localRows, &globalRows, 1, MPI_HLONG, MPI_SUM, agmg::comm);
+
+    char key[BUFSIZ];
+    sprintf(key, "%s_AMG%d_R" hlongFormat "_NS%d", parAlmond->eigenvalueCacheKey, lev, globalRows, (int) parAlmond->nullSpace);
+
+    dfloat cachedRho = 0;
+    int hit = parAlmondEigenvalueCacheLookup(parAlmond->options, agmg::comm, key, parAlmond->lambda, &cachedRho);
+
+    if (hit==2) {
+      rho = cachedRho;
+    } else if (hit==1) { // nearby lambda, cheap refresh
+      rho = mymax(cachedRho, rhoDinvA(parAlmond, level->A, level->A->diagInv, 3));
+    } else {
+      rho = rhoDinvA(parAlmond, level->A, level->A->diagInv, 10);
+    }
+
+    if (hit!=2)
+      parAlmondEigenvalueCacheStore(parAlmond->options, agmg::comm, key, parAlmond->lambda, rho);
 
     if (s == DAMPED_JACOBI) {
 
@@ -181,13 +206,12 @@ static void eig(const int Nrows, double *A, double *WR,
   }
 }
 
-dfloat rhoDinvA(parAlmond_t* parAlmond,csr *A, dfloat *invD){
+// k-step Arnoldi estimate of rho(invD*A)
+dfloat rhoDinvA(parAlmond_t* parAlmond,csr *A, dfloat *invD, int k){
 
   const dlong N = A->Nrows;
   const dlong M = A->Ncols;
 
-  int k = 10;
-
   int rank, size;
   rank = agmg::rank;
   size = agmg::size;
@@ -952,7 +952,7 @@ void find_aggregate_owners(agmgLevel *level, hlong* FineToCoarse, setupAide opti
 
   //determine a global numbering of the aggregates
   dlong *lNumAggs = (dlong*) calloc(size,sizeof(dlong));
-  MPI_Allgather(&numAggs, 1, MPI_DLONG, lNumAggs, 1, MPI_INT, agmg::comm);
+  MPI_Allgather(&numAggs, 1, MPI_DLONG, lNumAggs, 1, MPI_DLONG, agmg::comm);
 
   level->globalAggStarts[0] = 0;
   for (int r=0;r<size;r++)
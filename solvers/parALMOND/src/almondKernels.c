@@ -26,12 +26,9 @@ SOFTWARE.
 
 #include "agmg.h"
 
-void buildAlmondKernels(parAlmond_t *parAlmond){
+// built through the mesh kernel registry, so the solvers' parAlmond instances share one build
+void buildAlmondKernels(parAlmond_t *parAlmond, mesh_t *mesh){
 
-  int rank, size;
-  rank = agmg::rank;
-  size = agmg::size;
-  
   occa::properties kernelInfo;
  kernelInfo["defines"].asObject();
  kernelInfo["includes"].asArray();
@@ -76,73 +73,73 @@ void buildAlmondKernels(parAlmond_t *parAlmond){
     kernelInfo["compiler_flags"] += "--fmad=true"; // compiler option for cuda
   }
 
-  if (rank==0) printf("Compiling parALMOND Kernels \n");
+  if (mesh->rank==0) printf("Compiling parALMOND Kernels \n");
 
-  for (int r=0;r<size;r++) {
-    if (r==rank) {
-      parAlmond->ellAXPYKernel = parAlmond->device.buildKernel(DPWD "/okl/ellAXPY.okl",
-           "ellAXPY", kernelInfo);
+  for (int r=0;r<meshBuildKernelStages;r++) {
+    if (r==meshBuildKernelStage(mesh)) {
+      parAlmond->ellAXPYKernel = meshBuildKernel(mesh, DPWD "/okl/ellAXPY.okl",
+                      "ellAXPY", kernelInfo);
 
-      parAlmond->ellZeqAXPYKernel = parAlmond->device.buildKernel(DPWD "/okl/ellAXPY.okl",
-              "ellZeqAXPY", kernelInfo);
+      parAlmond->ellZeqAXPYKernel = meshBuildKernel(mesh, DPWD "/okl/ellAXPY.okl",
+                      "ellZeqAXPY", kernelInfo);
 
-      parAlmond->ellJacobiKernel = parAlmond->device.buildKernel(DPWD "/okl/ellAXPY.okl",
-              "ellJacobi", kernelInfo);
+      parAlmond->ellJacobiKernel = meshBuildKernel(mesh, DPWD "/okl/ellAXPY.okl",
+                      "ellJacobi", kernelInfo);
 
-      parAlmond->cooAXKernel = parAlmond->device.buildKernel(DPWD "/okl/cooAX.okl",
-             "cooAXKernel", kernelInfo);
+      parAlmond->cooAXKernel = meshBuildKernel(mesh, DPWD "/okl/cooAX.okl",
+                      "cooAXKernel", kernelInfo);
 
-      parAlmond->scaleVectorKernel = parAlmond->device.buildKernel(DPWD "/okl/scaleVector.okl",
-             "scaleVectorKernel", kernelInfo);
+      parAlmond->scaleVectorKernel = meshBuildKernel(mesh, DPWD "/okl/scaleVector.okl",
+                      "scaleVectorKernel", kernelInfo);
 
-      parAlmond->sumVectorKernel = parAlmond->device.buildKernel(DPWD "/okl/sumVector.okl",
-             "sumVectorKernel", kernelInfo);
+      parAlmond->sumVectorKernel = meshBuildKernel(mesh, DPWD "/okl/sumVector.okl",
+                      "sumVectorKernel", kernelInfo);
 
-      parAlmond->addScalarKernel = parAlmond->device.buildKernel(DPWD "/okl/addScalar.okl",
-             "addScalarKernel", kernelInfo);
+      parAlmond->addScalarKernel = meshBuildKernel(mesh, DPWD "/okl/addScalar.okl",
+                      "addScalarKernel", kernelInfo);
 
-      parAlmond->vectorAddKernel = parAlmond->device.buildKernel(DPWD "/okl/vectorAdd.okl",
-             "vectorAddKernel", kernelInfo);
+      parAlmond->vectorAddKernel = meshBuildKernel(mesh, DPWD "/okl/vectorAdd.okl",
+                      "vectorAddKernel", kernelInfo);
 
-      parAlmond->vectorAddKernel2 = parAlmond->device.buildKernel(DPWD "/okl/vectorAdd.okl",
-              "vectorAddKernel2", kernelInfo);
+      parAlmond->vectorAddKernel2 = meshBuildKernel(mesh, DPWD "/okl/vectorAdd.okl",
+                      "vectorAddKernel2", kernelInfo);
 
-      parAlmond->setVectorKernel = parAlmond->device.buildKernel(DPWD "/okl/setVector.okl",
-              "setVectorKernel", kernelInfo);
+      parAlmond->setVectorKernel = meshBuildKernel(mesh, DPWD "/okl/setVector.okl",
+                      "setVectorKernel", kernelInfo);
 
-      parAlmond->dotStarKernel = parAlmond->device.buildKernel(DPWD "/okl/dotStar.okl",
-               "dotStarKernel", kernelInfo);
+      parAlmond->dotStarKernel = meshBuildKernel(mesh, DPWD "/okl/dotStar.okl",
+                      "dotStarKernel", kernelInfo);
 
-      parAlmond->simpleDotStarKernel = parAlmond->device.buildKernel(DPWD "/okl/dotStar.okl",
-               "simpleDotStarKernel", kernelInfo);
+      parAlmond->simpleDotStarKernel = meshBuildKernel(mesh, DPWD "/okl/dotStar.okl",
+                      "simpleDotStarKernel", kernelInfo);
 
-      parAlmond->haloExtract = parAlmond->device.buildKernel(DPWD "/okl/haloExtract.okl",
-                "haloExtract", kernelInfo);
+      parAlmond->haloExtract = meshBuildKernel(mesh, DPWD "/okl/haloExtract.okl",
+                      "haloExtract", kernelInfo);
 
-      parAlmond->agg_interpolateKernel = parAlmond->device.buildKernel(DPWD "/okl/agg_interpolate.okl",
-                 "agg_interpolate", kernelInfo);
+      parAlmond->agg_interpolateKernel = meshBuildKernel(mesh, DPWD "/okl/agg_interpolate.okl",
+                      "agg_interpolate", kernelInfo);
 
-      parAlmond->innerProdKernel = parAlmond->device.buildKernel(DPWD "/okl/innerProduct.okl",
-                 "innerProductKernel", kernelInfo);
+      parAlmond->innerProdKernel = meshBuildKernel(mesh, DPWD "/okl/innerProduct.okl",
+                      "innerProductKernel", kernelInfo);
 
-      parAlmond->vectorAddInnerProdKernel = parAlmond->device.buildKernel(DPWD "/okl/vectorAddInnerProduct.okl",
-                 "vectorAddInnerProductKernel", kernelInfo);
+      parAlmond->vectorAddInnerProdKernel = meshBuildKernel(mesh, DPWD "/okl/vectorAddInnerProduct.okl",
+                      "vectorAddInnerProductKernel", kernelInfo);
 
-      parAlmond->kcycleCombinedOp1Kernel = parAlmond->device.buildKernel(DPWD "/okl/kcycleCombinedOp.okl",
-                 "kcycleCombinedOp1Kernel", kernelInfo);
+      parAlmond->kcycleCombinedOp1Kernel = meshBuildKernel(mesh, DPWD "/okl/kcycleCombinedOp.okl",
+                      "kcycleCombinedOp1Kernel", kernelInfo);
 
-      parAlmond->kcycleCombinedOp2Kernel = parAlmond->device.buildKernel(DPWD "/okl/kcycleCombinedOp.okl",
-                 "kcycleCombinedOp2Kernel", kernelInfo);
+      parAlmond->kcycleCombinedOp2Kernel = meshBuildKernel(mesh, DPWD "/okl/kcycleCombinedOp.okl",
+                      "kcycleCombinedOp2Kernel", kernelInfo);
 
-      parAlmond->vectorAddWeightedInnerProdKernel = parAlmond->device.buildKernel(DPWD "/okl/vectorAddInnerProduct.okl",
-                 "vectorAddWeightedInnerProductKernel", kernelInfo);
+      parAlmond->vectorAddWeightedInnerProdKernel = meshBuildKernel(mesh, DPWD "/okl/vectorAddInnerProduct.okl",
+                      "vectorAddWeightedInnerProductKernel", kernelInfo);
 
-      parAlmond->kcycleWeightedCombinedOp1Kernel = parAlmond->device.buildKernel(DPWD "/okl/kcycleCombinedOp.okl",
-                 "kcycleWeightedCombinedOp1Kernel", kernelInfo);
+      parAlmond->kcycleWeightedCombinedOp1Kernel = meshBuildKernel(mesh, DPWD "/okl/kcycleCombinedOp.okl",
+                      "kcycleWeightedCombinedOp1Kernel", kernelInfo);
 
-      parAlmond->kcycleWeightedCombinedOp2Kernel = parAlmond->device.buildKernel(DPWD "/okl/kcycleCombinedOp.okl",
-                 "kcycleWeightedCombinedOp2Kernel", kernelInfo);
+      parAlmond->kcycleWeightedCombinedOp2Kernel = meshBuildKernel(mesh, DPWD "/okl/kcycleCombinedOp.okl",
+                      "kcycleWeightedCombinedOp2Kernel", kernelInfo);
     }
-    MPI_Barrier(agmg::comm);
+    MPI_Barrier(mesh->comm);
   }
 }
@@ -84,6 +84,9 @@ parAlmond_t *parAlmondInit(mesh_t *mesh, setupAide options) {
 
   parAlmond->levels = (agmgLevel **) calloc(MAX_LEVELS,sizeof(agmgLevel *));
   parAlmond->numLevels = 0;
+
+  parAlmondEigenvalueCacheMeshKey(mesh, options, parAlmond->eigenvalueCacheKey);
+  parAlmond->lambda = 0.;
   
   if (options.compareArgs("PARALMOND CYCLE", "NONSYM")) {
     parAlmond->ktype = GMRES;  
@@ -95,7 +98,7 @@ parAlmond_t *parAlmondInit(mesh_t *mesh, setupAide options) {
   agmg::size = mesh->size;
   MPI_Comm_dup(mesh->comm, &(agmg::comm));
   
-  buildAlmondKernels(parAlmond);
+  buildAlmondKernels(parAlmond, mesh);
 
   return parAlmond;
 }
@@ -0,0 +1,171 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "agmg.h"
+
+// On-disk cache of smoother spectral radius estimates.
+//
+// Setting [EIGENVALUE CACHE] to a file name lets repeated setups (dt changes,
+// restarts) skip the Arnoldi estimates of rho(S*A). Each line of the file is
+//
+//   key lambda rho
+//
+// where key identifies the mesh, degree, level and smoother. A lookup hits
+// exactly when lambda matches, and returns a nearby estimate (for a cheap
+// refresh by the caller) when lambda is within eigenvalueCacheTolerance.
+// Storing a refreshed estimate replaces the nearby entries of the same key.
+
+#define eigenvalueCacheTolerance 0.1
+
+// cache file name, 0 when caching is off (no entry or NONE)
+static int eigenvalueCacheFile(setupAide &options, string &fileName){
+
+  if(!options.getArgs("EIGENVALUE CACHE", fileName)) return 0;
+
+  return (fileName.compare("NONE")) ? 1:0;
+}
+
+// 1 when [EIGENVALUE CACHE] names a cache file
+int parAlmondEigenvalueCacheOn(setupAide &options){
+
+  string fileName;
+  return eigenvalueCacheFile(options, fileName);
+}
+
+// collective when the cache is on: mesh part of the cache key (element type, sizes,
+// vertex sums). The key is empty, and nothing is communicated, when the cache is off.
+void parAlmondEigenvalueCacheMeshKey(mesh_t *mesh, setupAide &options, char *key){
+
+  key[0] = '\0';
+  if(!parAlmondEigenvalueCacheOn(options)) return;
+
+  double localSums[3] = {0., 0., 0.};
+  double sums[3];
+
+  for(dlong n=0;n<mesh->Nelements*mesh->Nverts;++n){
+    localSums[0] += mesh->EX[n];
+    localSums[1] += mesh->EY[n];
+    if(mesh->dim==3) localSums[2] += mesh->EZ[n];
+  }
+
+  MPI_Allreduce(localSums, sums, 3, MPI_DOUBLE, MPI_SUM, mesh->comm);
+
+  hlong localNelements = (hlong) mesh->Nelements;
+  hlong Nelements = 0;
+  MPI_Allreduce(&localNelements, &Nelements, 1, MPI_HLONG, MPI_SUM, mesh->comm);
+
+  sprintf(key, "V%d_E" hlongFormat "_P%d_N%d_%.8e_%.8e_%.8e",
+          mesh->Nverts, Nelements, mesh->size, mesh->N, sums[0], sums[1], sums[2]);
+}
+
+// collective: returns 2 for an exact hit, 1 for a nearby lambda, 0 for a miss
+int parAlmondEigenvalueCacheLookup(setupAide options, MPI_Comm comm, const char *key, dfloat lambda, dfloat *rho){
+
+  string fileName;
+  if(!eigenvalueCacheFile(options, fileName)) return 0;
+
+  int rank;
+  MPI_Comm_rank(comm, &rank);
+
+  double found[2] = {0., 0.}; // hit type, rho
+
+  if(rank==0){
+    FILE *fp = fopen(fileName.c_str(), "r");
+
+    if(fp){
+      char fileKey[BUFSIZ];
+      double fileLambda, fileRho;
+      double bestDistance = eigenvalueCacheTolerance;
+
+      while(fscanf(fp, "%s %lf %lf", fileKey, &fileLambda, &fileRho)==3){
+        if(strcmp(fileKey, key)) continue;
+
+        double scale = mymax(fabs(lambda), fabs(fileLambda));
+        double distance = (scale>0) ? fabs(lambda-fileLambda)/scale : 0.;
+
+        if(distance<1e-12){
+          found[0] = 2; found[1] = fileRho;
+          break;
+        }
+
+        if(distance<=bestDistance){
+          bestDistance = distance;
+          found[0] = 1; found[1] = fileRho;
+        }
+      }
+      fclose(fp);
+    }
+  }
+
+  MPI_Bcast(found, 2, MPI_DOUBLE, 0, comm);
+
+  *rho = (dfloat) found[1];
+
+  return (int) found[0];
+}
+
+void parAlmondEigenvalueCacheStore(setupAide options, MPI_Comm comm, const char *key, dfloat lambda, dfloat rho){
+
+  string fileName;
+  if(!eigenvalueCacheFile(options, fileName)) return;
+
+  int rank;
+  MPI_Comm_rank(comm, &rank);
+
+  if(rank==0){
+    // rewrite the file, replacing the entries this estimate refreshes
+    // (same key, lambda within the tolerance) instead of appending to them
+    string tmpName = fileName + ".tmp";
+    FILE *out = fopen(tmpName.c_str(), "w");
+
+    if(!out){
+      printf("WARNING: could not open eigenvalue cache %s\n", tmpName.c_str());
+      return;
+    }
+
+    FILE *fp = fopen(fileName.c_str(), "r");
+    if(fp){
+      char fileKey[BUFSIZ];
+      double fileLambda, fileRho;
+
+      while(fscanf(fp, "%s %lf %lf", fileKey, &fileLambda, &fileRho)==3){
+        if(!strcmp(fileKey, key)){
+          double scale = mymax(fabs(lambda), fabs(fileLambda));
+          double distance = (scale>0) ? fabs(lambda-fileLambda)/scale : 0.;
+          if(distance<=eigenvalueCacheTolerance) continue;
+        }
+        fprintf(out, "%s %.17g %.17g\n", fileKey, fileLambda, fileRho);
+      }
+      fclose(fp);
+    }
+
+    fprintf(out, "%s %.17g %.17g\n", key, (double) lambda, (double) rho);
+    fclose(out);
+
+    if(rename(tmpName.c_str(), fileName.c_str()))
+      printf("WARNING: could not update eigenvalue cache %s\n", fileName.c_str());
+  }
+}
@@ -0,0 +1,145 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <map>
+#include <string>
+#include <vector>
+#include "mpi.h"
+#include "mesh.h"
+
+// registry of kernels built by this process, keyed by okl file, kernel name,
+// device mode and kernel properties, so repeated requests reuse the first build.
+// Several devices of the same mode can share a key, so entries also record their device
+typedef struct {
+
+  std::string fileName;
+  std::string kernelName;
+  occa::device device;
+  occa::kernel kernel;
+
+  double buildTime; // seconds spent in occa buildKernel
+  int Nrequests;    // times this kernel was requested
+
+} registeredKernel_t;
+
+static std::multimap<std::string, int> kernelIndex;
+static std::vector<registeredKernel_t> kernels;
+static int Nreported = 0;
+
+// build stage of this rank: rank 0 compiles first, then one rank per host,
+// then the remaining ranks of each host which find the binaries in the occa cache
+int meshBuildKernelStage(mesh_t *mesh){
+
+  if (mesh->rank==0) return 0;
+  if (mesh->hostRank==0) return 1;
+  return 2;
+}
+
+occa::kernel meshBuildKernel(mesh_t *mesh, const char *fileName, const char *kernelName,
+                             occa::properties &kernelInfo){
+
+  std::string key = std::string(fileName) + ":" + kernelName + ":"
+                  + mesh->device.mode() + ":" + kernelInfo.toString();
+
+  typedef std::multimap<std::string, int>::iterator kernelIterator;
+  std::pair<kernelIterator, kernelIterator> range = kernelIndex.equal_range(key);
+  for (kernelIterator it=range.first;it!=range.second;++it) {
+    registeredKernel_t &entry = kernels[it->second];
+    if (entry.device==mesh->device) {
+      entry.Nrequests++;
+      return entry.kernel;
+    }
+  }
+
+  registeredKernel_t entry;
+  entry.fileName = fileName;
+  entry.kernelName = kernelName;
+  entry.device = mesh->device;
+  entry.Nrequests = 1;
+
+  double tic = MPI_Wtime();
+  entry.kernel = mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+  entry.buildTime = MPI_Wtime() - tic;
+
+  kernelIndex.insert(std::make_pair(key, (int) kernels.size()));
+  kernels.push_back(entry);
+
+  return entry.kernel;
+}
+
+// report the kernels registered since the last report (collective). Returns 1 on
+// every rank if the ranks disagree on the number of kernels, leaving the caller to stop
+int meshBuildKernelReport(mesh_t *mesh, setupAide &options){
+
+  int Nnew = (int) kernels.size() - Nreported;
+
+  int NnewMin = 0, NnewMax = 0;
+  MPI_Allreduce(&Nnew, &NnewMin, 1, MPI_INT, MPI_MIN, mesh->comm);
+  MPI_Allreduce(&Nnew, &NnewMax, 1, MPI_INT, MPI_MAX, mesh->comm);
+  if (NnewMin!=NnewMax) {
+    if (Nnew!=NnewMax)
+      printf("meshBuildKernelReport: rank %d registered %d kernels, expected %d\n", mesh->rank, Nnew, NnewMax);
+    Nreported = (int) kernels.size();
+    return 1;
+  }
+
+  double *localTimes = (double*) calloc(Nnew+1, sizeof(double));
+  double *maxTimes   = (double*) calloc(Nnew+1, sizeof(double));
+  for (int n=0;n<Nnew;n++)
+    localTimes[n] = kernels[Nreported+n].buildTime;
+
+  MPI_Reduce(localTimes, maxTimes, Nnew, MPI_DOUBLE, MPI_MAX, 0, mesh->comm);
+
+  if (mesh->rank==0) {
+    double totalTime = 0;
+    int Nreused = 0;
+    for (int n=0;n<Nnew;n++) {
+      totalTime += maxTimes[n];
+      Nreused += kernels[Nreported+n].Nrequests-1;
+    }
+
+    if (options.compareArgs("VERBOSE","TRUE")) {
+      printf("%-40s %-40s %10s %8s\n", "kernel", "file", "build(s)", "requests");
+      for (int n=0;n<Nnew;n++) {
+        registeredKernel_t &entry = kernels[Nreported+n];
+        const char *baseName = strrchr(entry.fileName.c_str(), '/');
+        baseName = baseName ? baseName+1 : entry.fileName.c_str();
+        printf("%-40s %-40s %10.4f %8d\n", entry.kernelName.c_str(), baseName, maxTimes[n], entry.Nrequests);
+      }
+    }
+    printf("Built %d kernels (%d requests reused) in %g seconds (slowest rank per kernel)\n",
+           Nnew, Nreused, totalTime);
+  }
+
+  free(localTimes); free(maxTimes);
+
+  Nreported = (int) kernels.size();
+
+  return 0;
+}
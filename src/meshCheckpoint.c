@@ -0,0 +1,608 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "mesh.h"
+
+/* checkpoint file layout (one file shared by all ranks):
+     header, Nscalars dfloats, Nfields ints (values per element of each field)
+     Nelements x Nverts hlong: sorted global vertex ids of each element (the element key)
+     for each field: Nelements x Nvalues dfloats, in the same element order as the keys
+   Elements are stored in rank order of the writing run. */
+
+#define meshCheckpointVersion 1
+#define meshCheckpointMaxVerts 8
+
+typedef struct {
+  char  magic[8];
+  int   version;
+  int   dfloatSize, hlongSize;
+  int   Np, Nverts;
+  int   Nscalars, Nfields;
+  hlong Nelements;      // global element count
+} meshCheckpointHeader_t;
+
+// one contiguous piece of the file written by this rank
+typedef struct {
+  size_t fileOffset;
+  size_t bytes;
+  size_t bufferOffset;
+} meshCheckpointBlock_t;
+
+typedef struct {
+
+  pthread_t thread;
+  int active;
+  int status;
+
+  char fileName[BUFSIZ];
+  size_t fileBytes;
+
+  // alternating host staging buffers
+  char  *buffer[2];
+  size_t bufferBytes[2];
+  int    next;
+
+  char *data; // buffer being drained
+  int Nblocks;
+  meshCheckpointBlock_t *blocks;
+
+  char  *mapBuffer;
+  size_t mapBufferBytes;
+
+}meshCheckpointWriter_t;
+
+// element key lookup record (element=-1 for records read from the file)
+typedef struct {
+  hlong v[meshCheckpointMaxVerts];
+  hlong fileId;
+  int   rank;
+  dlong element;
+} meshCheckpointKey_t;
+
+static void meshCheckpointElementKey(mesh_t *mesh, dlong e, hlong *v){
+  for(int n=0;n<mesh->Nverts;++n)
+    v[n] = mesh->EToV[e*mesh->Nverts+n];
+  mysort(v, mesh->Nverts, "ascending");
+}
+
+static size_t meshCheckpointHeaderBytes(int Nscalars, int Nfields){
+  return sizeof(meshCheckpointHeader_t) + Nscalars*sizeof(dfloat) + Nfields*sizeof(int);
+}
+
+static int meshCheckpointPwrite(int fd, const char *data, size_t bytes, size_t offset){
+  while(bytes){
+    ssize_t Nwritten = pwrite(fd, data, bytes, offset);
+    if(Nwritten<=0) return 0;
+    data += Nwritten; bytes -= Nwritten; offset += Nwritten;
+  }
+  return 1;
+}
+
+static int meshCheckpointPread(int fd, char *data, size_t bytes, size_t offset){
+  while(bytes){
+    ssize_t Nread = pread(fd, data, bytes, offset);
+    if(Nread<=0) return 0;
+    data += Nread; bytes -= Nread; offset += Nread;
+  }
+  return 1;
+}
+
+static void *meshCheckpointThread(void *args){
+
+  meshCheckpointWriter_t *writer = (meshCheckpointWriter_t*) args;
+
+  char tmpName[BUFSIZ+8];
+  sprintf(tmpName, "%s.tmp", writer->fileName);
+
+  writer->status = 0;
+
+  int fd = open(tmpName, O_WRONLY|O_CREAT, 0644);
+  if(fd<0) return NULL;
+
+  int status = 1;
+  for(int b=0;b<writer->Nblocks;++b)
+    status = status && meshCheckpointPwrite(fd, writer->data + writer->blocks[b].bufferOffset,
+                                            writer->blocks[b].bytes, writer->blocks[b].fileOffset);
+
+  if(close(fd)) status = 0;
+
+  writer->status = status;
+
+  return NULL;
+}
+
+// wait for the last checkpoint and move it into place once every rank has written its part
+void meshCheckpointFinish(mesh_t *mesh){
+
+  meshCheckpointWriter_t *writer = (meshCheckpointWriter_t*) mesh->checkpointWriter;
+
+  if(!writer || !writer->active) return;
+
+  pthread_join(writer->thread, NULL);
+  writer->active = 0;
+
+  int status = writer->status, allStatus = 0;
+  MPI_Allreduce(&status, &allStatus, 1, MPI_INT, MPI_MIN, mesh->comm);
+
+  if(mesh->rank==0){
+    char tmpName[BUFSIZ+8];
+    sprintf(tmpName, "%s.tmp", writer->fileName);
+
+    // a stale longer file may have been reused
+    if(allStatus && truncate(tmpName, writer->fileBytes)) allStatus = 0;
+    if(allStatus && rename(tmpName, writer->fileName)) allStatus = 0;
+
+    if(!allStatus)
+      printf("meshCheckpointFinish: writing checkpoint %s failed\n", writer->fileName);
+  }
+
+  free(writer->blocks);
+  writer->blocks = NULL;
+
+  MPI_Barrier(mesh->comm);
+}
+
+void meshCheckpointWrite(mesh_t *mesh, const char *fileName, int Nscalars, dfloat *scalars,
+                         int Nfields, meshCheckpointField_t *fields){
+
+  if(!mesh->checkpointWriter)
+    mesh->checkpointWriter = calloc(1, sizeof(meshCheckpointWriter_t));
+
+  meshCheckpointWriter_t *writer = (meshCheckpointWriter_t*) mesh->checkpointWriter;
+
+  if(mesh->Nverts>meshCheckpointMaxVerts){
+    printf("meshCheckpointWrite: elements with %d vertices are not supported\n", mesh->Nverts);
+    MPI_Abort(mesh->comm, -1);
+  }
+
+  // global element order is rank order
+  hlong Nlocal = mesh->Nelements, Nglobal = 0, start = 0;
+  MPI_Allreduce(&Nlocal, &Nglobal, 1, MPI_HLONG, MPI_SUM, mesh->comm);
+  MPI_Exscan(&Nlocal, &start, 1, MPI_HLONG, MPI_SUM, mesh->comm);
+  if(mesh->rank==0) start = 0;
+
+  size_t headerBytes = meshCheckpointHeaderBytes(Nscalars, Nfields);
+  size_t keyBytes    = ((size_t) mesh->Nverts)*sizeof(hlong);
+
+  // file blocks written by this rank: header (rank 0), keys, one per field
+  meshCheckpointBlock_t *blocks =
+    (meshCheckpointBlock_t*) calloc(Nfields+2, sizeof(meshCheckpointBlock_t));
+  int Nblocks = 0;
+  size_t bufferBytes = 0;
+  size_t fileOffset = headerBytes;
+
+  if(mesh->rank==0){
+    blocks[Nblocks].fileOffset = 0;
+    blocks[Nblocks].bytes = headerBytes;
+    blocks[Nblocks].bufferOffset = bufferBytes;
+    bufferBytes += headerBytes;
+    ++Nblocks;
+  }
+
+  blocks[Nblocks].fileOffset = fileOffset + start*keyBytes;
+  blocks[Nblocks].bytes = Nlocal*keyBytes;
+  blocks[Nblocks].bufferOffset = bufferBytes;
+  bufferBytes += blocks[Nblocks].bytes;
+  fileOffset += Nglobal*keyBytes;
+  ++Nblocks;
+
+  for(int fld=0;fld<Nfields;++fld){
+    size_t recordBytes = fields[fld].Nvalues*sizeof(dfloat);
+    blocks[Nblocks].fileOffset = fileOffset + start*recordBytes;
+    blocks[Nblocks].bytes = Nlocal*recordBytes;
+    blocks[Nblocks].bufferOffset = bufferBytes;
+    bufferBytes += blocks[Nblocks].bytes;
+    fileOffset += Nglobal*recordBytes;
+    ++Nblocks;
+  }
+
+  // stage into the buffer not being drained
+  int b = writer->next;
+  if(writer->bufferBytes[b]<bufferBytes){
+    free(writer->buffer[b]);
+    writer->buffer[b] = (char*) calloc(bufferBytes+1, sizeof(char));
+    writer->bufferBytes[b] = bufferBytes;
+  }
+  char *buffer = writer->buffer[b];
+
+  int blk = 0;
+  if(mesh->rank==0){
+    meshCheckpointHeader_t header;
+    memset(&header, 0, sizeof(header));
+    strcpy(header.magic, "LIBPCHK");
+    header.version    = meshCheckpointVersion;
+    header.dfloatSize = sizeof(dfloat);
+    header.hlongSize  = sizeof(hlong);
+    header.Np         = mesh->Np;
+    header.Nverts     = mesh->Nverts;
+    header.Nscalars   = Nscalars;
+    header.Nfields    = Nfields;
+    header.Nelements  = Nglobal;
+
+    char *h = buffer + blocks[blk].bufferOffset;
+    memcpy(h, &header, sizeof(header));
+    h += sizeof(header);
+    memcpy(h, scalars, Nscalars*sizeof(dfloat));
+    h += Nscalars*sizeof(dfloat);
+    for(int fld=0;fld<Nfields;++fld)
+      memcpy(h + fld*sizeof(int), &(fields[fld].Nvalues), sizeof(int));
+    ++blk;
+  }
+
+  hlong *keys = (hlong*) (buffer + blocks[blk].bufferOffset);
+  for(dlong e=0;e<mesh->Nelements;++e)
+    meshCheckpointElementKey(mesh, e, keys + e*mesh->Nverts);
+  ++blk;
+
+  for(int fld=0;fld<Nfields;++fld,++blk){
+    dfloat *q = (dfloat*) (buffer + blocks[blk].bufferOffset);
+    int Nvalues = fields[fld].Nvalues;
+
+    if(!Nlocal) continue;
+
+    if(fields[fld].elementMap==NULL){
+      fields[fld].o_q.copyTo(q, Nlocal*Nvalues*sizeof(dfloat), fields[fld].offset*sizeof(dfloat));
+    }
+    else{
+      // gather mapped records, elements without one are zero
+      dlong *map = fields[fld].elementMap;
+      dlong Nrecords = 0;
+      for(dlong e=0;e<mesh->Nelements;++e)
+        Nrecords = mymax(Nrecords, map[e]+1);
+
+      size_t mapBytes = ((size_t) Nrecords)*Nvalues*sizeof(dfloat);
+      if(writer->mapBufferBytes<mapBytes){
+        free(writer->mapBuffer);
+        writer->mapBuffer = (char*) calloc(mapBytes+1, sizeof(char));
+        writer->mapBufferBytes = mapBytes;
+      }
+      dfloat *records = (dfloat*) writer->mapBuffer;
+      if(mapBytes)
+        fields[fld].o_q.copyTo(records, mapBytes, fields[fld].offset*sizeof(dfloat));
+
+      for(dlong e=0;e<mesh->Nelements;++e){
+        if(map[e]<0)
+          memset(q + e*Nvalues, 0, Nvalues*sizeof(dfloat));
+        else
+          memcpy(q + e*Nvalues, records + map[e]*Nvalues, Nvalues*sizeof(dfloat));
+      }
+    }
+  }
+
+  // the previous checkpoint drains (and is moved into place) before this one starts
+  meshCheckpointFinish(mesh);
+
+  strncpy(writer->fileName, fileName, BUFSIZ-1);
+  writer->fileBytes = fileOffset;
+  writer->data = buffer;
+  writer->Nblocks = Nblocks;
+  writer->blocks = blocks;
+  writer->next = 1-b;
+
+  if(pthread_create(&(writer->thread), NULL, meshCheckpointThread, writer)){
+    // fall back to writing in place
+    meshCheckpointThread(writer);
+  }
+  writer->active = 1;
+}
+
+static int meshCheckpointNverts = 0;
+
+// compare on key then rank (file records, rank -1, lead)
+static int meshCheckpointCompareKeys(const void *a, const void *b){
+
+  meshCheckpointKey_t *ka = (meshCheckpointKey_t*) a;
+  meshCheckpointKey_t *kb = (meshCheckpointKey_t*) b;
+
+  for(int n=0;n<meshCheckpointNverts;++n){
+    if(ka->v[n] < kb->v[n]) return -1;
+    if(ka->v[n] > kb->v[n]) return +1;
+  }
+
+  if(ka->rank < kb->rank) return -1;
+  if(ka->rank > kb->rank) return +1;
+
+  return 0;
+}
+
+static int meshCheckpointCompareRanks(const void *a, const void *b){
+
+  meshCheckpointKey_t *ka = (meshCheckpointKey_t*) a;
+  meshCheckpointKey_t *kb = (meshCheckpointKey_t*) b;
+
+  if(ka->rank < kb->rank) return -1;
+  if(ka->rank > kb->rank) return +1;
+
+  return 0;
+}
+
+static int meshCheckpointRank(mesh_t *mesh, hlong *v){
+  unsigned long long int hash = 14695981039346656037ULL;
+  for(int n=0;n<mesh->Nverts;++n)
+    hash = (hash ^ (unsigned long long int) v[n])*1099511628211ULL;
+  return (int) (hash%mesh->size);
+}
+
+// find the position in the file of each local element
+static void meshCheckpointLocate(mesh_t *mesh, int fd, size_t keyOffset, hlong Nfile, hlong *fileIds){
+
+  size_t keyBytes = ((size_t) mesh->Nverts)*sizeof(hlong);
+
+  hlong Nlocal = mesh->Nelements, Nglobal = 0, start = 0;
+  MPI_Allreduce(&Nlocal, &Nglobal, 1, MPI_HLONG, MPI_SUM, mesh->comm);
+  MPI_Exscan(&Nlocal, &start, 1, MPI_HLONG, MPI_SUM, mesh->comm);
+  if(mesh->rank==0) start = 0;
+
+  hlong *v = (hlong*) calloc(meshCheckpointMaxVerts, sizeof(hlong));
+
+  // same partition as the writing run: keys are where this rank wrote them
+  int match = (Nglobal==Nfile);
+  if(match && Nlocal){
+    hlong *keys = (hlong*) calloc(Nlocal*mesh->Nverts, sizeof(hlong));
+    match = meshCheckpointPread(fd, (char*) keys, Nlocal*keyBytes, keyOffset + start*keyBytes);
+    for(dlong e=0;match && e<mesh->Nelements;++e){
+      meshCheckpointElementKey(mesh, e, v);
+      for(int n=0;n<mesh->Nverts;++n)
+        if(v[n]!=keys[e*mesh->Nverts+n]) match = 0;
+    }
+    free(keys);
+  }
+
+  int allMatch = 0;
+  MPI_Allreduce(&match, &allMatch, 1, MPI_INT, MPI_MIN, mesh->comm);
+
+  if(allMatch){
+    for(dlong e=0;e<mesh->Nelements;++e)
+      fileIds[e] = start + e;
+    free(v);
+    return;
+  }
+
+  // otherwise each rank reads a slice of the keys and both the file keys
+  // and the local element keys meet on a rank chosen by hashing the key
+  hlong fileStart = (Nfile*mesh->rank)/mesh->size;
+  hlong fileEnd   = (Nfile*(mesh->rank+1))/mesh->size;
+  hlong Nslice    = fileEnd-fileStart;
+
+  hlong *fileKeys = (hlong*) calloc(Nslice*mesh->Nverts+1, sizeof(hlong));
+  if(Nslice && !meshCheckpointPread(fd, (char*) fileKeys, Nslice*keyBytes, keyOffset + fileStart*keyBytes)){
+    printf("meshCheckpointRead: could not read element keys\n");
+    MPI_Abort(mesh->comm, -1);
+  }
+
+  dlong Nsend = Nslice + mesh->Nelements;
+  meshCheckpointKey_t *records = (meshCheckpointKey_t*) calloc(Nsend+1, sizeof(meshCheckpointKey_t));
+  int *dest = (int*) calloc(Nsend+1, sizeof(int));
+  int *sendCounts = (int*) calloc(mesh->size, sizeof(int));
+  int *recvCounts = (int*) calloc(mesh->size, sizeof(int));
+
+  for(hlong n=0;n<Nslice;++n){
+    for(int i=0;i<mesh->Nverts;++i)
+      records[n].v[i] = fileKeys[n*mesh->Nverts+i];
+    records[n].fileId  = fileStart + n;
+    records[n].rank    = -1;
+    records[n].element = -1;
+  }
+  for(dlong e=0;e<mesh->Nelements;++e){
+    meshCheckpointKey_t *r = records + Nslice + e;
+    meshCheckpointElementKey(mesh, e, r->v);
+    r->fileId  = -1;
+    r->rank    = mesh->rank;
+    r->element = e;
+  }
+  free(fileKeys);
+
+  // bucket by matching rank
+  for(dlong n=0;n<Nsend;++n){
+    dest[n] = meshCheckpointRank(mesh, records[n].v);
+    sendCounts[dest[n]]++;
+  }
+  int *starts = (int*) calloc(mesh->size+1, sizeof(int));
+  for(int r=0;r<mesh->size;++r)
+    starts[r+1] = starts[r] + sendCounts[r];
+  meshCheckpointKey_t *sendRecords = (meshCheckpointKey_t*) calloc(Nsend+1, sizeof(meshCheckpointKey_t));
+  for(dlong n=0;n<Nsend;++n)
+    sendRecords[starts[dest[n]]++] = records[n];
+  free(records);
+  free(dest);
+
+  meshCheckpointKey_t *recvRecords = (meshCheckpointKey_t*)
+    parallelExchange(mesh->comm, sizeof(meshCheckpointKey_t), sendRecords, sendCounts, recvCounts);
+  free(sendRecords);
+
+  dlong Nrecv = 0;
+  for(int r=0;r<mesh->size;++r)
+    Nrecv += recvCounts[r];
+
+  // file record leads each group of equal keys
+  meshCheckpointNverts = mesh->Nverts;
+  qsort(recvRecords, Nrecv, sizeof(meshCheckpointKey_t), meshCheckpointCompareKeys);
+
+  hlong fileId = -1;
+  dlong Nreply = 0;
+  for(dlong n=0;n<Nrecv;++n){
+    if(recvRecords[n].rank==-1){
+      fileId = recvRecords[n].fileId;
+      continue;
+    }
+    int sameKey = (n>0);
+    for(int i=0;sameKey && i<mesh->Nverts;++i)
+      if(recvRecords[n].v[i]!=recvRecords[n-1].v[i]) sameKey = 0;
+    if(!sameKey) fileId = -1;
+    recvRecords[n].fileId = fileId;
+    recvRecords[Nreply++] = recvRecords[n];
+  }
+
+  // send answers back to the element owners
+  qsort(recvRecords, Nreply, sizeof(meshCheckpointKey_t), meshCheckpointCompareRanks);
+  for(int r=0;r<mesh->size;++r)
+    sendCounts[r] = 0;
+  for(dlong n=0;n<Nreply;++n)
+    sendCounts[recvRecords[n].rank]++;
+
+  meshCheckpointKey_t *replies = (meshCheckpointKey_t*)
+    parallelExchange(mesh->comm, sizeof(meshCheckpointKey_t), recvRecords, sendCounts, recvCounts);
+
+  int missing = 0;
+  for(dlong n=0;n<mesh->Nelements;++n){
+    fileIds[replies[n].element] = replies[n].fileId;
+    if(replies[n].fileId<0) missing = 1;
+  }
+
+  if(missing){
+    printf("meshCheckpointRead: rank %d has elements that are not in the checkpoint\n", mesh->rank);
+    MPI_Abort(mesh->comm, -1);
+  }
+
+  free(recvRecords); free(replies);
+  free(sendCounts);  free(recvCounts);
+  free(starts);
+  free(v);
+}
+
+static hlong *meshCheckpointSortFileIds = NULL;
+
+static int meshCheckpointCompareFileIds(const void *a, const void *b){
+  hlong fa = meshCheckpointSortFileIds[*(dlong*)a];
+  hlong fb = meshCheckpointSortFileIds[*(dlong*)b];
+  if(fa < fb) return -1;
+  if(fa > fb) return +1;
+  return 0;
+}
+
+// returns 1 if the checkpoint was found and read (on all ranks), 0 if there is none
+int meshCheckpointRead(mesh_t *mesh, const char *fileName, int Nscalars, dfloat *scalars,
+                       int Nfields, meshCheckpointField_t *fields){
+
+  int fd = open(fileName, O_RDONLY);
+
+  int found = (fd>=0), allFound = 0;
+  MPI_Allreduce(&found, &allFound, 1, MPI_INT, MPI_MIN, mesh->comm);
+  if(!allFound){
+    if(fd>=0) close(fd);
+    return 0;
+  }
+
+  size_t headerBytes = meshCheckpointHeaderBytes(Nscalars, Nfields);
+  char *h = (char*) calloc(headerBytes, sizeof(char));
+  meshCheckpointHeader_t header;
+
+  int ok = meshCheckpointPread(fd, h, headerBytes, 0);
+  memcpy(&header, h, sizeof(header));
+
+  ok = ok && !strncmp(header.magic, "LIBPCHK", 8)
+    && header.version==meshCheckpointVersion
+    && header.dfloatSize==(int)sizeof(dfloat) && header.hlongSize==(int)sizeof(hlong)
+    && header.Np==mesh->Np && header.Nverts==mesh->Nverts
+    && header.Nscalars==Nscalars && header.Nfields==Nfields;
+
+  int *Nvalues = (int*) (h + sizeof(header) + Nscalars*sizeof(dfloat));
+  for(int fld=0;ok && fld<Nfields;++fld)
+    if(Nvalues[fld]!=fields[fld].Nvalues) ok = 0;
+
+  if(!ok){
+    printf("meshCheckpointRead: %s does not match this run (element type, degree or fields)\n", fileName);
+    MPI_Abort(mesh->comm, -1);
+  }
+
+  memcpy(scalars, h + sizeof(header), Nscalars*sizeof(dfloat));
+  free(h);
+
+  size_t keyOffset = headerBytes;
+  hlong Nfile = header.Nelements;
+
+  hlong *fileIds = (hlong*) calloc(mesh->Nelements+1, sizeof(hlong));
+  meshCheckpointLocate(mesh, fd, keyOffset, Nfile, fileIds);
+
+  // visit local elements in file order so that consecutive records are read together
+  dlong *order = (dlong*) calloc(mesh->Nelements+1, sizeof(dlong));
+  for(dlong e=0;e<mesh->Nelements;++e)
+    order[e] = e;
+  meshCheckpointSortFileIds = fileIds;
+  qsort(order, mesh->Nelements, sizeof(dlong), meshCheckpointCompareFileIds);
+
+  size_t fieldOffset = keyOffset + Nfile*mesh->Nverts*sizeof(hlong);
+
+  for(int fld=0;fld<Nfields;++fld){
+    int Nv = fields[fld].Nvalues;
+    size_t recordBytes = Nv*sizeof(dfloat);
+    dlong *map = fields[fld].elementMap;
+
+    dlong Nrecords = mesh->Nelements;
+    if(map){
+      Nrecords = 0;
+      for(dlong e=0;e<mesh->Nelements;++e)
+        Nrecords = mymax(Nrecords, map[e]+1);
+    }
+
+    dfloat *q   = (dfloat*) calloc(((size_t) Nrecords)*Nv+1, sizeof(dfloat));
+    dfloat *run = (dfloat*) calloc(((size_t) mesh->Nelements)*Nv+1, sizeof(dfloat));
+
+    // keep records of elements without one in the map
+    if(map && Nrecords)
+      fields[fld].o_q.copyTo(q, Nrecords*recordBytes, fields[fld].offset*sizeof(dfloat));
+
+    for(dlong n=0;n<mesh->Nelements;){
+      dlong m = n+1;
+      while(m<mesh->Nelements && fileIds[order[m]]==fileIds[order[m-1]]+1) ++m;
+
+      if(!meshCheckpointPread(fd, (char*) run, (m-n)*recordBytes,
+                              fieldOffset + fileIds[order[n]]*recordBytes)){
+        printf("meshCheckpointRead: could not read %s\n", fileName);
+        MPI_Abort(mesh->comm, -1);
+      }
+
+      for(dlong i=n;i<m;++i){
+        dlong e = order[i];
+        dlong record = map ? map[e] : e;
+        if(record>=0)
+          memcpy(q + record*Nv, run + (i-n)*Nv, recordBytes);
+      }
+      n = m;
+    }
+
+    if(Nrecords)
+      fields[fld].o_q.copyFrom(q, Nrecords*recordBytes, fields[fld].offset*sizeof(dfloat));
+
+    free(q);
+    free(run);
+
+    fieldOffset += Nfile*recordBytes;
+  }
+
+  close(fd);
+  free(order);
+  free(fileIds);
+
+  return 1;
+}
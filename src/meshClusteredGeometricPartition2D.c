@@ -105,13 +105,8 @@ dfloat meshClusteredGeometricPartition2D(mesh2D *mesh, int Nclusters, cluster_t
   rank = mesh->rank;
   size = mesh->size;
 
-  int maxNclusters;
-  MPI_Allreduce(&Nclusters, &maxNclusters, 1, MPI_INT, MPI_MAX,mesh->comm);
-  maxNclusters = 2*((maxNclusters+1)/2);
-  
-  // fix maxNclusters
   parallelCluster_t *parallelClusters 
-    = (parallelCluster_t*) calloc(maxNclusters, sizeof(parallelCluster_t));
+    = (parallelCluster_t*) calloc(Nclusters, sizeof(parallelCluster_t));
 
   // local bounding box of element centers
   dfloat mincx = 1e9, maxcx = -1e9;
@@ -178,19 +173,13 @@ dfloat meshClusteredGeometricPartition2D(mesh2D *mesh, int Nclusters, cluster_t
     parallelClusters[cnt].rank = rank;
   }
 
-  // pad cluster array with dummy clusters
-  for(int n=Nclusters;n<maxNclusters;++n){
-    parallelClusters[n].Nelements = -1;
-    parallelClusters[n].index = hilbert2D(Nboxes, Nboxes-1, Nboxes-1);
-  }
-
-  // odd-even parallel sort of cluster capsules based on their Morton index
+  // parallel sample sort of cluster capsules based on their Morton index
   parallelSort(mesh->size, mesh->rank, mesh->comm,
-	       maxNclusters, parallelClusters, sizeof(parallelCluster_t),
+	       Nclusters, parallelClusters, sizeof(parallelCluster_t),
 	       compareIndex2D, bogusMatch);
 
   int newNclusters =0;
-  for (int n=0;n<maxNclusters;n++)
+  for (int n=0;n<Nclusters;n++)
     newNclusters += (parallelClusters[n].Nelements != -1);
 
   //Do an initial partitioning
@@ -106,13 +106,8 @@ dfloat meshClusteredGeometricPartition3D(mesh3D *mesh, int Nclusters, cluster_t
   rank = mesh->rank;
   size = mesh->size;
 
-  int maxNclusters;
-  MPI_Allreduce(&Nclusters, &maxNclusters, 1, MPI_INT, MPI_MAX,mesh->comm);
-  maxNclusters = 2*((maxNclusters+1)/2);
-  
-  // fix maxNclusters
   parallelCluster_t *parallelClusters 
-    = (parallelCluster_t*) calloc(maxNclusters, sizeof(parallelCluster_t));
+    = (parallelCluster_t*) calloc(Nclusters, sizeof(parallelCluster_t));
 
   // local bounding box of element centers
   dfloat mincx = 1e9, maxcx = -1e9;
@@ -191,19 +186,13 @@ dfloat meshClusteredGeometricPartition3D(mesh3D *mesh, int Nclusters, cluster_t
     parallelClusters[cnt].rank = rank;
   }
 
-  // pad cluster array with dummy clusters
-  for(int n=Nclusters;n<maxNclusters;++n){
-    parallelClusters[n].Nelements = -1;
-    parallelClusters[n].index = mortonIndex3D(Nboxes+1, Nboxes+1,Nboxes+1);
-  }
-
-  // odd-even parallel sort of cluster capsules based on their Morton index
+  // parallel sample sort of cluster capsules based on their Morton index
   parallelSort(mesh->size, mesh->rank, mesh->comm,
-	       maxNclusters, parallelClusters, sizeof(parallelCluster_t),
+	       Nclusters, parallelClusters, sizeof(parallelCluster_t),
 	       compareIndex3D, bogusMatch);
 
   int newNclusters =0;
-  for (int n=0;n<maxNclusters;n++)
+  for (int n=0;n<Nclusters;n++)
     newNclusters += (parallelClusters[n].Nelements != -1);
 
   //Do an initial partitioning
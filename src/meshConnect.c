@@ -28,137 +28,98 @@ SOFTWARE.
 #include <stdio.h>
 #include "mesh.h"
 
-// structure used to encode vertices that make 
-// each face, the element/face indices, and
-// the neighbor element/face indices (if any)
-typedef struct{
-
-  dlong element;
-  int face;
-
-  dlong elementNeighbor; // neighbor element
-  int faceNeighbor;    // neighbor face
-
-  int NfaceVertices;
-  
-  hlong v[4];
-
-}face_t;
-
-// comparison function that orders vertices 
-// based on their combined vertex indices
-int compareVertices(const void *a, 
-                    const void *b){
-
-  face_t *fa = (face_t*) a;
-  face_t *fb = (face_t*) b;
-  
-  for(int n=0;n<fa->NfaceVertices;++n){
-    if(fa->v[n] < fb->v[n]) return -1;
-    if(fa->v[n] > fb->v[n]) return +1;
-  }
-  
-  return 0;
+// hash of a sorted face vertex tuple
+static unsigned long long int meshFaceHash(int NfaceVertices, hlong *v){
+
+  unsigned long long int hash = 14695981039346656037ULL;
+  for(int n=0;n<NfaceVertices;++n)
+    hash = (hash ^ (unsigned long long int) v[n])*1099511628211ULL;
 
+  return hash;
 }
-/* comparison function that orders element/face
-   based on their indexes */
-int compareFaces(const void *a, 
-                 const void *b){
 
-  face_t *fa = (face_t*) a;
-  face_t *fb = (face_t*) b;
+/* match faces with equal (sorted) vertex tuples through an open addressing
+   hash table. faceVerts holds NfaceVertices ids per face, on return match[n]
+   is the index of the face matching face n, or -1 if it has no match */
+void meshMatchFaces(int NfaceVertices, dlong Nfaces, hlong *faceVerts, dlong *match){
+
+  size_t Ntable = 1;
+  while(Ntable<2*(size_t)Nfaces) Ntable *= 2;
 
-  if(fa->element < fb->element) return -1;
-  if(fa->element > fb->element) return +1;
+  dlong *table = (dlong*) malloc(Ntable*sizeof(dlong));
+  for(size_t n=0;n<Ntable;++n)
+    table[n] = -1;
 
-  if(fa->face < fb->face) return -1;
-  if(fa->face > fb->face) return +1;
+  for(dlong n=0;n<Nfaces;++n){
+    hlong *v = faceVerts + (size_t)n*NfaceVertices;
 
-  return 0;
+    match[n] = -1;
 
+    // linear probing until the face or an empty slot is found
+    size_t slot = meshFaceHash(NfaceVertices, v)&(Ntable-1);
+    for(;table[slot]!=-1;slot=(slot+1)&(Ntable-1)){
+      dlong m = table[slot];
+      hlong *vm = faceVerts + (size_t)m*NfaceVertices;
+
+      int equal = 1;
+      for(int i=0;i<NfaceVertices;++i)
+        if(v[i]!=vm[i]) equal = 0;
+
+      if(equal){
+        if(match[m]==-1){
+          match[m] = n;
+          match[n] = m;
+        }
+        break;
+      }
+    }
+
+    if(table[slot]==-1)
+      table[slot] = n;
+  }
+
+  free(table);
 }
 
 /* routine to find EToE (Element To Element)
    and EToF (Element To Local Face) connectivity arrays */
 void meshConnect(mesh_t *mesh){
 
-  /* build list of faces */
-  face_t *faces = 
-    (face_t*) calloc(mesh->Nelements*mesh->Nfaces, sizeof(face_t));
-  
+  dlong Nfaces = mesh->Nelements*mesh->Nfaces;
+
+  /* build list of sorted face vertices */
+  hlong *faceVerts = (hlong*) calloc((size_t)Nfaces*mesh->NfaceVertices+1, sizeof(hlong));
+  dlong *match     = (dlong*) calloc(Nfaces+1, sizeof(dlong));
+
   dlong cnt = 0;
   for(dlong e=0;e<mesh->Nelements;++e){
     for(int f=0;f<mesh->Nfaces;++f){
-      
+      hlong *v = faceVerts + (size_t)cnt*mesh->NfaceVertices;
+
       for(int n=0;n<mesh->NfaceVertices;++n){
         dlong vid = e*mesh->Nverts + mesh->faceVertices[f*mesh->NfaceVertices+n];
-        faces[cnt].v[n] = mesh->EToV[vid];
+        v[n] = mesh->EToV[vid];
       }
-      
-      mysort(faces[cnt].v, mesh->NfaceVertices, "descending");
 
-      faces[cnt].NfaceVertices = mesh->NfaceVertices;
-      
-      faces[cnt].element = e;
-      faces[cnt].face = f;
-      
-      faces[cnt].elementNeighbor= -1;
-      faces[cnt].faceNeighbor = -1;
+      mysort(v, mesh->NfaceVertices, "descending");
 
       ++cnt;
-
     }
   }
-  
-  /* sort faces by their vertex number pairs */
-  qsort(faces, 
-        mesh->Nelements*mesh->Nfaces,
-        sizeof(face_t),
-        compareVertices);
-  
-  /* scan through sorted face lists looking for adjacent
-     faces that have the same vertex ids */
-  for(cnt=0;cnt<mesh->Nelements*mesh->Nfaces-1;++cnt){
-    
-    if(!compareVertices(faces+cnt, faces+cnt+1)){
-      // match
-      faces[cnt].elementNeighbor = faces[cnt+1].element;
-      faces[cnt].faceNeighbor = faces[cnt+1].face;
-
-      faces[cnt+1].elementNeighbor = faces[cnt].element;
-      faces[cnt+1].faceNeighbor = faces[cnt].face;
-    }
-    
-  }
 
-  /* resort faces back to the original element/face ordering */
-  qsort(faces, 
-        mesh->Nelements*mesh->Nfaces,
-        sizeof(face_t),
-        compareFaces);
+  /* pair up faces that have the same vertex ids */
+  meshMatchFaces(mesh->NfaceVertices, Nfaces, faceVerts, match);
 
   /* extract the element to element and element to face connectivity */
-  mesh->EToE = (dlong*) calloc(mesh->Nelements*mesh->Nfaces, sizeof(dlong));
-  mesh->EToF = (int*)   calloc(mesh->Nelements*mesh->Nfaces, sizeof(int  ));
+  mesh->EToE = (dlong*) calloc(Nfaces, sizeof(dlong));
+  mesh->EToF = (int*)   calloc(Nfaces, sizeof(int  ));
 
-  cnt = 0;
-  for(dlong e=0;e<mesh->Nelements;++e){
-    for(int f=0;f<mesh->Nfaces;++f){
-      mesh->EToE[cnt] = faces[cnt].elementNeighbor;
-      mesh->EToF[cnt] = faces[cnt].faceNeighbor;
-
-      //      printf("EToE(%d,%d) = %d \n", e,f, mesh->EToE[cnt]);
-      
-      ++cnt;
-    }
+  for(cnt=0;cnt<Nfaces;++cnt){
+    dlong m = match[cnt];
+    mesh->EToE[cnt] = (m==-1) ? -1 : m/mesh->Nfaces;
+    mesh->EToF[cnt] = (m==-1) ? -1 : m%mesh->Nfaces;
   }
 
-  // dlong Nbcs = 0;
-  // for(dlong e=0;e<mesh->Nelements;++e)
-  //   for(int f=0;f<mesh->Nfaces;++f)
-  //     if(mesh->EToE[e*mesh->Nfaces+f]==-1)
-  //       ++Nbcs;
-  //printf("Nelements = %d, Nbcs = %d\n", mesh->Nelements, Nbcs);
+  free(faceVerts);
+  free(match);
 }
-
@@ -188,13 +188,8 @@ void meshGeometricPartition2D(mesh2D *mesh){
   rank = mesh->rank;
   size = mesh->size;
 
-  dlong maxNelements;
-  MPI_Allreduce(&(mesh->Nelements), &maxNelements, 1, MPI_DLONG, MPI_MAX, mesh->comm);
-  maxNelements = 2*((maxNelements+1)/2);
-
-  // fix maxNelements
   element_t *elements
-    = (element_t*) calloc(maxNelements, sizeof(element_t));
+    = (element_t*) calloc(mesh->Nelements, sizeof(element_t));
 
   // local bounding box of element centers
   dfloat mincx = 1e9, maxcx = -1e9;
@@ -263,26 +258,16 @@ void meshGeometricPartition2D(mesh2D *mesh){
     elements[e].index = hilbert2D(Nboxes, ix, iy);
   }
 
-  // pad element array with dummy elements
-  for(dlong e=mesh->Nelements;e<maxNelements;++e){
-    elements[e].element = -1;
-
-    elements[e].index = hilbert2D(Nboxes, Nboxes-1, Nboxes-1);
-    
-    //    elements[e].index = hilbert2D(Nboxes+1, Nboxes+1);
-    //    elements[e].index = mortonIndex2D(Nboxes+1, Nboxes+1);
-  }
-
-  // odd-even parallel sort of element capsules based on their Morton index
+  // parallel sample sort of element capsules based on their Hilbert index
   parallelSort(mesh->size, mesh->rank, mesh->comm,
-	       maxNelements, elements, sizeof(element_t),
+	       mesh->Nelements, elements, sizeof(element_t),
 	       compareElements2D,
 	       bogusMatch);
 
 
   // compress and renumber elements
   dlong sk  = 0;
-  for(dlong e=0;e<maxNelements;++e){
+  for(dlong e=0;e<mesh->Nelements;++e){
     if(elements[e].element != -1){
       elements[sk] = elements[e];
       ++sk;
@@ -61,6 +61,71 @@ unsigned long long int mortonIndex3D(unsigned int ix, unsigned int iy, unsigned
   return mi;
 }
 
+// compute Hilbert index of (ix,iy,iz) relative to a bitRange x bitRange x bitRange lattice
+// (Skilling's transpose algorithm, bits of the transposed axes interleaved)
+unsigned long long int hilbertIndex3D(unsigned int ix, unsigned int iy, unsigned int iz){
+
+  unsigned int X[3] = {ix, iy, iz};
+  unsigned int M = 1u << (bitRange-1);
+
+  // inverse undo excess work
+  for(unsigned int Q=M;Q>1;Q>>=1){
+    unsigned int P = Q-1;
+    for(int i=0;i<3;++i){
+      if(X[i] & Q){
+        X[0] ^= P; // invert
+      } else {     // exchange
+        unsigned int t = (X[0]^X[i]) & P;
+        X[0] ^= t;
+        X[i] ^= t;
+      }
+    }
+  }
+
+  // Gray encode
+  for(int i=1;i<3;++i) X[i] ^= X[i-1];
+  unsigned int t = 0;
+  for(unsigned int Q=M;Q>1;Q>>=1)
+    if(X[2] & Q) t ^= Q-1;
+  for(int i=0;i<3;++i) X[i] ^= t;
+
+  unsigned long long int hi = 0;
+  for(int b=bitRange-1;b>=0;--b)
+    for(int i=0;i<3;++i)
+      hi = (hi<<1) | ((X[i]>>b) & 1);
+
+  return hi;
+}
+
+// element cost model for the weighted Hilbert partition (unset: Morton, equal counts)
+static int costModelSet = 0;
+static int costModelNtypes = 0;
+static int *costModelTypes = NULL;
+static dfloat *costModelWeights = NULL;
+
+void meshGeometricPartitionCostModel3D(int Ntypes, int *types, dfloat *weights){
+
+  costModelSet = 1;
+  costModelNtypes = Ntypes;
+
+  free(costModelTypes);
+  free(costModelWeights);
+  costModelTypes   = (int*) calloc(Ntypes+1, sizeof(int));
+  costModelWeights = (dfloat*) calloc(Ntypes+1, sizeof(dfloat));
+  for(int n=0;n<Ntypes;++n){
+    costModelTypes[n]   = types[n];
+    costModelWeights[n] = weights[n];
+  }
+}
+
+dfloat meshGeometricPartitionWeight3D(int type){
+
+  for(int n=0;n<costModelNtypes;++n)
+    if(costModelTypes[n]==type) return costModelWeights[n];
+
+  return 1.;
+}
+
 // capsule for element vertices + Morton index
 typedef struct {
   
@@ -70,6 +135,8 @@ typedef struct {
 
   int type;
 
+  dfloat weight;
+
   // use 8 for maximum vertices per element
   hlong v[8];
 
@@ -93,21 +160,16 @@ int compareElements(const void *a, const void *b){
 // stub for the match function needed by parallelSort
 void bogusMatch3D(void *a, void *b){ }
 
-// geometric partition of elements in 3D mesh using Morton ordering + parallelSort
+// geometric partition of elements in 3D mesh using Morton ordering + parallelSort,
+// or Hilbert ordering split by cumulative element weight when a cost model is set
 void meshGeometricPartition3D(mesh3D *mesh){
 
   int rank, size;
   rank = mesh->rank;
   size = mesh->size;
 
-  dlong maxNelements;
-  MPI_Allreduce(&(mesh->Nelements), &maxNelements, 1, MPI_DLONG, MPI_MAX,
-		mesh->comm);
-  maxNelements = 2*((maxNelements+1)/2);
-  
-  // fix maxNelements
   element_t *elements 
-    = (element_t*) calloc(maxNelements, sizeof(element_t));
+    = (element_t*) calloc(mesh->Nelements, sizeof(element_t));
 
   // local bounding box of element centers
   dfloat minvx = 1e9, maxvx = -1e9;
@@ -160,6 +222,7 @@ void meshGeometricPartition3D(mesh3D *mesh){
     }
 
     elements[e].type = mesh->elementInfo[e];
+    elements[e].weight = meshGeometricPartitionWeight3D(elements[e].type);
 
     dfloat maxlength = mymax(gmaxvx-gminvx, mymax(gmaxvy-gminvy, gmaxvz-gminvz));
 
@@ -168,25 +231,22 @@ void meshGeometricPartition3D(mesh3D *mesh){
     unsigned long long int iy = (cy-gminvy)*Nboxes/maxlength;
     unsigned long long int iz = (cz-gminvz)*Nboxes/maxlength;
 			
-    elements[e].index = mortonIndex3D(ix, iy, iz);
-  }
-
-  // pad element array with dummy elements
-  for(dlong e=mesh->Nelements;e<maxNelements;++e){
-    elements[e].element = -1;
-    elements[e].index = mortonIndex3D(Nboxes+1, Nboxes+1, Nboxes+1);
+    if(costModelSet)
+      elements[e].index = hilbertIndex3D(ix, iy, iz);
+    else
+      elements[e].index = mortonIndex3D(ix, iy, iz);
   }
 
-  // odd-even parallel sort of element capsules based on their Morton index
+  // parallel sample sort of element capsules based on their Morton/Hilbert index
   parallelSort(mesh->size, mesh->rank, mesh->comm,
-	       maxNelements, elements, sizeof(element_t),
+	       mesh->Nelements, elements, sizeof(element_t),
 	       compareElements, 
 	       bogusMatch3D);
 
 #if 0
   // count number of elements that end up on this process
   int cnt = 0;
-  for(int e=0;e<maxNelements;++e)
+  for(int e=0;e<mesh->Nelements;++e)
     cnt += (elements[e].element != -1);
 
   // reset number of elements and element-to-vertex connectivity from returned capsules
@@ -202,7 +262,7 @@ void meshGeometricPartition3D(mesh3D *mesh){
   mesh->EZ = (dfloat*) calloc(cnt*mesh->Nverts, sizeof(dfloat));
 
   cnt = 0;
-  for(int e=0;e<maxNelements;++e){
+  for(int e=0;e<mesh->Nelements;++e){
     if(elements[e].element != -1){
       for(int n=0;n<mesh->Nverts;++n){
 	mesh->EToV[cnt*mesh->Nverts + n] = elements[e].v[n];
@@ -216,7 +276,7 @@ void meshGeometricPartition3D(mesh3D *mesh){
 #else
   // compress and renumber elements
   dlong sk  = 0;
-  for(dlong e=0;e<maxNelements;++e){
+  for(dlong e=0;e<mesh->Nelements;++e){
     if(elements[e].element != -1){
       elements[sk] = elements[e];
       ++sk;
@@ -249,17 +309,18 @@ void meshGeometricPartition3D(mesh3D *mesh){
 
   // Make the MPI_ELEMENT_T data type
   MPI_Datatype MPI_ELEMENT_T;
-  MPI_Datatype dtype[7] = {MPI_LONG_LONG_INT, MPI_DLONG, MPI_INT,
+  MPI_Datatype dtype[8] = {MPI_LONG_LONG_INT, MPI_DLONG, MPI_INT, MPI_DFLOAT,
                             MPI_HLONG, MPI_DFLOAT, MPI_DFLOAT, MPI_DFLOAT};
-  int blength[7] = {1, 1, 1, 8, 8, 8, 8};
-  MPI_Aint addr[7], displ[7];
+  int blength[8] = {1, 1, 1, 1, 8, 8, 8, 8};
+  MPI_Aint addr[8], displ[8];
   MPI_Get_address ( &(elements[0]        ), addr+0);
   MPI_Get_address ( &(elements[0].element), addr+1);
   MPI_Get_address ( &(elements[0].type   ), addr+2);
-  MPI_Get_address ( &(elements[0].v[0]   ), addr+3);
-  MPI_Get_address ( &(elements[0].EX[0]  ), addr+4);
-  MPI_Get_address ( &(elements[0].EY[0]  ), addr+5);
-  MPI_Get_address ( &(elements[0].EZ[0]  ), addr+6);
+  MPI_Get_address ( &(elements[0].weight ), addr+3);
+  MPI_Get_address ( &(elements[0].v[0]   ), addr+4);
+  MPI_Get_address ( &(elements[0].EX[0]  ), addr+5);
+  MPI_Get_address ( &(elements[0].EY[0]  ), addr+6);
+  MPI_Get_address ( &(elements[0].EZ[0]  ), addr+7);
   displ[0] = 0;
   displ[1] = addr[1] - addr[0];
   displ[2] = addr[2] - addr[0];
@@ -267,23 +328,45 @@ void meshGeometricPartition3D(mesh3D *mesh){
   displ[4] = addr[4] - addr[0];
   displ[5] = addr[5] - addr[0];
   displ[6] = addr[6] - addr[0];
-  MPI_Type_create_struct (7, blength, displ, dtype, &MPI_ELEMENT_T);
+  displ[7] = addr[7] - addr[0];
+  MPI_Type_create_struct (8, blength, displ, dtype, &MPI_ELEMENT_T);
   MPI_Type_commit (&MPI_ELEMENT_T);
 
+  if(costModelSet){
+    // split the curve into equal chunks of cumulative weight
+    dfloat localWeight = 0., weightOffset = 0., totalWeight = 0.;
+    for(dlong e=0;e<localNelements;++e)
+      localWeight += elements[e].weight;
 
-  for(dlong e=0;e<localNelements;++e){
+    MPI_Exscan(&localWeight, &weightOffset, 1, MPI_DFLOAT, MPI_SUM, mesh->comm);
+    if(rank==0) weightOffset = 0.;
+    MPI_Allreduce(&localWeight, &totalWeight, 1, MPI_DFLOAT, MPI_SUM, mesh->comm);
 
-    // global element index
-    elements[e].element = starts[rank]+e;
+    dfloat chunkWeight = totalWeight/size;
 
-    // 0, chunk+1, 2*(chunk+1) ..., remainder*(chunk+1), remainder*(chunk+1) + chunk
-    int r;
-    if(elements[e].element<remainder*(chunk+1))
-      r = elements[e].element/(chunk+1);
-    else
-      r = remainder + ((elements[e].element-remainder*(chunk+1))/chunk);
+    for(dlong e=0;e<localNelements;++e){
+      // assign by the weight midpoint of the element
+      int r = (int) ((weightOffset + 0.5*elements[e].weight)/chunkWeight);
+      r = mymin(r, size-1);
+      weightOffset += elements[e].weight;
 
-    ++Nsend[r];
+      ++Nsend[r];
+    }
+  } else {
+    for(dlong e=0;e<localNelements;++e){
+
+      // global element index
+      elements[e].element = starts[rank]+e;
+
+      // 0, chunk+1, 2*(chunk+1) ..., remainder*(chunk+1), remainder*(chunk+1) + chunk
+      int r;
+      if(elements[e].element<remainder*(chunk+1))
+        r = elements[e].element/(chunk+1);
+      else
+        r = remainder + ((elements[e].element-remainder*(chunk+1))/chunk);
+
+      ++Nsend[r];
+    }
   }
 
   // find send offsets
@@ -314,6 +397,20 @@ void meshGeometricPartition3D(mesh3D *mesh){
   if (elements) free(elements);
   elements = tmpElements;
 
+  if(costModelSet){
+    // predicted load imbalance: heaviest rank relative to the mean
+    dfloat localWeight = 0., maxWeight = 0., totalWeight = 0.;
+    for(dlong e=0;e<newNelements;++e)
+      localWeight += elements[e].weight;
+
+    MPI_Allreduce(&localWeight, &maxWeight, 1, MPI_DFLOAT, MPI_MAX, mesh->comm);
+    MPI_Allreduce(&localWeight, &totalWeight, 1, MPI_DFLOAT, MPI_SUM, mesh->comm);
+
+    if(rank==0)
+      printf("Weighted Hilbert partition: predicted imbalance %g (max/mean rank weight)\n",
+             maxWeight*size/totalWeight);
+  }
+
   // reset number of elements and element-to-vertex connectivity from returned capsules
   free(mesh->EToV);
   free(mesh->EX);
@@ -28,6 +28,126 @@ SOFTWARE.
 
 #include "mesh.h"
 
+// persistent send/recv requests bound to one set of halo buffers
+typedef struct {
+
+  size_t Nbytes;
+  void *sendBuffer, *recvBuffer;
+
+  MPI_Request *requests; // NhaloMessages receives followed by NhaloMessages sends
+
+  long long int lastUse; // for least recently used eviction
+
+}haloPlan_t;
+
+// plans are keyed by raw buffer pointers, so the list is bounded and the least
+// recently used plan is evicted when a new buffer pair shows up
+#define maxHaloPlans 16
+
+typedef struct {
+
+  int Nplans;
+  int active; // plan started by meshHaloExchangeStart (-1 if none)
+  long long int Nuses;
+  haloPlan_t plans[maxHaloPlans];
+
+}haloPlanList_t;
+
+// initiate immediate sends and receives to each neighbour
+static void meshHaloExchangePost(mesh_t *mesh, size_t Nbytes, void *sendBuffer, void *recvBuffer){
+
+  int tag = 999;
+
+  for(int m=0;m<mesh->NhaloMessages;++m){
+    int r = mesh->haloNeighbors[m];
+    size_t offset = mesh->haloNeighborOffsets[m]*Nbytes;
+    size_t count  = mesh->NhaloPairs[r]*Nbytes;
+
+    MPI_Irecv(((char*)recvBuffer)+offset, count, MPI_CHAR, r, tag,
+              mesh->comm, (MPI_Request*)mesh->haloRecvRequests+m);
+
+    MPI_Isend(((char*)sendBuffer)+offset, count, MPI_CHAR, r, tag,
+              mesh->comm, (MPI_Request*)mesh->haloSendRequests+m);
+  }
+}
+
+// release the persistent requests of a plan
+static void meshHaloExchangePlanFree(mesh_t *mesh, haloPlan_t *plan){
+
+  for(int m=0;m<2*mesh->NhaloMessages;++m)
+    MPI_Request_free(plan->requests+m);
+
+  free(plan->requests);
+  plan->requests = NULL;
+}
+
+// remove plan n from the list, keeping the list contiguous
+static void meshHaloExchangePlanEvict(mesh_t *mesh, haloPlanList_t *list, int n){
+
+  meshHaloExchangePlanFree(mesh, list->plans+n);
+
+  list->plans[n] = list->plans[list->Nplans-1];
+  if(list->active==list->Nplans-1) list->active = n;
+  list->Nplans--;
+}
+
+// empty plan list, created with the halo so that meshes copying the halo share it
+void meshHaloExchangeSetup(mesh_t *mesh){
+
+  haloPlanList_t *list = (haloPlanList_t*) calloc(1, sizeof(haloPlanList_t));
+  list->active = -1;
+  mesh->haloPlans = list;
+}
+
+// find (or build once) the persistent requests for this set of buffers
+static haloPlan_t *meshHaloExchangePlan(mesh_t *mesh, size_t Nbytes, void *sendBuffer, void *recvBuffer){
+
+  haloPlanList_t *list = (haloPlanList_t*) mesh->haloPlans;
+
+  for(int n=0;n<list->Nplans;++n){
+    haloPlan_t *plan = list->plans+n;
+    if(plan->Nbytes==Nbytes && plan->sendBuffer==sendBuffer && plan->recvBuffer==recvBuffer){
+      plan->lastUse = list->Nuses++;
+      list->active = n;
+      return plan;
+    }
+  }
+
+  if(list->Nplans==maxHaloPlans){
+    int lru = -1;
+    for(int n=0;n<list->Nplans;++n){
+      if(n==list->active) continue; // still in flight
+      if(lru<0 || list->plans[n].lastUse<list->plans[lru].lastUse) lru = n;
+    }
+    meshHaloExchangePlanEvict(mesh, list, lru);
+  }
+
+  haloPlan_t *plan = list->plans+list->Nplans;
+  plan->lastUse = list->Nuses++;
+  plan->Nbytes = Nbytes;
+  plan->sendBuffer = sendBuffer;
+  plan->recvBuffer = recvBuffer;
+  plan->requests = (MPI_Request*) calloc(2*mesh->NhaloMessages, sizeof(MPI_Request));
+
+  int tag = 999;
+
+  for(int m=0;m<mesh->NhaloMessages;++m){
+    int r = mesh->haloNeighbors[m];
+    size_t offset = mesh->haloNeighborOffsets[m]*Nbytes;
+    size_t count  = mesh->NhaloPairs[r]*Nbytes;
+
+    MPI_Recv_init(((char*)recvBuffer)+offset, count, MPI_CHAR, r, tag,
+                  mesh->comm, plan->requests+m);
+
+    MPI_Send_init(((char*)sendBuffer)+offset, count, MPI_CHAR, r, tag,
+                  mesh->comm, plan->requests+mesh->NhaloMessages+m);
+  }
+
+  list->active = list->Nplans++;
+
+  return plan;
+}
+
 // send data from partition boundary elements
 // and receive data to ghost elements
 void meshHaloExchange(mesh_t *mesh,
@@ -36,50 +156,20 @@ void meshHaloExchange(mesh_t *mesh,
 		      void *sendBuffer,    // temporary buffer
 		      void *recvBuffer){
 
-  // MPI info
-  int rank, size;
-  rank = mesh->rank;
-  size = mesh->size;
-
-  // count outgoing and incoming meshes
-  int tag = 999;
-
   // copy data from outgoing elements into temporary send buffer
-  for(int i=0;i<mesh->totalHaloPairs;++i){
+  for(dlong i=0;i<mesh->totalHaloPairs;++i){
     // outgoing element
-    int e = mesh->haloElementList[i];
+    dlong e = mesh->haloElementList[i];
     // copy element e data to sendBuffer
     memcpy(((char*)sendBuffer)+i*Nbytes, ((char*)sourceBuffer)+e*Nbytes, Nbytes);
   }
 
-  // initiate immediate send  and receives to each other process as needed
-  int offset = 0, message = 0;
-  for(int r=0;r<size;++r){
-    if(r!=rank){
-      size_t count = mesh->NhaloPairs[r]*Nbytes;
-      if(count){
-	//	printf("rank %d sending %d bytes to rank %d\n", rank, count, r);
-	MPI_Irecv(((char*)recvBuffer)+offset, count, MPI_CHAR, r, tag,
-		  mesh->comm, (MPI_Request*)mesh->haloRecvRequests+message);
-	
-	MPI_Isend(((char*)sendBuffer)+offset, count, MPI_CHAR, r, tag,
-		  mesh->comm, (MPI_Request*)mesh->haloSendRequests+message);
-	offset += count;
-	++message;
-      }
-    }
-  }
-  //  printf("mesh->NhaloMessages = %d\n", mesh->NhaloMessages);
+  // sendBuffer is often a setup temporary, so do not bind persistent requests to it
+  meshHaloExchangePost(mesh, Nbytes, sendBuffer, recvBuffer);
 
   // Wait for all sent messages to have left and received messages to have arrived
-  MPI_Status *sendStatus = (MPI_Status*) calloc(mesh->NhaloMessages, sizeof(MPI_Status));
-  MPI_Status *recvStatus = (MPI_Status*) calloc(mesh->NhaloMessages, sizeof(MPI_Status));
-  
-  MPI_Waitall(mesh->NhaloMessages, (MPI_Request*)mesh->haloRecvRequests, recvStatus);
-  MPI_Waitall(mesh->NhaloMessages, (MPI_Request*)mesh->haloSendRequests, sendStatus);
-  
-  free(recvStatus);
-  free(sendStatus);
+  MPI_Waitall(mesh->NhaloMessages, (MPI_Request*)mesh->haloRecvRequests, MPI_STATUSES_IGNORE);
+  MPI_Waitall(mesh->NhaloMessages, (MPI_Request*)mesh->haloSendRequests, MPI_STATUSES_IGNORE);
 }      
 
 
@@ -90,46 +180,35 @@ void meshHaloExchangeStart(mesh_t *mesh,
 			     void *recvBuffer){
 
   if(mesh->totalHaloPairs>0){
-    // MPI info
-    int rank, size;
-    MPI_Comm_rank(mesh->comm, &rank);
-    MPI_Comm_size(mesh->comm, &size);
-
-    // count outgoing and incoming meshes
-    int tag = 999;
-    
-    // initiate immediate send  and receives to each other process as needed
-    int offset = 0, message = 0;
-    for(int r=0;r<size;++r){
-      if(r!=rank){
-	size_t count = mesh->NhaloPairs[r]*Nbytes;
-	if(count){
-	  MPI_Irecv(((char*)recvBuffer)+offset, count, MPI_CHAR, r, tag,
-		    mesh->comm, (MPI_Request*)mesh->haloRecvRequests+message);
-	
-	  MPI_Isend(((char*)sendBuffer)+offset, count, MPI_CHAR, r, tag,
-		    mesh->comm, (MPI_Request*)mesh->haloSendRequests+message);
-	  offset += count;
-	  ++message;
-	}
-      }
-    }
+    haloPlan_t *plan = meshHaloExchangePlan(mesh, Nbytes, sendBuffer, recvBuffer);
+
+    MPI_Startall(2*mesh->NhaloMessages, plan->requests);
   }  
 }
 
 void meshHaloExchangeFinish(mesh_t *mesh){
 
   if(mesh->totalHaloPairs>0){
+    haloPlanList_t *list = (haloPlanList_t*) mesh->haloPlans;
+    haloPlan_t *plan = list->plans+list->active;
+
     // Wait for all sent messages to have left and received messages to have arrived
-    MPI_Status *sendStatus = (MPI_Status*) calloc(mesh->NhaloMessages, sizeof(MPI_Status));
-    MPI_Status *recvStatus = (MPI_Status*) calloc(mesh->NhaloMessages, sizeof(MPI_Status));
-  
-    MPI_Waitall(mesh->NhaloMessages, (MPI_Request*)mesh->haloRecvRequests, recvStatus);
-    MPI_Waitall(mesh->NhaloMessages, (MPI_Request*)mesh->haloSendRequests, sendStatus);
-
-    free(recvStatus);
-    free(sendStatus);
+    MPI_Waitall(2*mesh->NhaloMessages, plan->requests, MPI_STATUSES_IGNORE);
+
+    list->active = -1;
   }
-}      
+}
 
+// free all persistent requests (call before MPI_Finalize). Multigrid level meshes
+// share the plan list of the mesh they were built from, so only that mesh frees it.
+void meshHaloExchangeFree(mesh_t *mesh){
 
+  haloPlanList_t *list = (haloPlanList_t*) mesh->haloPlans;
+  if(!list) return;
+
+  for(int n=0;n<list->Nplans;++n)
+    meshHaloExchangePlanFree(mesh, list->plans+n);
+
+  free(list);
+  mesh->haloPlans = NULL;
+}
@@ -59,15 +59,14 @@ int compareHaloFaces(const void *a,
 // exchange of trace nodes
 void meshHaloSetup(mesh_t *mesh){
 
+  // drop persistent requests bound to a previous halo (repartitioning)
+  meshHaloExchangeFree(mesh);
+
   // MPI info
   int rank, size;
   rank = mesh->rank;
   size = mesh->size;
 
-  // non-blocking MPI isend/irecv requests (used in meshHaloExchange)
-  mesh->haloSendRequests = calloc(size, sizeof(MPI_Request));
-  mesh->haloRecvRequests = calloc(size, sizeof(MPI_Request));
-  
   // count number of halo element nodes to swap
   mesh->totalHaloPairs = 0;
   mesh->NhaloPairs = (int*) calloc(size, sizeof(int));
@@ -87,6 +86,26 @@ void meshHaloSetup(mesh_t *mesh){
     if(mesh->NhaloPairs[r])
       ++mesh->NhaloMessages;
 
+  // compact neighbour list so exchanges only touch ranks we talk to
+  mesh->haloNeighbors = (int*) calloc(mesh->NhaloMessages, sizeof(int));
+  mesh->haloNeighborOffsets = (dlong*) calloc(mesh->NhaloMessages+1, sizeof(dlong));
+
+  int message = 0;
+  for(int r=0;r<size;++r){
+    if(mesh->NhaloPairs[r]){
+      mesh->haloNeighbors[message] = r;
+      mesh->haloNeighborOffsets[message+1] = mesh->haloNeighborOffsets[message] + mesh->NhaloPairs[r];
+      ++message;
+    }
+  }
+
+  // non-blocking MPI isend/irecv requests (used in meshHaloExchange)
+  mesh->haloSendRequests = calloc(mesh->NhaloMessages, sizeof(MPI_Request));
+  mesh->haloRecvRequests = calloc(mesh->NhaloMessages, sizeof(MPI_Request));
+
+  // persistent requests are created on first use by meshHaloExchangeStart
+  meshHaloExchangeSetup(mesh);
+
   // create a list of element/faces with halo neighbor
   facePair_t *haloElements = 
     (facePair_t*) calloc(mesh->totalHaloPairs, sizeof(facePair_t));
@@ -0,0 +1,457 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#include "mesh.h"
+
+#define meshIsoSurfaceBlockSize 256
+#define meshIsoSurfaceMaxFields 16
+
+typedef struct {
+
+  int isoNfields;
+
+  occa::kernel countKernel;
+  occa::kernel emitKernel;
+  occa::kernel scanBlocksKernel;
+  occa::kernel scanSumsKernel;
+  occa::kernel scanAddKernel;
+  occa::kernel zeroKernel;
+  occa::kernel weldHashKernel;
+  occa::kernel weldFillKernel;
+  occa::kernel weldFindKernel;
+  occa::kernel weldCompactKernel;
+  occa::kernel weldTriFlagsKernel;
+  occa::kernel weldTriCompactKernel;
+
+  occa::memory o_plotInterp, o_plotEToV, o_elementIds;
+
+  // scratch, grown to the largest surface seen so far
+  occa::memory o_elementNtris, o_elementStarts, o_blockSums, o_total;
+  occa::memory o_isoq;
+  occa::memory o_bucketCounts, o_bucketStarts, o_bucketEntries;
+  occa::memory o_vertexBuckets, o_vertexRanks, o_vertexReps, o_repFlags, o_vertexIds;
+  occa::memory o_triVerts, o_triFlags, o_triIds;
+
+  // welded surface of the last extraction
+  dlong Npoints, Ntris;
+  occa::memory o_points, o_fields, o_cells;
+
+  // host copy handed to the background writer
+  float *points, *fields;
+  int   *cells;
+  dlong maxPoints, maxTris;
+
+  pthread_t thread;
+  int active;
+
+  mesh_t *mesh;
+  int frame;
+  char fileBase[BUFSIZ];
+  char fieldNames[meshIsoSurfaceMaxFields][BUFSIZ];
+
+}meshIsoSurface_t;
+
+// make sure o_a holds at least bytes, contents are not kept
+static void meshIsoSurfaceReserve(mesh_t *mesh, occa::memory &o_a, size_t bytes){
+
+  if(o_a.isInitialized() && o_a.size()>=bytes) return;
+
+  if(o_a.isInitialized()) o_a.free();
+
+  // some slack so slowly growing surfaces do not reallocate every frame
+  o_a = mesh->device.malloc(bytes + bytes/4 + 8);
+}
+
+// exclusive scan of N int counts into dlong starts, returns the total
+static dlong meshIsoSurfaceScan(mesh_t *mesh, meshIsoSurface_t *iso, dlong N,
+                                occa::memory &o_counts, occa::memory &o_starts){
+
+  dlong Nblocks = (N+meshIsoSurfaceBlockSize-1)/meshIsoSurfaceBlockSize;
+
+  meshIsoSurfaceReserve(mesh, iso->o_blockSums, (Nblocks+1)*sizeof(dlong));
+
+  if(N) iso->scanBlocksKernel(N, o_counts, o_starts, iso->o_blockSums);
+  iso->scanSumsKernel(Nblocks, iso->o_blockSums, iso->o_total);
+  if(N) iso->scanAddKernel(N, iso->o_blockSums, o_starts);
+
+  dlong total = 0;
+  iso->o_total.copyTo(&total, sizeof(dlong));
+
+  return total;
+}
+
+static const char *meshIsoSurfaceByteOrder(){
+  int one = 1;
+  return (*(char*)&one) ? "LittleEndian" : "BigEndian";
+}
+
+static void meshIsoSurfaceWriteBlock(FILE *fp, const void *data, uint64_t Nbytes){
+  fwrite(&Nbytes, sizeof(uint64_t), 1, fp);
+  if(Nbytes) fwrite(data, 1, Nbytes, fp);
+}
+
+static void meshIsoSurfaceWritePiece(meshIsoSurface_t *iso){
+
+  mesh_t *mesh = iso->mesh;
+
+  dlong Npoints = iso->Npoints;
+  dlong Ntris   = iso->Ntris;
+
+  char fileName[BUFSIZ];
+  sprintf(fileName, "%s_%04d_%04d.vtu", iso->fileBase, mesh->rank, iso->frame);
+
+  FILE *fp = fopen(fileName, "w");
+  if(fp==NULL){
+    printf("meshIsoSurfaceWrite: could not open %s\n", fileName);
+    return;
+  }
+
+  uint64_t offset = 0;
+
+  fprintf(fp, "<?xml version=\"1.0\"?>\n");
+  fprintf(fp, "<VTKFile type=\"UnstructuredGrid\" version=\"1.0\" byte_order=\"%s\" header_type=\"UInt64\">\n",
+          meshIsoSurfaceByteOrder());
+  fprintf(fp, "  <UnstructuredGrid>\n");
+  fprintf(fp, "    <Piece NumberOfPoints=\"" dlongFormat "\" NumberOfCells=\"" dlongFormat "\">\n", Npoints, Ntris);
+
+  fprintf(fp, "      <Points>\n");
+  fprintf(fp, "        <DataArray type=\"Float32\" NumberOfComponents=\"3\" format=\"appended\" offset=\"%llu\"/>\n",
+          (unsigned long long) offset);
+  offset += sizeof(uint64_t) + ((uint64_t) Npoints)*3*sizeof(float);
+  fprintf(fp, "      </Points>\n");
+
+  fprintf(fp, "      <PointData>\n");
+  for(int fld=0;fld<iso->isoNfields;++fld){
+    fprintf(fp, "        <DataArray type=\"Float32\" Name=\"%s\" format=\"appended\" offset=\"%llu\"/>\n",
+            iso->fieldNames[fld], (unsigned long long) offset);
+    offset += sizeof(uint64_t) + ((uint64_t) Npoints)*sizeof(float);
+  }
+  fprintf(fp, "      </PointData>\n");
+
+  fprintf(fp, "      <Cells>\n");
+  fprintf(fp, "        <DataArray type=\"Int32\" Name=\"connectivity\" format=\"appended\" offset=\"%llu\"/>\n",
+          (unsigned long long) offset);
+  offset += sizeof(uint64_t) + ((uint64_t) Ntris)*3*sizeof(int32_t);
+  fprintf(fp, "        <DataArray type=\"Int32\" Name=\"offsets\" format=\"appended\" offset=\"%llu\"/>\n",
+          (unsigned long long) offset);
+  offset += sizeof(uint64_t) + ((uint64_t) Ntris)*sizeof(int32_t);
+  fprintf(fp, "        <DataArray type=\"UInt8\" Name=\"types\" format=\"appended\" offset=\"%llu\"/>\n",
+          (unsigned long long) offset);
+  fprintf(fp, "      </Cells>\n");
+
+  fprintf(fp, "    </Piece>\n");
+  fprintf(fp, "  </UnstructuredGrid>\n");
+  fprintf(fp, "  <AppendedData encoding=\"raw\">\n");
+  fprintf(fp, "_");
+
+  meshIsoSurfaceWriteBlock(fp, iso->points, ((uint64_t) Npoints)*3*sizeof(float));
+
+  for(int fld=0;fld<iso->isoNfields;++fld)
+    meshIsoSurfaceWriteBlock(fp, iso->fields + ((size_t) fld)*Npoints, ((uint64_t) Npoints)*sizeof(float));
+
+  meshIsoSurfaceWriteBlock(fp, iso->cells, ((uint64_t) Ntris)*3*sizeof(int32_t));
+
+  uint64_t Nbytes = ((uint64_t) Ntris)*sizeof(int32_t);
+  fwrite(&Nbytes, sizeof(uint64_t), 1, fp);
+  for(dlong t=0;t<Ntris;++t){
+    int32_t cnt = 3*(t+1);
+    fwrite(&cnt, sizeof(int32_t), 1, fp);
+  }
+
+  Nbytes = ((uint64_t) Ntris)*sizeof(unsigned char);
+  fwrite(&Nbytes, sizeof(uint64_t), 1, fp);
+  for(dlong t=0;t<Ntris;++t)
+    fputc(5, fp); // tri
+
+  fprintf(fp, "\n  </AppendedData>\n");
+  fprintf(fp, "</VTKFile>\n");
+  fclose(fp);
+}
+
+// master file listing the pieces of all ranks
+static void meshIsoSurfaceWriteMaster(meshIsoSurface_t *iso){
+
+  mesh_t *mesh = iso->mesh;
+
+  char fileName[BUFSIZ];
+  sprintf(fileName, "%s_%04d.pvtu", iso->fileBase, iso->frame);
+
+  FILE *fp = fopen(fileName, "w");
+  if(fp==NULL){
+    printf("meshIsoSurfaceWrite: could not open %s\n", fileName);
+    return;
+  }
+
+  // pieces live next to the master file
+  const char *pieceBase = strrchr(iso->fileBase, '/');
+  pieceBase = pieceBase ? pieceBase+1 : iso->fileBase;
+
+  fprintf(fp, "<?xml version=\"1.0\"?>\n");
+  fprintf(fp, "<VTKFile type=\"PUnstructuredGrid\" version=\"1.0\" byte_order=\"%s\" header_type=\"UInt64\">\n",
+          meshIsoSurfaceByteOrder());
+  fprintf(fp, "  <PUnstructuredGrid GhostLevel=\"0\">\n");
+  fprintf(fp, "    <PPoints>\n");
+  fprintf(fp, "      <PDataArray type=\"Float32\" NumberOfComponents=\"3\"/>\n");
+  fprintf(fp, "    </PPoints>\n");
+  fprintf(fp, "    <PPointData>\n");
+  for(int fld=0;fld<iso->isoNfields;++fld)
+    fprintf(fp, "      <PDataArray type=\"Float32\" Name=\"%s\"/>\n", iso->fieldNames[fld]);
+  fprintf(fp, "    </PPointData>\n");
+  for(int r=0;r<mesh->size;++r)
+    fprintf(fp, "    <Piece Source=\"%s_%04d_%04d.vtu\"/>\n", pieceBase, r, iso->frame);
+  fprintf(fp, "  </PUnstructuredGrid>\n");
+  fprintf(fp, "</VTKFile>\n");
+  fclose(fp);
+}
+
+static void *meshIsoSurfaceThread(void *args){
+
+  meshIsoSurface_t *iso = (meshIsoSurface_t*) args;
+
+  meshIsoSurfaceWritePiece(iso);
+
+  if(iso->mesh->rank==0)
+    meshIsoSurfaceWriteMaster(iso);
+
+  return NULL;
+}
+
+// build the extraction kernels for surfaces carrying isoNfields fields
+void meshIsoSurfaceSetup(mesh_t *mesh, occa::properties &kernelInfo, int isoNfields){
+
+  if(isoNfields>meshIsoSurfaceMaxFields){
+    printf("meshIsoSurfaceSetup: %d fields exceed the maximum of %d\n", isoNfields, meshIsoSurfaceMaxFields);
+    MPI_Abort(mesh->comm, -1);
+  }
+
+  meshIsoSurface_t *iso = new meshIsoSurface_t();
+  mesh->isoSurface = iso;
+
+  iso->isoNfields = isoNfields;
+
+  // interpolation matrix and plot connectivity stored node-fastest
+  dfloat *plotInterp = (dfloat*) calloc(mesh->plotNp*mesh->Np, sizeof(dfloat));
+  for(int n=0;n<mesh->plotNp;++n)
+    for(int m=0;m<mesh->Np;++m)
+      plotInterp[n+m*mesh->plotNp] = mesh->plotInterp[n*mesh->Np+m];
+
+  int *plotEToV = (int*) calloc(mesh->plotNelements*mesh->plotNverts, sizeof(int));
+  for(int n=0;n<mesh->plotNelements;++n)
+    for(int m=0;m<mesh->plotNverts;++m)
+      plotEToV[n+m*mesh->plotNelements] = mesh->plotEToV[n*mesh->plotNverts+m];
+
+  iso->o_plotInterp = mesh->device.malloc(mesh->plotNp*mesh->Np*sizeof(dfloat), plotInterp);
+  iso->o_plotEToV   = mesh->device.malloc(mesh->plotNelements*mesh->plotNverts*sizeof(int), plotEToV);
+
+  free(plotInterp);
+  free(plotEToV);
+
+  // all local elements in order
+  dlong *elementIds = (dlong*) calloc(mesh->Nelements+1, sizeof(dlong));
+  for(dlong e=0;e<mesh->Nelements;++e)
+    elementIds[e] = e;
+  iso->o_elementIds = mesh->device.malloc((mesh->Nelements+1)*sizeof(dlong), elementIds);
+  free(elementIds);
+
+  iso->o_total = mesh->device.malloc(sizeof(dlong));
+
+  occa::properties isoInfo = kernelInfo;
+  isoInfo["defines/" "p_isoNfields"]   = isoNfields;
+  isoInfo["defines/" "p_plotNp"]       = mesh->plotNp;
+  isoInfo["defines/" "p_plotNelements"] = mesh->plotNelements;
+  isoInfo["defines/" "p_plotNthreads"] = mymax(mesh->Np, mymax(mesh->plotNp, mesh->plotNelements));
+  isoInfo["defines/" "p_isoBlockSize"] = meshIsoSurfaceBlockSize;
+  isoInfo["defines/" "p_isoWeldScale"] = 1.0e5;
+
+  const char *fileName = DHOLMES "/okl/meshIsoSurface3D.okl";
+
+  for(int r=0;r<meshBuildKernelStages;r++){
+    if(r==meshBuildKernelStage(mesh)){
+      iso->countKernel          = meshBuildKernel(mesh, fileName, "meshIsoSurfaceCount3D", isoInfo);
+      iso->emitKernel           = meshBuildKernel(mesh, fileName, "meshIsoSurfaceEmit3D", isoInfo);
+      iso->scanBlocksKernel     = meshBuildKernel(mesh, fileName, "meshIsoSurfaceScanBlocks", isoInfo);
+      iso->scanSumsKernel       = meshBuildKernel(mesh, fileName, "meshIsoSurfaceScanSums", isoInfo);
+      iso->scanAddKernel        = meshBuildKernel(mesh, fileName, "meshIsoSurfaceScanAdd", isoInfo);
+      iso->zeroKernel           = meshBuildKernel(mesh, fileName, "meshIsoSurfaceZero", isoInfo);
+      iso->weldHashKernel       = meshBuildKernel(mesh, fileName, "meshIsoSurfaceWeldHash", isoInfo);
+      iso->weldFillKernel       = meshBuildKernel(mesh, fileName, "meshIsoSurfaceWeldFill", isoInfo);
+      iso->weldFindKernel       = meshBuildKernel(mesh, fileName, "meshIsoSurfaceWeldFind", isoInfo);
+      iso->weldCompactKernel    = meshBuildKernel(mesh, fileName, "meshIsoSurfaceWeldCompact", isoInfo);
+      iso->weldTriFlagsKernel   = meshBuildKernel(mesh, fileName, "meshIsoSurfaceWeldTriFlags", isoInfo);
+      iso->weldTriCompactKernel = meshBuildKernel(mesh, fileName, "meshIsoSurfaceWeldTriCompact", isoInfo);
+    }
+    MPI_Barrier(mesh->comm);
+  }
+}
+
+// extract and weld the isosurfaces of field isoField at isoNlevels levels on the device.
+// o_q holds isoNfields fields for each listed element: q[et*Np*isoNfields + fld*Np + n].
+// o_elementIds lists the mesh element of each of the Nelements entries, NULL for all
+// local elements in order. Returns the number of (welded) triangles.
+dlong meshIsoSurfaceExtract(mesh_t *mesh, dlong Nelements, occa::memory *o_elementIds,
+                            int isoField, int isoNlevels, occa::memory &o_isoLevels, occa::memory &o_q){
+
+  meshIsoSurface_t *iso = (meshIsoSurface_t*) mesh->isoSurface;
+
+  occa::memory &o_ids = o_elementIds ? *o_elementIds : iso->o_elementIds;
+
+  const int Nvals = 3 + iso->isoNfields;
+
+  iso->Npoints = 0;
+  iso->Ntris   = 0;
+
+  // count triangles per element and place each element's triangles
+  meshIsoSurfaceReserve(mesh, iso->o_elementNtris,  (Nelements+1)*sizeof(int));
+  meshIsoSurfaceReserve(mesh, iso->o_elementStarts, (Nelements+1)*sizeof(dlong));
+
+  if(Nelements)
+    iso->countKernel(Nelements, isoField, isoNlevels, o_isoLevels, o_q,
+                     iso->o_plotInterp, iso->o_plotEToV, iso->o_elementNtris);
+
+  dlong Ntris = meshIsoSurfaceScan(mesh, iso, Nelements, iso->o_elementNtris, iso->o_elementStarts);
+
+  if(Ntris==0) return 0;
+
+  dlong Nverts = 3*Ntris;
+
+  meshIsoSurfaceReserve(mesh, iso->o_isoq, ((size_t) Nverts)*Nvals*sizeof(dfloat));
+
+  iso->emitKernel(Nelements, o_ids, isoField, isoNlevels, o_isoLevels,
+                  mesh->o_x, mesh->o_y, mesh->o_z, o_q,
+                  iso->o_plotInterp, iso->o_plotEToV,
+                  iso->o_elementNtris, iso->o_elementStarts, iso->o_isoq);
+
+  // hash vertices into buckets by quantized position
+  dlong Nbuckets = Nverts;
+
+  meshIsoSurfaceReserve(mesh, iso->o_bucketCounts,  Nbuckets*sizeof(int));
+  meshIsoSurfaceReserve(mesh, iso->o_bucketStarts,  Nbuckets*sizeof(dlong));
+  meshIsoSurfaceReserve(mesh, iso->o_bucketEntries, Nverts*sizeof(dlong));
+  meshIsoSurfaceReserve(mesh, iso->o_vertexBuckets, Nverts*sizeof(dlong));
+  meshIsoSurfaceReserve(mesh, iso->o_vertexRanks,   Nverts*sizeof(int));
+  meshIsoSurfaceReserve(mesh, iso->o_vertexReps,    Nverts*sizeof(dlong));
+  meshIsoSurfaceReserve(mesh, iso->o_repFlags,      Nverts*sizeof(int));
+  meshIsoSurfaceReserve(mesh, iso->o_vertexIds,     Nverts*sizeof(dlong));
+
+  iso->zeroKernel(Nbuckets, iso->o_bucketCounts);
+
+  iso->weldHashKernel(Nverts, Nbuckets, iso->o_isoq, iso->o_bucketCounts,
+                      iso->o_vertexBuckets, iso->o_vertexRanks);
+
+  meshIsoSurfaceScan(mesh, iso, Nbuckets, iso->o_bucketCounts, iso->o_bucketStarts);
+
+  iso->weldFillKernel(Nverts, iso->o_vertexBuckets, iso->o_vertexRanks,
+                      iso->o_bucketStarts, iso->o_bucketEntries);
+
+  iso->weldFindKernel(Nverts, iso->o_isoq, iso->o_vertexBuckets, iso->o_bucketCounts,
+                      iso->o_bucketStarts, iso->o_bucketEntries, iso->o_vertexReps, iso->o_repFlags);
+
+  // number the representatives and write the welded surface
+  dlong Npoints = meshIsoSurfaceScan(mesh, iso, Nverts, iso->o_repFlags, iso->o_vertexIds);
+
+  meshIsoSurfaceReserve(mesh, iso->o_points,   ((size_t) Npoints)*3*sizeof(float));
+  meshIsoSurfaceReserve(mesh, iso->o_fields,   ((size_t) Npoints)*iso->isoNfields*sizeof(float));
+  meshIsoSurfaceReserve(mesh, iso->o_triVerts, Nverts*sizeof(int));
+  meshIsoSurfaceReserve(mesh, iso->o_triFlags, Ntris*sizeof(int));
+  meshIsoSurfaceReserve(mesh, iso->o_triIds,   Ntris*sizeof(dlong));
+
+  iso->weldCompactKernel(Nverts, Npoints, iso->o_isoq, iso->o_vertexReps, iso->o_repFlags,
+                         iso->o_vertexIds, iso->o_points, iso->o_fields, iso->o_triVerts);
+
+  // drop triangles collapsed by welding
+  iso->weldTriFlagsKernel(Ntris, iso->o_triVerts, iso->o_triFlags);
+
+  dlong NgoodTris = meshIsoSurfaceScan(mesh, iso, Ntris, iso->o_triFlags, iso->o_triIds);
+
+  meshIsoSurfaceReserve(mesh, iso->o_cells, ((size_t) NgoodTris)*3*sizeof(int));
+
+  iso->weldTriCompactKernel(Ntris, iso->o_triVerts, iso->o_triFlags, iso->o_triIds, iso->o_cells);
+
+  iso->Npoints = Npoints;
+  iso->Ntris   = NgoodTris;
+
+  return NgoodTris;
+}
+
+// copy the last extracted surface back and hand it to the background writer,
+// fieldNames names the isoNfields carried fields
+void meshIsoSurfaceWrite(mesh_t *mesh, const char *fileBase, int frame, const char **fieldNames){
+
+  meshIsoSurface_t *iso = (meshIsoSurface_t*) mesh->isoSurface;
+
+  // the previous surface must have drained before its buffers are reused
+  meshIsoSurfaceFinish(mesh);
+
+  if(iso->Npoints>iso->maxPoints){
+    free(iso->points);
+    free(iso->fields);
+    iso->maxPoints = iso->Npoints;
+    iso->points = (float*) calloc(((size_t) iso->maxPoints)*3, sizeof(float));
+    iso->fields = (float*) calloc(((size_t) iso->maxPoints)*iso->isoNfields, sizeof(float));
+  }
+  if(iso->Ntris>iso->maxTris){
+    free(iso->cells);
+    iso->maxTris = iso->Ntris;
+    iso->cells = (int*) calloc(((size_t) iso->maxTris)*3, sizeof(int));
+  }
+
+  if(iso->Npoints){
+    iso->o_points.copyTo(iso->points, ((size_t) iso->Npoints)*3*sizeof(float));
+    iso->o_fields.copyTo(iso->fields, ((size_t) iso->Npoints)*iso->isoNfields*sizeof(float));
+  }
+  if(iso->Ntris)
+    iso->o_cells.copyTo(iso->cells, ((size_t) iso->Ntris)*3*sizeof(int));
+
+  iso->mesh  = mesh;
+  iso->frame = frame;
+  strncpy(iso->fileBase, fileBase, BUFSIZ-1);
+  for(int fld=0;fld<iso->isoNfields;++fld)
+    strncpy(iso->fieldNames[fld], fieldNames[fld], BUFSIZ-1);
+
+  if(pthread_create(&(iso->thread), NULL, meshIsoSurfaceThread, iso)){
+    // fall back to writing in place
+    meshIsoSurfaceThread(iso);
+    return;
+  }
+  iso->active = 1;
+}
+
+// wait for the background writer to finish the last surface
+void meshIsoSurfaceFinish(mesh_t *mesh){
+
+  meshIsoSurface_t *iso = (meshIsoSurface_t*) mesh->isoSurface;
+
+  if(iso && iso->active){
+    pthread_join(iso->thread, NULL);
+    iso->active = 0;
+  }
+}
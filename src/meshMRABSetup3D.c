@@ -64,7 +64,7 @@ dfloat meshMRABSetup3D(mesh3D *mesh, dfloat *EToDT, int maxLevels, dfloat finalT
  
 
   //compute the level of each element
-  mesh->MRABlevel = (dlong *) calloc(mesh->Nelements+mesh->totalHaloPairs,sizeof(int));
+  mesh->MRABlevel = (int *) calloc(mesh->Nelements+mesh->totalHaloPairs,sizeof(int));
   int *MRABsendBuffer = (int *) calloc(mesh->totalHaloPairs,sizeof(int));
   for(int lev=0; lev<mesh->MRABNlevels; lev++){             
     dfloat dtlev = dtGmin*pow(2,lev);   
@@ -114,11 +114,11 @@ dfloat meshMRABSetup3D(mesh3D *mesh, dfloat *EToDT, int maxLevels, dfloat finalT
   }
 
   //construct element and halo lists
-  mesh->MRABelementIds = (int **) calloc(mesh->MRABNlevels,sizeof(int*));
-  mesh->MRABhaloIds = (int **) calloc(mesh->MRABNlevels,sizeof(int*));
+  mesh->MRABelementIds = (dlong **) calloc(mesh->MRABNlevels,sizeof(dlong*));
+  mesh->MRABhaloIds = (dlong **) calloc(mesh->MRABNlevels,sizeof(dlong*));
   
-  mesh->MRABNelements = (int *) calloc(mesh->MRABNlevels,sizeof(int));
-  mesh->MRABNhaloElements = (int *) calloc(mesh->MRABNlevels,sizeof(int));
+  mesh->MRABNelements = (dlong *) calloc(mesh->MRABNlevels,sizeof(dlong));
+  mesh->MRABNhaloElements = (dlong *) calloc(mesh->MRABNlevels,sizeof(dlong));
 
   for (dlong e=0;e<mesh->Nelements;e++) {
     mesh->MRABNelements[mesh->MRABlevel[e]]++;
@@ -134,8 +134,8 @@ dfloat meshMRABSetup3D(mesh3D *mesh, dfloat *EToDT, int maxLevels, dfloat finalT
   }
 
   for (int lev =0;lev<mesh->MRABNlevels;lev++){
-    mesh->MRABelementIds[lev] = (int *) calloc(mesh->MRABNelements[lev],sizeof(int));
-    mesh->MRABhaloIds[lev] = (int *) calloc(mesh->MRABNhaloElements[lev],sizeof(int));
+    mesh->MRABelementIds[lev] = (dlong *) calloc(mesh->MRABNelements[lev],sizeof(dlong));
+    mesh->MRABhaloIds[lev] = (dlong *) calloc(mesh->MRABNhaloElements[lev],sizeof(dlong));
     int cnt  =0;
     int cnt2 =0;
     for (dlong e=0;e<mesh->Nelements;e++){
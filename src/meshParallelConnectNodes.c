@@ -27,6 +27,7 @@ SOFTWARE.
 #include <stdio.h>
 #include <stdlib.h>
 #include <stddef.h>
+#include <math.h>
 
 #include "mesh.h"
 
@@ -43,8 +44,6 @@ typedef struct{
   int haloFlag;
 
   // info on base node (lowest rank node)
-  dlong baseElement; 
-  int baseNode;
   int baseRank;
   hlong baseId;
 
@@ -52,27 +51,171 @@ typedef struct{
 
 }parallelNode_t;
 
-// compare on base rank then by globalId
-int parallelCompareOwners(const void *a, const void *b){
+// a shared node is identified by the global vertex ids of the mesh entity (vertex,
+// edge, face) holding it and its integer position among that entity's nodes
+#define parallelNodeMaxVerts 8
 
-  parallelNode_t *fa = (parallelNode_t*) a;
-  parallelNode_t *fb = (parallelNode_t*) b;
+// reference coordinates this close to an element face are taken to lie on it
+#define parallelNodeTol 1e-4
 
-  if(fa->baseRank < fb->baseRank) return -1;
-  if(fa->baseRank > fb->baseRank) return +1;
+typedef struct{
+
+  int Nverts;                       // number of vertices of the entity holding the node
+  hlong v[parallelNodeMaxVerts];    // their global vertex ids (sorted)
+  int index;                        // position of the node among the entity's nodes
+
+  int rank;      // rank of original node
+  dlong localId; // local node id on that rank
+  hlong id;      // provisional id
+  int haloFlag;
+
+  // info on base node (lowest id, then lowest rank)
+  int baseRank;
+  hlong baseId;
+
+  hlong newGlobalId;
+
+}parallelNodeKey_t;
+
+// node of one element on a shared entity, with its weights at the entity vertices
+typedef struct{
+
+  int Nverts;
+  hlong v[parallelNodeMaxVerts];    // global vertex ids of the entity (sorted)
+  dfloat w[parallelNodeMaxVerts];   // weights of the node at those vertices
+  int node;                         // local node id in the element
+
+}parallelEntityNode_t;
+
+// one record per distinct node, sent to its base rank for numbering
+typedef struct{
+
+  hlong baseId;
+  int haloFlag;
+
+  int rank;     // rank holding the matched copies
+  dlong index;  // start of the matched copies on that rank
+
+  hlong newGlobalId;
+
+}parallelNodeBase_t;
+
+// compare on node key
+static int parallelCompareNodeKeys(const void *a, const void *b){
+
+  parallelNodeKey_t *fa = (parallelNodeKey_t*) a;
+  parallelNodeKey_t *fb = (parallelNodeKey_t*) b;
+
+  if(fa->Nverts < fb->Nverts) return -1;
+  if(fa->Nverts > fb->Nverts) return +1;
+
+  for(int v=0;v<fa->Nverts;++v){
+    if(fa->v[v] < fb->v[v]) return -1;
+    if(fa->v[v] > fb->v[v]) return +1;
+  }
+
+  if(fa->index < fb->index) return -1;
+  if(fa->index > fb->index) return +1;
 
   return 0;
 }
 
-// compare on base rank then by globalId
-int parallelCompareSourceRank(const void *a, const void *b){
+// compare on entity vertices
+static int parallelCompareEntities(const void *a, const void *b){
 
-  parallelNode_t *fa = (parallelNode_t*) a;
-  parallelNode_t *fb = (parallelNode_t*) b;
+  parallelEntityNode_t *fa = (parallelEntityNode_t*) a;
+  parallelEntityNode_t *fb = (parallelEntityNode_t*) b;
+
+  if(fa->Nverts < fb->Nverts) return -1;
+  if(fa->Nverts > fb->Nverts) return +1;
+
+  for(int v=0;v<fa->Nverts;++v){
+    if(fa->v[v] < fb->v[v]) return -1;
+    if(fa->v[v] > fb->v[v]) return +1;
+  }
+
+  return 0;
+}
+
+// compare on entity then by weights at the entity vertices in global id order. The
+// weights only depend on where the node sits relative to those vertices, so every
+// element sharing the entity orders its nodes the same way.
+static int parallelCompareEntityNodes(const void *a, const void *b){
+
+  int c = parallelCompareEntities(a, b);
+  if(c) return c;
+
+  parallelEntityNode_t *fa = (parallelEntityNode_t*) a;
+  parallelEntityNode_t *fb = (parallelEntityNode_t*) b;
+
+  for(int v=0;v<fa->Nverts;++v){
+    if(fa->w[v] < fb->w[v]-parallelNodeTol) return -1;
+    if(fa->w[v] > fb->w[v]+parallelNodeTol) return +1;
+  }
+
+  return 0;
+}
+
+// compare on node key then by provisional id and rank, so that the base node leads
+static int parallelCompareNodeCopies(const void *a, const void *b){
+
+  int c = parallelCompareNodeKeys(a, b);
+  if(c) return c;
+
+  parallelNodeKey_t *fa = (parallelNodeKey_t*) a;
+  parallelNodeKey_t *fb = (parallelNodeKey_t*) b;
+
+  if(fa->id < fb->id) return -1;
+  if(fa->id > fb->id) return +1;
+
+  if(fa->rank < fb->rank) return -1;
+  if(fa->rank > fb->rank) return +1;
+
+  return 0;
+}
+
+// compare on source rank then by local id
+static int parallelCompareNodeSources(const void *a, const void *b){
+
+  parallelNodeKey_t *fa = (parallelNodeKey_t*) a;
+  parallelNodeKey_t *fb = (parallelNodeKey_t*) b;
+
+  if(fa->rank < fb->rank) return -1;
+  if(fa->rank > fb->rank) return +1;
+
+  if(fa->localId < fb->localId) return -1;
+  if(fa->localId > fb->localId) return +1;
+
+  return 0;
+}
+
+// compare on halo flag then by base id
+static int parallelCompareBaseIds(const void *a, const void *b){
+
+  parallelNodeBase_t *fa = (parallelNodeBase_t*) a;
+  parallelNodeBase_t *fb = (parallelNodeBase_t*) b;
+
+  if(fa->haloFlag < fb->haloFlag) return -1;
+  if(fa->haloFlag > fb->haloFlag) return +1;
+
+  if(fa->baseId < fb->baseId) return -1;
+  if(fa->baseId > fb->baseId) return +1;
+
+  return 0;
+}
+
+// compare on source rank then by index
+static int parallelCompareBaseSources(const void *a, const void *b){
+
+  parallelNodeBase_t *fa = (parallelNodeBase_t*) a;
+  parallelNodeBase_t *fb = (parallelNodeBase_t*) b;
 
   if(fa->rank < fb->rank) return -1;
   if(fa->rank > fb->rank) return +1;
 
+  if(fa->index < fb->index) return -1;
+  if(fa->index > fb->index) return +1;
+
   return 0;
 }
 
@@ -99,7 +242,65 @@ int parallelCompareBaseNodes(const void *a, const void *b){
   return 0;
 }
 
-// iteratively find a gather numbering for all local element nodes
+// snap a tensor product coordinate onto the element boundary
+static dfloat meshNodeSnap(dfloat r){
+
+  if(fabs(r-1)<parallelNodeTol) return  1;
+  if(fabs(r+1)<parallelNodeTol) return -1;
+  return r;
+}
+
+// weights of reference node n at the element vertices (same maps as meshPhysicalNodes*).
+// Weights are exactly zero at the vertices off the smallest entity holding the node.
+static void meshNodeVertexWeights(mesh_t *mesh, int n, dfloat *w){
+
+  dfloat rn = mesh->r[n];
+  dfloat sn = mesh->s[n];
+
+  if(mesh->Nverts==3){ // triangle
+    w[0] = -0.5*(rn+sn);
+    w[1] = +0.5*(1+rn);
+    w[2] = +0.5*(1+sn);
+    for(int v=0;v<3;++v)
+      if(w[v]<parallelNodeTol) w[v] = 0;
+  }
+  else if(mesh->Nverts==4 && mesh->NfaceVertices==2){ // quadrilateral
+    rn = meshNodeSnap(rn);
+    sn = meshNodeSnap(sn);
+    w[0] = 0.25*(1-rn)*(1-sn);
+    w[1] = 0.25*(1+rn)*(1-sn);
+    w[2] = 0.25*(1+rn)*(1+sn);
+    w[3] = 0.25*(1-rn)*(1+sn);
+  }
+  else if(mesh->Nverts==4){ // tetrahedron
+    dfloat tn = mesh->t[n];
+    w[0] = -0.5*(1+rn+sn+tn);
+    w[1] = +0.5*(1+rn);
+    w[2] = +0.5*(1+sn);
+    w[3] = +0.5*(1+tn);
+    for(int v=0;v<4;++v)
+      if(w[v]<parallelNodeTol) w[v] = 0;
+  }
+  else{ // hexahedron
+    rn = meshNodeSnap(rn);
+    sn = meshNodeSnap(sn);
+    dfloat tn = meshNodeSnap(mesh->t[n]);
+    w[0] = 0.125*(1-rn)*(1-sn)*(1-tn);
+    w[1] = 0.125*(1+rn)*(1-sn)*(1-tn);
+    w[2] = 0.125*(1+rn)*(1+sn)*(1-tn);
+    w[3] = 0.125*(1-rn)*(1+sn)*(1-tn);
+    w[4] = 0.125*(1-rn)*(1-sn)*(1+tn);
+    w[5] = 0.125*(1+rn)*(1-sn)*(1+tn);
+    w[6] = 0.125*(1+rn)*(1+sn)*(1+tn);
+    w[7] = 0.125*(1-rn)*(1+sn)*(1+tn);
+  }
+}
+
+// find a gather numbering for all local element nodes. Each node on a vertex, edge or
+// face is keyed by the global vertex ids of that entity and its integer position on
+// it, and the copies are matched on a rank chosen by hashing that key. Element
+// interior nodes are numbered locally. This needs a fixed number of all-to-alls
+// instead of one halo exchange per sweep across the mesh.
 void meshParallelConnectNodes(mesh_t *mesh){
 
   int rank, size;
@@ -107,6 +308,18 @@ void meshParallelConnectNodes(mesh_t *mesh){
   size = mesh->size; 
   localRank = rank;
 
+  // the provisional numbering below uses ids up to Nnodes + sum of all local node counts
+  long long int localNodeCountLL = ((long long int) mesh->Np)*mesh->Nelements;
+  long long int globalNodeCountLL = 0;
+  MPI_Allreduce(&localNodeCountLL, &globalNodeCountLL, 1, MPI_LONG_LONG_INT, MPI_SUM, mesh->comm);
+  meshCheckIndexRange(mesh->comm, localNodeCountLL, dlongMax, "local node count");
+  meshCheckIndexRange(mesh->comm, 1 + globalNodeCountLL + mesh->Nnodes, hlongMax, "global node count");
+
+  if(mesh->Nverts>parallelNodeMaxVerts){
+    printf("meshParallelConnectNodes: elements with %d vertices are not supported\n", mesh->Nverts);
+    MPI_Abort(mesh->comm, -1);
+  }
+
   dlong localNodeCount = mesh->Np*mesh->Nelements;
   dlong *allLocalNodeCounts = (dlong*) calloc(size, sizeof(dlong));
 
@@ -120,177 +333,186 @@ void meshParallelConnectNodes(mesh_t *mesh){
   
   free(allLocalNodeCounts);
 
-  // form continuous node numbering (local=>virtual gather)
-  parallelNode_t *sendNodes =
-    (parallelNode_t*) calloc((mesh->totalHaloPairs+mesh->Nelements)*mesh->Np,
-                             sizeof(parallelNode_t));
-
-  // use local numbering
-  for(dlong e=0;e<mesh->Nelements;++e){
-    for(int n=0;n<mesh->Np;++n){
-      dlong id = e*mesh->Np+n;
-      sendNodes[id].element = e;
-      sendNodes[id].node = n;
-      sendNodes[id].rank = rank;
-      sendNodes[id].id = 1 + id + mesh->Nnodes + gatherNodeStart;
-
-      sendNodes[id].baseElement = e;
-      sendNodes[id].baseNode = n;
-      sendNodes[id].baseRank = rank;
-      sendNodes[id].baseId = 1 + id + mesh->Nnodes + gatherNodeStart;
-
-    }
+  // vertex weights of each reference node, nodes supported by all vertices are interior
+  dfloat *refWeights = (dfloat*) calloc(mesh->Np*mesh->Nverts, sizeof(dfloat));
+  int *refInterior = (int*) calloc(mesh->Np, sizeof(int));
+  int NrefInterior = 0;
+  for(int n=0;n<mesh->Np;++n){
+    meshNodeVertexWeights(mesh, n, refWeights+n*mesh->Nverts);
+    int Nsupport = 0;
+    for(int v=0;v<mesh->Nverts;++v)
+      if(refWeights[n*mesh->Nverts+v]!=0) ++Nsupport;
+    refInterior[n] = (Nsupport==mesh->Nverts);
+    NrefInterior += refInterior[n];
+  }
 
-    // use vertex ids for vertex nodes to reduce iterations
-    for(int v=0;v<mesh->Nverts;++v){
-      dlong id = e*mesh->Np + mesh->vertexNodes[v];
-      hlong gid = mesh->EToV[e*mesh->Nverts+v] + 1;
-      sendNodes[id].id = gid; 
-      sendNodes[id].baseId = gid; 
-    }
+  dlong Ninterior = NrefInterior*mesh->Nelements;
+  dlong Nshared = localNodeCount - Ninterior;
 
-    // label halo flags
+  // halo flags of local nodes
+  int *haloFlags = (int*) calloc(localNodeCount+1, sizeof(int));
+  for(dlong e=0;e<mesh->Nelements;++e){
     for(int f=0;f<mesh->Nfaces;++f){
       if(mesh->EToP[e*mesh->Nfaces+f]!=-1){
         for(int n=0;n<mesh->Nfp;++n){
           dlong id = e*mesh->Np+mesh->faceNodes[f*mesh->Nfp+n];
-          sendNodes[id].haloFlag = 1;
+          haloFlags[id] = 1;
         }
       }
     }
   }
 
-  dlong localChange = 0, gatherChange = 1;
+  // key every shared local node and find the rank that matches its copies
+  parallelNodeKey_t *nodes =
+    (parallelNodeKey_t*) calloc(Nshared+1, sizeof(parallelNodeKey_t));
+  parallelEntityNode_t *entityNodes =
+    (parallelEntityNode_t*) calloc(mesh->Np, sizeof(parallelEntityNode_t));
+  int *dest = (int*) calloc(Nshared+1, sizeof(int));
+  int *Nsend = (int*) calloc(size, sizeof(int));
+  int *Nrecv = (int*) calloc(size, sizeof(int));
 
-  parallelNode_t *sendBuffer =
-    (parallelNode_t*) calloc(mesh->totalHaloPairs*mesh->Np, sizeof(parallelNode_t));
+  dlong cnt = 0;
+  for(dlong e=0;e<mesh->Nelements;++e){
 
-  // keep comparing numbers on positive and negative traces until convergence
-  while(gatherChange>0){
+    // insertion sort of each node's entity vertices by global id
+    int Nentity = 0;
+    for(int n=0;n<mesh->Np;++n){
+      if(refInterior[n]) continue;
+      parallelEntityNode_t *en = entityNodes + Nentity++;
+      en->Nverts = 0;
+      en->node = n;
+      for(int v=0;v<mesh->Nverts;++v){
+        dfloat wv = refWeights[n*mesh->Nverts+v];
+        if(wv==0) continue;
+        hlong gv = mesh->EToV[e*mesh->Nverts+v];
+        int m = en->Nverts++;
+        while(m>0 && en->v[m-1]>gv){
+          en->v[m] = en->v[m-1];
+          en->w[m] = en->w[m-1];
+          --m;
+        }
+        en->v[m] = gv;
+        en->w[m] = wv;
+      }
+    }
 
-    // reset change counter
-    localChange = 0;
+    // number the nodes on each entity
+    qsort(entityNodes, Nentity, sizeof(parallelEntityNode_t), parallelCompareEntityNodes);
+
+    int index = 0;
+    for(int i=0;i<Nentity;++i){
+      parallelEntityNode_t *en = entityNodes+i;
+      index = (i>0 && !parallelCompareEntities(en-1, en)) ? index+1 : 0;
+
+      dlong id = e*mesh->Np+en->node;
+      parallelNodeKey_t *node = nodes+cnt;
+
+      node->Nverts = en->Nverts;
+      for(int v=0;v<en->Nverts;++v)
+        node->v[v] = en->v[v];
+      node->index = index;
+
+      node->rank = rank;
+      node->localId = id;
+      node->haloFlag = haloFlags[id];
+
+      // vertex nodes use vertex ids, others a rank-ordered provisional id
+      if(node->Nverts==1)
+        node->id = node->v[0] + 1;
+      else
+        node->id = 1 + id + mesh->Nnodes + gatherNodeStart;
+
+      // FNV-1a hash of the key picks the matching rank
+      unsigned long long int hash = 14695981039346656037ULL;
+      for(int v=0;v<node->Nverts;++v)
+        hash = (hash ^ (unsigned long long int) node->v[v])*1099511628211ULL;
+      hash = (hash ^ (unsigned long long int) node->index)*1099511628211ULL;
+
+      dest[cnt] = (int) (hash%size);
+      Nsend[dest[cnt]]++;
+      ++cnt;
+    }
+  }
 
-    // send halo data and recv into extension of buffer
-    meshHaloExchange(mesh, mesh->Np*sizeof(parallelNode_t),
-                     sendNodes, sendBuffer, sendNodes+localNodeCount);
+  free(entityNodes);
+  free(refWeights);
+  free(haloFlags);
 
-    // compare trace nodes
-    for(dlong e=0;e<mesh->Nelements;++e){
-      for(int n=0;n<mesh->Nfp*mesh->Nfaces;++n){
-        dlong id  = e*mesh->Nfp*mesh->Nfaces + n;
-        dlong idM = mesh->vmapM[id];
-        dlong idP = mesh->vmapP[id];
-        hlong gidM = sendNodes[idM].baseId;
-        hlong gidP = sendNodes[idP].baseId;
+  // bucket by matching rank, keeping local order within each bucket
+  int *sendStarts = (int*) calloc(size+1, sizeof(int));
+  for(int r=0;r<size;++r)
+    sendStarts[r+1] = sendStarts[r] + Nsend[r];
 
-        int baseRankM = sendNodes[idM].baseRank;
-        int baseRankP = sendNodes[idP].baseRank;
+  parallelNodeKey_t *sendNodes =
+    (parallelNodeKey_t*) calloc(Nshared+1, sizeof(parallelNodeKey_t));
+  for(dlong n=0;n<Nshared;++n)
+    sendNodes[sendStarts[dest[n]]++] = nodes[n];
 
-        // use minimum of trace variables
-        int haloM = sendNodes[idM].haloFlag;
-        int haloP = sendNodes[idP].haloFlag;
-        if(haloM!=haloP) {
-          ++localChange;
-          sendNodes[idM].haloFlag = mymax(haloM, haloP);
-          sendNodes[idP].haloFlag = mymax(haloM, haloP);  
-        }
-        
-        if(gidM<gidP || (gidP==gidM && baseRankM<baseRankP)){
-          ++localChange;
-          sendNodes[idP].baseElement = sendNodes[idM].baseElement;
-          sendNodes[idP].baseNode    = sendNodes[idM].baseNode;
-          sendNodes[idP].baseRank    = sendNodes[idM].baseRank;
-          sendNodes[idP].baseId      = sendNodes[idM].baseId;
-        }
-        
-        if(gidP<gidM || (gidP==gidM && baseRankP<baseRankM)){
-          ++localChange;
-          sendNodes[idM].baseElement = sendNodes[idP].baseElement;
-          sendNodes[idM].baseNode    = sendNodes[idP].baseNode;
-          sendNodes[idM].baseRank    = sendNodes[idP].baseRank;
-          sendNodes[idM].baseId      = sendNodes[idP].baseId;
-        }
-      }
-    }
+  free(sendStarts);
+  free(dest);
 
-    // sum up changes
-    MPI_Allreduce(&localChange, &gatherChange, 1, MPI_DLONG, MPI_SUM, mesh->comm);
-  }
+  parallelNodeKey_t *recvNodes = (parallelNodeKey_t*)
+    parallelExchange(mesh->comm, sizeof(parallelNodeKey_t), sendNodes, Nsend, Nrecv);
 
-  // sort based on base nodes (rank,element,node at base)
-  qsort(sendNodes, localNodeCount, sizeof(parallelNode_t), parallelCompareOwners);
-
-  // Make the MPI_PARALLELNODE_T data type
-  MPI_Datatype MPI_PARALLELNODE_T;
-  MPI_Datatype dtype[10] = {MPI_DLONG, MPI_INT, MPI_INT, MPI_HLONG, MPI_INT,
-                            MPI_DLONG, MPI_INT, MPI_INT, MPI_HLONG, MPI_HLONG};
-  int blength[10] = {1, 1, 1, 1, 1, 1, 1, 1, 1, 1};
-  MPI_Aint addr[10], displ[10];
-  MPI_Get_address ( &(sendNodes[0]            ), addr+0);
-  MPI_Get_address ( &(sendNodes[0].node       ), addr+1);
-  MPI_Get_address ( &(sendNodes[0].rank       ), addr+2);
-  MPI_Get_address ( &(sendNodes[0].id         ), addr+3);
-  MPI_Get_address ( &(sendNodes[0].haloFlag   ), addr+4);
-  MPI_Get_address ( &(sendNodes[0].baseElement), addr+5);
-  MPI_Get_address ( &(sendNodes[0].baseNode   ), addr+6);
-  MPI_Get_address ( &(sendNodes[0].baseRank   ), addr+7);
-  MPI_Get_address ( &(sendNodes[0].baseId     ), addr+8);
-  MPI_Get_address ( &(sendNodes[0].newGlobalId), addr+9);
-  displ[0] = 0;
-  displ[1] = addr[1] - addr[0];
-  displ[2] = addr[2] - addr[0];
-  displ[3] = addr[3] - addr[0];
-  displ[4] = addr[4] - addr[0];
-  displ[5] = addr[5] - addr[0];
-  displ[6] = addr[6] - addr[0];
-  displ[7] = addr[7] - addr[0];
-  displ[8] = addr[8] - addr[0];
-  displ[9] = addr[9] - addr[0];
-  MPI_Type_create_struct (10, blength, displ, dtype, &MPI_PARALLELNODE_T);
-  MPI_Type_commit (&MPI_PARALLELNODE_T);
-
-  // count how many nodes to send to each process
-  int *sendCounts = (int *) calloc(size,sizeof(int));
-  int *recvCounts = (int *) calloc(size,sizeof(int));
-  int *sendOffsets = (int *) calloc(size+1,sizeof(int));
-  int *recvOffsets = (int *) calloc(size+1,sizeof(int));
-
-  for(dlong n=0;n<localNodeCount;++n) 
-    sendCounts[sendNodes[n].baseRank]++;
-
-  // find how many nodes to expect (should use sparse version)
-  MPI_Alltoall(sendCounts, 1, MPI_INT, recvCounts, 1, MPI_INT, mesh->comm);
-  
-  // find send and recv offsets for gather
   dlong recvNtotal = 0;
-  for(int r=0;r<size;++r){
-    sendOffsets[r+1] = sendOffsets[r] + sendCounts[r];
-    recvOffsets[r+1] = recvOffsets[r] + recvCounts[r];
-    recvNtotal += recvCounts[r];
+  for(int r=0;r<size;++r)
+    recvNtotal += Nrecv[r];
+
+  // group copies of each node, base copy first
+  qsort(recvNodes, recvNtotal, sizeof(parallelNodeKey_t), parallelCompareNodeCopies);
+
+  // one record per distinct node, bucketed by its base rank
+  int *NbaseSend = (int*) calloc(size, sizeof(int));
+  int *NbaseRecv = (int*) calloc(size, sizeof(int));
+
+  dlong Ndistinct = 0;
+  for(dlong n=0;n<recvNtotal;){
+    dlong m = n+1;
+    int haloFlag = recvNodes[n].haloFlag;
+    while(m<recvNtotal && !parallelCompareNodeKeys(recvNodes+n, recvNodes+m)){
+      haloFlag = mymax(haloFlag, recvNodes[m].haloFlag);
+      if(recvNodes[m].rank!=recvNodes[n].rank) haloFlag = 1;
+      ++m;
+    }
+    for(dlong i=n;i<m;++i){
+      recvNodes[i].baseRank = recvNodes[n].rank;
+      recvNodes[i].baseId   = recvNodes[n].id;
+      recvNodes[i].haloFlag = haloFlag;
+    }
+    NbaseSend[recvNodes[n].rank]++;
+    ++Ndistinct;
+    n = m;
   }
 
-  parallelNode_t *recvNodes;
-  if (recvNtotal) recvNodes = (parallelNode_t*) calloc(recvNtotal, sizeof(parallelNode_t));
-  
-  // load up node data to send 
-  MPI_Alltoallv(sendNodes, sendCounts, sendOffsets, MPI_PARALLELNODE_T,
-                recvNodes, recvCounts, recvOffsets, MPI_PARALLELNODE_T,
-                mesh->comm);
-
-  // sort by global index shifting halo nodes to the end
-  qsort(recvNodes, recvNtotal, sizeof(parallelNode_t), parallelCompareBaseNodes);
-
-  // renumber unique nodes starting from 0 (need to be careful about zeros)
-  dlong Ngather = 0;
-  if (recvNtotal) recvNodes[0].newGlobalId = Ngather;
-  for(dlong n=1;n<recvNtotal;++n){
-    if(recvNodes[n].baseId!=recvNodes[n-1].baseId){ // new node
-      ++Ngather;
+  int *baseStarts = (int*) calloc(size+1, sizeof(int));
+  for(int r=0;r<size;++r)
+    baseStarts[r+1] = baseStarts[r] + NbaseSend[r];
+
+  parallelNodeBase_t *sendBases =
+    (parallelNodeBase_t*) calloc(Ndistinct+1, sizeof(parallelNodeBase_t));
+  for(dlong n=0;n<recvNtotal;++n){
+    if(n==0 || parallelCompareNodeKeys(recvNodes+n-1, recvNodes+n)){
+      parallelNodeBase_t *base = sendBases + baseStarts[recvNodes[n].baseRank]++;
+      base->baseId   = recvNodes[n].baseId;
+      base->haloFlag = recvNodes[n].haloFlag;
+      base->rank     = rank;
+      base->index    = n;
     }
-    recvNodes[n].newGlobalId = Ngather;
   }
-  if (recvNtotal) ++Ngather; // increment to actual number of unique nodes on this rank
+
+  free(baseStarts);
+
+  parallelNodeBase_t *recvBases = (parallelNodeBase_t*)
+    parallelExchange(mesh->comm, sizeof(parallelNodeBase_t), sendBases, NbaseSend, NbaseRecv);
+
+  dlong NbaseTotal = 0;
+  for(int r=0;r<size;++r)
+    NbaseTotal += NbaseRecv[r];
+
+  // number owned nodes starting from 0, interior nodes first and halo nodes at the end
+  qsort(recvBases, NbaseTotal, sizeof(parallelNodeBase_t), parallelCompareBaseIds);
+
+  dlong Ngather = Ninterior + NbaseTotal;
 
   // collect unique node counts from all processes
   dlong *allGather   = (dlong*) calloc(size, sizeof(dlong));
@@ -301,20 +523,76 @@ void meshParallelConnectNodes(mesh_t *mesh){
   for(int r=0;r<size;++r)
     mesh->gatherGlobalStarts[r+1] = mesh->gatherGlobalStarts[r] + allGather[r];
 
-  // shift numbering
-  for(dlong n=0;n<recvNtotal;++n)
-    recvNodes[n].newGlobalId += mesh->gatherGlobalStarts[rank];
-  
-  // sort by rank, local index
-  qsort(recvNodes, recvNtotal, sizeof(parallelNode_t), parallelCompareSourceRank);
+  free(allGather);
 
-  // reverse all to all to reclaim nodes
-  MPI_Alltoallv(recvNodes, recvCounts, recvOffsets, MPI_PARALLELNODE_T,
-                sendNodes, sendCounts, sendOffsets, MPI_PARALLELNODE_T,
-                mesh->comm);
+  for(dlong n=0;n<NbaseTotal;++n)
+    recvBases[n].newGlobalId = Ninterior + n + mesh->gatherGlobalStarts[rank];
+
+  // send numbers back to the matching ranks
+  qsort(recvBases, NbaseTotal, sizeof(parallelNodeBase_t), parallelCompareBaseSources);
+
+  free(sendBases);
+  sendBases = (parallelNodeBase_t*)
+    parallelExchange(mesh->comm, sizeof(parallelNodeBase_t), recvBases, NbaseRecv, NbaseSend);
+
+  // copy numbers to all copies of each node
+  for(dlong b=0;b<Ndistinct;++b){
+    dlong n = sendBases[b].index;
+    recvNodes[n].newGlobalId = sendBases[b].newGlobalId;
+    for(++n;n<recvNtotal && !parallelCompareNodeKeys(recvNodes+n-1, recvNodes+n);++n)
+      recvNodes[n].newGlobalId = sendBases[b].newGlobalId;
+  }
 
-  // sort by rank, local index
-  qsort(sendNodes, localNodeCount, sizeof(parallelNode_t), parallelCompareBaseNodes);
+  // return nodes to the ranks they came from
+  qsort(recvNodes, recvNtotal, sizeof(parallelNodeKey_t), parallelCompareNodeSources);
+
+  free(sendNodes);
+  sendNodes = (parallelNodeKey_t*)
+    parallelExchange(mesh->comm, sizeof(parallelNodeKey_t), recvNodes, Nrecv, Nsend);
+
+  // sort by base rank, halo flag and base id
+  parallelNode_t *localNodes =
+    (parallelNode_t*) calloc(localNodeCount+1, sizeof(parallelNode_t));
+  for(dlong n=0;n<Nshared;++n){
+    dlong id = sendNodes[n].localId;
+    localNodes[n].element     = id/mesh->Np;
+    localNodes[n].node        = id%mesh->Np;
+    localNodes[n].rank        = rank;
+    localNodes[n].id          = sendNodes[n].id;
+    localNodes[n].haloFlag    = sendNodes[n].haloFlag;
+    localNodes[n].baseRank    = sendNodes[n].baseRank;
+    localNodes[n].baseId      = sendNodes[n].baseId;
+    localNodes[n].newGlobalId = sendNodes[n].newGlobalId;
+  }
+
+  // element interior nodes are their own base nodes
+  cnt = Nshared;
+  hlong interiorId = mesh->gatherGlobalStarts[rank];
+  for(dlong e=0;e<mesh->Nelements;++e){
+    for(int n=0;n<mesh->Np;++n){
+      if(!refInterior[n]) continue;
+      dlong id = e*mesh->Np+n;
+      localNodes[cnt].element     = e;
+      localNodes[cnt].node        = n;
+      localNodes[cnt].rank        = rank;
+      localNodes[cnt].id          = 1 + id + mesh->Nnodes + gatherNodeStart;
+      localNodes[cnt].haloFlag    = 0;
+      localNodes[cnt].baseRank    = rank;
+      localNodes[cnt].baseId      = localNodes[cnt].id;
+      localNodes[cnt].newGlobalId = interiorId++;
+      ++cnt;
+    }
+  }
+
+  free(refInterior);
+
+  qsort(localNodes, localNodeCount, sizeof(parallelNode_t), parallelCompareBaseNodes);
+
+  free(nodes);
+  free(sendNodes); free(recvNodes);
+  free(sendBases); free(recvBases);
+  free(Nsend);     free(Nrecv);
+  free(NbaseSend); free(NbaseRecv);
 
   // extract base index of each node (i.e. gather numbering)
   mesh->gatherLocalIds  = (dlong*) calloc(localNodeCount, sizeof(dlong));
@@ -323,16 +601,13 @@ void meshParallelConnectNodes(mesh_t *mesh){
   mesh->gatherHaloFlags = (int*) calloc(localNodeCount, sizeof(int));
 
   for(dlong id=0;id<localNodeCount;++id){
-    mesh->gatherLocalIds[id]  = sendNodes[id].element*mesh->Np+sendNodes[id].node;
-    mesh->gatherBaseIds[id]   = sendNodes[id].newGlobalId+1;
-    mesh->gatherBaseRanks[id] = sendNodes[id].baseRank;
-    mesh->gatherHaloFlags[id] = sendNodes[id].haloFlag;
+    mesh->gatherLocalIds[id]  = localNodes[id].element*mesh->Np+localNodes[id].node;
+    mesh->gatherBaseIds[id]   = localNodes[id].newGlobalId+1;
+    mesh->gatherBaseRanks[id] = localNodes[id].baseRank;
+    mesh->gatherHaloFlags[id] = localNodes[id].haloFlag;
   }
   
-  MPI_Barrier(mesh->comm);
-  MPI_Type_free(&MPI_PARALLELNODE_T);
-  free(sendBuffer);
-  free(sendNodes);
+  free(localNodes);
 
   //make a locally-ordered version
   mesh->globalIds      = (hlong*) calloc(localNodeCount, sizeof(hlong));
@@ -29,50 +29,19 @@ SOFTWARE.
 
 #include "mesh.h"
 
+// unmatched local face sent to the rendezvous rank
 typedef struct {
-  hlong v[4]; // vertices on face
-  dlong element, elementN; 
-  int NfaceVertices;
-  int face, rank;    // face info
-  int faceN, rankN; // N for neighbor face info
-
+  hlong v[4]; // vertices on face (sorted)
+  dlong element;
+  int face;
 }parallelFace_t;
 
-// comparison function that orders vertices 
-// based on their combined vertex indices
-int parallelCompareVertices(const void *a, 
-                            const void *b){
-
-  parallelFace_t *fa = (parallelFace_t*) a;
-  parallelFace_t *fb = (parallelFace_t*) b;
-
-  for(int n=0;n<fa->NfaceVertices;++n){
-    if(fa->v[n] < fb->v[n]) return -1;
-    if(fa->v[n] > fb->v[n]) return +1;
-  }
-
-  return 0;
-}
-
-/* comparison function that orders element/face
-   based on their indexes */
-int parallelCompareFaces(const void *a, 
-                         const void *b){
-
-  parallelFace_t *fa = (parallelFace_t*) a;
-  parallelFace_t *fb = (parallelFace_t*) b;
-
-  if(fa->rank < fb->rank) return -1;
-  if(fa->rank > fb->rank) return +1;
-
-  if(fa->element < fb->element) return -1;
-  if(fa->element > fb->element) return +1;
-
-  if(fa->face < fb->face) return -1;
-  if(fa->face > fb->face) return +1;
+// neighbor info returned for each sent face
+typedef struct {
+  dlong elementN;
+  int faceN, rankN;
+}parallelFaceMatch_t;
 
-  return 0;
-}
   
 // mesh is the local partition
 void meshParallelConnect(mesh_t *mesh){
@@ -84,8 +53,8 @@ void meshParallelConnect(mesh_t *mesh){
   // serial connectivity on each process
   meshConnect(mesh);
 
-  // count # of elements to send to each rank based on
-  // minimum {vertex id % size}
+  // only faces left unmatched locally (partition or physical boundary) take
+  // part in the rendezvous on rank max{face vertex id} % size
   int *Nsend = (int*) calloc(size, sizeof(int));
   int *Nrecv = (int*) calloc(size, sizeof(int));
   int *sendOffsets = (int*) calloc(size, sizeof(int));
@@ -100,7 +69,7 @@ void meshParallelConnect(mesh_t *mesh){
         hlong maxv = 0;
         for(int n=0;n<mesh->NfaceVertices;++n){
           int nid = mesh->faceVertices[f*mesh->NfaceVertices+n];
-          dlong id = mesh->EToV[e*mesh->Nverts + nid];
+          hlong id = mesh->EToV[e*mesh->Nverts + nid];
           maxv = mymax(maxv, id);
         }
         int destRank = (int) (maxv%size);
@@ -121,77 +90,40 @@ void meshParallelConnect(mesh_t *mesh){
     Nsend[r] = 0;
 
   // buffer for outgoing data
-  parallelFace_t *sendFaces = (parallelFace_t*) calloc(allNsend, sizeof(parallelFace_t));
-
-  // Make the MPI_PARALLELFACE_T data type
-  MPI_Datatype MPI_PARALLELFACE_T;
-  MPI_Datatype dtype[8] = {MPI_HLONG, MPI_DLONG, MPI_DLONG, MPI_INT, 
-                            MPI_INT, MPI_INT, MPI_INT, MPI_INT};
-  int blength[8] = {4, 1, 1, 1, 1, 1, 1, 1};
-  MPI_Aint addr[8], displ[8];
-  MPI_Get_address ( &(sendFaces[0]              ), addr+0);
-  MPI_Get_address ( &(sendFaces[0].element      ), addr+1);
-  MPI_Get_address ( &(sendFaces[0].elementN     ), addr+2);
-  MPI_Get_address ( &(sendFaces[0].NfaceVertices), addr+3);
-  MPI_Get_address ( &(sendFaces[0].face         ), addr+4);
-  MPI_Get_address ( &(sendFaces[0].rank         ), addr+5);
-  MPI_Get_address ( &(sendFaces[0].faceN        ), addr+6);
-  MPI_Get_address ( &(sendFaces[0].rankN        ), addr+7);
-  displ[0] = 0;
-  displ[1] = addr[1] - addr[0];
-  displ[2] = addr[2] - addr[0];
-  displ[3] = addr[3] - addr[0];
-  displ[4] = addr[4] - addr[0];
-  displ[5] = addr[5] - addr[0];
-  displ[6] = addr[6] - addr[0];
-  displ[7] = addr[7] - addr[0];
-  MPI_Type_create_struct (8, blength, displ, dtype, &MPI_PARALLELFACE_T);
-  MPI_Type_commit (&MPI_PARALLELFACE_T);
+  parallelFace_t *sendFaces = (parallelFace_t*) calloc(allNsend+1, sizeof(parallelFace_t));
 
   // pack face data
   for(dlong e=0;e<mesh->Nelements;++e){
     for(int f=0;f<mesh->Nfaces;++f){
       if(mesh->EToE[e*mesh->Nfaces+f]==-1){
 
-        // find rank of destination for sorting based on max(face vertices)%size
-        hlong maxv = 0;
-        for(int n=0;n<mesh->NfaceVertices;++n){
-          int nid = mesh->faceVertices[f*mesh->NfaceVertices+n];
-          hlong id = mesh->EToV[e*mesh->Nverts + nid];
-          maxv = mymax(maxv, id);
-        }
-        int destRank = (int) (maxv%size);
-        
         // populate face to send out staged in segment of sendFaces array
-        int id = sendOffsets[destRank]+Nsend[destRank];
-
-        
-        sendFaces[id].element = e;
-        sendFaces[id].face = f;
+        hlong v[4];
         for(int n=0;n<mesh->NfaceVertices;++n){
           int nid = mesh->faceVertices[f*mesh->NfaceVertices+n];
-          sendFaces[id].v[n] = mesh->EToV[e*mesh->Nverts + nid];
+          v[n] = mesh->EToV[e*mesh->Nverts + nid];
         }
 
-        mysort(sendFaces[id].v,mesh->NfaceVertices, "descending");
+        mysort(v, mesh->NfaceVertices, "descending");
 
-        sendFaces[id].NfaceVertices = mesh->NfaceVertices;
-        sendFaces[id].rank = rank;
+        // sorted descending so v[0] is the largest vertex id
+        int destRank = (int) (v[0]%size);
+        int id = sendOffsets[destRank]+Nsend[destRank];
 
-        sendFaces[id].elementN = -1;
-        sendFaces[id].faceN = -1;
-        sendFaces[id].rankN = -1;
+        sendFaces[id].element = e;
+        sendFaces[id].face = f;
+        for(int n=0;n<mesh->NfaceVertices;++n)
+          sendFaces[id].v[n] = v[n];
         
         ++Nsend[destRank];
       }
     }
   }
 
-  // exchange byte counts 
-  MPI_Alltoall(Nsend, 1, MPI_INT,
-               Nrecv, 1, MPI_INT,
-               mesh->comm);
-  
+  // exchange parallel faces
+  parallelFace_t *recvFaces = (parallelFace_t*)
+    parallelExchange(mesh->comm, sizeof(parallelFace_t), sendFaces, Nsend, Nrecv);
+
   // count incoming faces
   int allNrecv = 0;
   for(int r=0;r<size;++r)
@@ -199,40 +131,41 @@ void meshParallelConnect(mesh_t *mesh){
 
   // find offsets for recv data
   for(int r=1;r<size;++r)
-    recvOffsets[r] = recvOffsets[r-1] + Nrecv[r-1]; // byte offsets
-  
-  // buffer for incoming face data
-  parallelFace_t *recvFaces = (parallelFace_t*) calloc(allNrecv, sizeof(parallelFace_t));
-  
-  // exchange parallel faces
-  MPI_Alltoallv(sendFaces, Nsend, sendOffsets, MPI_PARALLELFACE_T,
-                recvFaces, Nrecv, recvOffsets, MPI_PARALLELFACE_T,
-                mesh->comm);
-  
-  // local sort allNrecv received faces
-  qsort(recvFaces, allNrecv, sizeof(parallelFace_t), parallelCompareVertices);
-
-  // find matches
-  for(int n=0;n<allNrecv-1;++n){
-    // since vertices are ordered we just look for pairs
-    if(!parallelCompareVertices(recvFaces+n, recvFaces+n+1)){
-      recvFaces[n].elementN = recvFaces[n+1].element;
-      recvFaces[n].faceN = recvFaces[n+1].face;
-      recvFaces[n].rankN = recvFaces[n+1].rank;
-      
-      recvFaces[n+1].elementN = recvFaces[n].element;
-      recvFaces[n+1].faceN = recvFaces[n].face;
-      recvFaces[n+1].rankN = recvFaces[n].rank;
+    recvOffsets[r] = recvOffsets[r-1] + Nrecv[r-1];
+
+  // match received faces in place
+  hlong *faceVerts = (hlong*) calloc((size_t)allNrecv*mesh->NfaceVertices+1, sizeof(hlong));
+  dlong *match     = (dlong*) calloc(allNrecv+1, sizeof(dlong));
+  int *recvRanks   = (int*) calloc(allNrecv+1, sizeof(int));
+
+  for(int r=0;r<size;++r){
+    for(int n=recvOffsets[r];n<recvOffsets[r]+Nrecv[r];++n){
+      recvRanks[n] = r;
+      for(int i=0;i<mesh->NfaceVertices;++i)
+        faceVerts[(size_t)n*mesh->NfaceVertices+i] = recvFaces[n].v[i];
     }
   }
 
-  // sort back to original ordering
-  qsort(recvFaces, allNrecv, sizeof(parallelFace_t), parallelCompareFaces);
+  meshMatchFaces(mesh->NfaceVertices, allNrecv, faceVerts, match);
+
+  // replies stay in received order, so one reverse exchange returns them
+  parallelFaceMatch_t *recvMatches =
+    (parallelFaceMatch_t*) calloc(allNrecv+1, sizeof(parallelFaceMatch_t));
+
+  for(int n=0;n<allNrecv;++n){
+    dlong m = match[n];
+    recvMatches[n].elementN = (m==-1) ? -1 : recvFaces[m].element;
+    recvMatches[n].faceN    = (m==-1) ? -1 : recvFaces[m].face;
+    recvMatches[n].rankN    = (m==-1) ? -1 : recvRanks[m];
+  }
+
+  free(faceVerts);
+  free(match);
+  free(recvRanks);
 
-  // send faces back from whence they came
-  MPI_Alltoallv(recvFaces, Nrecv, recvOffsets, MPI_PARALLELFACE_T,
-                sendFaces, Nsend, sendOffsets, MPI_PARALLELFACE_T,
-                mesh->comm);
+  // send matches back from whence the faces came
+  parallelFaceMatch_t *sendMatches = (parallelFaceMatch_t*)
+    parallelExchange(mesh->comm, sizeof(parallelFaceMatch_t), recvMatches, Nrecv, Nsend);
   
   // extract connectivity info
   mesh->EToP = (int*) calloc(mesh->Nelements*mesh->Nfaces, sizeof(int));
@@ -241,10 +174,10 @@ void meshParallelConnect(mesh_t *mesh){
   
   for(int cnt=0;cnt<allNsend;++cnt){
     dlong e = sendFaces[cnt].element;
-    dlong eN = sendFaces[cnt].elementN;
     int f = sendFaces[cnt].face;
-    int fN = sendFaces[cnt].faceN;
-    int rN = sendFaces[cnt].rankN;
+    dlong eN = sendMatches[cnt].elementN;
+    int fN = sendMatches[cnt].faceN;
+    int rN = sendMatches[cnt].rankN;
     
     if(e>=0 && f>=0 && eN>=0 && fN>=0){
       mesh->EToE[e*mesh->Nfaces+f] = eN;
@@ -253,8 +186,8 @@ void meshParallelConnect(mesh_t *mesh){
     }
   }
 
-  MPI_Barrier(mesh->comm);
-  MPI_Type_free(&MPI_PARALLELFACE_T);
-  free(sendFaces);
-  free(recvFaces);
+  free(Nsend);       free(Nrecv);
+  free(sendOffsets); free(recvOffsets);
+  free(sendFaces);   free(recvFaces);
+  free(sendMatches); free(recvMatches);
 }
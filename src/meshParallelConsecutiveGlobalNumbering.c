@@ -119,7 +119,7 @@ void meshParallelConsecutiveGlobalNumbering(mesh_t *mesh,
     recvNtotal += recvCounts[r];
   }
 
-  printf("Nlocal = %d\n", Nlocal);
+  printf("Nlocal = " dlongFormat "\n", Nlocal);
   
   // populate parallel nodes to send
   parallelNode2_t *sendNodes = NULL;
@@ -188,6 +188,11 @@ void meshParallelConsecutiveGlobalNumbering(mesh_t *mesh,
   MPI_Allgather(&cnt, 1, MPI_DLONG, allCounts, 1, MPI_DLONG, mesh->comm);
   
   // cumulative sum of unique node counts => starting node index for each process
+  long long int totalCount = 0;
+  for(int r=0;r<size;++r)
+    totalCount += allCounts[r];
+  meshCheckIndexRange(mesh->comm, totalCount, hlongMax, "global numbering");
+
   for(int r=0;r<size;++r)
     globalStarts[r+1] = globalStarts[r] + allCounts[r];
   
@@ -30,6 +30,117 @@ SOFTWARE.
 
 #include "mesh.h"
 
+// make sure the halo gather and exchange buffers hold Nentries fields
+static void meshParallelGatherScatterReserve(mesh_t *mesh, ogs_t *ogs, int Nentries){
+
+  if(Nentries<=ogs->NentriesMax) return;
+
+  if(ogs->NentriesMax){
+    if(ogs->NhaloGather) ogs->o_haloGatherTmp.free();
+    if(ogs->Nsend) ogs->o_exchangeSendBuffer.free();
+    if(ogs->Nrecv) ogs->o_exchangeRecvBuffer.free();
+  }
+
+  ogs->NentriesMax = Nentries;
+
+  if(ogs->NhaloGather)
+    ogs->haloGatherTmp = (dfloat*) occaHostMallocPinned(mesh->device, Nentries*ogs->NhaloGather*sizeof(dfloat), NULL, ogs->o_haloGatherTmp);
+
+  if(ogs->Nsend)
+    ogs->exchangeSendBuffer = (dfloat*) occaHostMallocPinned(mesh->device, Nentries*ogs->Nsend*sizeof(dfloat), NULL, ogs->o_exchangeSendBuffer);
+
+  if(ogs->Nrecv)
+    ogs->exchangeRecvBuffer = (dfloat*) occaHostMallocPinned(mesh->device, Nentries*ogs->Nrecv*sizeof(dfloat), NULL, ogs->o_exchangeRecvBuffer);
+}
+
+// send partial sums of non-owned halo nodes (already in o_haloGatherTmp) to their owners
+static void meshParallelGatherScatterExchangeStart(mesh_t *mesh, ogs_t *ogs, int Nentries){
+
+  MPI_Request *requests = (MPI_Request*) ogs->exchangeRequests;
+  int tag = 1001;
+
+  if(ogs->Nsend)
+    mesh->ogsExchangePackKernel(ogs->Nsend, Nentries, ogs->o_sendIds, ogs->o_haloGatherTmp, ogs->o_exchangeSendBuffer);
+
+  // packed values land in pinned host memory
+  mesh->device.finish();
+
+  for(int m=0;m<ogs->NrecvRanks;++m){
+    dlong offset = ogs->recvOffsets[m];
+    int count = Nentries*(ogs->recvOffsets[m+1]-offset);
+    MPI_Irecv(ogs->exchangeRecvBuffer+Nentries*offset, count, MPI_DFLOAT, ogs->recvRanks[m], tag,
+              mesh->comm, requests+m);
+  }
+
+  for(int m=0;m<ogs->NsendRanks;++m){
+    dlong offset = ogs->sendOffsets[m];
+    int count = Nentries*(ogs->sendOffsets[m+1]-offset);
+    MPI_Isend(ogs->exchangeSendBuffer+Nentries*offset, count, MPI_DFLOAT, ogs->sendRanks[m], tag,
+              mesh->comm, requests+ogs->NrecvRanks+m);
+  }
+}
+
+// owners add up the partial sums and return the totals, leaving them in o_haloGatherTmp
+static void meshParallelGatherScatterExchangeFinish(mesh_t *mesh, ogs_t *ogs, int Nentries){
+
+  MPI_Request *requests = (MPI_Request*) ogs->exchangeRequests;
+  int Nrequests = ogs->NrecvRanks+ogs->NsendRanks;
+  int tag = 1002;
+
+  MPI_Waitall(Nrequests, requests, MPI_STATUSES_IGNORE);
+
+  if(ogs->Nrecv){
+    mesh->ogsExchangeAddKernel(ogs->NhaloGather, Nentries, ogs->o_recvGatherStarts, ogs->o_recvGatherIds,
+                               ogs->o_exchangeRecvBuffer, ogs->o_haloGatherTmp);
+
+    // reuse the receive buffer to return the totals
+    mesh->ogsExchangePackKernel(ogs->Nrecv, Nentries, ogs->o_recvIds, ogs->o_haloGatherTmp, ogs->o_exchangeRecvBuffer);
+  }
+
+  mesh->device.finish();
+
+  for(int m=0;m<ogs->NsendRanks;++m){
+    dlong offset = ogs->sendOffsets[m];
+    int count = Nentries*(ogs->sendOffsets[m+1]-offset);
+    MPI_Irecv(ogs->exchangeSendBuffer+Nentries*offset, count, MPI_DFLOAT, ogs->sendRanks[m], tag,
+              mesh->comm, requests+m);
+  }
+
+  for(int m=0;m<ogs->NrecvRanks;++m){
+    dlong offset = ogs->recvOffsets[m];
+    int count = Nentries*(ogs->recvOffsets[m+1]-offset);
+    MPI_Isend(ogs->exchangeRecvBuffer+Nentries*offset, count, MPI_DFLOAT, ogs->recvRanks[m], tag,
+              mesh->comm, requests+ogs->NsendRanks+m);
+  }
+
+  MPI_Waitall(Nrequests, requests, MPI_STATUSES_IGNORE);
+
+  if(ogs->Nsend)
+    mesh->ogsExchangeUnpackKernel(ogs->Nsend, Nentries, ogs->o_sendIds, ogs->o_exchangeSendBuffer, ogs->o_haloGatherTmp);
+}
+
+void meshParallelGatherScatterStart(mesh_t *mesh, ogs_t *ogs, occa::memory &o_v, int Nentries, dlong stride){
+
+  if (ogs->NhaloGather) {
+    meshParallelGatherScatterReserve(mesh, ogs, Nentries);
+
+    // gather halo nodes on device
+    mesh->gatherKernel(ogs->NhaloGather, ogs->o_haloGatherOffsets, ogs->o_haloGatherLocalIds, Nentries, stride, o_v, ogs->o_haloGatherTmp);
+
+    meshParallelGatherScatterExchangeStart(mesh, ogs, Nentries);
+  }
+}
+
+void meshParallelGatherScatterFinish(mesh_t *mesh, ogs_t *ogs, occa::memory &o_v, int Nentries, dlong stride){
+
+  if (ogs->NhaloGather) {
+    meshParallelGatherScatterExchangeFinish(mesh, ogs, Nentries);
+
+    // do scatter back to local nodes
+    mesh->scatterKernel(ogs->NhaloGather, ogs->o_haloGatherOffsets, ogs->o_haloGatherLocalIds, Nentries, stride, ogs->o_haloGatherTmp, o_v);
+  }
+}
+
 // ok to use o_v = o_gsv
 void meshParallelGatherScatter(mesh_t *mesh,
                                ogs_t *ogs, 
@@ -37,32 +148,13 @@ void meshParallelGatherScatter(mesh_t *mesh,
   int one = 1;
   dlong dOne = 1;
 
-  // gather halo nodes on device
-  if (ogs->NhaloGather) {
-    mesh->gatherKernel(ogs->NhaloGather, ogs->o_haloGatherOffsets, ogs->o_haloGatherLocalIds, one, dOne, o_v, ogs->o_haloGatherTmp);
-    ogs->o_haloGatherTmp.copyTo(ogs->haloGatherTmp);
-  }
+  meshParallelGatherScatterStart(mesh, ogs, o_v, one, dOne);
 
   if(ogs->NnonHaloGather) {
     mesh->gatherScatterKernel(ogs->NnonHaloGather, ogs->o_nonHaloGatherOffsets, ogs->o_nonHaloGatherLocalIds, one, dOne, o_v);
   }
 
-  if (ogs->NhaloGather) {
-    // MPI based gather scatter using libgs
-    gsParallelGatherScatter(ogs->haloGsh, ogs->haloGatherTmp, dfloatString, "add");
-
-    // copy totally gather halo data back from HOST to DEVICE
-    mesh->device.setStream(mesh->dataStream);
-    ogs->o_haloGatherTmp.copyFrom(ogs->haloGatherTmp,"async: true");
-
-    // wait for async copy
-    mesh->device.finish();
-
-    // do scatter back to local nodes
-    mesh->scatterKernel(ogs->NhaloGather, ogs->o_haloGatherOffsets, ogs->o_haloGatherLocalIds, one, dOne, ogs->o_haloGatherTmp, o_v);
-    mesh->device.finish();
-    mesh->device.setStream(mesh->defaultStream);
-  }
+  meshParallelGatherScatterFinish(mesh, ogs, o_v, one, dOne);
 }
 
 void meshParallelGather(mesh_t *mesh,
@@ -75,8 +167,11 @@ void meshParallelGather(mesh_t *mesh,
 
   // gather halo nodes on device
   if (ogs->NhaloGather) {
+    meshParallelGatherScatterReserve(mesh, ogs, one);
+
     mesh->gatherKernel(ogs->NhaloGather, ogs->o_haloGatherOffsets, ogs->o_haloGatherLocalIds, one, dOne, o_v, ogs->o_haloGatherTmp);
-    ogs->o_haloGatherTmp.copyTo(ogs->haloGatherTmp);
+
+    meshParallelGatherScatterExchangeStart(mesh, ogs, one);
   }
 
   if(ogs->NnonHaloGather) {
@@ -84,22 +179,10 @@ void meshParallelGather(mesh_t *mesh,
   }
 
   if (ogs->NhaloGather) {
-    // MPI based gather scatter using libgs
-    gsParallelGatherScatter(ogs->haloGsh, ogs->haloGatherTmp, dfloatString, "add");
-
-    mesh->device.setStream(mesh->dataStream);
-    
-    // copy gathered halo data back from HOST to DEVICE
-    ogs->o_haloGatherTmp.copyFrom(ogs->haloGatherTmp,"async: true");
-    
-    // wait for async copy
-    mesh->device.finish();
+    meshParallelGatherScatterExchangeFinish(mesh, ogs, one);
 
     // insert totally gathered halo node data - need this kernel 
     mesh->putKernel(ogs->NhaloGather, ogs->o_haloGatherTmp, ogs->o_ownedHaloGatherIds, o_gv); 
-
-    mesh->device.finish();
-    mesh->device.setStream(mesh->defaultStream);
   }
 }
 
@@ -111,10 +194,13 @@ void meshParallelScatter(mesh_t *mesh,
   int one = 1;
   dlong dOne = 1;
 
-  // gather halo nodes on device
+  // owned halo values go out, everyone else contributes zero
   if (ogs->NhaloGather) {
+    meshParallelGatherScatterReserve(mesh, ogs, one);
+
     mesh->getKernel(ogs->NhaloGather, o_v, ogs->o_ownedHaloGatherIds, ogs->o_haloGatherTmp);
-    ogs->o_haloGatherTmp.copyTo(ogs->haloGatherTmp);
+
+    meshParallelGatherScatterExchangeStart(mesh, ogs, one);
   }
 
   if(ogs->NnonHaloGather) {
@@ -122,22 +208,9 @@ void meshParallelScatter(mesh_t *mesh,
   }
 
   if (ogs->NhaloGather) {
-    // MPI based gather scatter using libgs
-    gsParallelGatherScatter(ogs->haloGsh, ogs->haloGatherTmp, dfloatString, "add");
-
-    // copy totally gather halo data back from HOST to DEVICE
-    mesh->device.setStream(mesh->dataStream);
-    
-    // copy owned and gathered halo data back from HOST to DEVICE
-    ogs->o_haloGatherTmp.copyFrom(ogs->haloGatherTmp,"async: true");
-    
-    // wait for async copy
-    mesh->device.finish();
+    meshParallelGatherScatterExchangeFinish(mesh, ogs, one);
 
     // insert totally gathered halo node data - need this kernel 
     mesh->scatterKernel(ogs->NhaloGather, ogs->o_haloGatherOffsets, ogs->o_haloGatherLocalIds, one, dOne, ogs->o_haloGatherTmp, o_sv);
-
-    mesh->device.finish();
-    mesh->device.setStream(mesh->defaultStream);
   }
-}
\ No newline at end of file
+}
@@ -30,6 +30,162 @@ SOFTWARE.
 
 #include "mesh.h"
 
+typedef struct {
+
+  hlong baseId;
+  dlong id;
+
+}ogsOwnedNode_t;
+
+static int compareOwnedNodes(const void *a, const void *b){
+
+  const ogsOwnedNode_t *fa = (const ogsOwnedNode_t*) a;
+  const ogsOwnedNode_t *fb = (const ogsOwnedNode_t*) b;
+
+  if(fa->baseId < fb->baseId) return -1;
+  if(fa->baseId > fb->baseId) return +1;
+
+  return 0;
+}
+
+// build the neighbour pattern used to exchange halo gather nodes
+// (collective: every rank must call this, with or without halo nodes)
+static void meshParallelGatherScatterExchangeSetup(mesh_t *mesh, ogs_t *ogs){
+
+  int rank = mesh->rank;
+  int size = mesh->size;
+
+  int *sendCounts = (int*) calloc(size, sizeof(int));
+  int *recvCounts = (int*) calloc(size, sizeof(int));
+  int *sendDispls = (int*) calloc(size+1, sizeof(int));
+  int *recvDispls = (int*) calloc(size+1, sizeof(int));
+
+  // every halo node not owned here is sent to its base rank
+  for(dlong g=0;g<ogs->NhaloGather;++g){
+    int r = ogs->haloGatherBaseRanks[g];
+    if(r!=rank) sendCounts[r]++;
+  }
+
+  MPI_Alltoall(sendCounts, 1, MPI_INT, recvCounts, 1, MPI_INT, mesh->comm);
+
+  for(int r=0;r<size;++r){
+    sendDispls[r+1] = sendDispls[r] + sendCounts[r];
+    recvDispls[r+1] = recvDispls[r] + recvCounts[r];
+  }
+
+  ogs->Nsend = sendDispls[size];
+  ogs->Nrecv = recvDispls[size];
+
+  ogs->sendIds = (dlong*) calloc(ogs->Nsend, sizeof(dlong));
+  ogs->recvIds = (dlong*) calloc(ogs->Nrecv, sizeof(dlong));
+
+  hlong *sendBaseIds = (hlong*) calloc(ogs->Nsend, sizeof(hlong));
+  hlong *recvBaseIds = (hlong*) calloc(ogs->Nrecv, sizeof(hlong));
+
+  int *cnt = (int*) calloc(size, sizeof(int));
+  for(dlong g=0;g<ogs->NhaloGather;++g){
+    int r = ogs->haloGatherBaseRanks[g];
+    if(r!=rank){
+      dlong id = sendDispls[r] + cnt[r]++;
+      ogs->sendIds[id] = g;
+      sendBaseIds[id] = ogs->haloGatherBaseIds[g];
+    }
+  }
+  free(cnt);
+
+  MPI_Alltoallv(sendBaseIds, sendCounts, sendDispls, MPI_HLONG,
+                recvBaseIds, recvCounts, recvDispls, MPI_HLONG, mesh->comm);
+
+  // match incoming base ids against the halo nodes owned here
+  ogsOwnedNode_t *owned = (ogsOwnedNode_t*) calloc(ogs->NownedHalo+1, sizeof(ogsOwnedNode_t));
+  dlong Nowned = 0;
+  for(dlong g=0;g<ogs->NhaloGather;++g){
+    if(ogs->haloGatherBaseRanks[g]==rank){
+      owned[Nowned].baseId = ogs->haloGatherBaseIds[g];
+      owned[Nowned].id = g;
+      ++Nowned;
+    }
+  }
+  qsort(owned, Nowned, sizeof(ogsOwnedNode_t), compareOwnedNodes);
+
+  ogs->recvGatherStarts = (dlong*) calloc(ogs->NhaloGather+1, sizeof(dlong));
+  ogs->recvGatherIds = (dlong*) calloc(ogs->Nrecv, sizeof(dlong));
+
+  for(dlong n=0;n<ogs->Nrecv;++n){
+    ogsOwnedNode_t key;
+    key.baseId = recvBaseIds[n];
+    ogsOwnedNode_t *match =
+      (ogsOwnedNode_t*) bsearch(&key, owned, Nowned, sizeof(ogsOwnedNode_t), compareOwnedNodes);
+
+    if(!match){
+      printf("ERROR: rank %d received halo node " hlongFormat " it does not own\n", rank, recvBaseIds[n]-1);
+      MPI_Abort(mesh->comm, 1);
+    }
+
+    ogs->recvIds[n] = match->id;
+    ogs->recvGatherStarts[match->id+1]++;
+  }
+
+  for(dlong g=0;g<ogs->NhaloGather;++g)
+    ogs->recvGatherStarts[g+1] += ogs->recvGatherStarts[g];
+
+  dlong *fill = (dlong*) calloc(ogs->NhaloGather+1, sizeof(dlong));
+  for(dlong n=0;n<ogs->Nrecv;++n){
+    dlong g = ogs->recvIds[n];
+    ogs->recvGatherIds[ogs->recvGatherStarts[g] + fill[g]++] = n;
+  }
+  free(fill);
+
+  // compact neighbour lists
+  ogs->NsendRanks = 0;
+  ogs->NrecvRanks = 0;
+  for(int r=0;r<size;++r){
+    if(sendCounts[r]) ogs->NsendRanks++;
+    if(recvCounts[r]) ogs->NrecvRanks++;
+  }
+
+  ogs->sendRanks   = (int*)   calloc(ogs->NsendRanks, sizeof(int));
+  ogs->recvRanks   = (int*)   calloc(ogs->NrecvRanks, sizeof(int));
+  ogs->sendOffsets = (dlong*) calloc(ogs->NsendRanks+1, sizeof(dlong));
+  ogs->recvOffsets = (dlong*) calloc(ogs->NrecvRanks+1, sizeof(dlong));
+
+  int NsendRanks = 0, NrecvRanks = 0;
+  for(int r=0;r<size;++r){
+    if(sendCounts[r]){
+      ogs->sendRanks[NsendRanks] = r;
+      ogs->sendOffsets[NsendRanks+1] = ogs->sendOffsets[NsendRanks] + sendCounts[r];
+      NsendRanks++;
+    }
+    if(recvCounts[r]){
+      ogs->recvRanks[NrecvRanks] = r;
+      ogs->recvOffsets[NrecvRanks+1] = ogs->recvOffsets[NrecvRanks] + recvCounts[r];
+      NrecvRanks++;
+    }
+  }
+
+  ogs->exchangeRequests = calloc(ogs->NsendRanks+ogs->NrecvRanks, sizeof(MPI_Request));
+
+  if(ogs->Nsend)
+    ogs->o_sendIds = mesh->device.malloc(ogs->Nsend*sizeof(dlong), ogs->sendIds);
+
+  if(ogs->Nrecv){
+    ogs->o_recvIds = mesh->device.malloc(ogs->Nrecv*sizeof(dlong), ogs->recvIds);
+    ogs->o_recvGatherIds = mesh->device.malloc(ogs->Nrecv*sizeof(dlong), ogs->recvGatherIds);
+    ogs->o_recvGatherStarts = mesh->device.malloc((ogs->NhaloGather+1)*sizeof(dlong), ogs->recvGatherStarts);
+  }
+
+  // exchange buffers are sized on first use
+  ogs->NentriesMax = 0;
+
+  free(owned);
+  free(sendBaseIds);
+  free(recvBaseIds);
+  free(sendCounts);
+  free(recvCounts);
+  free(sendDispls);
+  free(recvDispls);
+}
+
 // assume nodes locally sorted by rank then global index
 // assume gather and scatter are the same sets
 ogs_t *meshParallelGatherScatterSetup(mesh_t *mesh,
@@ -83,6 +239,7 @@ ogs_t *meshParallelGatherScatterSetup(mesh_t *mesh,
   ogs->haloGatherOffsets  = (dlong*) calloc(ogs->NhaloGather+1, sizeof(dlong)); // offset into sorted list of nodes
   ogs->haloGatherLocalIds = (dlong*) calloc(Nhalo, sizeof(dlong));
 
+  ogs->haloGatherBaseRanks = (int*) calloc(ogs->NhaloGather, sizeof(int));
   ogs->ownedHaloGatherIds = (dlong*) calloc(ogs->NhaloGather, sizeof(dlong));  
 
   ogs->nonHaloGatherBaseIds  = (hlong*) calloc(ogs->NnonHaloGather, sizeof(hlong)); // offset into sorted list of nodes
@@ -104,6 +261,7 @@ ogs_t *meshParallelGatherScatterSetup(mesh_t *mesh,
       if(test){
         ogs->haloGatherOffsets[ogs->NhaloGather] = Nhalo;
         ogs->haloGatherBaseIds[ogs->NhaloGather] = baseIds[n]+1;
+        ogs->haloGatherBaseRanks[ogs->NhaloGather] = baseRanks[n];
         
         if (baseRanks[n]==rank) {
           ogs->ownedHaloGatherIds[ogs->NhaloGather] = haloOffset++;
@@ -131,22 +289,15 @@ ogs_t *meshParallelGatherScatterSetup(mesh_t *mesh,
 
   // if there are halo nodes to gather
   if(ogs->NhaloGather){
-
-#if 0
-    occa::memory o_gatherTmpPinned = mesh->device.mappedAlloc(ogs->NhaloGather*sizeof(dfloat), NULL);
-    ogs->haloGatherTmp = (dfloat*) o_gatherTmpPinned.getMappedPointer(); // (char*) calloc(ogs->NhaloGather*sizeof(dfloat), sizeof(char));
-#else
-    ogs->haloGatherTmp = (dfloat*) occaHostMallocPinned(mesh->device, ogs->NhaloGather*sizeof(dfloat), NULL, ogs->o_haloGatherTmp);
     ogs->o_haloGatherOffsets  = mesh->device.malloc((ogs->NhaloGather+1)*sizeof(dlong), ogs->haloGatherOffsets);
     ogs->o_haloGatherLocalIds = mesh->device.malloc(Nhalo*sizeof(dlong),                ogs->haloGatherLocalIds);
-#endif
 
     ogs->o_ownedHaloGatherIds = mesh->device.malloc(ogs->NhaloGather*sizeof(dlong), ogs->ownedHaloGatherIds);
-
-    // initiate gslib gather-scatter comm pattern on halo nodes only
-    ogs->haloGsh = gsParallelGatherScatterSetup(mesh->comm, ogs->NhaloGather, ogs->haloGatherBaseIds,verbose);
   }
 
+  // neighbour exchange pattern for the halo nodes
+  meshParallelGatherScatterExchangeSetup(mesh, ogs);
+
   // if there are non-halo nodes to gather
   if(ogs->NnonHaloGather){
     ogs->o_nonHaloGatherOffsets  = mesh->device.malloc((ogs->NnonHaloGather+1)*sizeof(dlong), ogs->nonHaloGatherOffsets);
@@ -0,0 +1,164 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include  "mpi.h"
+
+#include "mesh.h"
+#include "meshBinaryFormat.h"
+
+/*
+  purpose: detect the libParanumal binary mesh format by its magic string
+*/
+int meshBinaryFormat(char *fileName){
+
+  int rank;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  int isBinary = 0;
+
+  // only the root opens the file to avoid a metadata storm on shared file systems
+  if(rank==0){
+    FILE *fp = fopen(fileName, "rb");
+    if(fp){
+      char magic[meshBinaryMagicLength];
+      if(fread(magic, sizeof(char), meshBinaryMagicLength, fp)==meshBinaryMagicLength)
+        isBinary = !strncmp(magic, meshBinaryMagic, meshBinaryMagicLength);
+      fclose(fp);
+    }
+  }
+
+  MPI_Bcast(&isBinary, 1, MPI_INT, 0, MPI_COMM_WORLD);
+
+  return isBinary;
+}
+
+/*
+  purpose: read this rank's slice of elements from a binary mesh with MPI-IO.
+           fills EToV, EX/EY/EZ, elementInfo and boundaryInfo exactly as the
+           gmsh readers do. Element type info (Nverts etc) must be set on entry.
+*/
+void meshParallelReaderBinary(mesh_t *mesh, char *fileName){
+
+  int rank = mesh->rank;
+  int size = mesh->size;
+
+  MPI_File fh;
+  int err = MPI_File_open(mesh->comm, fileName, MPI_MODE_RDONLY, MPI_INFO_NULL, &fh);
+  if(err!=MPI_SUCCESS){
+    if(rank==0) printf("meshParallelReaderBinary: could not load file %s\n", fileName);
+    MPI_Abort(mesh->comm, 1);
+  }
+
+  long long int header[meshBinaryNheader];
+  MPI_File_read_at_all(fh, meshBinaryMagicLength, header, meshBinaryNheader,
+                       MPI_LONG_LONG_INT, MPI_STATUS_IGNORE);
+
+  if(header[meshBinaryDimId]!=mesh->dim ||
+     header[meshBinaryNvertsId]!=mesh->Nverts ||
+     header[meshBinaryNfaceVerticesId]!=mesh->NfaceVertices){
+    if(rank==0)
+      printf("meshParallelReaderBinary: %s holds dim=%lld, Nverts=%lld elements, expected dim=%d, Nverts=%d\n",
+             fileName, header[meshBinaryDimId], header[meshBinaryNvertsId], mesh->dim, mesh->Nverts);
+    MPI_Abort(mesh->comm, 1);
+  }
+
+  long long int Nnodes         = header[meshBinaryNnodesId];
+  long long int Nelements      = header[meshBinaryNelementsId];
+  long long int NboundaryFaces = header[meshBinaryNboundaryFacesId];
+
+  meshCheckIndexRange(mesh->comm, Nnodes, hlongMax, "Nnodes");
+  meshCheckIndexRange(mesh->comm, Nelements, hlongMax, "Nelements");
+
+  mesh->Nnodes = (hlong) Nnodes;
+
+  // same block distribution as the gmsh readers
+  long long int chunk = Nelements/size;
+  int remainder = (int) (Nelements - chunk*size);
+
+  long long int NelementsLocal = chunk + (rank<remainder);
+  long long int start = rank*chunk + mymin(rank, remainder);
+
+  meshCheckIndexRange(mesh->comm, NelementsLocal*mesh->Nverts, dlongMax, "local Nelements*Nverts");
+
+  mesh->Nelements = (dlong) NelementsLocal;
+
+  const int Nverts = mesh->Nverts;
+  const int NbInfo = mesh->NfaceVertices+1;
+
+  // section offsets
+  MPI_Offset offset = meshBinaryMagicLength + meshBinaryNheader*sizeof(long long int);
+  MPI_Offset elementInfoOffset = offset;
+  offset += Nelements*sizeof(long long int);
+  MPI_Offset EToVOffset = offset;
+  offset += Nelements*Nverts*sizeof(long long int);
+  MPI_Offset coordOffset = offset;
+  offset += mesh->dim*Nelements*Nverts*sizeof(double);
+  MPI_Offset boundaryOffset = offset;
+
+  // read local element slice
+  long long int *ibuf = (long long int*) calloc(mymax(NelementsLocal*Nverts, NboundaryFaces*NbInfo)+1,
+                                                sizeof(long long int));
+  double *dbuf = (double*) calloc(NelementsLocal*Nverts+1, sizeof(double));
+
+  mesh->elementInfo = (int*) calloc(NelementsLocal, sizeof(int));
+  MPI_File_read_at_all(fh, elementInfoOffset + start*sizeof(long long int),
+                       ibuf, (int) NelementsLocal, MPI_LONG_LONG_INT, MPI_STATUS_IGNORE);
+  for(dlong e=0;e<mesh->Nelements;++e)
+    mesh->elementInfo[e] = (int) ibuf[e];
+
+  mesh->EToV = (hlong*) calloc(NelementsLocal*Nverts, sizeof(hlong));
+  MPI_File_read_at_all(fh, EToVOffset + start*Nverts*sizeof(long long int),
+                       ibuf, (int) (NelementsLocal*Nverts), MPI_LONG_LONG_INT, MPI_STATUS_IGNORE);
+  for(dlong n=0;n<mesh->Nelements*Nverts;++n){
+    meshCheckIndexRange(mesh->comm, ibuf[n], Nnodes-1, "EToV");
+    mesh->EToV[n] = (hlong) ibuf[n];
+  }
+
+  dfloat **coords[3] = {&(mesh->EX), &(mesh->EY), &(mesh->EZ)};
+  for(int d=0;d<mesh->dim;++d){
+    *coords[d] = (dfloat*) calloc(NelementsLocal*Nverts, sizeof(dfloat));
+    MPI_File_read_at_all(fh, coordOffset + (d*Nelements + start)*Nverts*sizeof(double),
+                         dbuf, (int) (NelementsLocal*Nverts), MPI_DOUBLE, MPI_STATUS_IGNORE);
+    for(dlong n=0;n<mesh->Nelements*Nverts;++n)
+      (*coords[d])[n] = (dfloat) dbuf[n];
+  }
+
+  // every rank keeps the full boundary face list (as the gmsh readers do)
+  mesh->NboundaryFaces = (hlong) NboundaryFaces;
+  mesh->boundaryInfo = (hlong*) calloc(NboundaryFaces*NbInfo, sizeof(hlong));
+  MPI_File_read_at_all(fh, boundaryOffset, ibuf, (int) (NboundaryFaces*NbInfo),
+                       MPI_LONG_LONG_INT, MPI_STATUS_IGNORE);
+  for(hlong n=0;n<NboundaryFaces*NbInfo;++n)
+    mesh->boundaryInfo[n] = (hlong) ibuf[n];
+
+  MPI_File_close(&fh);
+
+  free(ibuf);
+  free(dbuf);
+}
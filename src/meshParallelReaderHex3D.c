@@ -40,8 +40,6 @@ mesh3D* meshParallelReaderHex3D(char *fileName){
   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
   MPI_Comm_size(MPI_COMM_WORLD, &size);
 
-  FILE *fp = fopen(fileName, "r");
-  
   char *status;
 
   mesh3D *mesh = (mesh3D*) calloc(1, sizeof(mesh3D));
@@ -64,6 +62,14 @@ mesh3D* meshParallelReaderHex3D(char *fileName){
 
   memcpy(mesh->faceVertices, faceVertices[0], mesh->NfaceVertices*mesh->Nfaces*sizeof(int));
     
+  /* native binary mesh: each rank reads only its own slice */
+  if(meshBinaryFormat(fileName)){
+    meshParallelReaderBinary(mesh, fileName);
+    return mesh;
+  }
+
+  FILE *fp = fopen(fileName, "r");
+
   if(fp==NULL){
     printf("meshReaderHex3D: could not load file %s\n", fileName);
     exit(0);
@@ -41,8 +41,6 @@ mesh3D* meshParallelReaderTet3D(char *fileName){
   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
   MPI_Comm_size(MPI_COMM_WORLD, &size);
 
-  FILE *fp = fopen(fileName, "r");
-
   char *status;
 
   mesh3D *mesh = (mesh3D*) calloc(1, sizeof(mesh3D));
@@ -63,6 +61,14 @@ mesh3D* meshParallelReaderTet3D(char *fileName){
     (int*) calloc(mesh->NfaceVertices*mesh->Nfaces, sizeof(int));
   memcpy(mesh->faceVertices, faceVertices[0], 12*sizeof(int));
     
+  /* native binary mesh: each rank reads only its own slice */
+  if(meshBinaryFormat(fileName)){
+    meshParallelReaderBinary(mesh, fileName);
+    return mesh;
+  }
+
+  FILE *fp = fopen(fileName, "r");
+
   if(fp==NULL){
     printf("meshReaderTet3D: could not load file %s\n", fileName);
     exit(0);
@@ -42,8 +42,6 @@ mesh2D* meshParallelReaderTri2D(char *fileName){
   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
   MPI_Comm_size(MPI_COMM_WORLD, &size);
 
-  FILE *fp = fopen(fileName, "r");
-
   char *status;
 
   mesh2D *mesh = (mesh2D*) calloc(1, sizeof(mesh2D));
@@ -66,6 +64,14 @@ mesh2D* meshParallelReaderTri2D(char *fileName){
 
   memcpy(mesh->faceVertices, faceVertices[0], mesh->NfaceVertices*mesh->Nfaces*sizeof(int));
 
+  /* native binary mesh: each rank reads only its own slice */
+  if(meshBinaryFormat(fileName)){
+    meshParallelReaderBinary(mesh, fileName);
+    return mesh;
+  }
+
+  FILE *fp = fopen(fileName, "r");
+
   if(fp==NULL){
     printf("meshParallelReaderTri2D: could not load file %s\n", fileName);
     exit(0);
@@ -75,7 +75,7 @@ mesh3D* meshParallelReaderTri3D(char *fileName){
 
   /* read number of nodes in mesh */
   fgets(buf, BUFSIZ, fp);
-  sscanf(buf, "%d", &(mesh->Nnodes));
+  sscanf(buf, hlongFormat, &(mesh->Nnodes));
 
   /* allocate space for node coordinates */
   dfloat *VX = (dfloat*) calloc(mesh->Nnodes, sizeof(dfloat));
@@ -96,7 +96,7 @@ mesh3D* meshParallelReaderTri3D(char *fileName){
 
   /* read number of nodes in mesh */
   fgets(buf, BUFSIZ, fp);
-  sscanf(buf, "%d", &(mesh->Nelements));
+  sscanf(buf, dlongFormat, &(mesh->Nelements));
 
   /* find # of triangles */
   fpos_t fpos;
@@ -125,8 +125,8 @@ mesh3D* meshParallelReaderTri3D(char *fileName){
   /* allocate space for Element node index data */
 
   mesh->EToV
-    = (int*) calloc(NtrianglesLocal*mesh->Nverts,
-		     sizeof(int));
+    = (hlong*) calloc(NtrianglesLocal*mesh->Nverts,
+		     sizeof(hlong));
   mesh->elementInfo
     = (int*) calloc(NtrianglesLocal,sizeof(int));
 
@@ -134,13 +134,13 @@ mesh3D* meshParallelReaderTri3D(char *fileName){
   int cnt=0, bcnt=0;
   Ntriangles = 0;
 
-  mesh->boundaryInfo = (int*) calloc(NboundaryFaces*3, sizeof(int));
+  mesh->boundaryInfo = (hlong*) calloc(NboundaryFaces*3, sizeof(hlong));
   for(n=0;n<mesh->Nelements;++n){
     int elementType, v1, v2, v3;
     fgets(buf, BUFSIZ, fp);
     sscanf(buf, "%*d%d", &elementType);
     if(elementType==1){ // boundary face
-      sscanf(buf, "%*d%*d %*d%d%*d %d%d",
+      sscanf(buf, "%*d%*d %*d" hlongFormat "%*d %d%d",
 	     mesh->boundaryInfo+bcnt*3, &v1, &v2);
       mesh->boundaryInfo[bcnt*3+1] = v1-1;
       mesh->boundaryInfo[bcnt*3+2] = v2-1;
@@ -0,0 +1,364 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mesh.h"
+
+// boundary refinement settings (no passes: refinement off)
+static int refineNpasses = 0;
+static dfloat refineTolerance = 0.05;
+
+// read PARTITION REFINEMENT PASSES and PARTITION IMBALANCE TOLERANCE
+void meshSetPartitionRefinement(setupAide &options){
+  refineNpasses = 0;
+  refineTolerance = 0.05;
+  options.getArgs("PARTITION REFINEMENT PASSES", refineNpasses);
+  options.getArgs("PARTITION IMBALANCE TOLERANCE", refineTolerance);
+}
+
+// capsule for an element moving between ranks
+typedef struct {
+
+  // 8 for maximum number of vertices per element
+  hlong v[8];
+  dfloat EX[8], EY[8], EZ[8];
+
+  int type;
+
+}refineElement_t;
+
+// candidate move: element, destination rank and face-cut gain
+typedef struct {
+
+  dlong element;
+  int rank;
+  int gain;
+
+}refineMove_t;
+
+static int compareGains(const void *a, const void *b){
+
+  refineMove_t *ma = (refineMove_t*) a;
+  refineMove_t *mb = (refineMove_t*) b;
+
+  if(ma->gain > mb->gain) return -1;
+  if(ma->gain < mb->gain) return +1;
+
+  if(ma->element < mb->element) return -1;
+  if(ma->element > mb->element) return +1;
+
+  return 0;
+}
+
+// number of faces shared with other ranks, summed over all ranks
+static hlong meshCutFaces(mesh_t *mesh){
+
+  hlong localCut = 0, cut = 0;
+  for(dlong n=0;n<mesh->Nelements*mesh->Nfaces;++n)
+    if(mesh->EToP[n]!=-1) ++localCut;
+
+  MPI_Allreduce(&localCut, &cut, 1, MPI_HLONG, MPI_SUM, mesh->comm);
+
+  return cut/2;
+}
+
+static dfloat meshElementWeight(mesh_t *mesh, dfloat (*elementWeight)(int type), dlong e){
+
+  return (elementWeight) ? elementWeight(mesh->elementInfo[e]) : 1.;
+}
+
+// sum of the element weights on this rank
+static dfloat meshPartitionLoad(mesh_t *mesh, dfloat (*elementWeight)(int type)){
+
+  dfloat load = 0;
+  for(dlong e=0;e<mesh->Nelements;++e)
+    load += meshElementWeight(mesh, elementWeight, e);
+
+  return load;
+}
+
+/* ---------------------------------------------------------
+
+Kernighan-Lin/Fiduccia-Mattheyses style boundary refinement of
+the element partition on the dual graph given by EToE/EToP.
+
+Each pass:
+  - every element on a partition boundary computes the gain
+    (faces to rank q minus faces on its own rank) of moving to
+    each neighbouring rank q. Moves only go up in rank on even
+    passes and down on odd passes, so two neighbouring elements
+    never swap sides in the same pass.
+  - ranks propose their positive gain moves, receivers accept
+    as many as fit under (1+tolerance) times the mean load, and
+    senders keep at least (1-tolerance) times it. The load of a
+    rank is the sum of its element weights.
+  - accepted elements move and the mesh is reconnected.
+
+Stops after Npasses or when a pass in each direction moves nothing.
+
+------------------------------------------------------------ */
+void meshPartitionRefine(mesh_t *mesh, dfloat (*elementWeight)(int type)){
+
+  if(refineNpasses<1 || mesh->size==1) return;
+
+  int rank = mesh->rank;
+  int size = mesh->size;
+
+  dfloat localLoad = meshPartitionLoad(mesh, elementWeight), globalLoad = 0;
+  MPI_Allreduce(&localLoad, &globalLoad, 1, MPI_DFLOAT, MPI_SUM, mesh->comm);
+
+  dfloat meanLoad = globalLoad/size;
+  dfloat maxLoad = (1.+refineTolerance)*meanLoad;
+  dfloat minLoad = (1.-refineTolerance)*meanLoad;
+
+  hlong cut0 = meshCutFaces(mesh);
+
+  int *Npropose = (int*) calloc(size, sizeof(int));
+  int *Nincoming = (int*) calloc(size, sizeof(int));
+  int *Naccept = (int*) calloc(size, sizeof(int));
+  int *Nsend = (int*) calloc(size, sizeof(int));
+  int *Nrecv = (int*) calloc(size, sizeof(int));
+  int *sendOffsets = (int*) calloc(size+1, sizeof(int));
+  int *proposeOffsets = (int*) calloc(size+1, sizeof(int));
+  int *incomingOffsets = (int*) calloc(size+1, sizeof(int));
+
+  int Nrun = 0, Nidle = 0;
+  for(int pass=0;pass<refineNpasses;++pass){
+
+    ++Nrun;
+
+    int up = (pass%2==0);
+
+    // find the best move for each boundary element
+    refineMove_t *moves = (refineMove_t*) calloc(mesh->Nelements+1, sizeof(refineMove_t));
+    dlong Nmoves = 0;
+
+    for(dlong e=0;e<mesh->Nelements;++e){
+      int localFaces = 0;
+      for(int f=0;f<mesh->Nfaces;++f){
+        dlong id = e*mesh->Nfaces+f;
+        if(mesh->EToE[id]!=-1 && mesh->EToP[id]==-1) ++localFaces;
+      }
+
+      int bestRank = -1, bestGain = 0;
+      for(int f=0;f<mesh->Nfaces;++f){
+        int q = mesh->EToP[e*mesh->Nfaces+f];
+        if(q==-1) continue;
+        if((up && q<rank) || (!up && q>rank)) continue;
+
+        int remoteFaces = 0;
+        for(int g=0;g<mesh->Nfaces;++g)
+          if(mesh->EToP[e*mesh->Nfaces+g]==q) ++remoteFaces;
+
+        int gain = remoteFaces - localFaces;
+        if(gain>bestGain || (gain==bestGain && gain>0 && q<bestRank)){
+          bestGain = gain;
+          bestRank = q;
+        }
+      }
+
+      if(bestRank!=-1){
+        moves[Nmoves].element = e;
+        moves[Nmoves].rank = bestRank;
+        moves[Nmoves].gain = bestGain;
+        ++Nmoves;
+      }
+    }
+
+    qsort(moves, Nmoves, sizeof(refineMove_t), compareGains);
+
+    // propose moves, best gain first, without dropping below the lower load bound
+    localLoad = meshPartitionLoad(mesh, elementWeight);
+    int *proposed = (int*) calloc(Nmoves+1, sizeof(int));
+    dfloat spare = localLoad-minLoad;
+    for(int r=0;r<size;++r) Npropose[r] = 0;
+    for(dlong n=0;n<Nmoves;++n){
+      dfloat w = meshElementWeight(mesh, elementWeight, moves[n].element);
+      if(w>spare) continue;
+      spare -= w;
+      proposed[n] = 1;
+      ++Npropose[moves[n].rank];
+    }
+
+    MPI_Alltoall(Npropose, 1, MPI_INT, Nincoming, 1, MPI_INT, mesh->comm);
+
+    // send the weights of the proposed elements, in gain order per destination
+    for(int r=0;r<size;++r){
+      proposeOffsets[r+1] = proposeOffsets[r] + Npropose[r];
+      incomingOffsets[r+1] = incomingOffsets[r] + Nincoming[r];
+      Naccept[r] = 0;
+    }
+
+    dfloat *proposeWeights = (dfloat*) calloc(proposeOffsets[size]+1, sizeof(dfloat));
+    dfloat *incomingWeights = (dfloat*) calloc(incomingOffsets[size]+1, sizeof(dfloat));
+    for(dlong n=0;n<Nmoves;++n){
+      if(!proposed[n]) continue;
+      int q = moves[n].rank;
+      proposeWeights[proposeOffsets[q]+Naccept[q]++] = meshElementWeight(mesh, elementWeight, moves[n].element);
+    }
+
+    MPI_Alltoallv(proposeWeights, Npropose, proposeOffsets, MPI_DFLOAT,
+                  incomingWeights, Nincoming, incomingOffsets, MPI_DFLOAT, mesh->comm);
+
+    // accept a prefix of each rank's proposals up to the upper load bound
+    dfloat capacity = maxLoad-localLoad;
+    for(int r=0;r<size;++r){
+      Naccept[r] = 0;
+      for(int n=0;n<Nincoming[r];++n){
+        dfloat w = incomingWeights[incomingOffsets[r]+n];
+        if(w>capacity) break;
+        capacity -= w;
+        ++Naccept[r];
+      }
+    }
+
+    MPI_Alltoall(Naccept, 1, MPI_INT, Nsend, 1, MPI_INT, mesh->comm);
+
+    // mark accepted moves by destination
+    int *dest = (int*) calloc(mesh->Nelements+1, sizeof(int));
+    for(dlong e=0;e<mesh->Nelements;++e) dest[e] = -1;
+
+    int *Ntaken = (int*) calloc(size, sizeof(int));
+    dlong NmovedLocal = 0;
+    for(dlong n=0;n<Nmoves;++n){
+      if(!proposed[n]) continue;
+      int q = moves[n].rank;
+      if(Ntaken[q]<Nsend[q]){
+        dest[moves[n].element] = q;
+        ++Ntaken[q];
+        ++NmovedLocal;
+      }
+    }
+
+    free(proposed);
+    free(proposeWeights); free(incomingWeights);
+
+    hlong Nmoved = 0, NmovedLocalH = NmovedLocal;
+    MPI_Allreduce(&NmovedLocalH, &Nmoved, 1, MPI_HLONG, MPI_SUM, mesh->comm);
+
+    if(Nmoved==0){
+      free(moves); free(dest); free(Ntaken);
+      // stop once neither direction moves anything
+      if(++Nidle==2) break;
+      continue;
+    }
+    Nidle = 0;
+
+    // pack outgoing elements by destination
+    for(int r=0;r<size;++r){
+      sendOffsets[r+1] = sendOffsets[r] + Ntaken[r];
+      Ntaken[r] = 0;
+    }
+
+    refineElement_t *sendElements = (refineElement_t*) calloc(NmovedLocal+1, sizeof(refineElement_t));
+    dlong Nkeep = 0;
+    for(dlong e=0;e<mesh->Nelements;++e){
+      int q = dest[e];
+      if(q==-1){
+        // compress the elements staying on this rank
+        for(int n=0;n<mesh->Nverts;++n){
+          mesh->EToV[Nkeep*mesh->Nverts+n] = mesh->EToV[e*mesh->Nverts+n];
+          mesh->EX[Nkeep*mesh->Nverts+n] = mesh->EX[e*mesh->Nverts+n];
+          mesh->EY[Nkeep*mesh->Nverts+n] = mesh->EY[e*mesh->Nverts+n];
+          if(mesh->dim==3)
+            mesh->EZ[Nkeep*mesh->Nverts+n] = mesh->EZ[e*mesh->Nverts+n];
+        }
+        mesh->elementInfo[Nkeep] = mesh->elementInfo[e];
+        ++Nkeep;
+      } else {
+        refineElement_t *ref = sendElements + sendOffsets[q] + Ntaken[q]++;
+        for(int n=0;n<mesh->Nverts;++n){
+          ref->v[n] = mesh->EToV[e*mesh->Nverts+n];
+          ref->EX[n] = mesh->EX[e*mesh->Nverts+n];
+          ref->EY[n] = mesh->EY[e*mesh->Nverts+n];
+          if(mesh->dim==3)
+            ref->EZ[n] = mesh->EZ[e*mesh->Nverts+n];
+        }
+        ref->type = mesh->elementInfo[e];
+      }
+    }
+
+    // exchange the moved elements
+    refineElement_t *recvElements = (refineElement_t*)
+      parallelExchange(mesh->comm, sizeof(refineElement_t), sendElements, Ntaken, Nrecv);
+
+    dlong NnewElements = 0;
+    for(int r=0;r<size;++r)
+      NnewElements += Nrecv[r];
+
+    for(int r=0;r<=size;++r) sendOffsets[r] = 0;
+
+    // append inbound elements
+    mesh->Nelements = Nkeep + NnewElements;
+    mesh->EToV = (hlong*) realloc(mesh->EToV, mesh->Nelements*mesh->Nverts*sizeof(hlong));
+    mesh->EX = (dfloat*) realloc(mesh->EX, mesh->Nelements*mesh->Nverts*sizeof(dfloat));
+    mesh->EY = (dfloat*) realloc(mesh->EY, mesh->Nelements*mesh->Nverts*sizeof(dfloat));
+    if(mesh->dim==3)
+      mesh->EZ = (dfloat*) realloc(mesh->EZ, mesh->Nelements*mesh->Nverts*sizeof(dfloat));
+    mesh->elementInfo = (int*) realloc(mesh->elementInfo, mesh->Nelements*sizeof(int));
+
+    for(dlong n=0;n<NnewElements;++n){
+      dlong e = Nkeep + n;
+      for(int v=0;v<mesh->Nverts;++v){
+        mesh->EToV[e*mesh->Nverts+v] = recvElements[n].v[v];
+        mesh->EX[e*mesh->Nverts+v] = recvElements[n].EX[v];
+        mesh->EY[e*mesh->Nverts+v] = recvElements[n].EY[v];
+        if(mesh->dim==3)
+          mesh->EZ[e*mesh->Nverts+v] = recvElements[n].EZ[v];
+      }
+      mesh->elementInfo[e] = recvElements[n].type;
+    }
+
+    free(moves); free(dest); free(Ntaken);
+    free(sendElements); free(recvElements);
+
+    // reconnect the moved elements
+    free(mesh->EToE);
+    free(mesh->EToF);
+    free(mesh->EToP);
+    meshParallelConnect(mesh);
+
+    if(rank==0)
+      printf("Partition refinement pass %d: moved " hlongFormat " elements\n", pass, Nmoved);
+  }
+
+  hlong cut1 = meshCutFaces(mesh);
+
+  localLoad = meshPartitionLoad(mesh, elementWeight);
+  dfloat maxRankLoad = 0;
+  MPI_Allreduce(&localLoad, &maxRankLoad, 1, MPI_DFLOAT, MPI_MAX, mesh->comm);
+
+  if(rank==0)
+    printf("Partition refinement: %d passes, cut faces " hlongFormat " -> " hlongFormat ", imbalance %g\n",
+           Nrun, cut0, cut1, maxRankLoad/meanLoad);
+
+  free(Npropose); free(Nincoming); free(Naccept);
+  free(Nsend); free(Nrecv);
+  free(sendOffsets);
+  free(proposeOffsets); free(incomingOffsets);
+}
@@ -68,5 +68,13 @@ void meshPartitionStatistics(mesh_t *mesh){
     }
   }
   
+  /* halo volume summary (faces shared with other ranks) */
+  int minComms = 0, maxComms = 0, sumComms = 0;
+  MPI_Allreduce(&Ncomms, &minComms, 1, MPI_INT, MPI_MIN, mesh->comm);
+  MPI_Allreduce(&Ncomms, &maxComms, 1, MPI_INT, MPI_MAX, mesh->comm);
+  MPI_Allreduce(&Ncomms, &sumComms, 1, MPI_INT, MPI_SUM, mesh->comm);
+  if(rank==0)
+    printf("halo faces per rank: min %d, mean %g, max %d\n", minComms, ((double)sumComms)/size, maxComms);
+
   free(comms);
 }
@@ -0,0 +1,345 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#include "mesh.h"
+
+#define meshPlotVTUMaxArrays 16
+
+// one frame queued for the background writer
+typedef struct {
+
+  pthread_t thread;
+  int active;
+
+  mesh_t *mesh;
+  int frame;
+  char fileBase[BUFSIZ];
+
+  int  Narrays;
+  char arrayNames[meshPlotVTUMaxArrays][BUFSIZ];
+  int  arrayComponents[meshPlotVTUMaxArrays];
+
+}meshPlotVTUWriter_t;
+
+static const char *meshPlotVTUByteOrder(){
+  int one = 1;
+  return (*(char*)&one) ? "LittleEndian" : "BigEndian";
+}
+
+// appended blocks are a UInt64 byte count followed by the raw data
+static void meshPlotVTUWriteBlockSize(FILE *fp, uint64_t Nbytes){
+  fwrite(&Nbytes, sizeof(uint64_t), 1, fp);
+}
+
+// interleave Ncomponents components (stride Nplot) of q per node
+static void meshPlotVTUWriteComponents(FILE *fp, const float *q, dlong Nplot, int Ncomponents){
+
+  const dlong Nchunk = 4096;
+  float *buffer = (float*) calloc(Nchunk*Ncomponents, sizeof(float));
+
+  meshPlotVTUWriteBlockSize(fp, ((uint64_t) Nplot)*Ncomponents*sizeof(float));
+
+  for(dlong start=0;start<Nplot;start+=Nchunk){
+    dlong N = mymin(Nchunk, Nplot-start);
+    for(dlong n=0;n<N;++n)
+      for(int c=0;c<Ncomponents;++c)
+        buffer[n*Ncomponents+c] = q[c*Nplot + start + n];
+    fwrite(buffer, sizeof(float), N*Ncomponents, fp);
+  }
+
+  free(buffer);
+}
+
+static void meshPlotVTUWritePiece(meshPlotVTUWriter_t *writer){
+
+  mesh_t *mesh = writer->mesh;
+
+  dlong Nplot  = mesh->Nelements*mesh->plotNp;
+  dlong Ncells = mesh->Nelements*mesh->plotNelements;
+
+  // triangles for surface/2D plot elements, otherwise tetrahedra
+  unsigned char cellType = (mesh->plotNverts==3) ? 5 : 10;
+
+  char fileName[BUFSIZ];
+  sprintf(fileName, "%s_%04d_%04d.vtu", writer->fileBase, mesh->rank, writer->frame);
+
+  FILE *fp = fopen(fileName, "w");
+  if(fp==NULL){
+    printf("meshPlotVTUWrite: could not open %s\n", fileName);
+    return;
+  }
+
+  uint64_t offset = 0;
+
+  fprintf(fp, "<?xml version=\"1.0\"?>\n");
+  fprintf(fp, "<VTKFile type=\"UnstructuredGrid\" version=\"1.0\" byte_order=\"%s\" header_type=\"UInt64\">\n",
+          meshPlotVTUByteOrder());
+  fprintf(fp, "  <UnstructuredGrid>\n");
+  fprintf(fp, "    <Piece NumberOfPoints=\"" dlongFormat "\" NumberOfCells=\"" dlongFormat "\">\n", Nplot, Ncells);
+
+  fprintf(fp, "      <Points>\n");
+  fprintf(fp, "        <DataArray type=\"Float32\" NumberOfComponents=\"3\" format=\"appended\" offset=\"%llu\"/>\n",
+          (unsigned long long) offset);
+  offset += sizeof(uint64_t) + ((uint64_t) Nplot)*3*sizeof(float);
+  fprintf(fp, "      </Points>\n");
+
+  fprintf(fp, "      <PointData>\n");
+  for(int a=0;a<writer->Narrays;++a){
+    fprintf(fp, "        <DataArray type=\"Float32\" Name=\"%s\" NumberOfComponents=\"%d\" format=\"appended\" offset=\"%llu\"/>\n",
+            writer->arrayNames[a], writer->arrayComponents[a], (unsigned long long) offset);
+    offset += sizeof(uint64_t) + ((uint64_t) Nplot)*writer->arrayComponents[a]*sizeof(float);
+  }
+  fprintf(fp, "      </PointData>\n");
+
+  fprintf(fp, "      <Cells>\n");
+  fprintf(fp, "        <DataArray type=\"Int32\" Name=\"connectivity\" format=\"appended\" offset=\"%llu\"/>\n",
+          (unsigned long long) offset);
+  offset += sizeof(uint64_t) + ((uint64_t) Ncells)*mesh->plotNverts*sizeof(int32_t);
+  fprintf(fp, "        <DataArray type=\"Int32\" Name=\"offsets\" format=\"appended\" offset=\"%llu\"/>\n",
+          (unsigned long long) offset);
+  offset += sizeof(uint64_t) + ((uint64_t) Ncells)*sizeof(int32_t);
+  fprintf(fp, "        <DataArray type=\"UInt8\" Name=\"types\" format=\"appended\" offset=\"%llu\"/>\n",
+          (unsigned long long) offset);
+  fprintf(fp, "      </Cells>\n");
+
+  fprintf(fp, "    </Piece>\n");
+  fprintf(fp, "  </UnstructuredGrid>\n");
+  fprintf(fp, "  <AppendedData encoding=\"raw\">\n");
+  fprintf(fp, "_");
+
+  // points
+  meshPlotVTUWriteBlockSize(fp, ((uint64_t) Nplot)*3*sizeof(float));
+  fwrite(mesh->plotPoints, sizeof(float), ((size_t) Nplot)*3, fp);
+
+  // fields
+  int field = 0;
+  for(int a=0;a<writer->Narrays;++a){
+    meshPlotVTUWriteComponents(fp, mesh->plotq + ((size_t) field)*Nplot, Nplot, writer->arrayComponents[a]);
+    field += writer->arrayComponents[a];
+  }
+
+  // cells, one element at a time
+  int32_t *cells = (int32_t*) calloc(mesh->plotNelements*mesh->plotNverts, sizeof(int32_t));
+
+  meshPlotVTUWriteBlockSize(fp, ((uint64_t) Ncells)*mesh->plotNverts*sizeof(int32_t));
+  for(dlong e=0;e<mesh->Nelements;++e){
+    for(int n=0;n<mesh->plotNelements*mesh->plotNverts;++n)
+      cells[n] = e*mesh->plotNp + mesh->plotEToV[n];
+    fwrite(cells, sizeof(int32_t), mesh->plotNelements*mesh->plotNverts, fp);
+  }
+
+  meshPlotVTUWriteBlockSize(fp, ((uint64_t) Ncells)*sizeof(int32_t));
+  for(dlong e=0;e<mesh->Nelements;++e){
+    for(int n=0;n<mesh->plotNelements;++n)
+      cells[n] = (e*mesh->plotNelements + n + 1)*mesh->plotNverts;
+    fwrite(cells, sizeof(int32_t), mesh->plotNelements, fp);
+  }
+
+  free(cells);
+
+  meshPlotVTUWriteBlockSize(fp, ((uint64_t) Ncells)*sizeof(unsigned char));
+  for(dlong n=0;n<Ncells;++n)
+    fputc(cellType, fp);
+
+  fprintf(fp, "\n  </AppendedData>\n");
+  fprintf(fp, "</VTKFile>\n");
+  fclose(fp);
+}
+
+// master file listing the pieces of all ranks
+static void meshPlotVTUWriteMaster(meshPlotVTUWriter_t *writer){
+
+  mesh_t *mesh = writer->mesh;
+
+  char fileName[BUFSIZ];
+  sprintf(fileName, "%s_%04d.pvtu", writer->fileBase, writer->frame);
+
+  FILE *fp = fopen(fileName, "w");
+  if(fp==NULL){
+    printf("meshPlotVTUWrite: could not open %s\n", fileName);
+    return;
+  }
+
+  // pieces live next to the master file
+  const char *pieceBase = strrchr(writer->fileBase, '/');
+  pieceBase = pieceBase ? pieceBase+1 : writer->fileBase;
+
+  fprintf(fp, "<?xml version=\"1.0\"?>\n");
+  fprintf(fp, "<VTKFile type=\"PUnstructuredGrid\" version=\"1.0\" byte_order=\"%s\" header_type=\"UInt64\">\n",
+          meshPlotVTUByteOrder());
+  fprintf(fp, "  <PUnstructuredGrid GhostLevel=\"0\">\n");
+  fprintf(fp, "    <PPoints>\n");
+  fprintf(fp, "      <PDataArray type=\"Float32\" NumberOfComponents=\"3\"/>\n");
+  fprintf(fp, "    </PPoints>\n");
+  fprintf(fp, "    <PPointData>\n");
+  for(int a=0;a<writer->Narrays;++a)
+    fprintf(fp, "      <PDataArray type=\"Float32\" Name=\"%s\" NumberOfComponents=\"%d\"/>\n",
+            writer->arrayNames[a], writer->arrayComponents[a]);
+  fprintf(fp, "    </PPointData>\n");
+  for(int r=0;r<mesh->size;++r)
+    fprintf(fp, "    <Piece Source=\"%s_%04d_%04d.vtu\"/>\n", pieceBase, r, writer->frame);
+  fprintf(fp, "  </PUnstructuredGrid>\n");
+  fprintf(fp, "</VTKFile>\n");
+  fclose(fp);
+}
+
+static void *meshPlotVTUThread(void *args){
+
+  meshPlotVTUWriter_t *writer = (meshPlotVTUWriter_t*) args;
+
+  meshPlotVTUWritePiece(writer);
+
+  if(writer->mesh->rank==0)
+    meshPlotVTUWriteMaster(writer);
+
+  return NULL;
+}
+
+// build the plot interpolation kernel and stage the plot node coordinates
+void meshPlotVTUSetup(mesh_t *mesh, occa::properties &kernelInfo, int Nfields){
+
+  dlong Nplot = mesh->Nelements*mesh->plotNp;
+
+  // coordinates go through the same staging buffer
+  int Nstaged = mymax(Nfields, mesh->dim);
+  mesh->plotNfields = Nfields;
+
+  // interpolation matrix stored node-fastest for coalesced reads
+  dfloat *plotInterpT = (dfloat*) calloc(mesh->plotNp*mesh->Np, sizeof(dfloat));
+  for(int n=0;n<mesh->plotNp;++n){
+    for(int m=0;m<mesh->Np;++m){
+      plotInterpT[n+m*mesh->plotNp] = mesh->plotInterp[n*mesh->Np+m];
+    }
+  }
+  mesh->o_plotInterpT = mesh->device.malloc(mesh->plotNp*mesh->Np*sizeof(dfloat), plotInterpT);
+  free(plotInterpT);
+
+  mesh->o_plotq = mesh->device.malloc((((size_t) Nstaged)*Nplot+1)*sizeof(float));
+  mesh->plotq   = (float*) calloc(((size_t) Nstaged)*Nplot+1, sizeof(float));
+
+  occa::properties plotInfo = kernelInfo;
+  plotInfo["defines/" "p_plotNp"] = mesh->plotNp;
+  plotInfo["defines/" "p_plotNthreads"] = mymax(mesh->Np, mesh->plotNp);
+
+  for(int r=0;r<meshBuildKernelStages;r++){
+    if(r==meshBuildKernelStage(mesh)){
+      mesh->plotInterpKernel =
+        meshBuildKernel(mesh, DHOLMES "/okl/meshPlotInterp.okl", "meshPlotInterp", plotInfo);
+    }
+    MPI_Barrier(mesh->comm);
+  }
+
+  // plot node coordinates do not change between frames (z=0 in 2D)
+  mesh->plotPoints = (float*) calloc(((size_t) Nplot)*3+1, sizeof(float));
+
+  dlong zeroOffset = 0;
+  mesh->plotInterpKernel(mesh->Nelements, zeroOffset, 1, 0, Nplot, mesh->o_plotInterpT, mesh->o_x, mesh->o_plotq);
+  mesh->plotInterpKernel(mesh->Nelements, zeroOffset, 1, 1, Nplot, mesh->o_plotInterpT, mesh->o_y, mesh->o_plotq);
+  if(mesh->dim==3)
+    mesh->plotInterpKernel(mesh->Nelements, zeroOffset, 1, 2, Nplot, mesh->o_plotInterpT, mesh->o_z, mesh->o_plotq);
+
+  if(Nplot)
+    mesh->o_plotq.copyTo(mesh->plotq, ((size_t) mesh->dim)*Nplot*sizeof(float));
+
+  for(dlong n=0;n<Nplot;++n)
+    for(int d=0;d<mesh->dim;++d)
+      mesh->plotPoints[3*n+d] = mesh->plotq[d*Nplot+n];
+
+  mesh->plotWriter = calloc(1, sizeof(meshPlotVTUWriter_t));
+}
+
+// interpolate Nfields fields of o_q (stride fieldOffset) to plot components field..field+Nfields-1
+void meshPlotVTUInterpolate(mesh_t *mesh, int field, int Nfields, dlong fieldOffset, occa::memory &o_q){
+
+  if(field+Nfields>mesh->plotNfields){
+    printf("meshPlotVTUInterpolate: components %d..%d exceed the %d set up\n",
+           field, field+Nfields-1, mesh->plotNfields);
+    MPI_Abort(mesh->comm, -1);
+  }
+
+  dlong Nplot = mesh->Nelements*mesh->plotNp;
+
+  mesh->plotInterpKernel(mesh->Nelements, fieldOffset, Nfields, field, Nplot,
+                         mesh->o_plotInterpT, o_q, mesh->o_plotq);
+}
+
+// copy the interpolated components back and hand them to the background writer;
+// arrays take consecutive components in order
+void meshPlotVTUWrite(mesh_t *mesh, const char *fileBase, int frame,
+                      int Narrays, const char **arrayNames, const int *arrayComponents){
+
+  meshPlotVTUWriter_t *writer = (meshPlotVTUWriter_t*) mesh->plotWriter;
+
+  int Ncomponents = 0;
+  for(int a=0;a<Narrays;++a)
+    Ncomponents += arrayComponents[a];
+
+  if(Narrays>meshPlotVTUMaxArrays || Ncomponents>mesh->plotNfields){
+    printf("meshPlotVTUWrite: %d arrays with %d components exceed the %d set up\n",
+           Narrays, Ncomponents, mesh->plotNfields);
+    MPI_Abort(mesh->comm, -1);
+  }
+
+  // the previous frame must have drained before its buffer is reused
+  meshPlotVTUFinish(mesh);
+
+  dlong Nplot = mesh->Nelements*mesh->plotNp;
+  if(Ncomponents && Nplot)
+    mesh->o_plotq.copyTo(mesh->plotq, ((size_t) Ncomponents)*Nplot*sizeof(float));
+
+  writer->mesh = mesh;
+  writer->frame = frame;
+  strncpy(writer->fileBase, fileBase, BUFSIZ-1);
+  writer->Narrays = Narrays;
+  for(int a=0;a<Narrays;++a){
+    strncpy(writer->arrayNames[a], arrayNames[a], BUFSIZ-1);
+    writer->arrayComponents[a] = arrayComponents[a];
+  }
+
+  if(pthread_create(&(writer->thread), NULL, meshPlotVTUThread, writer)){
+    // fall back to writing in place
+    meshPlotVTUThread(writer);
+    return;
+  }
+  writer->active = 1;
+}
+
+// wait for the background writer to finish the last frame
+void meshPlotVTUFinish(mesh_t *mesh){
+
+  meshPlotVTUWriter_t *writer = (meshPlotVTUWriter_t*) mesh->plotWriter;
+
+  if(writer && writer->active){
+    pthread_join(writer->thread, NULL);
+    writer->active = 0;
+  }
+}
@@ -42,8 +42,8 @@ void meshProbeSetup2D(mesh2D *mesh, dfloat *pX, dfloat *pY){
  
   dfloat *probeR           = (dfloat *) calloc(10*mesh->probeNTotal,sizeof(dfloat));
   dfloat *probeS           = (dfloat *) calloc(10*mesh->probeNTotal,sizeof(dfloat));
-  mesh->probeElementIds    = (int *)   calloc(10*mesh->probeNTotal,sizeof(int));
-  mesh->probeIds           = (int *)   calloc(10*mesh->probeNTotal,sizeof(int));
+  mesh->probeElementIds    = (dlong *)   calloc(10*mesh->probeNTotal,sizeof(dlong));
+  mesh->probeIds           = (dlong *)   calloc(10*mesh->probeNTotal,sizeof(dlong));
 
  
   double *A        = (double *) calloc((mesh->dim+1)*mesh->Nverts,sizeof(double)); 
@@ -141,7 +141,7 @@ mesh->probeN = 0;
  
   dfloat *probeR           = (dfloat *) calloc(mesh->probeNTotal,sizeof(dfloat));
   dfloat *probeS           = (dfloat *) calloc(mesh->probeNTotal,sizeof(dfloat));
-  mesh->probeElementIds    = (int *)   calloc(mesh->probeNTotal,sizeof(int));
+  mesh->probeElementIds    = (dlong *)   calloc(mesh->probeNTotal,sizeof(dlong));
 
  
   double *A        = (double *) calloc((mesh->dim+1)*mesh->Nverts,sizeof(double)); 
@@ -236,8 +236,8 @@ mesh->probeN = 0;
 
   if(mesh->probeN){
     //Reallocate ProbeIds and Element Ids, Now take cares of  cares 
-    mesh->probeIds        = (int *)   realloc(mesh->probeIds,        mesh->probeN*sizeof(int));
-    mesh->probeElementIds = (int *)   realloc(mesh->probeElementIds, mesh->probeN*sizeof(int));
+    mesh->probeIds        = (dlong *)   realloc(mesh->probeIds,        mesh->probeN*sizeof(dlong));
+    mesh->probeElementIds = (dlong *)   realloc(mesh->probeElementIds, mesh->probeN*sizeof(dlong));
     probeR                = (dfloat *) realloc(probeR, mesh->probeN*sizeof(dfloat));
     probeS                = (dfloat *) realloc(probeS, mesh->probeN*sizeof(dfloat));
 
@@ -36,6 +36,9 @@ mesh3D *meshSetupHex3D(char *filename, int N){
   
   // connect elements using parallel sort
   meshParallelConnect(mesh);
+
+  // optional boundary refinement of the partition (reconnects the mesh)
+  meshPartitionRefine(mesh, meshGeometricPartitionWeight3D);
   
   // print out connectivity statistics
   meshPartitionStatistics(mesh);
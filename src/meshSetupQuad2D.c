@@ -37,6 +37,9 @@ mesh2D *meshSetupQuad2D(char *filename, int N){
   // connect elements using parallel sort
   meshParallelConnect(mesh);
 
+  // optional boundary refinement of the partition (reconnects the mesh)
+  meshPartitionRefine(mesh, NULL);
+
   // print out connectivity statistics
   meshPartitionStatistics(mesh);
 
@@ -37,6 +37,9 @@ mesh3D *meshSetupTet3D(char *filename, int N){
   // connect elements using parallel sort
   meshParallelConnect(mesh);
 
+  // optional boundary refinement of the partition (reconnects the mesh)
+  meshPartitionRefine(mesh, meshGeometricPartitionWeight3D);
+
   // print out connectivity statistics
   meshPartitionStatistics(mesh);
 
@@ -40,6 +40,9 @@ mesh2D *meshSetupTri2D(char *filename, int N){
   // connect elements using parallel sort
   meshParallelConnect(mesh);
 
+  // optional boundary refinement of the partition (reconnects the mesh)
+  meshPartitionRefine(mesh, NULL);
+
   // print out connectivity statistics
   meshPartitionStatistics(mesh);
 
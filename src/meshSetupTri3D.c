@@ -40,6 +40,9 @@ mesh3D *meshSetupTri3D(char *filename, int N, double sphereRadius){
   // connect elements using parallel sort
   meshParallelConnect(mesh);
 
+  // optional boundary refinement of the partition (reconnects the mesh)
+  meshPartitionRefine(mesh, meshGeometricPartitionWeight3D);
+
   // print out connectivity statistics
   meshPartitionStatistics(mesh);
 
@@ -55,6 +55,15 @@ void occaDeviceConfig(mesh_t *mesh, setupAide &options){
     if (hostIds[r]==hostId) totalDevices++;
   }
 
+  // group the ranks on each host, coloured by the lowest rank on the host
+  int hostColor = rank;
+  for (int r=rank-1;r>=0;r--) {
+    if (hostIds[r]==hostId) hostColor = r;
+  }
+  MPI_Comm_split(mesh->comm, hostColor, rank, &(mesh->hostComm));
+  MPI_Comm_rank(mesh->hostComm, &(mesh->hostRank));
+  free(hostIds);
+
   if (size==1) options.getArgs("DEVICE NUMBER" ,device_id);
 
 #ifdef OCCA_VERSION_1_0
@@ -108,4 +117,10 @@ void occaDeviceConfig(mesh_t *mesh, setupAide &options){
   mesh->device.setup(deviceConfig);
 
   occa::initTimer(mesh->device);
+
+  // kernels are timed with stream tags, so profiling does not sync the device
+  if(options.compareArgs("PROFILE", "TRUE")){
+    occa::globalTimer.setApplicationProfiling(true);
+    occa::globalTimer.setKernelProfiling(true);
+  }
 }
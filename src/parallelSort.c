@@ -31,119 +31,167 @@ SOFTWARE.
 /* use this for int */
 #include "mesh.h"
 
-void mergeLists(size_t sz,
-		int N1, char *v1,
-		int N2, char *v2,
-		char *v3,
-		int (*compare)(const void *, const void *),
-		void (*match)(void *, void *)){
-    
-  int n1 = 0, n2 = 0, n3 = 0;
-    
-  // merge two lists from v1 and v2
-  for(n3=0;n3<N1+N2;++n3){
-    if(n1<N1 && n2<N2){
-      int c = compare(v1+n1*sz,v2+n2*sz);
-      if(c==-1){
-	memcpy(v3+n3*sz, v1+n1*sz, sz);
-	++n1;
-      }
-      else{
-	memcpy(v3+n3*sz, v2+n2*sz, sz);
-	++n2;
-      }
-    }
-    else if(n1<N1){
-      memcpy(v3+n3*sz, v1+n1*sz, sz);
-      ++n1;
-    }
-    else if(n2<N2){
-      memcpy(v3+n3*sz, v2+n2*sz, sz);
-      ++n2;
+// scan a sorted list for matching neighbours
+static void matchList(size_t sz, int N, char *v,
+		      int (*compare)(const void *, const void *),
+		      void (*match)(void *, void *)){
+
+  for(int n=0;n<N-1;++n){
+    if(!compare(v+n*sz,v+(n+1)*sz)){
+      match(v+n*sz, v+(n+1)*sz);
     }
   }
-  
-  // scan for matches
-  for(n3=0;n3<N1+N2-1;++n3){
-    if(!compare(v3+n3*sz,v3+(n3+1)*sz)){
-      match(v3+n3*sz, v3+(n3+1)*sz);
-    }
+}
+
+// exchange blocks of sorted entries, Nsend[r] entries to rank r, returns the received entries.
+// Counts and offsets are in entries of the contiguous entry type, so they do not overflow
+// int the way byte counts would.
+static char *exchangeLists(int size, MPI_Comm comm, MPI_Datatype entryType, size_t sz,
+			   char *v, int *Nsend, int *Nrecv){
+
+  int *sendOffsets = (int*) calloc(size+1, sizeof(int));
+  int *recvOffsets = (int*) calloc(size+1, sizeof(int));
+
+  MPI_Alltoall(Nsend, 1, MPI_INT, Nrecv, 1, MPI_INT, comm);
+
+  for(int r=0;r<size;++r){
+    sendOffsets[r+1] = sendOffsets[r] + Nsend[r];
+    recvOffsets[r+1] = recvOffsets[r] + Nrecv[r];
   }
-    
-  /* copy result back to v1, v2 */
-  memcpy(v1, v3,       N1*sz);
-  memcpy(v2, v3+sz*N1, N2*sz);
+
+  char *w = (char*) calloc(((size_t)recvOffsets[size])*sz+1, sizeof(char));
+
+  MPI_Alltoallv(v, Nsend, sendOffsets, entryType,
+		w, Nrecv, recvOffsets, entryType, comm);
+
+  free(sendOffsets); free(recvOffsets);
+
+  return w;
+}
+
+// exchange records of sz bytes, Nsend[r] records to rank r in rank order, sets Nrecv
+// and returns the received records in rank order (caller frees)
+void *parallelExchange(MPI_Comm comm, size_t sz, void *v, int *Nsend, int *Nrecv){
+
+  int size;
+  MPI_Comm_size(comm, &size);
+
+  MPI_Datatype entryType;
+  MPI_Type_contiguous((int) sz, MPI_CHAR, &entryType);
+  MPI_Type_commit(&entryType);
+
+  char *w = exchangeLists(size, comm, entryType, sz, (char*) v, Nsend, Nrecv);
+
+  MPI_Type_free(&entryType);
+
+  return w;
 }
 
-// assumes N is even and the same on all ranks
+// regular samples taken from each rank's sorted list
+#define sortOversample 32
+
+// sample sort: N may differ between ranks and each rank gets back N entries of the
+// globally sorted list. match is called on every pair of neighbouring equal entries.
+// Rank 0 gathers at most sortOversample samples per rank and broadcasts size-1
+// splitters, then two all-to-all exchanges move the entries.
 void parallelSort(int size, int rank, MPI_Comm comm,
 		  int N, void *vv, size_t sz,
 		  int (*compare)(const void *, const void *),
 		  void (*match)(void *, void *)
 		  ){
 
-#if 0
-  int rank, size;
-  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
-  MPI_Comm_size(MPI_COMM_WORLD, &size);
-#endif
-  
   /* cast void * to char * */
   char *v = (char*) vv;
 
-  /* sort faces by their vertex number pairs */
+  /* local sort */
   qsort(v, N, sz, compare);
-    
-  /* now do progressive merges */
-  int NA=N/2, NB = N/2, NC = N/2;
-    
-  MPI_Request recvA, recvC;
-  MPI_Request sendA, sendC;
-  MPI_Status status;
-  int tag = 999;
-    
-  /* temporary buffer for incoming data */
-  void *A = (void*) calloc(NA, sz);
-  void *B = v;
-  void *C = v+NB*sz;
-  
-  /* temporary space for merge sort */
-  void *tmp = (void*) calloc(N, sz);
-
-  /* max and min elements out of place hop one process at each step */
-  for(int step=0;step<size-1;++step){
-      
-    /* send C, receive A */
-    if(rank<size-1)
-      MPI_Isend(C, NC*sz, MPI_CHAR,  rank+1, tag, comm, &sendC);
-    if(rank>0)
-      MPI_Irecv(A, NA*sz, MPI_CHAR,  rank-1, tag, comm, &recvA);
-      
-    if(rank<size-1)
-      MPI_Wait(&sendC, &status);
-    if(rank>0)
-      MPI_Wait(&recvA, &status);
-      
-    /* merge sort A & B */
-    if(rank>0) 
-      mergeLists(sz, NA, (char*)A, NB, (char*)B, (char*)tmp, compare, match);
-      
-    /* send A, receive C */
-    if(rank>0)
-      MPI_Isend(A, NA*sz, MPI_CHAR, rank-1, tag, comm, &sendA);
-    if(rank<size-1)
-      MPI_Irecv(C, NC*sz, MPI_CHAR, rank+1, tag, comm, &recvC);
-      
-    if(rank>0)
-      MPI_Wait(&sendA, &status);
-    if(rank<size-1)
-      MPI_Wait(&recvC, &status);
-      
-    /* merge sort B & C */
-    mergeLists(sz, NB, (char*)B, NC, (char*)C, (char*)tmp, compare, match);
-      
+
+  if(size==1){
+    matchList(sz, N, v, compare, match);
+    return;
   }
-    
-  free(tmp);
-  free(A);
+
+  MPI_Datatype entryType;
+  MPI_Type_contiguous((int) sz, MPI_CHAR, &entryType);
+  MPI_Type_commit(&entryType);
+
+  /* bounded number of regular samples of the local list */
+  int Nsamples = mymin(N, sortOversample);
+  char *samples = (char*) calloc(Nsamples*sz+1, sizeof(char));
+  for(int s=0;s<Nsamples;++s)
+    memcpy(samples+s*sz, v+(((long long int)(2*s+1)*N)/(2*Nsamples))*sz, sz);
+
+  int *sampleCounts  = (int*) calloc(size, sizeof(int));
+  int *sampleOffsets = (int*) calloc(size+1, sizeof(int));
+  MPI_Gather(&Nsamples, 1, MPI_INT, sampleCounts, 1, MPI_INT, 0, comm);
+  for(int r=0;r<size;++r)
+    sampleOffsets[r+1] = sampleOffsets[r] + sampleCounts[r];
+
+  int NallSamples = sampleOffsets[size];
+  char *allSamples = (char*) calloc(((size_t)NallSamples)*sz+1, sizeof(char));
+  MPI_Gatherv(samples, Nsamples, entryType,
+	      allSamples, sampleCounts, sampleOffsets, entryType, 0, comm);
+
+  /* rank 0 chooses size-1 splitters from the sorted samples */
+  char *splitters = (char*) calloc((size-1)*sz+1, sizeof(char));
+  if(rank==0){
+    qsort(allSamples, NallSamples, sz, compare);
+    for(int r=0;r<size-1 && NallSamples>0;++r)
+      memcpy(splitters+r*sz, allSamples+(((long long int)(r+1)*NallSamples)/size)*sz, sz);
+  }
+  MPI_Bcast(&NallSamples, 1, MPI_INT, 0, comm);
+  MPI_Bcast(splitters, size-1, entryType, 0, comm);
+
+  /* bucket r holds entries not less than splitter r-1 and less than splitter r,
+     so equal entries always land on the same rank */
+  int *Nsend = (int*) calloc(size, sizeof(int));
+  int *Nrecv = (int*) calloc(size, sizeof(int));
+  int r = 0;
+  for(int n=0;n<N;++n){
+    while(r<size-1 && NallSamples>0 &&
+	  compare(v+n*sz, splitters+r*sz)>=0)
+      ++r;
+    ++Nsend[r];
+  }
+
+  char *w = exchangeLists(size, comm, entryType, sz, v, Nsend, Nrecv);
+
+  int Nw = 0;
+  for(int r=0;r<size;++r) Nw += Nrecv[r];
+
+  /* sort the received runs and find matches, which are now all on-rank */
+  qsort(w, Nw, sz, compare);
+  matchList(sz, Nw, w, compare, match);
+
+  /* return N entries to each rank, keeping the global order */
+  int *allN = (int*) calloc(size, sizeof(int));
+  MPI_Allgather(&N, 1, MPI_INT, allN, 1, MPI_INT, comm);
+
+  long long int start = 0, localNw = Nw;
+  MPI_Exscan(&localNw, &start, 1, MPI_LONG_LONG_INT, MPI_SUM, comm);
+  if(rank==0) start = 0;
+
+  for(int r=0;r<size;++r) Nsend[r] = 0;
+
+  long long int targetStart = 0;
+  int dest = 0;
+  for(int n=0;n<Nw;++n){
+    while(start+n >= targetStart+allN[dest]){
+      targetStart += allN[dest];
+      ++dest;
+    }
+    ++Nsend[dest];
+  }
+
+  char *u = exchangeLists(size, comm, entryType, sz, w, Nsend, Nrecv);
+  memcpy(v, u, ((size_t)N)*sz);
+
+  free(u);
+  free(w);
+  free(allN);
+  free(Nsend); free(Nrecv);
+  free(samples); free(allSamples); free(splitters);
+  free(sampleCounts); free(sampleOffsets);
+
+  MPI_Type_free(&entryType);
 }
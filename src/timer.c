@@ -24,6 +24,9 @@ SOFTWARE.
 
 */
 
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include "timer.h"
 
 namespace occa {
@@ -42,17 +45,14 @@ namespace occa {
     deviceInitialized  = false;
     profileApplication = false;
 
-    /*
-    std::string profilerOn       = occa::env::var("OCCA_PROFILE");
-    std::string kernelProfilerOn = occa::env::var("OCCA_KERNEL_PROFILE");
-    */
-    std::string profilerOn = "1";
-    std::string kernelProfilerOn = "1";
-    
-    if(profilerOn == "1")
+    // off unless requested, solvers also switch it on with PROFILE
+    const char *profilerOn       = getenv("OCCA_PROFILE");
+    const char *kernelProfilerOn = getenv("OCCA_KERNEL_PROFILE");
+
+    if(profilerOn && !strcmp(profilerOn, "1"))
       profileApplication = true;
 
-    if(kernelProfilerOn == "1"){
+    if(kernelProfilerOn && !strcmp(kernelProfilerOn, "1")){
       profileKernels     = true;
       profileApplication = true;
     }
@@ -76,6 +76,12 @@ namespace occa {
 
       timeStack.push(currentTime);
 
+      // device work queued from here on is timed against this tag
+      if(profileKernels && deviceInitialized)
+        tagStack.push(occaHandle.tagStream());
+      else
+        tagStack.push(occa::streamTag());
+
 
       if(treeDepth){
         keyStack.pop();
@@ -109,38 +115,14 @@ namespace occa {
 
       keyStack.pop();
       timeStack.pop();
+      tagStack.pop();
     }
 
     return elapsedTime;
   }
 
   double timer::toc(std::string key, occa::kernel &kernel){
-
-    double elapsedTime = 0.;
-
-    if(profileApplication){
-
-      assert(key == keyStack.top());
-
-      //      OCCA_CHECK(key == keyStack.top(),
-      //                 "Error in timer " << key << '\n');
-
-      if(profileKernels){
-        if(deviceInitialized)
-          occaHandle.finish();
-
-        double currentTime = occa::currentTime();
-        elapsedTime = (currentTime - timeStack.top());
-        // times[keyStack].timeTaken += kernel.timeTaken();
-        times[keyStack].timeTaken += elapsedTime;
-        times[keyStack].numCalls++;
-      }
-
-      keyStack.pop();
-      timeStack.pop();
-    }
-
-    return elapsedTime;
+    return tocEvent(key, 0., 0.);
   }
 
 
@@ -161,6 +143,7 @@ namespace occa {
 
       keyStack.pop();
       timeStack.pop();
+      tagStack.pop();
     }
 
     return elapsedTime;
@@ -168,28 +151,7 @@ namespace occa {
 
 
   double timer::toc(std::string key, occa::kernel &kernel, double flops){
-
-    double elapsedTime = 0.;
-
-    if(profileApplication){
-
-      assert(key == keyStack.top());
-
-      if(profileKernels){
-        occaHandle.finish();
-        double currentTime = occa::currentTime();
-        elapsedTime = (currentTime - timeStack.top());
-        // times[keyStack].timeTaken += kernel.timeTaken();
-        times[keyStack].timeTaken += elapsedTime;
-        times[keyStack].numCalls++;
-        times[keyStack].flopCount += flops;
-      }
-
-      keyStack.pop();
-      timeStack.pop();
-    }
-
-    return elapsedTime;
+    return tocEvent(key, flops, 0.);
   }
 
   double timer::toc(std::string key, double flops, double bw){
@@ -212,6 +174,7 @@ namespace occa {
 
       keyStack.pop();
       timeStack.pop();
+      tagStack.pop();
     }
 
     return elapsedTime;
@@ -220,6 +183,10 @@ namespace occa {
 
   double timer::toc(std::string key, occa::kernel &kernel,
                     double flops, double bw){
+    return tocEvent(key, flops, bw);
+  }
+
+  double timer::tocEvent(std::string key, double flops, double bw){
 
     double elapsedTime = 0.;
 
@@ -227,26 +194,67 @@ namespace occa {
 
       assert(key == keyStack.top());
 
-      if(profileKernels){
-        occaHandle.finish();
-        double currentTime = occa::currentTime();
-        elapsedTime = (currentTime - timeStack.top());
-        // times[keyStack].timeTaken += kernel.timeTaken();
+      double currentTime = occa::currentTime();
+      elapsedTime = (currentTime - timeStack.top());
+
+      if(profileKernels && deviceInitialized){
+        // device time between the tic and toc tags, no sync here
+        timerEvent event;
+        event.keys     = keyStack;
+        event.startTag = tagStack.top();
+        event.endTag   = occaHandle.tagStream();
+        pendingEvents.push_back(event);
+      }
+      else{
         times[keyStack].timeTaken += elapsedTime;
-        times[keyStack].numCalls++;
-        times[keyStack].flopCount += flops;
-        times[keyStack].bandWidthCount += bw;
       }
 
+      times[keyStack].numCalls++;
+      times[keyStack].flopCount += flops;
+      times[keyStack].bandWidthCount += bw;
+
       dataTransferred += bw;
 
       keyStack.pop();
       timeStack.pop();
+      tagStack.pop();
+
+      if(pendingEvents.size()>=maxPendingEvents)
+        flushEvents();
     }
 
     return elapsedTime;
   }
 
+  double timer::tocEvent(std::string key, long long int Nelements){
+
+    double flops = 0., bw = 0.;
+
+    std::map<std::string, timerCost>::iterator iter = kernelCosts.find(key);
+    if(iter != kernelCosts.end()){
+      flops = iter->second.flopsPerElement*Nelements;
+      bw    = iter->second.bytesPerElement*Nelements;
+    }
+
+    return tocEvent(key, flops, bw);
+  }
+
+  void timer::registerKernel(std::string key, double flopsPerElement, double bytesPerElement){
+    kernelCosts[key].flopsPerElement = flopsPerElement;
+    kernelCosts[key].bytesPerElement = bytesPerElement;
+  }
+
+  void timer::flushEvents(){
+
+    // waits for the last recorded tag only
+    for(size_t n=0;n<pendingEvents.size();++n){
+      timerEvent *event = &(pendingEvents[n]);
+      times[event->keys].timeTaken += occaHandle.timeBetween(event->startTag, event->endTag);
+    }
+
+    pendingEvents.clear();
+  }
+
   double timer::print_recursively(std::vector<std::string> &childs,
                                   double parentTime,
                                   double overallTime){
@@ -297,6 +305,8 @@ namespace occa {
   void timer::printTimer(){
 
     if(profileApplication){
+      flushEvents();
+
       std::map<std::stack<std::string>, timerTraits>::iterator iter;
 
       // compute overall time
@@ -433,6 +443,154 @@ namespace occa {
     }
   }
 
+  // per-timer statistics over the ranks that recorded it
+  class timerStats{
+  public:
+    int    Nranks;
+    double minTime, maxTime, sumTime;
+    double numCalls, flopCount, bandWidthCount;
+
+    timerStats(){
+      Nranks = 0;
+      minTime = maxTime = sumTime = 0.;
+      numCalls = flopCount = bandWidthCount = 0.;
+    }
+  };
+
+  void timer::writeTimer(MPI_Comm comm, std::string fileBase){
+
+    if(!profileApplication) return;
+
+    flushEvents();
+
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+
+    // flatten the tree into parent/child paths and
+    // (time, calls, flops, bytes) per path
+    const int Nvals = 4;
+
+    std::string names;
+    std::vector<double> vals;
+
+    std::map<std::stack<std::string>, timerTraits>::iterator iter;
+    for(iter = times.begin(); iter != times.end(); iter++){
+      std::stack<std::string> keys = iter->first;
+
+      std::string path = keys.top();
+      keys.pop();
+      while(!keys.empty()){
+        path = keys.top() + "/" + path;
+        keys.pop();
+      }
+      names.append(path);
+      names.push_back('\0');
+
+      vals.push_back(iter->second.timeTaken);
+      vals.push_back(iter->second.numCalls);
+      vals.push_back(iter->second.flopCount);
+      vals.push_back(iter->second.bandWidthCount);
+    }
+
+    int Ntimers = times.size();
+    int Nchars  = names.size();
+
+    int *rankNtimers = (int*) calloc(size, sizeof(int));
+    int *rankNchars  = (int*) calloc(size, sizeof(int));
+    MPI_Gather(&Ntimers, 1, MPI_INT, rankNtimers, 1, MPI_INT, 0, comm);
+    MPI_Gather(&Nchars,  1, MPI_INT, rankNchars,  1, MPI_INT, 0, comm);
+
+    int *valCounts  = (int*) calloc(size, sizeof(int));
+    int *valStarts  = (int*) calloc(size+1, sizeof(int));
+    int *charStarts = (int*) calloc(size+1, sizeof(int));
+    for(int r=0;r<size;++r){
+      valCounts[r]    = Nvals*rankNtimers[r];
+      valStarts[r+1]  = valStarts[r]  + valCounts[r];
+      charStarts[r+1] = charStarts[r] + rankNchars[r];
+    }
+
+    char   *allNames = (char*)   calloc(charStarts[size]+1, sizeof(char));
+    double *allVals  = (double*) calloc(valStarts[size]+1, sizeof(double));
+
+    MPI_Gatherv((void*) names.data(), Nchars, MPI_CHAR,
+                allNames, rankNchars, charStarts, MPI_CHAR, 0, comm);
+    MPI_Gatherv(vals.data(), Nvals*Ntimers, MPI_DOUBLE,
+                allVals, valCounts, valStarts, MPI_DOUBLE, 0, comm);
+
+    if(rank==0){
+      std::map<std::string, timerStats> stats;
+
+      for(int r=0;r<size;++r){
+        const char *name = allNames + charStarts[r];
+        for(int n=0;n<rankNtimers[r];++n){
+          double *v = allVals + valStarts[r] + Nvals*n;
+
+          timerStats *st = &(stats[name]);
+          st->minTime = (st->Nranks) ? std::min(st->minTime, v[0]) : v[0];
+          st->maxTime = std::max(st->maxTime, v[0]);
+          st->sumTime += v[0];
+          st->numCalls = std::max(st->numCalls, v[1]);
+          st->flopCount += v[2];
+          st->bandWidthCount += v[3];
+          st->Nranks++;
+
+          name += strlen(name)+1;
+        }
+      }
+
+      std::string jsonName = fileBase + ".json";
+      std::string csvName  = fileBase + ".csv";
+
+      FILE *json = fopen(jsonName.c_str(), "w");
+      FILE *csv  = fopen(csvName.c_str(), "w");
+
+      if(!json || !csv){
+        printf("Could not open profile files %s/%s\n", jsonName.c_str(), csvName.c_str());
+      }
+      else{
+        fprintf(json, "{\n  \"ranks\": %d,\n  \"timers\": [", size);
+        fprintf(csv, "name,depth,ranks,calls,min,mean,max,flops,bytes,gflops,gbs\n");
+
+        std::map<std::string, timerStats>::iterator it;
+        for(it = stats.begin(); it != stats.end(); it++){
+          timerStats *st = &(it->second);
+
+          int depth = std::count(it->first.begin(), it->first.end(), '/');
+
+          // achieved rates of all ranks together, limited by the slowest
+          double invTime = (st->maxTime > 1e-10) ? 1.0/st->maxTime : 0.;
+          double gflops  = st->flopCount*invTime/1e9;
+          double gbs     = st->bandWidthCount*invTime/1e9;
+          double mean    = st->sumTime/st->Nranks;
+
+          fprintf(json, "%s\n    {\"name\": \"%s\", \"depth\": %d, \"ranks\": %d, \"calls\": %.0f, "
+                  "\"min\": %.6e, \"mean\": %.6e, \"max\": %.6e, "
+                  "\"flops\": %.6e, \"bytes\": %.6e, \"gflops\": %.6e, \"gbs\": %.6e}",
+                  (it==stats.begin()) ? "" : ",",
+                  it->first.c_str(), depth, st->Nranks, st->numCalls,
+                  st->minTime, mean, st->maxTime,
+                  st->flopCount, st->bandWidthCount, gflops, gbs);
+
+          fprintf(csv, "\"%s\",%d,%d,%.0f,%.6e,%.6e,%.6e,%.6e,%.6e,%.6e,%.6e\n",
+                  it->first.c_str(), depth, st->Nranks, st->numCalls,
+                  st->minTime, mean, st->maxTime,
+                  st->flopCount, st->bandWidthCount, gflops, gbs);
+        }
+
+        fprintf(json, "\n  ]\n}\n");
+      }
+
+      if(json) fclose(json);
+      if(csv)  fclose(csv);
+    }
+
+    free(rankNtimers); free(rankNchars);
+    free(valCounts);   free(valStarts);
+    free(charStarts);
+    free(allNames);    free(allVals);
+  }
+
   timer globalTimer;
 
   double dataTransferred = 0.;
@@ -473,6 +631,10 @@ namespace occa {
     globalTimer.printTimer();
   }
 
+  void writeTimer(MPI_Comm comm, std::string fileBase){
+    globalTimer.writeTimer(comm, fileBase);
+  }
+
   double currentTime() {
 #if (OCCA_OS & LINUX_OS)
 
@@ -521,13 +683,22 @@ namespace occa {
 }
 
 
+// device timers are closed on stream tags, so neither call syncs the device
 void occaTimerTic(occa::device device,std::string name) {
-  device.finish(); 
+  if(occa::globalTimer.hostTimed()) device.finish();
   occa::tic(name); 
 };
 
 void occaTimerToc(occa::device device,std::string name) {
+  if(occa::globalTimer.hostTimed()) device.finish();
+  occa::globalTimer.tocEvent(name, 0., 0.); 
+};
+
+void occaTimerToc(occa::device device,std::string name, long long int Nelements) {
+  if(occa::globalTimer.hostTimed()) device.finish();
+  occa::globalTimer.tocEvent(name, Nelements); 
+};
 
-  device.finish(); 
-  occa::toc(name); 
+void occaTimerRegister(std::string name, double flopsPerElement, double bytesPerElement) {
+  occa::globalTimer.registerKernel(name, flopsPerElement, bytesPerElement);
 };
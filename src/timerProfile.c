@@ -0,0 +1,48 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mesh.h"
+
+// profiler helpers on top of the timer in timer.c: the per-element cost model
+// used with occaTimerRegister and the profile writer called at the end of a run
+
+void meshKernelCostFactors(mesh_t *mesh, int elementType, double *Dflops, double *Gbytes){
+
+  const int tensor = (elementType==QUADRILATERALS || elementType==HEXAHEDRA);
+
+  *Dflops = tensor ? 2.*mesh->Nq : 2.*mesh->Np;
+  *Gbytes = (tensor ? mesh->Np : 1)*mesh->Nvgeo*sizeof(dfloat);
+}
+
+void meshWriteProfile(mesh_t *mesh, setupAide &options){
+
+  string profileName;
+  options.getArgs("OUTPUT FILE NAME", profileName);
+  occa::writeTimer(mesh->comm, profileName + "_profile");
+}
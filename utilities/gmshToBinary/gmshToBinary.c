@@ -0,0 +1,214 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/*
+  purpose: one-shot serial conversion of a gmsh (ASCII v2) mesh into the
+           libParanumal binary mesh format read by meshParallelReaderBinary
+
+  usage: ./gmshToBinary Tri2D|Quad2D|Tet3D|Hex3D foo.msh foo.bmsh
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "meshBinaryFormat.h"
+
+typedef long long int llong;
+
+typedef struct {
+  const char *name;
+  int dim;
+  int Nverts;
+  int NfaceVertices;
+  int elementType;  // gmsh code for volume elements
+  int faceType;     // gmsh code for boundary faces
+} elementDesc_t;
+
+static const elementDesc_t elementDescs[] = {
+  {"Tri2D",  2, 3, 2, 2, 1},
+  {"Quad2D", 2, 4, 2, 3, 1},
+  {"Tet3D",  3, 4, 3, 4, 2},
+  {"Hex3D",  3, 8, 4, 5, 3}
+};
+
+static void writeOrDie(const void *ptr, size_t sz, size_t N, FILE *fp){
+  if(fwrite(ptr, sz, N, fp)!=N){
+    printf("gmshToBinary: write failed\n");
+    exit(-1);
+  }
+}
+
+/* read the remaining integers of a gmsh element line into v */
+static int scanIds(char *buf, llong *v, int Nmax){
+  int Nids = 0;
+  char *tok = strtok(buf, " \t\r\n");
+  while(tok && Nids<Nmax){
+    v[Nids++] = atoll(tok);
+    tok = strtok(NULL, " \t\r\n");
+  }
+  return Nids;
+}
+
+int main(int argc, char **argv){
+
+  if(argc!=4){
+    printf("usage: ./gmshToBinary Tri2D|Quad2D|Tet3D|Hex3D foo.msh foo.bmsh\n");
+    exit(-1);
+  }
+
+  const elementDesc_t *desc = NULL;
+  for(size_t n=0;n<sizeof(elementDescs)/sizeof(elementDesc_t);++n)
+    if(!strcmp(argv[1], elementDescs[n].name)) desc = elementDescs+n;
+
+  if(desc==NULL){
+    printf("gmshToBinary: unknown element type %s\n", argv[1]);
+    exit(-1);
+  }
+
+  FILE *fp = fopen(argv[2], "r");
+  if(fp==NULL){
+    printf("gmshToBinary: could not load file %s\n", argv[2]);
+    exit(-1);
+  }
+
+  const int dim = desc->dim;
+  const int Nverts = desc->Nverts;
+  const int NbInfo = desc->NfaceVertices+1;
+
+  char buf[BUFSIZ];
+  do{
+    if(!fgets(buf, BUFSIZ, fp)){ printf("gmshToBinary: no $Nodes section\n"); exit(-1); }
+  }while(!strstr(buf, "$Nodes"));
+
+  /* read number of nodes in mesh */
+  llong Nnodes;
+  if(!fgets(buf, BUFSIZ, fp)) exit(-1);
+  sscanf(buf, "%lld", &Nnodes);
+
+  double *VX = (double*) calloc(Nnodes, sizeof(double));
+  double *VY = (double*) calloc(Nnodes, sizeof(double));
+  double *VZ = (double*) calloc(Nnodes, sizeof(double));
+
+  for(llong n=0;n<Nnodes;++n){
+    if(!fgets(buf, BUFSIZ, fp)) exit(-1);
+    sscanf(buf, "%*d%lf%lf%lf", VX+n, VY+n, VZ+n);
+  }
+
+  do{
+    if(!fgets(buf, BUFSIZ, fp)){ printf("gmshToBinary: no $Elements section\n"); exit(-1); }
+  }while(!strstr(buf, "$Elements"));
+
+  llong NgmshElements;
+  if(!fgets(buf, BUFSIZ, fp)) exit(-1);
+  sscanf(buf, "%lld", &NgmshElements);
+
+  // over allocate, trimmed on output
+  llong *elementInfo  = (llong*) calloc(NgmshElements, sizeof(llong));
+  llong *EToV         = (llong*) calloc(NgmshElements*Nverts, sizeof(llong));
+  llong *boundaryInfo = (llong*) calloc(NgmshElements*NbInfo, sizeof(llong));
+
+  llong Nelements = 0, NboundaryFaces = 0;
+
+  for(llong n=0;n<NgmshElements;++n){
+    llong v[64];
+    if(!fgets(buf, BUFSIZ, fp)) exit(-1);
+
+    // id, type, Ntags, tags..., vertices...
+    int Nids = scanIds(buf, v, 64);
+    int elementType = (int) v[1];
+    int Ntags = (int) v[2];
+    llong *verts = v+3+Ntags;
+
+    if(elementType==desc->faceType && Nids>=3+Ntags+desc->NfaceVertices){
+      boundaryInfo[NboundaryFaces*NbInfo] = v[3]; // physical tag
+      for(int f=0;f<desc->NfaceVertices;++f)
+        boundaryInfo[NboundaryFaces*NbInfo+1+f] = verts[f]-1;
+      ++NboundaryFaces;
+    }
+
+    if(elementType==desc->elementType && Nids>=3+Ntags+Nverts){
+      llong *EToVn = EToV + Nelements*Nverts;
+      for(int f=0;f<Nverts;++f) EToVn[f] = verts[f]-1;
+
+      // same orientation fix as meshParallelReaderTri2D/Quad2D
+      if(dim==2){
+        int vb = (Nverts==3) ? 2:3;
+        double xe1 = VX[EToVn[0]], xe2 = VX[EToVn[1]], xeb = VX[EToVn[vb]];
+        double ye1 = VY[EToVn[0]], ye2 = VY[EToVn[1]], yeb = VY[EToVn[vb]];
+        double J = 0.25*((xe2-xe1)*(yeb-ye1) - (xeb-xe1)*(ye2-ye1));
+        if(J<0){
+          llong vtmp = EToVn[vb];
+          EToVn[vb] = EToVn[1];
+          EToVn[1] = vtmp;
+        }
+      }
+
+      elementInfo[Nelements] = v[3];
+      ++Nelements;
+    }
+  }
+  fclose(fp);
+
+  FILE *out = fopen(argv[3], "wb");
+  if(out==NULL){
+    printf("gmshToBinary: could not open %s for writing\n", argv[3]);
+    exit(-1);
+  }
+
+  llong header[meshBinaryNheader] = {0};
+  header[meshBinaryDimId] = dim;
+  header[meshBinaryNvertsId] = Nverts;
+  header[meshBinaryNfaceVerticesId] = desc->NfaceVertices;
+  header[meshBinaryNnodesId] = Nnodes;
+  header[meshBinaryNelementsId] = Nelements;
+  header[meshBinaryNboundaryFacesId] = NboundaryFaces;
+
+  writeOrDie(meshBinaryMagic, sizeof(char), meshBinaryMagicLength, out);
+  writeOrDie(header, sizeof(llong), meshBinaryNheader, out);
+  writeOrDie(elementInfo, sizeof(llong), Nelements, out);
+  writeOrDie(EToV, sizeof(llong), Nelements*Nverts, out);
+
+  // element vertex coordinates, one block per coordinate direction
+  double *VXYZ[3] = {VX, VY, VZ};
+  double *EXYZ = (double*) calloc(Nelements*Nverts, sizeof(double));
+  for(int d=0;d<dim;++d){
+    for(llong n=0;n<Nelements*Nverts;++n)
+      EXYZ[n] = VXYZ[d][EToV[n]];
+    writeOrDie(EXYZ, sizeof(double), Nelements*Nverts, out);
+  }
+
+  writeOrDie(boundaryInfo, sizeof(llong), NboundaryFaces*NbInfo, out);
+  fclose(out);
+
+  printf("gmshToBinary: wrote %lld %s elements, %lld boundary faces, %lld nodes to %s\n",
+         Nelements, desc->name, NboundaryFaces, Nnodes, argv[3]);
+
+  free(VX); free(VY); free(VZ);
+  free(elementInfo); free(EToV); free(boundaryInfo); free(EXYZ);
+
+  return 0;
+}